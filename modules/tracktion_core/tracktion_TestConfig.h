@@ -20,6 +20,7 @@
 
 #define ENGINE_UNIT_TESTS_AUTOMATION                    1
 #define ENGINE_UNIT_TESTS_AUX_SEND                      1
+#define ENGINE_UNIT_TESTS_BINARY_EDIT_FILE              1
 #define ENGINE_UNIT_TESTS_CLIPBOARD                     1
 #define ENGINE_UNIT_TESTS_CLIPSLOT                      1
 #define ENGINE_UNIT_TESTS_CONSTRAINED_CACHED_VALUE      1
@@ -48,6 +49,9 @@
 #define ENGINE_UNIT_TESTS_SELECTABLE                    1
 #define ENGINE_UNIT_TESTS_AUDIO_FILE                    1
 #define ENGINE_UNIT_TESTS_AUDIO_FILE_CACHE              1
+#define ENGINE_UNIT_TESTS_PEAK_FILE                     1
+#define ENGINE_UNIT_TESTS_LEVEL_MEASURER                1
+#define ENGINE_UNIT_TESTS_LOUDNESS_METER                1
 #define ENGINE_UNIT_TESTS_VOLPANPLUGIN                  1
 #define ENGINE_UNIT_TESTS_TEMPO_SEQUENCE                1
 #define ENGINE_UNIT_TESTS_QUANTISATION_TYPE             1
@@ -60,8 +64,12 @@
 #define GRAPH_UNIT_TESTS_NODEVISITING                   1
 #define GRAPH_UNIT_TESTS_SAMPLECONVERSION               1
 #define GRAPH_UNIT_TESTS_CONNECTEDNODE                  1
+#define GRAPH_UNIT_TESTS_SCHEDULING                     1
 
 #define GRAPH_UNIT_TESTS_AUDIOBUFFERPOOL                1
+#define GRAPH_UNIT_TESTS_AUDIOBUFFERARENA               1
+#define GRAPH_UNIT_TESTS_SUMMINGKERNELS                 1
+#define GRAPH_UNIT_TESTS_MIDIMESSAGEARRAY               1
 #define GRAPH_UNIT_TESTS_SEMAPHORE                      1
 #define GRAPH_UNIT_TESTS_ALLOCATION                     1
 
@@ -69,6 +77,8 @@
 #define CORE_BENCHMARKS_TEMPO                           1
 
 #define GRAPH_BENCHMARKS_THREADS                        1
+#define GRAPH_BENCHMARKS_SCHEDULING                     1
+#define GRAPH_BENCHMARKS_SUMMING                        1
 
 #define ENGINE_BENCHMARKS_AUDIOFILECACHE                1
 #define ENGINE_BENCHMARKS_CONTAINERCLIP                 1
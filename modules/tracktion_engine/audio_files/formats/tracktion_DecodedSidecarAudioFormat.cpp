@@ -0,0 +1,351 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+static int getDecodedSidecarHeaderInt()         { return (int) juce::ByteOrder::littleEndianInt ("TKDS"); }
+static constexpr int decodedSidecarHeaderSize = 4096;
+
+//==============================================================================
+class DecodedSidecarAudioFormatReader  : public juce::AudioFormatReader
+{
+public:
+    DecodedSidecarAudioFormatReader (juce::InputStream* in)
+        : AudioFormatReader (in, TRANS("Decoded audio file"))
+    {
+        if (in->readInt() != getDecodedSidecarHeaderInt())
+            return;
+
+        dataStartOffset         = in->readInt();
+        sampleRate              = in->readDouble();
+        lengthInSamples         = in->readInt64();
+        numChannels             = (unsigned int) in->readInt();
+        bitsPerSample           = (unsigned int) in->readInt();
+        usesFloatingPointData   = bitsPerSample == 32;
+        const auto sourceSize   = in->readInt64();
+        const auto sourceTime   = in->readInt64();
+        const bool isComplete   = in->readInt() != 0;
+
+        metadataValues.set (DecodedSidecarAudioFormat::sourceFileSizeKey, juce::String (sourceSize));
+        metadataValues.set (DecodedSidecarAudioFormat::sourceModificationTimeKey, juce::String (sourceTime));
+
+        if (! isComplete || dataStartOffset < decodedSidecarHeaderSize
+            || numChannels < 1 || numChannels > 64
+            || (bitsPerSample != 16 && bitsPerSample != 32)
+            || in->getTotalLength() < dataStartOffset + lengthInSamples * getBytesPerFrame())
+            sampleRate = 0;
+    }
+
+    int getBytesPerFrame() const
+    {
+        return (int) (numChannels * bitsPerSample / 8);
+    }
+
+    bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      juce::int64 startSampleInFile, int numSamples) override
+    {
+        clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples, lengthInSamples);
+
+        if (numSamples <= 0)
+            return true;
+
+        const int bytesPerFrame = getBytesPerFrame();
+        input->setPosition (dataStartOffset + startSampleInFile * bytesPerFrame);
+
+        while (numSamples > 0)
+        {
+            const int tempBufSize = 480 * 3 * 4 * 16;
+            char tempBuffer [tempBufSize];
+
+            const int numThisTime = std::min (tempBufSize / bytesPerFrame, numSamples);
+            const int bytesRead = input->read (tempBuffer, numThisTime * bytesPerFrame);
+
+            if (bytesRead < numThisTime * bytesPerFrame)
+            {
+                jassert (bytesRead >= 0);
+                std::memset (tempBuffer + bytesRead, 0, (size_t) (numThisTime * bytesPerFrame - bytesRead));
+            }
+
+            if (usesFloatingPointData)
+                ReadHelper<juce::AudioData::Float32, juce::AudioData::Float32, juce::AudioData::LittleEndian>
+                    ::read (destSamples, startOffsetInDestBuffer, numDestChannels, tempBuffer, (int) numChannels, numThisTime);
+            else
+                ReadHelper<juce::AudioData::Int32, juce::AudioData::Int16, juce::AudioData::LittleEndian>
+                    ::read (destSamples, startOffsetInDestBuffer, numDestChannels, tempBuffer, (int) numChannels, numThisTime);
+
+            startOffsetInDestBuffer += numThisTime;
+            numSamples -= numThisTime;
+        }
+
+        return true;
+    }
+
+    int dataStartOffset = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedSidecarAudioFormatReader)
+};
+
+//==============================================================================
+class DecodedSidecarAudioFormatWriter  : public juce::AudioFormatWriter
+{
+public:
+    DecodedSidecarAudioFormatWriter (juce::OutputStream* out, double sampleRate_, unsigned int numChannels_,
+                                     int bitsPerSample_, const juce::StringPairArray& metadata)
+        : AudioFormatWriter (out,
+                             TRANS("Decoded audio file"),
+                             sampleRate_,
+                             numChannels_,
+                             (unsigned int) bitsPerSample_),
+          sourceFileSize (metadata[DecodedSidecarAudioFormat::sourceFileSizeKey].getLargeIntValue()),
+          sourceModificationTime (metadata[DecodedSidecarAudioFormat::sourceModificationTimeKey].getLargeIntValue())
+    {
+        usesFloatingPointData = bitsPerSample == 32;
+        writeHeader (false);
+    }
+
+    ~DecodedSidecarAudioFormatWriter() override
+    {
+        output->flush();
+        output->setPosition (0);
+        writeHeader (true);
+    }
+
+    //==============================================================================
+    bool write (const int** data, int numSamps) override
+    {
+        const auto bytesPerFrame = (size_t) (numChannels * bitsPerSample / 8);
+        tempBuffer.ensureSize (bytesPerFrame * (size_t) numSamps, false);
+
+        if (usesFloatingPointData)
+        {
+            auto dest = static_cast<float*> (tempBuffer.getData());
+
+            for (int j = 0; j < numSamps; ++j)
+            {
+                for (unsigned int i = 0; i < numChannels; ++i)
+                {
+                    float val = data[i] != nullptr ? ((const float*) data[i])[j] : 0.0f;
+                    JUCE_UNDENORMALISE (val);
+                    *dest++ = juce::ByteOrder::swapIfBigEndian (val);
+                }
+            }
+        }
+        else
+        {
+            auto dest = static_cast<int16_t*> (tempBuffer.getData());
+
+            for (int j = 0; j < numSamps; ++j)
+                for (unsigned int i = 0; i < numChannels; ++i)
+                    *dest++ = (int16_t) juce::ByteOrder::swapIfBigEndian ((uint16_t) (data[i] != nullptr ? (data[i][j] >> 16) : 0));
+        }
+
+        lengthInSamples += numSamps;
+        return output->write (tempBuffer.getData(), bytesPerFrame * (size_t) numSamps);
+    }
+
+private:
+    juce::int64 lengthInSamples = 0;
+    const juce::int64 sourceFileSize, sourceModificationTime;
+    juce::MemoryBlock tempBuffer;
+
+    void writeHeader (bool isComplete)
+    {
+        output->writeInt (getDecodedSidecarHeaderInt());
+        output->writeInt (decodedSidecarHeaderSize);
+        output->writeDouble (sampleRate);
+        output->writeInt64 (lengthInSamples);
+        output->writeInt ((int) numChannels);
+        output->writeInt ((int) bitsPerSample);
+        output->writeInt64 (sourceFileSize);
+        output->writeInt64 (sourceModificationTime);
+        output->writeInt (isComplete ? 1 : 0);
+
+        while (output->getPosition() < decodedSidecarHeaderSize)
+            output->writeByte (0);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedSidecarAudioFormatWriter)
+};
+
+//==============================================================================
+class MemoryMappedDecodedSidecarReader   : public juce::MemoryMappedAudioFormatReader
+{
+public:
+    MemoryMappedDecodedSidecarReader (const juce::File& f, const DecodedSidecarAudioFormatReader& reader)
+        : MemoryMappedAudioFormatReader (f, reader,
+                                         reader.dataStartOffset,
+                                         reader.lengthInSamples * reader.getBytesPerFrame(),
+                                         reader.getBytesPerFrame())
+    {
+    }
+
+    bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      juce::int64 startSampleInFile, int numSamples) override
+    {
+        clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples, lengthInSamples);
+
+        if (map == nullptr || ! mappedSection.contains ({ startSampleInFile, startSampleInFile + numSamples }))
+        {
+            jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
+            return false;
+        }
+
+        if (usesFloatingPointData)
+            ReadHelper<juce::AudioData::Float32, juce::AudioData::Float32, juce::AudioData::LittleEndian>
+                ::read (destSamples, startOffsetInDestBuffer, numDestChannels, sampleToPointer (startSampleInFile), (int) numChannels, numSamples);
+        else
+            ReadHelper<juce::AudioData::Int32, juce::AudioData::Int16, juce::AudioData::LittleEndian>
+                ::read (destSamples, startOffsetInDestBuffer, numDestChannels, sampleToPointer (startSampleInFile), (int) numChannels, numSamples);
+
+        return true;
+    }
+
+    void getSample (juce::int64 sample, float* result) const noexcept override
+    {
+        if (map == nullptr || ! mappedSection.contains (sample))
+        {
+            jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
+
+            std::memset (result, 0, sizeof (float) * numChannels);
+            return;
+        }
+
+        const void* sourceData = sampleToPointer (sample);
+
+        if (usesFloatingPointData)
+            ReadHelper<juce::AudioData::Float32, juce::AudioData::Float32, juce::AudioData::LittleEndian>
+                ::read (&result, 0, 1, sourceData, 1, (int) numChannels);
+        else
+            ReadHelper<juce::AudioData::Float32, juce::AudioData::Int16, juce::AudioData::LittleEndian>
+                ::read (&result, 0, 1, sourceData, 1, (int) numChannels);
+    }
+
+    using juce::MemoryMappedAudioFormatReader::readMaxLevels;
+
+    void readMaxLevels (juce::int64 startSampleInFile, juce::int64 numSamples,
+                        juce::Range<float>* results, int numChannelsToRead) override
+    {
+        if (numSamples <= 0)
+        {
+            for (int i = 0; i < numChannelsToRead; ++i)
+                results[i] = {};
+
+            return;
+        }
+
+        if (map == nullptr || ! mappedSection.contains ({ startSampleInFile, startSampleInFile + numSamples }))
+        {
+            jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
+
+            for (int i = 0; i < numChannelsToRead; ++i)
+                results[i] = {};
+
+            return;
+        }
+
+        if (usesFloatingPointData)
+            scanMinAndMax<juce::AudioData::Float32> (startSampleInFile, numSamples, results, numChannelsToRead);
+        else
+            scanMinAndMax<juce::AudioData::Int16> (startSampleInFile, numSamples, results, numChannelsToRead);
+    }
+
+private:
+    template <typename SampleType>
+    void scanMinAndMax (int64_t startSampleInFile, int64_t numSamples, juce::Range<float>* results, int numChannelsToRead) const
+    {
+        typedef juce::AudioData::Pointer<SampleType, juce::AudioData::LittleEndian, juce::AudioData::Interleaved, juce::AudioData::Const> SourceType;
+
+        for (int i = 0; i < numChannelsToRead; ++i)
+            results[i] = SourceType (juce::addBytesToPointer (sampleToPointer (startSampleInFile), (int) (i * bitsPerSample / 8)),
+                                     (int) numChannels).findMinAndMax ((size_t) numSamples);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MemoryMappedDecodedSidecarReader)
+};
+
+//==============================================================================
+DecodedSidecarAudioFormat::DecodedSidecarAudioFormat()  : AudioFormat ("Decoded audio file", ".trkdecoded") {}
+DecodedSidecarAudioFormat::~DecodedSidecarAudioFormat() {}
+
+bool DecodedSidecarAudioFormat::isValidFor (const juce::File& sidecarFile, const juce::File& sourceFile)
+{
+    if (auto fin = sidecarFile.createInputStream())
+    {
+        DecodedSidecarAudioFormatReader reader (fin.release());
+
+        return reader.sampleRate > 0
+            && reader.metadataValues[sourceFileSizeKey].getLargeIntValue() == sourceFile.getSize()
+            && reader.metadataValues[sourceModificationTimeKey].getLargeIntValue() == sourceFile.getLastModificationTime().toMilliseconds();
+    }
+
+    return false;
+}
+
+juce::StringPairArray DecodedSidecarAudioFormat::createMetadataFor (const juce::File& sourceFile)
+{
+    juce::StringPairArray metadata;
+    metadata.set (sourceFileSizeKey, juce::String (sourceFile.getSize()));
+    metadata.set (sourceModificationTimeKey, juce::String (sourceFile.getLastModificationTime().toMilliseconds()));
+
+    return metadata;
+}
+
+juce::Array<int> DecodedSidecarAudioFormat::getPossibleSampleRates()   { return { 8000, 11025, 16000, 22050, 32000, 44100, 48000, 88200, 96000, 176400, 192000 }; }
+juce::Array<int> DecodedSidecarAudioFormat::getPossibleBitDepths()     { return { 16, 32 }; }
+
+bool DecodedSidecarAudioFormat::canDoStereo()    { return true; }
+bool DecodedSidecarAudioFormat::canDoMono()      { return true; }
+
+bool DecodedSidecarAudioFormat::canHandleFile (const juce::File& f)
+{
+    return f.hasFileExtension (".trkdecoded");
+}
+
+juce::AudioFormatReader* DecodedSidecarAudioFormat::createReaderFor (juce::InputStream* in, bool deleteStreamIfOpeningFails)
+{
+    std::unique_ptr<DecodedSidecarAudioFormatReader> r (new DecodedSidecarAudioFormatReader (in));
+
+    if (r->sampleRate > 0)
+        return r.release();
+
+    if (! deleteStreamIfOpeningFails)
+        r->input = nullptr;
+
+    return {};
+}
+
+juce::MemoryMappedAudioFormatReader* DecodedSidecarAudioFormat::createMemoryMappedReader (const juce::File& file)
+{
+    if (auto fin = file.createInputStream())
+    {
+        DecodedSidecarAudioFormatReader reader (fin.release());
+
+        if (reader.sampleRate > 0 && reader.lengthInSamples > 0)
+            return new MemoryMappedDecodedSidecarReader (file, reader);
+    }
+
+    return {};
+}
+
+juce::AudioFormatWriter* DecodedSidecarAudioFormat::createWriterFor (juce::OutputStream* out,
+                                                                     double sampleRate,
+                                                                     unsigned int numChannels,
+                                                                     int bitsPerSample,
+                                                                     const juce::StringPairArray& metadataValues,
+                                                                     int /*qualityOptionIndex*/)
+{
+    return new DecodedSidecarAudioFormatWriter (out, sampleRate, numChannels,
+                                                bitsPerSample <= 16 ? 16 : 32, metadataValues);
+}
+
+}} // namespace tracktion { inline namespace engine
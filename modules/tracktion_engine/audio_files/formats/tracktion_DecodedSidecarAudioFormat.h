@@ -0,0 +1,67 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    A raw format used to store decoded copies of compressed files so they can be
+    memory mapped next time they're opened.
+
+    The samples are interleaved, little-endian 16-bit ints or 32-bit floats and
+    start on a page boundary after a fixed size header. The header also holds
+    the size and modification time of the file that was decoded so a stale copy
+    can be detected. These are passed to the writer and returned by the reader
+    in the metadata, using the sourceFileSizeKey and sourceModificationTimeKey.
+
+    A file is only marked as complete when its writer is deleted so one that was
+    interrupted whilst being written won't be opened.
+*/
+class DecodedSidecarAudioFormat   : public juce::AudioFormat
+{
+public:
+    DecodedSidecarAudioFormat();
+    ~DecodedSidecarAudioFormat() override;
+
+    static constexpr const char* sourceFileSizeKey = "sourceFileSize";
+    static constexpr const char* sourceModificationTimeKey = "sourceModificationTime";
+
+    /** Returns true if the sidecar file is complete and was decoded from the
+        current version of the source file.
+    */
+    static bool isValidFor (const juce::File& sidecarFile, const juce::File& sourceFile);
+
+    /** Returns the metadata to pass to createWriterFor for a source file. */
+    static juce::StringPairArray createMetadataFor (const juce::File& sourceFile);
+
+    //==============================================================================
+    juce::Array<int> getPossibleSampleRates() override;
+    juce::Array<int> getPossibleBitDepths() override;
+    bool canDoStereo() override;
+    bool canDoMono() override;
+    bool canHandleFile (const juce::File&) override;
+
+    //==============================================================================
+    using juce::AudioFormat::createReaderFor;
+    juce::AudioFormatReader* createReaderFor (juce::InputStream*, bool deleteStreamIfOpeningFails) override;
+
+    using juce::AudioFormat::createMemoryMappedReader;
+    juce::MemoryMappedAudioFormatReader* createMemoryMappedReader (const juce::File&) override;
+
+    using juce::AudioFormat::createWriterFor;
+    juce::AudioFormatWriter* createWriterFor (juce::OutputStream*, double sampleRate,
+                                              unsigned int numChannels, int bitsPerSample,
+                                              const juce::StringPairArray& metadataValues,
+                                              int qualityOptionIndex) override;
+};
+
+}} // namespace tracktion { inline namespace engine
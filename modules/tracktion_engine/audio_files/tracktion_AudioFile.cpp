@@ -118,6 +118,8 @@ bool AudioFile::deleteFile() const
 
     bool ok = file.deleteFile();
     jassert (ok);
+
+    PeakFile::getFileFor (*engine, file).deleteFile();
     return ok;
 }
 
@@ -220,6 +222,286 @@ bool AudioFileWriter::writeFromAudioReader (juce::AudioFormatReader& reader,
     return writer != nullptr && writer->writeFromAudioReader (reader, startSample, numSamples);
 }
 
+//==============================================================================
+static juce::File getIncompleteRenderMarker (const AudioFile& proxy)
+{
+    return proxy.getFile().getSiblingFile (proxy.getFile().getFileName() + ".incomplete");
+}
+
+//==============================================================================
+/**
+    Renders a GeneratorJob's proxy in time chunks on several threads.
+
+    The proxy is first written at its full length as silence so the cache can map
+    it and play each chunk as soon as it's been written in to the file. Each chunk
+    is rendered with some pre-roll to settle any stateful processing which is then
+    discarded, and once both sides of a chunk boundary have been rendered, they're
+    crossfaded over a short overlap.
+*/
+class AudioProxyGenerator::ChunkedRender
+{
+public:
+    ChunkedRender (AudioProxyGenerator& g, GeneratorJob& j, const GeneratorJob::ChunkedRenderFormat& f)
+        : generator (g), job (j), format (f),
+          crossfadeLength (roundUp (256, format.chunkAlignment))
+    {
+    }
+
+    bool render()
+    {
+        CRASH_TRACER
+
+        if (format.lengthInSamples <= 0 || format.numChannels <= 0)
+            return false;
+
+        auto& afm = job.proxy.engine->getAudioFileManager();
+        const auto marker = getIncompleteRenderMarker (job.proxy);
+
+        if (! marker.create() || ! writeSilentFile() || ! mapFile())
+            return false;
+
+        // Let playback start using the file whilst the chunks are rendered
+        afm.checkFileForChangesAsync (job.proxy);
+
+        createChunks();
+
+        const int numExtraThreads = generator.claimChunkThreads ((int) std::min<size_t> (chunks.size(), maxNumThreads) - 1);
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < numExtraThreads; ++i)
+            threads.emplace_back ([this] { renderChunks(); });
+
+        renderChunks();
+
+        for (auto& t : threads)
+            t.join();
+
+        generator.releaseChunkThreads (numExtraThreads);
+        mappedFile.reset();
+
+        if (failed || job.shouldExit())
+            return false;
+
+        // Make sure the change is picked up as the mapped writes might not update the time
+        job.proxy.getFile().setLastModificationTime (juce::Time::getCurrentTime());
+        return marker.deleteFile();
+    }
+
+private:
+    struct Boundary
+    {
+        std::mutex mutex;
+        juce::AudioBuffer<float> tail, head;
+        bool hasTail = false, hasHead = false;
+    };
+
+    static constexpr size_t maxNumThreads = 16;
+
+    AudioProxyGenerator& generator;
+    GeneratorJob& job;
+    const GeneratorJob::ChunkedRenderFormat format;
+    const SampleCount crossfadeLength;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    char* sampleData = nullptr;
+    int bytesPerSample = 0;
+    bool isFloat = false;
+
+    std::vector<SampleRange> chunks;
+    std::unique_ptr<Boundary[]> boundaries;
+    std::atomic<size_t> nextChunk { 0 };
+    std::atomic<SampleCount> numSamplesDone { 0 };
+    std::atomic<bool> failed { false };
+
+    static SampleCount roundUp (SampleCount value, int multiple)
+    {
+        return multiple > 1 ? ((value + multiple - 1) / multiple) * multiple : value;
+    }
+
+    bool writeSilentFile()
+    {
+        {
+            AudioFileWriter writer (job.proxy, job.proxy.engine->getAudioFileFormatManager().getWavFormat(),
+                                    format.numChannels, format.sampleRate, format.bitsPerSample,
+                                    format.metadata, 0);
+
+            if (! writer.isOpen())
+                return false;
+
+            juce::AudioBuffer<float> silence (format.numChannels, 65536);
+            silence.clear();
+
+            for (SampleCount pos = 0; pos < format.lengthInSamples; pos += silence.getNumSamples())
+            {
+                if (job.shouldExit())
+                    return false;
+
+                if (! writer.appendBuffer (silence, (int) std::min ((SampleCount) silence.getNumSamples(), format.lengthInSamples - pos)))
+                    return false;
+            }
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (*job.proxy.engine, job.proxy.getFile()));
+
+        if (reader == nullptr || reader->lengthInSamples != format.lengthInSamples)
+            return false;
+
+        bytesPerSample = (int) reader->bitsPerSample / 8;
+        isFloat = reader->usesFloatingPointData;
+
+        return (isFloat && bytesPerSample == 4)
+                || (! isFloat && bytesPerSample >= 2 && bytesPerSample <= 4);
+    }
+
+    bool mapFile()
+    {
+        mappedFile = std::make_unique<juce::MemoryMappedFile> (job.proxy.getFile(), juce::MemoryMappedFile::readWrite);
+        auto data = static_cast<char*> (mappedFile->getData());
+        const auto size = (SampleCount) mappedFile->getSize();
+
+        if (data == nullptr || size < 12
+             || std::memcmp (data, "RIFF", 4) != 0
+             || std::memcmp (data + 8, "WAVE", 4) != 0)
+            return false;
+
+        // Find the data chunk
+        for (SampleCount pos = 12; pos + 8 <= size;)
+        {
+            const auto chunkSize = (SampleCount) juce::ByteOrder::littleEndianInt (data + pos + 4);
+
+            if (std::memcmp (data + pos, "data", 4) == 0)
+            {
+                if (pos + 8 + format.lengthInSamples * format.numChannels * bytesPerSample > size)
+                    return false;
+
+                sampleData = data + pos + 8;
+                return true;
+            }
+
+            pos += 8 + chunkSize + (chunkSize & 1);
+        }
+
+        return false;
+    }
+
+    void createChunks()
+    {
+        // Aim for a couple of chunks per thread but keep them long enough that the pre-roll is a small part
+        const auto minChunkLength = roundUp ((SampleCount) (format.sampleRate * 10.0), format.chunkAlignment);
+        const auto numCpus = (SampleCount) juce::SystemStats::getNumCpus();
+        const auto chunkLength = std::max (minChunkLength,
+                                           roundUp (format.lengthInSamples / std::max ((SampleCount) 1, numCpus * 2), format.chunkAlignment));
+
+        for (SampleCount start = 0; start < format.lengthInSamples; start += chunkLength)
+            chunks.push_back ({ start, std::min (start + chunkLength, format.lengthInSamples) });
+
+        boundaries = std::make_unique<Boundary[]> (chunks.size());
+    }
+
+    void renderChunks()
+    {
+        for (;;)
+        {
+            const auto index = nextChunk.fetch_add (1);
+
+            if (index >= chunks.size() || failed || job.shouldExit())
+                return;
+
+            if (! renderChunk (index))
+            {
+                failed = true;
+                return;
+            }
+        }
+    }
+
+    bool renderChunk (size_t index)
+    {
+        CRASH_TRACER
+        const auto chunk = chunks[index];
+        const bool isLast = index == chunks.size() - 1;
+        const auto tailLength = isLast ? SampleCount() : std::min (crossfadeLength, chunks[index + 1].getLength());
+        const SampleRange renderRange (std::max (SampleCount(), chunk.getStart() - roundUp (format.preRollSamples, format.chunkAlignment)),
+                                       chunk.getEnd() + tailLength);
+
+        juce::AudioBuffer<float> buffer (format.numChannels, (int) renderRange.getLength());
+        buffer.clear();
+
+        if (! job.renderChunk (renderRange, buffer))
+            return false;
+
+        const auto chunkOffset = (int) (chunk.getStart() - renderRange.getStart());
+        writeToFile (buffer, chunkOffset, chunk.getStart(), (int) chunk.getLength());
+
+        if (index > 0)
+            addToBoundary (index, buffer, chunkOffset, false);
+
+        if (! isLast)
+            addToBoundary (index + 1, buffer, chunkOffset + (int) chunk.getLength(), true);
+
+        const auto done = numSamplesDone.fetch_add (chunk.getLength()) + chunk.getLength();
+        job.progress = juce::jlimit (0.0f, 1.0f, (float) (done / (double) format.lengthInSamples));
+
+        return true;
+    }
+
+    /** Stores one side of a boundary and crossfades the two sides once both have been rendered. */
+    void addToBoundary (size_t index, const juce::AudioBuffer<float>& source, int sourceStart, bool isTail)
+    {
+        auto& b = boundaries[index];
+        const auto length = (int) std::min (crossfadeLength, chunks[index].getLength());
+
+        const std::scoped_lock sl (b.mutex);
+        auto& dest = isTail ? b.tail : b.head;
+        dest.setSize (format.numChannels, length);
+
+        for (int i = 0; i < format.numChannels; ++i)
+            dest.copyFrom (i, 0, source, i, sourceStart, length);
+
+        (isTail ? b.hasTail : b.hasHead) = true;
+
+        if (b.hasTail && b.hasHead)
+        {
+            for (int i = 0; i < format.numChannels; ++i)
+            {
+                b.head.applyGainRamp (i, 0, length, 0.0f, 1.0f);
+                b.head.addFromWithRamp (i, 0, b.tail.getReadPointer (i), length, 1.0f, 0.0f);
+            }
+
+            writeToFile (b.head, 0, chunks[index].getStart(), length);
+        }
+    }
+
+    void writeToFile (const juce::AudioBuffer<float>& source, int sourceStart, SampleCount fileStart, int numSamples)
+    {
+        if (isFloat)
+            writeSamples<juce::AudioData::Float32> (source, sourceStart, fileStart, numSamples);
+        else if (bytesPerSample == 2)
+            writeSamples<juce::AudioData::Int16> (source, sourceStart, fileStart, numSamples);
+        else if (bytesPerSample == 3)
+            writeSamples<juce::AudioData::Int24> (source, sourceStart, fileStart, numSamples);
+        else
+            writeSamples<juce::AudioData::Int32> (source, sourceStart, fileStart, numSamples);
+    }
+
+    template <typename DestSampleType>
+    void writeSamples (const juce::AudioBuffer<float>& source, int sourceStart, SampleCount fileStart, int numSamples)
+    {
+        using SourceType = juce::AudioData::Pointer<juce::AudioData::Float32, juce::AudioData::NativeEndian,
+                                                    juce::AudioData::NonInterleaved, juce::AudioData::Const>;
+        using DestType = juce::AudioData::Pointer<DestSampleType, juce::AudioData::LittleEndian,
+                                                  juce::AudioData::Interleaved, juce::AudioData::NonConst>;
+
+        auto frame = sampleData + fileStart * format.numChannels * bytesPerSample;
+
+        for (int i = 0; i < format.numChannels; ++i)
+            DestType (frame + i * bytesPerSample, format.numChannels)
+                .convertSamples (SourceType (source.getReadPointer (i, sourceStart)), numSamples);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChunkedRender)
+};
+
 //==============================================================================
 AudioProxyGenerator::GeneratorJob::GeneratorJob (const AudioFile& p)
     : ThreadPoolJobWithProgress ("proxy"), proxy (p)
@@ -240,10 +522,23 @@ juce::ThreadPoolJob::JobStatus AudioProxyGenerator::GeneratorJob::runJob()
     juce::FloatVectorOperations::disableDenormalisedNumberSupport();
     proxy.deleteFile();
 
-    if (render())
+    bool ok;
+
+    if (auto chunkedFormat = getChunkedRenderFormat())
+        ok = ChunkedRender (afm.proxyGenerator, *this, *chunkedFormat).render();
+    else
+        ok = render();
+
+    if (ok)
+    {
         afm.checkFileForChangesAsync (proxy);
+    }
     else
+    {
+        afm.releaseFile (proxy);
         proxy.deleteFile();
+        getIncompleteRenderMarker (proxy).deleteFile();
+    }
 
     progress = 1.0f;
 
@@ -274,10 +569,12 @@ static bool checkProxyStatus (const AudioFile& f)
 {
     if (f.getFile().existsAsFile())
     {
-        if (f.isValid())
+        // A chunked render that didn't finish will have left silent sections
+        if (f.isValid() && ! AudioProxyGenerator::hasIncompleteRender (f))
             return true;
 
         f.deleteFile();
+        getIncompleteRenderMarker (f).deleteFile();
     }
 
     return false;
@@ -288,18 +585,42 @@ void AudioProxyGenerator::beginJob (GeneratorJob* j)
     CRASH_TRACER
     std::unique_ptr<GeneratorJob> job (j);
 
-    if (! checkProxyStatus (job->proxy))
+    // Check for a running job first as a chunked render's file exists before it's complete
+    const juce::ScopedLock sl (jobListLock);
+
+    if (findJob (job->proxy) == nullptr
+         && ! checkProxyStatus (job->proxy))
     {
-        const juce::ScopedLock sl (jobListLock);
+        job->proxy.engine->getBackgroundJobs().addJob (j, true);
+        activeJobs.add (job.release());
+    }
+}
 
-        if (findJob (job->proxy) == nullptr)
-        {
-            job->proxy.engine->getBackgroundJobs().addJob (j, true);
-            activeJobs.add (job.release());
-        }
+bool AudioProxyGenerator::hasIncompleteRender (const AudioFile& proxyFile)
+{
+    return getIncompleteRenderMarker (proxyFile).existsAsFile();
+}
+
+int AudioProxyGenerator::claimChunkThreads (int numWanted) noexcept
+{
+    const int maxNumThreads = std::max (1, juce::SystemStats::getNumCpus() - 1);
+    auto numInUse = numChunkThreadsInUse.load();
+
+    for (;;)
+    {
+        const auto numToClaim = std::max (0, std::min (numWanted, maxNumThreads - numInUse));
+
+        if (numToClaim == 0 || numChunkThreadsInUse.compare_exchange_weak (numInUse, numInUse + numToClaim))
+            return numToClaim;
     }
 }
 
+void AudioProxyGenerator::releaseChunkThreads (int num) noexcept
+{
+    numChunkThreadsInUse -= num;
+    jassert (numChunkThreadsInUse >= 0);
+}
+
 bool AudioProxyGenerator::isProxyBeingGenerated (const AudioFile& proxyFile) const noexcept
 {
     const juce::ScopedLock sl (jobListLock);
@@ -336,6 +657,7 @@ void AudioProxyGenerator::deleteProxy (const AudioFile& proxyFile)
         proxyFile.engine->getBackgroundJobs().removeJob (j, true, 10000);
 
     proxyFile.deleteFile();
+    getIncompleteRenderMarker (proxyFile).deleteFile();
 }
 
 
@@ -360,7 +682,8 @@ AudioFileInfo::AudioFileInfo (const AudioFile& file, juce::AudioFormatReader* re
         isFloatingPoint = reader->usesFloatingPointData;
         needsCachedProxy = dynamic_cast<juce::WavAudioFormat*> (format) == nullptr
                               && dynamic_cast<juce::AiffAudioFormat*> (format) == nullptr
-                              && dynamic_cast<FloatAudioFormat*> (format) == nullptr;
+                              && dynamic_cast<FloatAudioFormat*> (format) == nullptr
+                              && dynamic_cast<DecodedSidecarAudioFormat*> (format) == nullptr;
         metadata = reader->metadataValues;
     }
     else
@@ -562,6 +885,14 @@ void SmartThumbnail::drawChannels (juce::Graphics& g, juce::Rectangle<int> r,
                              verticalZoomFactor);
 }
 
+bool SmartThumbnail::getPeaks (TimeRange time, int channelNum, std::span<PeakFile::Peak> dest) const
+{
+    if (peaks == nullptr || ! peaks->isComplete())
+        return false;
+
+    return peaks->getPeaks (toSamples (time, peaks->getSampleRate()), channelNum, dest);
+}
+
 double SmartThumbnail::getProportionComplete() const noexcept
 {
     if (auto sampleRate = file.getSampleRate(); sampleRate > 0)
@@ -601,6 +932,9 @@ void SmartThumbnail::createThumbnailReader()
 
         setReader (AudioFileUtils::createReaderFor (engine, file.getFile()), hashCode);
         thumbnailIsInvalid = false;
+
+        if (engine.getUIBehaviour().shouldCreatePeakFiles())
+            peaks = PeakFile::loadOrBuild (engine, file.getFile());
     }
     else
     {
@@ -631,6 +965,7 @@ void SmartThumbnail::audioFileChanged()
 void SmartThumbnail::clear()
 {
     thumbnail->clear();
+    peaks.reset();
 }
 
 bool SmartThumbnail::setSource (juce::InputSource* source)
@@ -707,6 +1042,16 @@ float SmartThumbnail::getApproximatePeak() const
 void SmartThumbnail::getApproximateMinMax (double startTime, double endTime, int channelIndex,
                                            float& minValue, float& maxValue) const noexcept
 {
+    if (peaks != nullptr && peaks->isComplete())
+    {
+        const auto sampleRate = peaks->getSampleRate();
+        auto peak = peaks->getPeak ({ (SampleCount) (startTime * sampleRate), (SampleCount) (endTime * sampleRate) },
+                                    channelIndex);
+        minValue = peak.min;
+        maxValue = peak.max;
+        return;
+    }
+
     thumbnail->getApproximateMinMax (startTime, endTime, channelIndex,
                                      minValue, maxValue);
 }
@@ -26,6 +26,7 @@ public:
     void runTest() override
     {
         runFileInfoTest();
+        runChunkedProxyTest();
     }
 
 private:
@@ -80,6 +81,76 @@ private:
             expectEquals (info.getLengthInSeconds(), 1.0);
         }
     }
+
+    void runChunkedProxyTest()
+    {
+        // Render a sine that depends only on the sample position so the chunks
+        // and their crossfades should match a continuous render
+        struct SineJob  : public AudioProxyGenerator::GeneratorJob
+        {
+            using GeneratorJob::GeneratorJob;
+
+            static float getSample (SampleCount pos)
+            {
+                return 0.5f * (float) std::sin (juce::MathConstants<double>::twoPi * 440.0 * (double) pos / sampleRate);
+            }
+
+            bool render() override  { return false; }
+
+            std::optional<ChunkedRenderFormat> getChunkedRenderFormat() override
+            {
+                ChunkedRenderFormat f;
+                f.sampleRate = sampleRate;
+                f.numChannels = 2;
+                f.bitsPerSample = 32;
+                f.lengthInSamples = (SampleCount) (sampleRate * 45.0);
+                f.preRollSamples = 1024;
+                f.chunkAlignment = 1024;
+                return f;
+            }
+
+            bool renderChunk (SampleRange range, juce::AudioBuffer<float>& dest) override
+            {
+                for (int i = 0; i < dest.getNumSamples(); ++i)
+                    for (int c = 0; c < dest.getNumChannels(); ++c)
+                        dest.setSample (c, i, getSample (range.getStart() + i));
+
+                return true;
+            }
+
+            static constexpr double sampleRate = 44100.0;
+        };
+
+        auto& engine = *Engine::getEngines().getFirst();
+        juce::TemporaryFile tempFile (".wav");
+        const AudioFile proxy (engine, tempFile.getFile());
+
+        {
+            SineJob job (proxy);
+            job.runJob();
+        }
+
+        beginTest ("Render a proxy in chunks");
+        expect (! AudioProxyGenerator::hasIncompleteRender (proxy));
+
+        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, tempFile.getFile()));
+        expect (reader != nullptr);
+
+        if (reader != nullptr)
+        {
+            expectEquals (reader->lengthInSamples, (juce::int64) (SineJob::sampleRate * 45.0));
+
+            juce::AudioBuffer<float> buffer (2, (int) reader->lengthInSamples);
+            reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+
+            float maxError = 0.0f;
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                maxError = std::max (maxError, std::abs (buffer.getSample (1, i) - SineJob::getSample (i)));
+
+            expectLessThan (maxError, 1.0e-5f);
+        }
+    }
 };
 
 static AudioFileTests audioFileTests;
@@ -28,6 +28,177 @@ static void clearSetOfChannels (int* const* channels, int numChannels, int offse
             juce::FloatVectorOperations::clear (chan + offset, numSamples);
 }
 
+//==============================================================================
+/** The layouts of mapped data that can be converted directly to floats. */
+enum class InterleavedEncoding
+{
+    unknown,
+    int16,
+    int24,
+    int32,
+    float32
+};
+
+/** Returns the layout of a format's mapped data if it's interleaved little-endian frames. */
+static InterleavedEncoding getInterleavedEncoding (juce::AudioFormat* format, const juce::AudioFormatReader& reader)
+{
+   #if JUCE_LITTLE_ENDIAN
+    if (dynamic_cast<juce::WavAudioFormat*> (format) == nullptr
+         && dynamic_cast<DecodedSidecarAudioFormat*> (format) == nullptr)
+        return InterleavedEncoding::unknown;
+
+    if (reader.usesFloatingPointData)
+        return reader.bitsPerSample == 32 ? InterleavedEncoding::float32
+                                          : InterleavedEncoding::unknown;
+
+    switch (reader.bitsPerSample)
+    {
+        case 16:    return InterleavedEncoding::int16;
+        case 24:    return InterleavedEncoding::int24;
+        case 32:    return InterleavedEncoding::int32;
+        default:    return InterleavedEncoding::unknown;
+    }
+   #else
+    juce::ignoreUnused (format, reader);
+    return InterleavedEncoding::unknown;
+   #endif
+}
+
+/** Gives access to the start of a frame in a MemoryMappedAudioFormatReader's mapped section. */
+struct MappedFrameAccess  : public juce::MemoryMappedAudioFormatReader
+{
+    static const void* getFrame (const juce::MemoryMappedAudioFormatReader& r, SampleCount frame) noexcept
+    {
+        jassert (r.getMappedSection().contains (frame));
+        return (r.*(&MappedFrameAccess::sampleToPointer)) (frame);
+    }
+};
+
+// These are kept as simple strided loops with the scale folded in so the compiler
+// can vectorise them and each destination channel is written in a single pass
+template <typename SourceType>
+static void convertInterleavedChannel (float* dest, const SourceType* source, int stride,
+                                       int numFrames, float scale) noexcept
+{
+    for (int i = 0; i < numFrames; ++i)
+        dest[i] = static_cast<float> (source[i * stride]) * scale;
+}
+
+static void convertInterleaved24BitChannel (float* dest, const uint8_t* source, int strideBytes,
+                                            int numFrames, float scale) noexcept
+{
+    for (int i = 0; i < numFrames; ++i)
+    {
+        auto s = source + i * strideBytes;
+        dest[i] = static_cast<float> (static_cast<int32_t> ((uint32_t) s[0] << 8
+                                                             | (uint32_t) s[1] << 16
+                                                             | (uint32_t) s[2] << 24)) * scale;
+    }
+}
+
+static void convertInterleavedFrames (InterleavedEncoding encoding, const void* sourceFrames, int numSourceChannels,
+                                      choc::buffer::ChannelArrayView<float> dest,
+                                      std::span<const int> sourceChannelForDestChannel, float gain) noexcept
+{
+    const auto numFrames = (int) dest.getNumFrames();
+    const float intScale = gain / (float) 0x7fffffff;
+
+    for (choc::buffer::ChannelCount i = 0; i < dest.getNumChannels(); ++i)
+    {
+        auto destData = dest.getChannel (i).data.data;
+        const auto sourceChannel = i < sourceChannelForDestChannel.size() ? sourceChannelForDestChannel[i] : -1;
+
+        if (! juce::isPositiveAndBelow (sourceChannel, numSourceChannels))
+        {
+            juce::FloatVectorOperations::clear (destData, numFrames);
+            continue;
+        }
+
+        switch (encoding)
+        {
+            case InterleavedEncoding::int16:
+                convertInterleavedChannel (destData, static_cast<const int16_t*> (sourceFrames) + sourceChannel,
+                                           numSourceChannels, numFrames, intScale * 65536.0f);
+                break;
+
+            case InterleavedEncoding::int24:
+                convertInterleaved24BitChannel (destData, static_cast<const uint8_t*> (sourceFrames) + sourceChannel * 3,
+                                                numSourceChannels * 3, numFrames, intScale);
+                break;
+
+            case InterleavedEncoding::int32:
+                convertInterleavedChannel (destData, static_cast<const int32_t*> (sourceFrames) + sourceChannel,
+                                           numSourceChannels, numFrames, intScale);
+                break;
+
+            case InterleavedEncoding::float32:
+                convertInterleavedChannel (destData, static_cast<const float*> (sourceFrames) + sourceChannel,
+                                           numSourceChannels, numFrames, gain);
+                break;
+
+            case InterleavedEncoding::unknown:
+            default:
+                jassertfalse;
+                juce::FloatVectorOperations::clear (destData, numFrames);
+                break;
+        }
+    }
+}
+
+/** Reads from a function that fills int channels in the same way as AudioFormatReader::readSamples
+    and remaps, converts and applies gain to the result in place in the destination.
+*/
+template <typename ReadFunction>
+static bool readAndRemapChannels (choc::buffer::ChannelArrayView<float> dest,
+                                  std::span<const int> sourceChannelForDestChannel,
+                                  int numSourceChannels, bool isFloatingPoint, float gain,
+                                  ReadFunction&& readInto)
+{
+    static constexpr int maxNumChannels = 32;
+    int* chans[maxNumChannels] = {};
+    int numChansToRead = 0;
+    const auto numFrames = (int) dest.getNumFrames();
+    numSourceChannels = std::min (numSourceChannels, maxNumChannels);
+
+    // Each source channel is read in to the first destination that uses it
+    for (choc::buffer::ChannelCount i = 0; i < dest.getNumChannels(); ++i)
+    {
+        const auto sourceChannel = i < sourceChannelForDestChannel.size() ? sourceChannelForDestChannel[i] : -1;
+
+        if (juce::isPositiveAndBelow (sourceChannel, numSourceChannels) && chans[sourceChannel] == nullptr)
+        {
+            chans[sourceChannel] = reinterpret_cast<int*> (dest.getChannel (i).data.data);
+            numChansToRead = std::max (numChansToRead, sourceChannel + 1);
+        }
+    }
+
+    const bool ok = numChansToRead == 0 || readInto (chans, numChansToRead);
+
+    for (int i = 0; i < numChansToRead; ++i)
+    {
+        if (auto chan = reinterpret_cast<float*> (chans[i]))
+        {
+            if (! isFloatingPoint)
+                juce::FloatVectorOperations::convertFixedToFloat (chan, chans[i], gain / (float) 0x7fffffff, numFrames);
+            else if (gain != 1.0f)
+                juce::FloatVectorOperations::multiply (chan, gain, numFrames);
+        }
+    }
+
+    for (choc::buffer::ChannelCount i = 0; i < dest.getNumChannels(); ++i)
+    {
+        auto destData = dest.getChannel (i).data.data;
+        const auto sourceChannel = i < sourceChannelForDestChannel.size() ? sourceChannelForDestChannel[i] : -1;
+
+        if (! juce::isPositiveAndBelow (sourceChannel, numSourceChannels))
+            juce::FloatVectorOperations::clear (destData, numFrames);
+        else if (auto source = reinterpret_cast<const float*> (chans[sourceChannel]); source != destData)
+            juce::FloatVectorOperations::copy (destData, source, numFrames);
+    }
+
+    return ok;
+}
+
 //==============================================================================
 //==============================================================================
 struct AudioFileCache::ScopedFileRead
@@ -58,6 +229,27 @@ struct AudioFileCache::ScopedFileRead
     const double startTimeMs { juce::Time::getMillisecondCounterHiRes() };
 };
 
+//==============================================================================
+/**
+    Where a Reader publishes where it's reading from so the RefresherThread can
+    work out what to pre-fetch without locking the client list.
+
+    Slots are owned by the CachedFile and are claimed by a Reader when it's added
+    as a client and released when the client is purged.
+*/
+struct AudioFileCache::PrefetchSlot
+{
+    std::atomic<bool> isInUse { false };
+    std::atomic<uint32_t> generation { 0 };
+    std::atomic<SampleCount> readPos { 0 }, loopStart { 0 }, loopLength { 0 };
+    std::atomic<int> samplesPerRead { 0 };
+    std::atomic<float> speedRatio { 1.0f };
+
+    // Only accessed by the RefresherThread
+    uint32_t lastGenerationPrefetched = 0;
+    SampleRange prefetched, prefetchedAfterLoop;
+};
+
 
 //==============================================================================
 //==============================================================================
@@ -73,55 +265,123 @@ public:
             mapEntireFile = true;
     }
 
-    enum { readAheadSamples = 48000 };
+    ~CachedFile()
+    {
+        // If the cache is deleted whilst Readers are still held, they mustn't publish to the slots
+        for (auto r : clients)
+            r->prefetchSlot.store (nullptr, std::memory_order_release);
+    }
+
+    enum
+    {
+        readAheadSamples = 48000,
+        minReadAheadSamples = 4096,
+        maxReadAheadSamples = readAheadSamples * 4,
+        minBlocksToReadAhead = 8
+    };
+
+    static constexpr double readAheadSeconds = 0.1;
+
+    /** Returns the region a client will read next and, if that crosses the end of
+        its loop, the region after the loop start.
+    */
+    std::pair<SampleRange, SampleRange> getRegionsToPrefetch (const PrefetchSlot& slot) const
+    {
+        const auto readPos = slot.readPos.load (std::memory_order_acquire);
+        const auto loopStart = slot.loopStart.load (std::memory_order_relaxed);
+        const auto loopLength = slot.loopLength.load (std::memory_order_relaxed);
+
+        // Size the region by how far the reader will get before the next pass
+        const auto speed = std::abs ((double) slot.speedRatio.load (std::memory_order_relaxed));
+        const auto numForTime = (SampleCount) std::ceil (speed * info.sampleRate * readAheadSeconds);
+        const auto numForBlocks = (SampleCount) slot.samplesPerRead.load (std::memory_order_relaxed) * minBlocksToReadAhead;
+        const auto numToReadAhead = std::clamp (std::max (numForTime, numForBlocks),
+                                                (SampleCount) minReadAheadSamples, (SampleCount) maxReadAheadSamples);
+
+        if (readPos + numToReadAhead <= 0)
+            return {};
+
+        const SampleRange region (std::max (SampleCount(), readPos), readPos + numToReadAhead);
 
-    void touchFiles()
+        if (loopLength <= 0)
+            return { region, {} };
+
+        const auto loopEnd = loopStart + loopLength;
+
+        if (region.getEnd() <= loopEnd)
+            return { region, {} };
+
+        return { region.withEnd (loopEnd),
+                 SampleRange::withStartAndLength (loopStart, std::min (region.getEnd() - loopEnd, loopLength)) };
+    }
+
+    /** Touches the pages that the clients are about to read.
+        Only the parts of each region that weren't touched on the last pass are
+        touched, so a reader moving forwards only costs the pages it's moved on by.
+    */
+    void prefetch()
     {
-        juce::Array<SampleCount> readPoints;
-        readPoints.ensureStorageAllocated (64);
+        // Don't hold up the MapperThread, this will catch up on the next pass
+        if (! readerLock.tryEnterRead())
+            return;
+
+        // If the file has been re-mapped, everything needs touching again
+        const bool readersChanged = readerGeneration != lastReaderGenerationPrefetched;
+        lastReaderGenerationPrefetched = readerGeneration;
 
+        forEachPrefetchSlot ([this, readersChanged] (PrefetchSlot& slot)
         {
-            const juce::ScopedReadLock sl (clientListLock);
+            if (! slot.isInUse.load (std::memory_order_acquire))
+                return;
 
-            for (auto r : clients)
+            if (const auto generation = slot.generation.load (std::memory_order_acquire);
+                readersChanged || generation != slot.lastGenerationPrefetched)
             {
-                const auto readPos = r->readPos.load();
-                const auto loopLength = r->loopLength.load();
+                slot.lastGenerationPrefetched = generation;
+                slot.prefetched = {};
+                slot.prefetchedAfterLoop = {};
+            }
 
-                if (r->getReferenceCount() > 1 && readPos > -readAheadSamples)
-                {
-                    if (loopLength > 0)
-                        if (readPos + readAheadSamples > r->loopStart + loopLength)
-                            readPoints.addIfNotAlreadyThere (r->loopStart);
+            auto [region, regionAfterLoop] = getRegionsToPrefetch (slot);
 
-                    readPoints.addIfNotAlreadyThere (std::max (SampleCount(), readPos));
-                }
-            }
-        }
+            // The reader has wrapped round to the start of the loop
+            if (slot.prefetchedAfterLoop.contains (region.getStart()))
+                std::swap (slot.prefetched, slot.prefetchedAfterLoop);
+
+            prefetchRegion (region, slot.prefetched);
+            prefetchRegion (regionAfterLoop, slot.prefetchedAfterLoop);
+        });
+
+        readerLock.exitRead();
+    }
 
-        const juce::ScopedReadLock sl (readerLock);
+    void prefetchRegion (SampleRange region, SampleRange& alreadyPrefetched) const
+    {
+        auto rangeToTouch = region;
 
-        for (auto pos : readPoints)
-            touchAllReaders ({ pos, pos + 128 });
+        if (alreadyPrefetched.contains (region.getStart()) || alreadyPrefetched.getEnd() == region.getStart())
+            rangeToTouch = rangeToTouch.withStart (std::min (region.getEnd(), alreadyPrefetched.getEnd()));
 
-        for (auto pos : readPoints)
-            touchAllReaders ({ pos + 128, pos + 4096 });
+        alreadyPrefetched = region;
 
-        for (int distanceAhead = 4096; distanceAhead < 48000; distanceAhead += 8192)
-            for (auto pos : readPoints)
-                touchAllReaders ({ pos + distanceAhead, pos + distanceAhead + 8192 });
+        if (! rangeToTouch.isEmpty())
+            touchAllReaders (rangeToTouch);
     }
 
     void touchAllReaders (SampleRange range) const
     {
+        // One sample per page is enough to get it read in
+        const auto bytesPerFrame = std::max (1, info.numChannels * info.bitsPerSample / 8);
+        const auto samplesPerPage = std::max (1, 4096 / bytesPerFrame);
+
         for (auto* r : readers)
         {
             if (r != nullptr)
             {
                 auto section = r->getMappedSection();
-                range = range.getIntersectionWith (SampleRange (section.getStart(), section.getEnd()));
+                auto rangeInSection = range.getIntersectionWith (SampleRange (section.getStart(), section.getEnd()));
 
-                for (auto i = range.getStart(); i < range.getEnd(); i += 64)
+                for (auto i = rangeInSection.getStart(); i < rangeInSection.getEnd(); i += samplesPerPage)
                     r->touchSample (i);
             }
         }
@@ -152,6 +412,7 @@ public:
                 if (auto r = createNewReader (nullptr))
                 {
                     readers.add (r);
+                    ++readerGeneration;
                 }
                 else
                 {
@@ -169,43 +430,32 @@ public:
         auto lastPossibleBlockIndex = (int) ((info.lengthInSamples - 1) / blockSize);
         juce::Array<int> blocksNeeded;
 
+        forEachPrefetchSlot ([&] (const PrefetchSlot& slot)
         {
-            const juce::ScopedReadLock sl (clientListLock);
+            if (! slot.isInUse.load (std::memory_order_acquire))
+                return;
 
-            for (auto r : clients)
+            auto [region, regionAfterLoop] = getRegionsToPrefetch (slot);
+
+            for (auto r : { region.withStart (std::max (SampleCount(), region.getStart() - 256)), regionAfterLoop })
             {
-                if (r->getReferenceCount() <= 1)
-                {
-                    needToPurgeUnusedClients = true;
-                }
-                else
-                {
-                    const auto readPos = r->readPos.load();
-                    const auto loopStart = r->loopStart.load();
-                    const auto loopLength = r->loopLength.load();
+                if (r.isEmpty())
+                    continue;
 
-                    if (loopLength > 0)
-                    {
-                        auto loopEnd = loopStart + loopLength;
-                        auto start = std::max (0, (int) (std::max (loopStart, readPos - 256) / blockSize));
-                        auto end   = std::min (lastPossibleBlockIndex, (int) (std::min (loopEnd, readPos + readAheadSamples) / blockSize));
+                auto start = std::max (0, (int) (r.getStart() / blockSize));
+                auto end   = std::min (lastPossibleBlockIndex, (int) ((r.getEnd() - 1) / blockSize));
 
-                        for (int i = start; i <= end; ++i)
-                            blocksNeeded.addIfNotAlreadyThere (i);
+                for (int i = start; i <= end; ++i)
+                    blocksNeeded.addIfNotAlreadyThere (i);
+            }
+        });
 
-                        if (readPos + readAheadSamples > loopEnd)
-                            blocksNeeded.addIfNotAlreadyThere ((int) (loopStart / blockSize));
-                    }
-                    else
-                    {
-                        auto start = std::max (0, (int) ((readPos - 256) / blockSize));
-                        auto end   = std::min (lastPossibleBlockIndex, (int) ((readPos + readAheadSamples) / blockSize));
+        {
+            const juce::ScopedReadLock sl (clientListLock);
 
-                        for (int i = start; i <= end; ++i)
-                            blocksNeeded.addIfNotAlreadyThere (i);
-                    }
-                }
-            }
+            for (auto r : clients)
+                if (r->getReferenceCount() <= 1)
+                    needToPurgeUnusedClients = true;
         }
 
         if (blocksNeeded != currentBlocks)
@@ -245,6 +495,7 @@ public:
                 const juce::ScopedWriteLock sl (readerLock);
                 newReaders.swapWith (readers);
                 currentBlocks.swapWith (blocksNeeded);
+                ++readerGeneration;
 
                 jassert (readers.size() == currentBlocks.size());
             }
@@ -257,13 +508,7 @@ public:
         }
 
         if (needToPurgeUnusedClients)
-        {
-            const juce::ScopedWriteLock sl (clientListLock);
-
-            for (int i = clients.size(); --i >= 0;)
-                if (clients.getObjectPointerUnchecked(i)->getReferenceCount() <= 1)
-                    clients.remove (i);
-        }
+            purgeOrphanReaders();
 
         return anythingChanged;
     }
@@ -290,6 +535,7 @@ public:
             failedToOpenFile = false;
 
             info = AudioFileInfo (file, r.get(), af);
+            encoding.store (getInterleavedEncoding (af, *r), std::memory_order_release);
             return r.release();
         }
 
@@ -301,8 +547,17 @@ public:
         const juce::ScopedWriteLock sl (clientListLock);
 
         for (int i = clients.size(); --i >= 0;)
-            if (clients.getObjectPointerUnchecked (i)->getReferenceCount() <= 1)
+        {
+            auto r = clients.getObjectPointerUnchecked (i);
+
+            if (r->getReferenceCount() <= 1)
+            {
+                if (auto slot = r->prefetchSlot.exchange (nullptr, std::memory_order_acq_rel))
+                    slot->isInUse.store (false, std::memory_order_release);
+
                 clients.remove (i);
+            }
+        }
     }
 
     bool isUnused() const
@@ -317,6 +572,7 @@ public:
         const juce::ScopedWriteLock sl (readerLock);
         readers.clear();
         currentBlocks.clear();
+        ++readerGeneration;
     }
 
     void validateFile()
@@ -429,6 +685,62 @@ public:
         return allDataRead;
     }
 
+    bool read (SampleCount startSample, choc::buffer::ChannelArrayView<float> dest,
+               std::span<const int> sourceChannelForDestChannel, float gain, int timeoutMs)
+    {
+        jassert (startSample >= 0);
+
+        bool allDataRead = true;
+        const auto numSourceChannels = info.numChannels;
+        const auto localEncoding = encoding.load (std::memory_order_acquire);
+
+        while (dest.getNumFrames() > 0)
+        {
+            if (startSample >= info.lengthInSamples)
+            {
+                dest.clear();
+                break;
+            }
+
+            const LockedReaderFinder l (*this, startSample, timeoutMs);
+            SCOPED_REALTIME_CHECK
+
+            if (l.isLocked && l.reader != nullptr)
+            {
+                const auto numThisTime = (choc::buffer::FrameCount) std::min<int64_t> (dest.getNumFrames(),
+                                                                                        l.reader->getMappedSection().getEnd() - startSample);
+                auto section = dest.getStart (numThisTime);
+
+                if (localEncoding != InterleavedEncoding::unknown)
+                {
+                    convertInterleavedFrames (localEncoding, MappedFrameAccess::getFrame (*l.reader, startSample),
+                                              numSourceChannels, section, sourceChannelForDestChannel, gain);
+                }
+                else
+                {
+                    readAndRemapChannels (section, sourceChannelForDestChannel, numSourceChannels, info.isFloatingPoint, gain,
+                                          [&] (int* const* chans, int numChans)
+                                          {
+                                              return l.reader->readSamples (chans, numChans, 0, startSample, (int) numThisTime);
+                                          });
+                }
+
+                startSample += numThisTime;
+                dest = dest.fromFrame (numThisTime);
+            }
+            else
+            {
+                allDataRead = false;
+                dest.clear();
+                DBG ("*** Cache miss");
+                break;
+            }
+        }
+
+        lastReadTime = juce::Time::getApproximateMillisecondCounter();
+        return allDataRead;
+    }
+
     bool getRange (SampleCount startSample, int numSamples,
                    float& lmax, float& lmin, float& rmax, float& rmin,
                    const int timeoutMs)
@@ -478,8 +790,21 @@ public:
         return allDataRead;
     }
 
+    /** Adds a client and gives it a PrefetchSlot.
+        This must be called with the cache's fileListLock held for writing so only
+        one thread adds slots at a time.
+    */
     void addClient (Reader* r)
     {
+        auto& slot = claimPrefetchSlot();
+        slot.readPos.store (r->readPos.load());
+        slot.loopStart.store (r->loopStart.load());
+        slot.loopLength.store (r->loopLength.load());
+        slot.samplesPerRead.store (0);
+        slot.speedRatio.store (1.0f);
+        slot.generation.fetch_add (1, std::memory_order_release);
+        r->prefetchSlot.store (&slot, std::memory_order_release);
+
         juce::ScopedWriteLock sl (clientListLock);
         clients.add (r);
     }
@@ -493,10 +818,23 @@ public:
 
 private:
     juce::OwnedArray<juce::MemoryMappedAudioFormatReader> readers;
+    std::atomic<InterleavedEncoding> encoding { InterleavedEncoding::unknown };
     juce::ReferenceCountedArray<Reader> clients;
 
+    // Blocks of slots are only ever added so the slots can be walked without locking
+    struct PrefetchSlotBlock
+    {
+        std::array<PrefetchSlot, 16> slots;
+        std::atomic<PrefetchSlotBlock*> next { nullptr };
+    };
+
+    std::vector<std::unique_ptr<PrefetchSlotBlock>> prefetchSlotBlocks;
+    std::atomic<PrefetchSlotBlock*> firstPrefetchSlotBlock { nullptr };
+
     juce::CriticalSection blockUpdateLock;
     juce::Array<int> currentBlocks;
+    uint32_t readerGeneration = 0; // Only changed with the readerLock held for writing
+    uint32_t lastReaderGenerationPrefetched = 0;
 
     bool mapEntireFile = false;
     std::atomic<bool> failedToOpenFile { false };
@@ -505,6 +843,41 @@ private:
 
     juce::ReadWriteLock clientListLock, readerLock;
 
+    template<typename Fn>
+    void forEachPrefetchSlot (Fn&& fn)
+    {
+        for (auto block = firstPrefetchSlotBlock.load (std::memory_order_acquire); block != nullptr;
+             block = block->next.load (std::memory_order_acquire))
+            for (auto& slot : block->slots)
+                fn (slot);
+    }
+
+    PrefetchSlot& claimPrefetchSlot()
+    {
+        for (auto& block : prefetchSlotBlocks)
+        {
+            for (auto& slot : block->slots)
+            {
+                bool expected = false;
+
+                if (slot.isInUse.compare_exchange_strong (expected, true, std::memory_order_acq_rel))
+                    return slot;
+            }
+        }
+
+        auto newBlock = std::make_unique<PrefetchSlotBlock>();
+        auto& slot = newBlock->slots[0];
+        slot.isInUse.store (true, std::memory_order_relaxed);
+
+        if (prefetchSlotBlocks.empty())
+            firstPrefetchSlotBlock.store (newBlock.get(), std::memory_order_release);
+        else
+            prefetchSlotBlocks.back()->next.store (newBlock.get(), std::memory_order_release);
+
+        prefetchSlotBlocks.push_back (std::move (newBlock));
+        return slot;
+    }
+
     juce::MemoryMappedAudioFormatReader* findReaderFor (SampleCount sample) const
     {
         for (auto r : readers)
@@ -589,19 +962,26 @@ public:
 };
 
 //==============================================================================
-AudioFileCache::AudioFileCache (Engine& e)  : engine (e)
+AudioFileCache::AudioFileCache (Engine& e)
+    : engine (e)
 {
     CRASH_TRACER
     const int defaultSize = 6 * 48000;
 
     // TODO: when we drop 32-bit support, delete the cache size and related code
     setCacheSizeSamples (static_cast<juce::int64> (engine.getPropertyStorage().getProperty (SettingID::cacheSizeSamples, defaultSize)));
+
+    decodedBlockCache = std::make_unique<DecodedBlockCache> (engine);
+    decodedBlockCache->setMaxBytes (static_cast<int64_t> (getDecodedCacheSizeMb()) * 1024 * 1024);
+
+    decodedSidecarsEnabled = static_cast<bool> (engine.getPropertyStorage().getProperty (SettingID::decodedSidecars, true));
 }
 
 AudioFileCache::~AudioFileCache()
 {
     CRASH_TRACER
     stopThreads();
+    decodedBlockCache.reset();
     purgeOrphanReaders();
     jassert (activeFiles.isEmpty());
     activeFiles.clear();
@@ -649,6 +1029,47 @@ void AudioFileCache::setCacheSizeSamples (SampleCount samples)
     }
 }
 
+void AudioFileCache::setDecodedCacheSizeMb (int sizeMb)
+{
+    sizeMb = juce::jlimit (64, 64 * 1024, sizeMb);
+    engine.getPropertyStorage().setProperty (SettingID::decodedCacheSizeMb, sizeMb);
+    decodedBlockCache->setMaxBytes (static_cast<int64_t> (sizeMb) * 1024 * 1024);
+}
+
+int AudioFileCache::getDecodedCacheSizeMb() const
+{
+    return static_cast<int> (engine.getPropertyStorage().getProperty (SettingID::decodedCacheSizeMb, 512));
+}
+
+int64_t AudioFileCache::getDecodedBytesInUse() const
+{
+    return decodedBlockCache->getBytesInUse();
+}
+
+void AudioFileCache::setDecodedSidecarsEnabled (bool shouldBeEnabled)
+{
+    decodedSidecarsEnabled = shouldBeEnabled;
+    engine.getPropertyStorage().setProperty (SettingID::decodedSidecars, shouldBeEnabled);
+}
+
+juce::File AudioFileCache::getDecodedSidecarFile (const AudioFile& f) const
+{
+    // The modification time is part of the name so an edited source gets a new file
+    // rather than one that AudioFileManager might have stale info for
+    return engine.getTemporaryFileManager().getTempDirectory()
+             .getChildFile ("decoded")
+             .getChildFile (f.getHashString() + "_"
+                             + juce::String::toHexString (f.getFile().getLastModificationTime().toMilliseconds())
+                             + ".trkdecoded");
+}
+
+bool AudioFileCache::hasDecodedSidecar (const AudioFile& f) const
+{
+    return decodedSidecarsEnabled
+        && ! f.isNull()
+        && DecodedSidecarAudioFormat::isValidFor (getDecodedSidecarFile (f), f.getFile());
+}
+
 //==============================================================================
 AudioFileCache::CachedFile* AudioFileCache::getOrCreateCachedFile (const AudioFile& f)
 {
@@ -671,6 +1092,29 @@ AudioFileCache::CachedFile* AudioFileCache::getOrCreateCachedFile (const AudioFi
     return {};
 }
 
+AudioFileCache::DecodedSidecar AudioFileCache::findDecodedSidecar (const AudioFile& f) const
+{
+    if (! decodedSidecarsEnabled || f.isNull() || ! f.getFile().existsAsFile())
+        return {};
+
+    const auto sidecarFile = getDecodedSidecarFile (f);
+    return { sidecarFile, DecodedSidecarAudioFormat::isValidFor (sidecarFile, f.getFile()) };
+}
+
+AudioFileCache::Reader::Ptr AudioFileCache::createCachedFileReader (const AudioFile& file)
+{
+    const juce::ScopedWriteLock sl (fileListLock);
+
+    if (auto f = getOrCreateCachedFile (file))
+    {
+        auto r = new Reader (*this, f, nullptr);
+        f->addClient (r);
+        return r;
+    }
+
+    return {};
+}
+
 void AudioFileCache::releaseFile (const AudioFile& file)
 {
     const juce::ScopedReadLock sl (fileListLock);
@@ -743,7 +1187,7 @@ void AudioFileCache::touchReaders()
 
     for (auto f : activeFiles)
     {
-        f->touchFiles();
+        f->prefetch();
         totalBytes += f->totalBytesInUse;
     }
 
@@ -790,22 +1234,20 @@ bool AudioFileCache::hasMappedReader (const AudioFile& af, SampleCount c) const
 AudioFileCache::Reader::Ptr AudioFileCache::createReader (const AudioFile& file)
 {
     CRASH_TRACER
-    const juce::ScopedWriteLock sl (fileListLock);
 
-    if (auto f = getOrCreateCachedFile (file))
-    {
-        auto r = new Reader (*this, f, nullptr);
-        f->addClient (r);
+    if (auto r = createCachedFileReader (file))
         return r;
-    }
 
-    if (auto reader = AudioFileUtils::createReaderFor (engine, file.getFile()))
-    {
-        backgroundReaderThread.startThread (juce::Thread::Priority::low);
+    // This reads the sidecar's header so is done without the fileListLock held
+    const auto sidecar = findDecodedSidecar (file);
 
-        return new Reader (*this, nullptr, std::make_unique<BufferingAudioReaderWrapper> (std::make_unique<juce::BufferingAudioReader> (reader, backgroundReaderThread,
-                                                                                                                                        48000 * 5)));
-    }
+    if (sidecar.isComplete)
+        if (auto r = createCachedFileReader (AudioFile (engine, sidecar.file)))
+            return r;
+
+    // Otherwise the sidecar is written from the blocks decoded for the reader
+    if (auto decodedReader = decodedBlockCache->createReader (file, sidecar.isComplete ? juce::File() : sidecar.file))
+        return new Reader (*this, nullptr, std::move (decodedReader));
 
     return {};
 }
@@ -816,13 +1258,21 @@ AudioFileCache::Reader::Ptr AudioFileCache::createReader (const AudioFile& file,
                                                                                                                int samplesToBuffer)>& createFallbackReader)
 {
     CRASH_TRACER
-    const juce::ScopedWriteLock sl (fileListLock);
 
-    if (auto f = getOrCreateCachedFile (file))
-    {
-        auto r = new Reader (*this, f, nullptr);
-        f->addClient (r);
+    if (auto r = createCachedFileReader (file))
         return r;
+
+    const auto sidecar = findDecodedSidecar (file);
+
+    if (sidecar.isComplete)
+    {
+        if (auto r = createCachedFileReader (AudioFile (engine, sidecar.file)))
+            return r;
+    }
+    else if (sidecar.file != juce::File())
+    {
+        // The fallback reader does its own decoding so the sidecar has to be decoded separately
+        decodedBlockCache->writeSidecar (file, sidecar.file);
     }
 
     if (auto reader = AudioFileUtils::createReaderFor (engine, file.getFile()))
@@ -878,6 +1328,8 @@ void AudioFileCache::Reader::setReadPosition (SampleCount pos) noexcept
         readPos = localLoopStart + (pos % localLoopLength);
     else
         readPos = localLoopStart + juce::negativeAwareModulo (pos, localLoopLength);
+
+    publishPosition();
 }
 
 int AudioFileCache::Reader::getNumChannels() const noexcept
@@ -896,6 +1348,26 @@ void AudioFileCache::Reader::setLoopRange (SampleRange newRange)
 {
     loopStart  = newRange.getStart();
     loopLength = newRange.getLength();
+    publishPosition();
+}
+
+void AudioFileCache::Reader::setPlaybackSpeedHint (double speedRatio) noexcept
+{
+    if (auto slot = prefetchSlot.load (std::memory_order_acquire))
+        slot->speedRatio.store ((float) speedRatio, std::memory_order_relaxed);
+}
+
+void AudioFileCache::Reader::publishPosition() noexcept
+{
+    if (fallbackReader != nullptr)
+        fallbackReader->setNextReadPositionHint (readPos.load (std::memory_order_relaxed));
+
+    if (auto slot = prefetchSlot.load (std::memory_order_acquire))
+    {
+        slot->loopStart.store (loopStart.load (std::memory_order_relaxed), std::memory_order_relaxed);
+        slot->loopLength.store (loopLength.load (std::memory_order_relaxed), std::memory_order_relaxed);
+        slot->readPos.store (readPos.load (std::memory_order_relaxed), std::memory_order_release);
+    }
 }
 
 bool AudioFileCache::Reader::readSamples (int numSamples,
@@ -1014,6 +1486,9 @@ bool AudioFileCache::Reader::readSamples (int* const* destSamples, int numDestCh
     jassert (getReferenceCount() > 1 || file == nullptr); // may be being used after the cache has been deleted
     jassert (timeoutMs >= 0);
 
+    if (auto slot = prefetchSlot.load (std::memory_order_relaxed))
+        slot->samplesPerRead.store (numSamples, std::memory_order_relaxed);
+
     if (readPos < 0)
     {
         auto silence = (int) std::min (-readPos, (SampleCount) numSamples);
@@ -1027,7 +1502,10 @@ bool AudioFileCache::Reader::readSamples (int* const* destSamples, int numDestCh
         readPos += silence;
 
         if (numSamples <= 0)
+        {
+            publishPosition();
             return true;
+        }
     }
 
     bool allOk = true;
@@ -1074,6 +1552,7 @@ bool AudioFileCache::Reader::readSamples (int* const* destSamples, int numDestCh
             numSamples -= numToRead;
         }
 
+        publishPosition();
         return allOk;
     }
     else
@@ -1081,12 +1560,132 @@ bool AudioFileCache::Reader::readSamples (int* const* destSamples, int numDestCh
         clearSetOfChannels (destSamples, numDestChannels, startOffsetInDestBuffer, numSamples);
     }
 
+    publishPosition();
+
+    if (! allOk)
+        cache.cacheMissed = true;
+
+    return allOk;
+}
+
+bool AudioFileCache::Reader::readSamples (choc::buffer::ChannelArrayView<float> destBuffer,
+                                          std::span<const int> sourceChannelForDestChannel,
+                                          float gain, int timeoutMs)
+{
+    using choc::buffer::FrameCount;
+
+    jassert (destBuffer.getNumFrames() < CachedFile::readAheadSamples); // this method fails unless broken down into chunks smaller than this
+    jassert (getReferenceCount() > 1 || file == nullptr); // may be being used after the cache has been deleted
+    jassert (timeoutMs >= 0);
+
+    if (auto slot = prefetchSlot.load (std::memory_order_relaxed))
+        slot->samplesPerRead.store ((int) destBuffer.getNumFrames(), std::memory_order_relaxed);
+
+    if (readPos < 0)
+    {
+        const auto silence = (FrameCount) std::min (-readPos, (SampleCount) destBuffer.getNumFrames());
+        destBuffer.getStart (silence).clear();
+        destBuffer = destBuffer.fromFrame (silence);
+        readPos += silence;
+
+        if (destBuffer.getNumFrames() == 0)
+        {
+            publishPosition();
+            return true;
+        }
+    }
+
+    bool allOk = true;
+    const ScopedFileRead sfr (cache);
+
+    if (loopLength == 0)
+    {
+        allOk = readSection (readPos, destBuffer, sourceChannelForDestChannel, gain, timeoutMs);
+        readPos += destBuffer.getNumFrames();
+    }
+    else if (loopLength > 1)
+    {
+        while (destBuffer.getNumFrames() > 0)
+        {
+            jassert (juce::isPositiveAndBelow (readPos.load() - loopStart.load(), loopLength.load()));
+
+            const auto numToRead = (FrameCount) std::min ((SampleCount) destBuffer.getNumFrames(), loopStart + loopLength - readPos);
+            allOk = readSection (readPos, destBuffer.getStart (numToRead), sourceChannelForDestChannel, gain, timeoutMs) && allOk;
+
+            readPos += numToRead;
+
+            if (readPos >= loopStart + loopLength)
+                readPos -= loopLength;
+
+            destBuffer = destBuffer.fromFrame (numToRead);
+        }
+    }
+    else
+    {
+        destBuffer.clear();
+    }
+
+    publishPosition();
+
     if (! allOk)
         cache.cacheMissed = true;
 
     return allOk;
 }
 
+bool AudioFileCache::Reader::readSection (SampleCount start, choc::buffer::ChannelArrayView<float> destBuffer,
+                                          std::span<const int> sourceChannelForDestChannel, float gain, int timeoutMs)
+{
+    if (auto cf = static_cast<CachedFile*> (file))
+        return cf->read (start, destBuffer, sourceChannelForDestChannel, gain, timeoutMs);
+
+    fallbackReader->setReadTimeout (timeoutMs);
+
+    return readAndRemapChannels (destBuffer, sourceChannelForDestChannel,
+                                 (int) fallbackReader->numChannels, fallbackReader->usesFloatingPointData, gain,
+                                 [&] (int* const* chans, int numChans)
+                                 {
+                                     return fallbackReader->readSamples (chans, numChans, 0, start, (int) destBuffer.getNumFrames());
+                                 });
+}
+
+std::vector<int> AudioFileCache::Reader::createChannelMap (const juce::AudioChannelSet& destBufferChannels,
+                                                          const juce::AudioChannelSet& sourceBufferChannels) const
+{
+    std::vector<int> map ((size_t) destBufferChannels.size(), -1);
+
+    if (cache.engine.getEngineBehaviour().isDescriptionOfWaveDevicesSupported())
+    {
+        for (int destIndex = 0; destIndex < destBufferChannels.size(); ++destIndex)
+            map[(size_t) destIndex] = sourceBufferChannels.getChannelIndexForType (destBufferChannels.getTypeOfChannel (destIndex));
+
+        return map;
+    }
+
+    const bool usesLeft = sourceBufferChannels.getChannelIndexForType (juce::AudioChannelSet::left) >= 0;
+    const bool usesRight = sourceBufferChannels.getChannelIndexForType (juce::AudioChannelSet::right) >= 0;
+
+    if (map.size() > 1)
+    {
+        // Mono sources or single sides are duplicated to both destination channels
+        if (usesLeft && usesRight)
+        {
+            map[0] = 0;
+            map[1] = getNumChannels() > 1 ? 1 : 0;
+        }
+        else
+        {
+            map[0] = map[1] = usesLeft ? 0 : 1;
+        }
+    }
+    else if (map.size() == 1)
+    {
+        map[0] = (usesLeft || getNumChannels() < 2) ? 0 : 1;
+    }
+
+    return map;
+}
+
 bool AudioFileCache::Reader::getRange (int numSamples, float& lmax, float& lmin, float& rmax, float& rmin, int timeoutMs)
 {
     jassert (getReferenceCount() > 1 || file == nullptr); // may be being used after the cache has been deleted
@@ -1105,6 +1704,7 @@ bool AudioFileCache::Reader::getRange (int numSamples, float& lmax, float& lmin,
     }
 
     readPos += numSamples;
+    publishPosition();
     return ok;
 }
 
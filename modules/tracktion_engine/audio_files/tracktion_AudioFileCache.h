@@ -22,6 +22,12 @@ struct FallbackReader  : public juce::AudioFormatReader
         A value greater than 0 means wait for the given number of ms
     */
     virtual void setReadTimeout (int timeoutMilliseconds) = 0;
+
+    /** Called when the position that will be read from next changes, e.g. when the
+        Reader's position or loop range is set. Subclasses that read ahead can use this
+        to start before the first read. This can be called from the audio thread.
+    */
+    virtual void setNextReadPositionHint (int64_t /*position*/) {}
 };
 
 //==============================================================================
@@ -34,6 +40,10 @@ public:
     ~AudioFileCache();
 
     //==============================================================================
+private:
+    struct PrefetchSlot;
+
+public:
     class Reader  : public juce::ReferenceCountedObject
     {
     public:
@@ -57,6 +67,24 @@ public:
                           int numSamples,
                           int timeoutMs);
 
+        /** Reads float samples directly in to a view, starting at the read position.
+            Each entry of sourceChannelForDestChannel is the file channel to read in to
+            that channel of the view, or -1 to clear it. The gain is applied as the
+            samples are converted. For uncompressed files the samples are converted
+            straight from the mapped file without any intermediate buffers.
+            @see createChannelMap
+        */
+        bool readSamples (choc::buffer::ChannelArrayView<float> destBuffer,
+                          std::span<const int> sourceChannelForDestChannel,
+                          float gain,
+                          int timeoutMs);
+
+        /** Returns the file channel to read in to each channel of a destination,
+            using the same rules as the AudioChannelSet version of readSamples.
+        */
+        std::vector<int> createChannelMap (const juce::AudioChannelSet& destBufferChannels,
+                                           const juce::AudioChannelSet& sourceBufferChannels) const;
+
         bool getRange (int numSamples,
                        float& lmax, float& lmin,
                        float& rmax, float& rmin,
@@ -64,6 +92,13 @@ public:
 
         void setLoopRange (SampleRange);
 
+        /** Tells the cache how fast this reader moves through the file, relative to
+            the file's own sample rate, so it can size the region it pre-fetches.
+            The size of each read is also used, so this only needs calling if the
+            speed is something other than 1.
+        */
+        void setPlaybackSpeedHint (double speedRatio) noexcept;
+
         int getNumChannels() const noexcept;
         double getSampleRate() const noexcept;
 
@@ -74,14 +109,21 @@ public:
         void* file;
         std::atomic<SampleCount> readPos { 0 }, loopStart { 0 }, loopLength { 0 };
         std::unique_ptr<FallbackReader> fallbackReader;
+        std::atomic<PrefetchSlot*> prefetchSlot { nullptr };
 
         Reader (AudioFileCache&, void*, std::unique_ptr<FallbackReader>);
 
+        void publishPosition() noexcept;
+        bool readSection (SampleCount, choc::buffer::ChannelArrayView<float>, std::span<const int>, float gain, int timeoutMs);
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Reader)
     };
 
     /** Creates a Reader to read an AudioFile.
-        This will use a memoery mapped reader for uncompressed formats.
+        This will use a memoery mapped reader for uncompressed formats and blocks
+        decoded in the background for compressed formats.
+        If decoded sidecars are enabled, the decoded blocks of compressed formats are
+        also written to a sidecar file which is memory mapped once it's complete.
     */
     Reader::Ptr createReader (const AudioFile&);
 
@@ -103,6 +145,30 @@ public:
 
     SampleCount getBytesInUse() const               { return totalBytesUsed; }
 
+    //==============================================================================
+    /** Sets the maximum size of the blocks decoded from compressed files, in Mb.
+        When this is reached, the least recently read blocks are discarded.
+    */
+    void setDecodedCacheSizeMb (int sizeMb);
+    int getDecodedCacheSizeMb() const;
+
+    /** Returns the number of bytes currently used by blocks decoded from compressed files. */
+    int64_t getDecodedBytesInUse() const;
+
+    //==============================================================================
+    /** Enables or disables writing decoded copies of compressed files to the temp
+        folder so they can be memory mapped the next time they're opened.
+    */
+    void setDecodedSidecarsEnabled (bool);
+    bool areDecodedSidecarsEnabled() const          { return decodedSidecarsEnabled; }
+
+    /** Returns the file a compressed AudioFile will be decoded to. */
+    juce::File getDecodedSidecarFile (const AudioFile&) const;
+
+    /** Returns true if there's a complete, up-to-date decoded sidecar for a file. */
+    bool hasDecodedSidecar (const AudioFile&) const;
+
+    //==============================================================================
     bool hasCacheMissed (bool clearMissedFlag);
 
     /** Returns the amount of time spent reading files in the last block. */
@@ -120,6 +186,7 @@ private:
     bool cacheMissed = false;
 
     std::atomic<double> blockDurationMs { 0.0 }, lastBlockDurationMs { 0.0 };
+    std::atomic<bool> decodedSidecarsEnabled { true };
     struct ScopedFileRead;
 
     class CacheBuffer;
@@ -129,6 +196,16 @@ private:
     juce::ReadWriteLock fileListLock;
 
     CachedFile* getOrCreateCachedFile (const AudioFile&);
+    Reader::Ptr createCachedFileReader (const AudioFile&);
+
+    struct DecodedSidecar
+    {
+        juce::File file;
+        bool isComplete = false;
+    };
+
+    DecodedSidecar findDecodedSidecar (const AudioFile&) const;
+
     bool serviceNextReader();
     void touchReaders();
 
@@ -138,6 +215,7 @@ private:
     std::unique_ptr<RefresherThread> refresherThread;
 
     juce::TimeSliceThread backgroundReaderThread { "Preview Buffer" };
+    std::unique_ptr<DecodedBlockCache> decodedBlockCache;
 
     void stopThreads();
 
@@ -32,6 +32,10 @@ public:
     void runTest() override
     {
         runCacheReadTest();
+        runLoopedCacheReadTest();
+        runViewReadTest();
+        runDecodedCacheReadTest();
+        runDecodedSidecarReadTest();
     }
 
 private:
@@ -60,6 +64,161 @@ private:
         beginTest ("Read a sin wav file");
         expectAudioBuffer (*this, bufferFromFile, bufferFromCache);
     }
+
+    void runLoopedCacheReadTest()
+    {
+        Engine& engine = *Engine::getEngines().getFirst();
+
+        using namespace graph::test_utilities;
+        auto tempFile = getSquareFile<juce::WavAudioFormat> (44100.0, 10.0, 2);
+
+        auto fileReader = std::unique_ptr<juce::AudioFormatReader> (AudioFileUtils::createReaderFor (engine, tempFile->getFile()));
+        const SampleRange loopRange (44100, 44100 + 30'000);
+        const int numSamples = 100'000;
+
+        // Build the expected output by repeating the loop section
+        juce::AudioBuffer<float> bufferFromFile ((int) fileReader->numChannels, numSamples);
+
+        for (int i = 0; i < numSamples;)
+        {
+            const auto numToRead = std::min (numSamples - i, (int) loopRange.getLength());
+            fileReader->read (&bufferFromFile, i, numToRead, loopRange.getStart(), true, true);
+            i += numToRead;
+        }
+
+        auto cacheReader = engine.getAudioFileManager().cache.createReader (AudioFile (engine, tempFile->getFile()));
+        cacheReader->setLoopRange (loopRange);
+        cacheReader->setPlaybackSpeedHint (1.0);
+        cacheReader->setReadPosition (0);
+
+        juce::AudioBuffer<float> bufferFromCache ((int) fileReader->numChannels, numSamples);
+
+        for (int i = 0; i < numSamples; i += 512)
+        {
+            const int numToRead = std::min (numSamples - i, 512);
+            cacheReader->readSamples (numToRead,
+                                      bufferFromCache, juce::AudioChannelSet::stereo(),
+                                      i, juce::AudioChannelSet::stereo(), 5'000);
+        }
+
+        beginTest ("Read a looped section across the loop end");
+        expectAudioBuffer (*this, bufferFromFile, bufferFromCache);
+    }
+
+    void runViewReadTest()
+    {
+        Engine& engine = *Engine::getEngines().getFirst();
+
+        using namespace graph::test_utilities;
+        auto tempFile = getSquareFile<juce::WavAudioFormat> (44100.0, 10.0, 2);
+
+        auto fileReader = std::unique_ptr<juce::AudioFormatReader> (AudioFileUtils::createReaderFor (engine, tempFile->getFile()));
+        const int numSamples = (int) fileReader->lengthInSamples;
+
+        // Swap the channels, halve the gain and leave a third channel silent
+        juce::AudioBuffer<float> stereoBuffer (2, numSamples);
+        fileReader->read (&stereoBuffer, 0, numSamples, 0, true, true);
+
+        juce::AudioBuffer<float> bufferFromFile (3, numSamples);
+        bufferFromFile.clear();
+        bufferFromFile.copyFrom (0, 0, stereoBuffer, 1, 0, numSamples, 0.5f);
+        bufferFromFile.copyFrom (1, 0, stereoBuffer, 0, 0, numSamples, 0.5f);
+
+        auto cacheReader = engine.getAudioFileManager().cache.createReader (AudioFile (engine, tempFile->getFile()));
+        auto bufferFromCache = choc::buffer::ChannelArrayBuffer<float> (3, (choc::buffer::FrameCount) numSamples);
+        const std::vector<int> channelMap { 1, 0, -1 };
+        bool allOk = true;
+
+        for (int i = 0; i < numSamples; i += 32'768)
+        {
+            const auto numToRead = std::min (numSamples - i, 32'768);
+            allOk = cacheReader->readSamples (bufferFromCache.getFrameRange ({ (choc::buffer::FrameCount) i, (choc::buffer::FrameCount) (i + numToRead) }),
+                                              channelMap, 0.5f, 5'000) && allOk;
+        }
+
+        beginTest ("Read a wav file directly in to a view");
+        expect (allOk);
+        expect (buffersAreEqual (bufferFromFile, toAudioBuffer (bufferFromCache), 1.0e-4f));
+    }
+
+    void runDecodedCacheReadTest()
+    {
+        Engine& engine = *Engine::getEngines().getFirst();
+
+        using namespace graph::test_utilities;
+        auto tempFile = getSquareFile<juce::FlacAudioFormat> (44100.0, 10.0, 2);
+
+        auto fileReader = std::unique_ptr<juce::AudioFormatReader> (AudioFileUtils::createReaderFor (engine, tempFile->getFile()));
+        juce::AudioBuffer<float> bufferFromFile ((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
+        fileReader->read (&bufferFromFile, 0, (int) fileReader->lengthInSamples, 0, true, true);
+
+        // Two readers of the same file share the decoded blocks
+        auto& cache = engine.getAudioFileManager().cache;
+        auto cacheReader1 = cache.createReader (AudioFile (engine, tempFile->getFile()));
+        auto cacheReader2 = cache.createReader (AudioFile (engine, tempFile->getFile()));
+
+        for (auto cacheReader : { cacheReader1, cacheReader2 })
+        {
+            juce::AudioBuffer<float> bufferFromCache ((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
+
+            for (int i = 0; i < bufferFromCache.getNumSamples(); i += 32'768)
+            {
+                const int numToRead = std::min ((int) fileReader->lengthInSamples - i, 32'768);
+                expect (cacheReader->readSamples (numToRead,
+                                                  bufferFromCache, juce::AudioChannelSet::stereo(),
+                                                  i, juce::AudioChannelSet::stereo(), 5'000));
+            }
+
+            beginTest ("Read a flac file from the decoded cache");
+            expectAudioBuffer (*this, bufferFromFile, bufferFromCache);
+        }
+
+        beginTest ("Decoded blocks are within the budget");
+        expect (cache.getDecodedBytesInUse() > 0);
+        expect (cache.getDecodedBytesInUse() <= (int64_t) cache.getDecodedCacheSizeMb() * 1024 * 1024);
+    }
+
+    void runDecodedSidecarReadTest()
+    {
+        Engine& engine = *Engine::getEngines().getFirst();
+
+        using namespace graph::test_utilities;
+        auto tempFile = getSquareFile<juce::FlacAudioFormat> (44100.0, 10.0, 2);
+        const AudioFile audioFile (engine, tempFile->getFile());
+
+        auto fileReader = std::unique_ptr<juce::AudioFormatReader> (AudioFileUtils::createReaderFor (engine, tempFile->getFile()));
+        juce::AudioBuffer<float> bufferFromFile ((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
+        fileReader->read (&bufferFromFile, 0, (int) fileReader->lengthInSamples, 0, true, true);
+
+        // The first reader starts the sidecar being written in the background
+        auto& cache = engine.getAudioFileManager().cache;
+        cache.setDecodedSidecarsEnabled (true);
+        expect (cache.createReader (audioFile) != nullptr);
+
+        for (int i = 0; i < 100 && ! cache.hasDecodedSidecar (audioFile); ++i)
+            juce::Thread::sleep (100);
+
+        beginTest ("Decoded sidecar is written");
+        expect (cache.hasDecodedSidecar (audioFile));
+
+        auto cacheReader = cache.createReader (audioFile);
+        juce::AudioBuffer<float> bufferFromCache ((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
+
+        for (int i = 0; i < bufferFromCache.getNumSamples(); i += 32'768)
+        {
+            const int numToRead = std::min ((int) fileReader->lengthInSamples - i, 32'768);
+            expect (cacheReader->readSamples (numToRead,
+                                              bufferFromCache, juce::AudioChannelSet::stereo(),
+                                              i, juce::AudioChannelSet::stereo(), 5'000));
+        }
+
+        beginTest ("Read a flac file from its decoded sidecar");
+        expectAudioBuffer (*this, bufferFromFile, bufferFromCache);
+
+        beginTest ("Decoded sidecar is invalidated when the source changes");
+        tempFile->getFile().setLastModificationTime (juce::Time::getCurrentTime() + juce::RelativeTime::hours (1));
+        expect (! cache.hasDecodedSidecar (audioFile));
+    }
 };
 
 static AudioFileCacheTests audioFileCacheTests;
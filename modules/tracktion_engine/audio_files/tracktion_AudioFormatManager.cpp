@@ -28,6 +28,9 @@ AudioFileFormatManager::AudioFileFormatManager()
     floatFormat = std::make_unique<FloatAudioFormat>();
     readFormats.add (floatFormat.get());
 
+    decodedSidecarFormat = std::make_unique<DecodedSidecarAudioFormat>();
+    readFormats.add (decodedSidecarFormat.get());
+
     oggFormat = std::make_unique<juce::OggVorbisAudioFormat>();
     readFormats.add (oggFormat.get());
     writeFormats.add (oggFormat.get());
@@ -62,6 +65,7 @@ AudioFileFormatManager::AudioFileFormatManager()
     readFormatManager.registerFormat (new juce::WavAudioFormat(), true);
     readFormatManager.registerFormat (new juce::AiffAudioFormat(), false);
     readFormatManager.registerFormat (new FloatAudioFormat(), false);
+    readFormatManager.registerFormat (new DecodedSidecarAudioFormat(), false);
     readFormatManager.registerFormat (new juce::OggVorbisAudioFormat(), false);
     readFormatManager.registerFormat (new juce::FlacAudioFormat(), false);
 
@@ -88,6 +92,7 @@ AudioFileFormatManager::AudioFileFormatManager()
     memoryMappedFormatManager.registerFormat (new juce::WavAudioFormat(), true);
     memoryMappedFormatManager.registerFormat (new juce::AiffAudioFormat(), false);
     memoryMappedFormatManager.registerFormat (new FloatAudioFormat(), false);
+    memoryMappedFormatManager.registerFormat (new DecodedSidecarAudioFormat(), false);
 }
 
 AudioFileFormatManager::~AudioFileFormatManager()
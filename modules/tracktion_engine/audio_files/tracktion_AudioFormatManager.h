@@ -35,17 +35,18 @@ public:
     bool canOpen (const juce::File&) const;
     juce::String getValidFileExtensions() const;
 
-    juce::AudioFormat* getDefaultFormat() const     { return wavFormat.get(); }
-    juce::AudioFormat* getWavFormat() const         { return wavFormat.get(); }
-    juce::AudioFormat* getAiffFormat() const        { return aiffFormat.get(); }
-    juce::AudioFormat* getFrozenFileFormat() const  { return floatFormat.get(); }
-    juce::AudioFormat* getOggFormat() const         { return oggFormat.get(); }
-    juce::AudioFormat* getFlacFormat() const        { return flacFormat.get(); }
-    juce::AudioFormat* getNativeAudioFormat() const { return nativeAudioFormat.get(); }
-    juce::AudioFormat* getLameFormat() const        { return lameFormat.get(); }
+    juce::AudioFormat* getDefaultFormat() const        { return wavFormat.get(); }
+    juce::AudioFormat* getWavFormat() const            { return wavFormat.get(); }
+    juce::AudioFormat* getAiffFormat() const           { return aiffFormat.get(); }
+    juce::AudioFormat* getFrozenFileFormat() const     { return floatFormat.get(); }
+    juce::AudioFormat* getDecodedSidecarFormat() const { return decodedSidecarFormat.get(); }
+    juce::AudioFormat* getOggFormat() const            { return oggFormat.get(); }
+    juce::AudioFormat* getFlacFormat() const           { return flacFormat.get(); }
+    juce::AudioFormat* getNativeAudioFormat() const    { return nativeAudioFormat.get(); }
+    juce::AudioFormat* getLameFormat() const           { return lameFormat.get(); }
 
    #if TRACKTION_ENABLE_REX
-    juce::AudioFormat* getRexFormat() const         { return rexFormat.get(); }
+    juce::AudioFormat* getRexFormat() const            { return rexFormat.get(); }
    #endif
 
     juce::AudioFormatManager readFormatManager, writeFormatManager, memoryMappedFormatManager;
@@ -54,7 +55,7 @@ private:
     juce::Array<juce::AudioFormat*> allFormats, readFormats, writeFormats;
     juce::OwnedArray<juce::AudioFormat> additionalFormats;
 
-    std::unique_ptr<juce::AudioFormat> wavFormat, aiffFormat, floatFormat, nativeAudioFormat,
+    std::unique_ptr<juce::AudioFormat> wavFormat, aiffFormat, floatFormat, decodedSidecarFormat, nativeAudioFormat,
                                        mp3ReadFormat, oggFormat, flacFormat, lameFormat;
 
    #if TRACKTION_ENABLE_REX
@@ -22,6 +22,11 @@ public:
     bool isProxyBeingGenerated (const AudioFile& proxyFile) const noexcept;
     float getProportionComplete (const AudioFile& proxyFile) const noexcept;
 
+    /** Returns true if a proxy was being rendered in chunks and hasn't finished.
+        The file may exist but will have silent sections.
+    */
+    static bool hasIncompleteRender (const AudioFile& proxyFile);
+
     //==============================================================================
     struct GeneratorJob  : public ThreadPoolJobWithProgress
     {
@@ -30,6 +35,29 @@ public:
 
         virtual bool render() = 0;
 
+        /** Describes the proxy file for a job that can render in chunks. */
+        struct ChunkedRenderFormat
+        {
+            double sampleRate = 0.0;
+            int numChannels = 0;
+            int bitsPerSample = 16;
+            juce::StringPairArray metadata;
+            SampleCount lengthInSamples = 0;        /**< The total length of the proxy. */
+            SampleCount preRollSamples = 0;         /**< Rendered before each chunk and discarded to settle any state. */
+            int chunkAlignment = 1;                 /**< Chunk boundaries are rounded to a multiple of this. */
+        };
+
+        /** Jobs that can render any section of their proxy independently can return
+            a format here to have the proxy rendered in chunks on several threads.
+            renderChunk() will then be called instead of render().
+        */
+        virtual std::optional<ChunkedRenderFormat> getChunkedRenderFormat()     { return {}; }
+
+        /** Renders a section of the proxy in to a buffer of the section's length.
+            This is called from several threads at once so mustn't share any state.
+        */
+        virtual bool renderChunk (SampleRange, juce::AudioBuffer<float>&)      { return false; }
+
         float getCurrentTaskProgress() override         { return progress; }
 
         ThreadPoolJob::JobStatus runJob() override;
@@ -49,6 +77,12 @@ private:
     juce::Array<GeneratorJob*> activeJobs;
     juce::CriticalSection jobListLock;
 
+    class ChunkedRender;
+    std::atomic<int> numChunkThreadsInUse { 0 };
+
+    int claimChunkThreads (int numWanted) noexcept;
+    void releaseChunkThreads (int num) noexcept;
+
     GeneratorJob* findJob (const AudioFile&) const noexcept;
     void removeFinishedJob (GeneratorJob*);
 
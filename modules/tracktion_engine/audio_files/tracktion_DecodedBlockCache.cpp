@@ -0,0 +1,770 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    A block of decoded samples.
+
+    The state holds whether the block is ready or being decoded/evicted and, in
+    the remaining bits, the number of readers currently copying from it. Readers
+    can only pin a ready block and a block can only be evicted when it's ready and
+    has no pins so the data can't be freed whilst it's being read.
+*/
+struct DecodedBlockCache::Block
+{
+    static constexpr uint32_t readyFlag     = 1u << 31;
+    static constexpr uint32_t busyFlag      = 1u << 30;
+
+    std::atomic<uint32_t> state { 0 };
+    std::atomic<uint32_t> lastUseTime { 0 };
+    choc::buffer::ChannelArrayBuffer<float> data;
+    int64_t numBytes = 0;
+
+    bool isEmpty() const noexcept
+    {
+        return state.load (std::memory_order_acquire) == 0;
+    }
+
+    bool tryPin() noexcept
+    {
+        auto current = state.load (std::memory_order_acquire);
+
+        while ((current & readyFlag) != 0)
+            if (state.compare_exchange_weak (current, current + 1, std::memory_order_acquire))
+                return true;
+
+        return false;
+    }
+
+    void unpin() noexcept
+    {
+        state.fetch_sub (1, std::memory_order_release);
+    }
+
+    bool tryClaimForDecoding() noexcept
+    {
+        uint32_t expected = 0;
+        return state.compare_exchange_strong (expected, busyFlag, std::memory_order_acquire);
+    }
+
+    bool tryClaimForEviction() noexcept
+    {
+        uint32_t expected = readyFlag;
+        return state.compare_exchange_strong (expected, busyFlag, std::memory_order_acquire);
+    }
+
+    void markReady() noexcept
+    {
+        lastUseTime.store (juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+        state.store (readyFlag, std::memory_order_release);
+    }
+
+    void markEmpty()
+    {
+        data = {};
+        state.store (0, std::memory_order_release);
+    }
+};
+
+//==============================================================================
+class DecodedBlockCache::DecodedFile
+{
+public:
+    DecodedFile (std::unique_ptr<juce::AudioFormatReader> sourceReader, const juce::File& fileBeingRead)
+        : sourceFile (fileBeingRead), source (std::move (sourceReader)),
+          blocks ((size_t) ((source->lengthInSamples + framesPerBlock - 1) / framesPerBlock))
+    {
+    }
+
+    ~DecodedFile()
+    {
+        if (sidecarWriter != nullptr)
+            stopWritingSidecar (false);
+    }
+
+    const juce::AudioFormatReader& getSource() const    { return *source; }
+    size_t getNumBlocks() const                         { return blocks.size(); }
+    Block& getBlock (size_t index)                      { return blocks[index]; }
+
+    juce::Range<int64_t> getBlockRange (size_t index) const
+    {
+        const auto start = (int64_t) index * framesPerBlock;
+        return { start, std::min (start + framesPerBlock, (int64_t) source->lengthInSamples) };
+    }
+
+    int64_t getNumBytesForBlock (size_t index) const
+    {
+        return getBlockRange (index).getLength() * (int64_t) source->numChannels * (int64_t) sizeof (float);
+    }
+
+    //==============================================================================
+    void addReader (Reader& r)
+    {
+        const std::scoped_lock sl (readersMutex);
+        readers.push_back (&r);
+    }
+
+    void removeReader (Reader& r)
+    {
+        const std::scoped_lock sl (readersMutex);
+        std::erase (readers, &r);
+        lastUsedTime.store (juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+    }
+
+    bool hasReaders()
+    {
+        const std::scoped_lock sl (readersMutex);
+        return ! readers.empty();
+    }
+
+    uint32_t getLastUsedTime() const
+    {
+        return lastUsedTime.load (std::memory_order_relaxed);
+    }
+
+    /** Finds the empty block that a reader will get to soonest.
+        @returns the block index and the number of frames until it's needed
+    */
+    std::optional<std::pair<size_t, int64_t>> findMostUrgentBlock();
+
+    /** Decodes a block, the block must have been claimed for decoding first. */
+    void decodeBlock (size_t index)
+    {
+        auto& block = blocks[index];
+        const auto range = getBlockRange (index);
+        const auto numChannels = (int) source->numChannels;
+        const auto numFrames = (int) range.getLength();
+
+        block.data.resize ({ (choc::buffer::ChannelCount) numChannels, (choc::buffer::FrameCount) numFrames });
+        block.numBytes = getNumBytesForBlock (index);
+        auto destBuffer = toAudioBuffer (block.data.getView());
+
+        // The source can only be read by one thread at a time
+        const std::scoped_lock sl (sourceMutex);
+        source->read (&destBuffer, 0, numFrames, range.getStart(), true, true);
+    }
+
+    //==============================================================================
+    /** Starts writing the blocks to a sidecar file, unless it's already being written. */
+    bool startWritingSidecar (juce::AudioFormat& format, const juce::File& fileToWrite)
+    {
+        const std::scoped_lock sl (sidecarMutex);
+
+        if (sidecarWriter != nullptr || (hasWrittenSidecar && sidecarFile == fileToWrite))
+            return false;
+
+        sidecarFile = fileToWrite;
+        const auto tempFile = getTempSidecarFile();
+
+        if (! tempFile.getParentDirectory().createDirectory())
+            return false;
+
+        tempFile.deleteFile();
+        auto out = tempFile.createOutputStream();
+
+        if (out == nullptr)
+            return false;
+
+        // 16-bit sources are stored as ints to halve the size, anything else as floats
+        const int bitsPerSample = (source->usesFloatingPointData || source->bitsPerSample > 16) ? 32 : 16;
+
+        sidecarWriter.reset (format.createWriterFor (out.get(), source->sampleRate,
+                                                     source->numChannels, bitsPerSample,
+                                                     DecodedSidecarAudioFormat::createMetadataFor (sourceFile), 0));
+
+        if (sidecarWriter == nullptr)
+            return false;
+
+        out.release();
+        hasWrittenSidecar = false;
+        nextSidecarBlock.store (0, std::memory_order_relaxed);
+        isWritingSidecarFlag.store (true, std::memory_order_release);
+
+        return true;
+    }
+
+    bool isWritingSidecar() const noexcept
+    {
+        return isWritingSidecarFlag.load (std::memory_order_acquire);
+    }
+
+    /** Returns the block the sidecar needs next if it hasn't been decoded yet. */
+    std::optional<size_t> getNextSidecarBlockToDecode() const
+    {
+        if (! isWritingSidecar())
+            return {};
+
+        if (const auto index = nextSidecarBlock.load (std::memory_order_acquire);
+            index < blocks.size() && blocks[index].isEmpty())
+            return index;
+
+        return {};
+    }
+
+    /** Writes the sidecar's next blocks for as long as they're decoded, finishing it
+        after the last one. If another thread is already writing, this does nothing.
+        @returns true if any blocks were written
+    */
+    bool writeSidecarBlocks()
+    {
+        std::unique_lock sl (sidecarMutex, std::try_to_lock);
+
+        if (! sl.owns_lock() || sidecarWriter == nullptr)
+            return false;
+
+        bool hasWrittenBlocks = false;
+
+        for (auto index = nextSidecarBlock.load (std::memory_order_relaxed); index < blocks.size(); ++index)
+        {
+            // If the block has been evicted it'll be decoded again when the threads have time
+            auto& block = blocks[index];
+
+            if (! block.tryPin())
+                return hasWrittenBlocks;
+
+            const bool ok = sidecarWriter->writeFromAudioSampleBuffer (toAudioBuffer (block.data.getView()),
+                                                                       0, (int) block.data.getNumFrames());
+            block.unpin();
+
+            if (! ok)
+            {
+                stopWritingSidecar (false);
+                return hasWrittenBlocks;
+            }
+
+            nextSidecarBlock.store (index + 1, std::memory_order_release);
+            hasWrittenBlocks = true;
+        }
+
+        stopWritingSidecar (true);
+        return hasWrittenBlocks;
+    }
+
+    /** The number of blocks currently decoded, only used with the cache's filesMutex locked. */
+    int numResidentBlocks = 0;
+
+private:
+    const juce::File sourceFile;
+    std::mutex sourceMutex;
+    std::unique_ptr<juce::AudioFormatReader> source;
+    std::vector<Block> blocks;
+
+    std::mutex sidecarMutex;
+    std::unique_ptr<juce::AudioFormatWriter> sidecarWriter;
+    juce::File sidecarFile;
+    std::atomic<size_t> nextSidecarBlock { 0 };
+    std::atomic<bool> isWritingSidecarFlag { false };
+    bool hasWrittenSidecar = false;
+
+    // The sidecar is written to a temporary file and only moved once it's complete
+    // so a partial file is never opened
+    juce::File getTempSidecarFile() const
+    {
+        return sidecarFile.getSiblingFile (sidecarFile.getFileName() + ".partial");
+    }
+
+    void stopWritingSidecar (bool hasFinished)
+    {
+        // N.B. The writer marks the file as complete when it's deleted
+        sidecarWriter.reset();
+        const auto tempFile = getTempSidecarFile();
+
+        if (hasFinished)
+            tempFile.moveFileTo (sidecarFile);
+
+        tempFile.deleteFile();
+        hasWrittenSidecar = hasFinished;
+        isWritingSidecarFlag.store (false, std::memory_order_release);
+    }
+
+    std::mutex readersMutex;
+    std::vector<Reader*> readers;
+    std::atomic<uint32_t> lastUsedTime { juce::Time::getMillisecondCounter() };
+};
+
+//==============================================================================
+/**
+    A FallbackReader that copies from a DecodedFile's blocks.
+*/
+class DecodedBlockCache::Reader  : public FallbackReader
+{
+public:
+    Reader (DecodedBlockCache& c, std::shared_ptr<DecodedFile> fileToRead)
+        : cache (c), file (std::move (fileToRead))
+    {
+        auto& source = file->getSource();
+        sampleRate              = source.sampleRate;
+        lengthInSamples         = source.lengthInSamples;
+        numChannels             = source.numChannels;
+        metadataValues          = source.metadataValues;
+        bitsPerSample           = 32;
+        usesFloatingPointData   = true;
+
+        file->addReader (*this);
+    }
+
+    ~Reader() override
+    {
+        file->removeReader (*this);
+    }
+
+    /** Returns the position this will read from next.
+        This starts at 0 so the start of the file is decoded before the first read.
+    */
+    int64_t getNextReadPosition() const noexcept
+    {
+        return nextReadPosition.load (std::memory_order_relaxed);
+    }
+
+    /** @internal */
+    void setNextReadPositionHint (int64_t position) override
+    {
+        publishReadPosition (position);
+    }
+
+    /** @internal */
+    void setReadTimeout (int timeoutMilliseconds) override
+    {
+        timeoutMs = timeoutMilliseconds;
+    }
+
+    /** @internal */
+    bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      juce::int64 startSampleInFile, int numSamples) override
+    {
+        jassert (startSampleInFile >= 0);
+        clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples, lengthInSamples);
+
+        const auto startTime = juce::Time::getMillisecondCounter();
+        bool allSamplesRead = true, hasSignalledMissingBlock = false;
+
+        while (numSamples > 0)
+        {
+            // Publish the position so the decode threads know which blocks are needed
+            publishReadPosition (startSampleInFile);
+
+            const auto blockIndex = (size_t) (startSampleInFile / framesPerBlock);
+            const auto blockRange = file->getBlockRange (blockIndex);
+            const auto offset = (choc::buffer::FrameCount) (startSampleInFile - blockRange.getStart());
+            const auto numThisTime = (int) std::min ((int64_t) numSamples, blockRange.getEnd() - startSampleInFile);
+            auto& block = file->getBlock (blockIndex);
+
+            if (block.tryPin())
+            {
+                block.lastUseTime.store (startTime, std::memory_order_relaxed);
+
+                for (int i = 0; i < numDestChannels; ++i)
+                {
+                    if (auto dest = (float*) destSamples[i])
+                    {
+                        dest += startOffsetInDestBuffer;
+
+                        if (i < (int) numChannels)
+                            std::memcpy (dest, &block.data.getSample ((choc::buffer::ChannelCount) i, offset), sizeof (float) * (size_t) numThisTime);
+                        else
+                            juce::FloatVectorOperations::clear (dest, numThisTime);
+                    }
+                }
+
+                block.unpin();
+            }
+            else if (timeoutMs < 0 || (int) (juce::Time::getMillisecondCounter() - startTime) < timeoutMs)
+            {
+                // The block might have been evicted or skipped when there wasn't room so wake a thread for it
+                if (! std::exchange (hasSignalledMissingBlock, true))
+                    cache.workAvailable.signal();
+
+                juce::Thread::yield();
+                continue;
+            }
+            else
+            {
+                for (int i = 0; i < numDestChannels; ++i)
+                    if (auto dest = (float*) destSamples[i])
+                        juce::FloatVectorOperations::clear (dest + startOffsetInDestBuffer, numThisTime);
+
+                allSamplesRead = false;
+            }
+
+            startSampleInFile += numThisTime;
+            startOffsetInDestBuffer += numThisTime;
+            numSamples -= numThisTime;
+        }
+
+        publishReadPosition (startSampleInFile);
+
+        return allSamplesRead;
+    }
+
+private:
+    DecodedBlockCache& cache;
+    std::shared_ptr<DecodedFile> file;
+    std::atomic<int64_t> nextReadPosition { 0 }, lastPublishedBlock { 0 };
+    int timeoutMs = 0;
+
+    void publishReadPosition (int64_t position) noexcept
+    {
+        nextReadPosition.store (position, std::memory_order_relaxed);
+
+        // The read-ahead only moves on when the position gets to a new block so that's
+        // the only time the decode threads need waking
+        if (lastPublishedBlock.exchange (position / framesPerBlock, std::memory_order_relaxed) != position / framesPerBlock)
+            cache.workAvailable.signal();
+    }
+};
+
+//==============================================================================
+std::optional<std::pair<size_t, int64_t>> DecodedBlockCache::DecodedFile::findMostUrgentBlock()
+{
+    std::optional<std::pair<size_t, int64_t>> mostUrgent;
+    const std::scoped_lock sl (readersMutex);
+
+    for (auto r : readers)
+    {
+        const auto readPos = r->getNextReadPosition();
+
+        if (readPos < 0 || readPos >= source->lengthInSamples)
+            continue;
+
+        const auto firstBlock = (size_t) (readPos / framesPerBlock);
+        const auto lastBlock = std::min (firstBlock + (size_t) numBlocksToReadAhead, blocks.size());
+
+        for (auto i = firstBlock; i < lastBlock; ++i)
+        {
+            if (! blocks[i].isEmpty())
+                continue;
+
+            const auto numFramesUntilNeeded = std::max ((int64_t) 0, getBlockRange (i).getStart() - readPos);
+
+            if (! mostUrgent || numFramesUntilNeeded < mostUrgent->second)
+                mostUrgent = { i, numFramesUntilNeeded };
+
+            break;
+        }
+    }
+
+    return mostUrgent;
+}
+
+//==============================================================================
+//==============================================================================
+DecodedBlockCache::DecodedBlockCache (Engine& e, size_t numThreads)
+    : engine (e),
+      numThreadsToStart (numThreads != 0 ? numThreads
+                                         : (size_t) juce::jlimit (2, 8, juce::SystemStats::getNumCpus() / 2))
+{
+}
+
+DecodedBlockCache::~DecodedBlockCache()
+{
+    threadsShouldExit.store (true, std::memory_order_release);
+    workAvailable.signal ((int) threads.size());
+
+    for (auto& t : threads)
+        t.join();
+}
+
+std::unique_ptr<FallbackReader> DecodedBlockCache::createReader (const AudioFile& audioFile, const juce::File& sidecarFileToWrite)
+{
+    std::call_once (threadsStartedFlag, [this] { startThreads(); });
+
+    auto decodedFile = getOrCreateDecodedFile (audioFile);
+
+    if (decodedFile == nullptr)
+        return {};
+
+    if (sidecarFileToWrite != juce::File())
+        decodedFile->startWritingSidecar (*engine.getAudioFileFormatManager().getDecodedSidecarFormat(), sidecarFileToWrite);
+
+    // Wake the threads to decode the start of the file ready for the first read
+    auto reader = std::make_unique<Reader> (*this, std::move (decodedFile));
+    workAvailable.signal ((int) numBlocksToReadAhead);
+
+    return reader;
+}
+
+bool DecodedBlockCache::writeSidecar (const AudioFile& audioFile, const juce::File& sidecarFile)
+{
+    std::call_once (threadsStartedFlag, [this] { startThreads(); });
+
+    auto decodedFile = getOrCreateDecodedFile (audioFile);
+
+    if (decodedFile == nullptr)
+        return false;
+
+    if (decodedFile->startWritingSidecar (*engine.getAudioFileFormatManager().getDecodedSidecarFormat(), sidecarFile))
+        workAvailable.signal();
+
+    return true;
+}
+
+void DecodedBlockCache::setMaxBytes (int64_t newMaxBytes)
+{
+    maxBytes.store (newMaxBytes, std::memory_order_relaxed);
+    makeRoomFor (0, nullptr, 0);
+}
+
+//==============================================================================
+std::shared_ptr<DecodedBlockCache::DecodedFile> DecodedBlockCache::getOrCreateDecodedFile (const AudioFile& audioFile)
+{
+    const auto hash = audioFile.getHash();
+
+    {
+        const std::scoped_lock sl (filesMutex);
+        purgeUnusedFiles();
+
+        if (auto found = files.find (hash); found != files.end())
+            return found->second;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> source (AudioFileUtils::createReaderFor (engine, audioFile.getFile()));
+
+    if (source == nullptr || source->lengthInSamples <= 0)
+        return {};
+
+    const std::scoped_lock sl (filesMutex);
+    auto& fileInMap = files[hash];
+
+    if (fileInMap == nullptr)
+        fileInMap = std::make_shared<DecodedFile> (std::move (source), audioFile.getFile());
+
+    return fileInMap;
+}
+
+void DecodedBlockCache::startThreads()
+{
+    for (size_t i = 0; i < numThreadsToStart; ++i)
+        threads.emplace_back ([this] { runDecodeThread(); });
+}
+
+void DecodedBlockCache::runDecodeThread()
+{
+    juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+
+    // Re-used for each block so the files can be collected without allocating
+    std::vector<std::shared_ptr<DecodedFile>> filesToService;
+
+    for (;;)
+    {
+        if (threadsShouldExit.load (std::memory_order_acquire))
+            break;
+
+        if (decodeNextBlock (filesToService))
+            continue;
+
+        // Sleep until a reader moves in to a new block or can't find the one it needs
+        workAvailable.wait();
+    }
+}
+
+bool DecodedBlockCache::decodeNextBlock (std::vector<std::shared_ptr<DecodedFile>>& filesToService)
+{
+    // Keep the files alive whilst the block is being decoded
+    getFilesToService (filesToService);
+
+    DecodedFile* fileToDecode = nullptr;
+    size_t blockIndex = 0;
+    bool isOnlyForSidecar = false, hasWrittenSidecarBlocks = false;
+
+    // A block that's been claimed isn't empty any more, so if another thread gets to
+    // the most urgent block first, searching again finds the next one
+    for (;;)
+    {
+        fileToDecode = nullptr;
+        int64_t numFramesUntilNeeded = std::numeric_limits<int64_t>::max();
+
+        for (auto& f : filesToService)
+        {
+            if (auto block = f->findMostUrgentBlock(); block && block->second < numFramesUntilNeeded)
+            {
+                fileToDecode = f.get();
+                blockIndex = block->first;
+                numFramesUntilNeeded = block->second;
+            }
+        }
+
+        // When no reader needs a block, carry on decoding any sidecars
+        isOnlyForSidecar = fileToDecode == nullptr;
+
+        if (isOnlyForSidecar)
+        {
+            for (auto& f : filesToService)
+            {
+                if (! f->isWritingSidecar())
+                    continue;
+
+                // Blocks that have already been decoded for readers can be written first
+                if (f->writeSidecarBlocks())
+                    hasWrittenSidecarBlocks = true;
+
+                if (auto index = f->getNextSidecarBlockToDecode())
+                {
+                    fileToDecode = f.get();
+                    blockIndex = *index;
+                    break;
+                }
+            }
+        }
+
+        if (fileToDecode == nullptr)
+        {
+            filesToService.clear();
+            return hasWrittenSidecarBlocks;
+        }
+
+        if (fileToDecode->getBlock (blockIndex).tryClaimForDecoding())
+            break;
+    }
+
+    auto& block = fileToDecode->getBlock (blockIndex);
+    const auto numBytes = fileToDecode->getNumBytesForBlock (blockIndex);
+
+    if (! makeRoomFor (numBytes, fileToDecode, blockIndex))
+    {
+        // Everything else is being read so wait until a reader asks for this block again
+        block.markEmpty();
+        filesToService.clear();
+        return false;
+    }
+
+    fileToDecode->decodeBlock (blockIndex);
+
+    {
+        const std::scoped_lock sl (filesMutex);
+        residentBlocks.push_back ({ fileToDecode, blockIndex });
+        ++fileToDecode->numResidentBlocks;
+    }
+
+    block.markReady();
+
+    if (fileToDecode->isWritingSidecar())
+    {
+        fileToDecode->writeSidecarBlocks();
+
+        // Blocks no reader has asked for are the first to be evicted
+        if (isOnlyForSidecar)
+            block.lastUseTime.store (0, std::memory_order_relaxed);
+    }
+
+    filesToService.clear();
+    return true;
+}
+
+void DecodedBlockCache::getFilesToService (std::vector<std::shared_ptr<DecodedFile>>& filesToService)
+{
+    filesToService.clear();
+    const std::scoped_lock sl (filesMutex);
+
+    for (auto& [hash, f] : files)
+        if (f->hasReaders() || f->isWritingSidecar())
+            filesToService.push_back (f);
+}
+
+bool DecodedBlockCache::makeRoomFor (int64_t numBytes, const DecodedFile* fileToKeep, size_t blockIndexToKeep)
+{
+    const std::scoped_lock sl (filesMutex);
+
+    // Reserve the space up front so other threads can't use it whilst this block is decoded
+    auto fitsInBudget = [&]
+    {
+        auto current = bytesInUse.load (std::memory_order_relaxed);
+
+        while (current + numBytes <= maxBytes.load (std::memory_order_relaxed))
+            if (bytesInUse.compare_exchange_weak (current, current + numBytes, std::memory_order_relaxed))
+                return true;
+
+        return false;
+    };
+
+    if (fitsInBudget())
+        return true;
+
+    // Evict the least recently read blocks until there's enough room
+    std::vector<std::pair<uint32_t, size_t>> blocksByAge;
+    blocksByAge.reserve (residentBlocks.size());
+
+    for (size_t i = 0; i < residentBlocks.size(); ++i)
+    {
+        auto& rb = residentBlocks[i];
+
+        if (rb.file == fileToKeep && rb.blockIndex == blockIndexToKeep)
+            continue;
+
+        blocksByAge.emplace_back (rb.file->getBlock (rb.blockIndex).lastUseTime.load (std::memory_order_relaxed), i);
+    }
+
+    std::sort (blocksByAge.begin(), blocksByAge.end());
+    std::vector<bool> evicted (residentBlocks.size(), false);
+    bool hasRoom = false;
+
+    for (auto [lastUseTime, index] : blocksByAge)
+    {
+        auto& rb = residentBlocks[index];
+        auto& block = rb.file->getBlock (rb.blockIndex);
+
+        // Skip any being read right now
+        if (! block.tryClaimForEviction())
+            continue;
+
+        bytesInUse.fetch_sub (block.numBytes, std::memory_order_relaxed);
+        --rb.file->numResidentBlocks;
+        block.markEmpty();
+        evicted[index] = true;
+
+        if (fitsInBudget())
+        {
+            hasRoom = true;
+            break;
+        }
+    }
+
+    size_t index = 0;
+    std::erase_if (residentBlocks, [&] (auto&) { return evicted[index++]; });
+
+    return hasRoom;
+}
+
+void DecodedBlockCache::purgeUnusedFiles()
+{
+    // Files are kept around whilst they still have blocks so re-opening them is quick,
+    // but their sources are closed once they haven't been read for a while.
+    // Files are always kept whilst their sidecars are being written
+    const auto now = juce::Time::getMillisecondCounter();
+    constexpr uint32_t maxTimeUnusedMs = 30'000;
+
+    for (auto iter = files.begin(); iter != files.end();)
+    {
+        auto& f = iter->second;
+
+        if (f.use_count() == 1
+            && ! f->isWritingSidecar()
+            && (f->numResidentBlocks == 0 || now - f->getLastUsedTime() > maxTimeUnusedMs))
+        {
+            const auto file = f.get();
+            std::erase_if (residentBlocks, [file] (auto& rb) { return rb.file == file; });
+
+            for (size_t i = 0; i < f->getNumBlocks(); ++i)
+                if (auto& block = f->getBlock (i); ! block.isEmpty())
+                    bytesInUse.fetch_sub (block.numBytes, std::memory_order_relaxed);
+
+            iter = files.erase (iter);
+            continue;
+        }
+
+        ++iter;
+    }
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,110 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/** @internal
+    Decodes compressed files (FLAC, Ogg, MP3 etc.) in to fixed size blocks of
+    float samples on a pool of background threads.
+
+    All the readers of a file share its blocks. The blocks are held within a
+    global budget of bytes and when that's reached, the least recently read
+    blocks are evicted to make room for new ones.
+
+    Readers publish their read position and the decode threads work on the block
+    that's needed soonest by any reader, so there's no locking on the audio thread.
+    The threads are started when the first reader is created and sleep until a
+    reader moves in to a new block or finds one that isn't ready.
+
+    A file can also be written to a DecodedSidecarAudioFormat file as its blocks
+    are decoded. When no reader needs a block, the threads decode the rest of
+    the file for the sidecar so it's only decoded once.
+*/
+class DecodedBlockCache
+{
+public:
+    /** Creates a cache with a number of decode threads.
+        If numThreads is 0, a number based on the number of CPUs is used.
+        The threads aren't started until the first reader is created.
+    */
+    DecodedBlockCache (Engine&, size_t numThreads = 0);
+
+    /** Destructor. All the readers should have been deleted first. */
+    ~DecodedBlockCache();
+
+    /** Returns a reader for a file or nullptr if it can't be opened.
+        If a sidecarFileToWrite is given, the file will also be written to it.
+        @see writeSidecar
+    */
+    std::unique_ptr<FallbackReader> createReader (const AudioFile&, const juce::File& sidecarFileToWrite = {});
+
+    /** Writes a decoded copy of a file to a DecodedSidecarAudioFormat file in the background.
+        The blocks decoded for any readers are written as well, so the file is only decoded
+        once. It's written to a temporary file first and moved to sidecarFile once complete.
+        Returns false if the file can't be opened.
+    */
+    bool writeSidecar (const AudioFile&, const juce::File& sidecarFile);
+
+    //==============================================================================
+    /** Sets the maximum number of bytes the decoded blocks can use. */
+    void setMaxBytes (int64_t);
+
+    /** Returns the maximum number of bytes the decoded blocks can use. */
+    int64_t getMaxBytes() const                 { return maxBytes.load (std::memory_order_relaxed); }
+
+    /** Returns the number of bytes the decoded blocks are currently using. */
+    int64_t getBytesInUse() const               { return bytesInUse.load (std::memory_order_relaxed); }
+
+    /** The number of frames in each block. */
+    static constexpr int64_t framesPerBlock = 65'536;
+
+    /** The number of blocks ahead of each reader's position that are decoded. */
+    static constexpr int64_t numBlocksToReadAhead = 3;
+
+private:
+    struct Block;
+    class DecodedFile;
+    class Reader;
+
+    Engine& engine;
+    std::atomic<int64_t> maxBytes { 512 * 1024 * 1024 }, bytesInUse { 0 };
+
+    std::mutex filesMutex;
+    std::map<HashCode, std::shared_ptr<DecodedFile>> files;
+
+    // Only accessed with the filesMutex locked
+    struct ResidentBlock
+    {
+        DecodedFile* file = nullptr;
+        size_t blockIndex = 0;
+    };
+
+    std::vector<ResidentBlock> residentBlocks;
+
+    const size_t numThreadsToStart;
+    std::once_flag threadsStartedFlag;
+    std::vector<std::thread> threads;
+    std::atomic<bool> threadsShouldExit { false };
+    tracktion::graph::LightweightSemaphore workAvailable;
+
+    std::shared_ptr<DecodedFile> getOrCreateDecodedFile (const AudioFile&);
+    void startThreads();
+    void runDecodeThread();
+    bool decodeNextBlock (std::vector<std::shared_ptr<DecodedFile>>& filesToService);
+    void getFilesToService (std::vector<std::shared_ptr<DecodedFile>>&);
+    bool makeRoomFor (int64_t numBytes, const DecodedFile* fileToKeep, size_t blockIndexToKeep);
+    void purgeUnusedFiles();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedBlockCache)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,497 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace peak_file
+{
+    static constexpr int magic = 0x4b504b54; // "TKPK"
+    static constexpr int version = 1;
+
+    // magic, version, numChannels, numLevels, sampleRate, numSamples, sourceFileSize, sourceModificationTime
+    static constexpr size_t fixedHeaderSize = 4 * 4 + 4 * 8;
+
+    inline int16_t quantise (float v) noexcept
+    {
+        return (int16_t) juce::roundToInt (juce::jlimit (-1.0f, 1.0f, v) * 32767.0f);
+    }
+
+    inline float unquantise (int16_t v) noexcept
+    {
+        return v * (1.0f / 32767.0f);
+    }
+}
+
+//==============================================================================
+class PeakFile::BuilderJob  : public ThreadPoolJobWithProgress
+{
+public:
+    BuilderJob (Engine& e, const juce::File& f, const std::shared_ptr<PeakFile>& p)
+        : ThreadPoolJobWithProgress (TRANS("Creating peak file") + ": " + f.getFileName()),
+          engine (e), audioFile (f), peakFile (p)
+    {
+    }
+
+    ~BuilderJob() override
+    {
+        prepareForJobDeletion();
+    }
+
+    JobStatus runJob() override
+    {
+        CRASH_TRACER
+        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, audioFile));
+
+        if (reader == nullptr || reader->numChannels == 0)
+            return jobHasFinished;
+
+        const auto length = (SampleCount) reader->lengthInSamples;
+        const int blockSize = 65536;
+        juce::AudioBuffer<float> buffer ((int) reader->numChannels, blockSize);
+
+        if (auto peaks = peakFile.lock())
+            peaks->reset ((int) reader->numChannels, reader->sampleRate);
+
+        for (SampleCount pos = 0; pos < length;)
+        {
+            // Give up if nothing's using the peaks any more
+            auto peaks = peakFile.lock();
+
+            if (peaks == nullptr || shouldExit())
+                return jobHasFinished;
+
+            auto numThisTime = (int) std::min<SampleCount> (blockSize, length - pos);
+
+            if (! reader->read (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), pos, numThisTime))
+                return jobHasFinished;
+
+            peaks->addBlock (buffer, 0, numThisTime);
+            pos += numThisTime;
+            progress = (float) (pos / (double) length);
+        }
+
+        if (auto peaks = peakFile.lock())
+        {
+            peaks->finish();
+            peaks->save (engine, audioFile);
+        }
+
+        return jobHasFinished;
+    }
+
+    float getCurrentTaskProgress() override
+    {
+        return progress;
+    }
+
+private:
+    Engine& engine;
+    const juce::File audioFile;
+    std::weak_ptr<PeakFile> peakFile;
+    std::atomic<float> progress { 0.0f };
+};
+
+//==============================================================================
+PeakFile::PeakFile()
+{
+}
+
+PeakFile::~PeakFile()
+{
+}
+
+juce::File PeakFile::getFileFor (Engine& engine, const juce::File& audioFile)
+{
+    auto folder = audioFile.getParentDirectory();
+
+    if (folder.hasWriteAccess())
+        return audioFile.getSiblingFile (audioFile.getFileName() + ".tkpeaks");
+
+    return engine.getTemporaryFileManager().getThumbnailsFolder()
+             .getChildFile ("peaks_" + juce::String::toHexString (audioFile.hashCode64()) + ".tkpeaks");
+}
+
+std::shared_ptr<PeakFile> PeakFile::load (Engine& engine, const juce::File& audioFile)
+{
+    auto peaks = std::make_shared<PeakFile>();
+
+    if (peaks->loadFrom (getFileFor (engine, audioFile), audioFile))
+        return peaks;
+
+    return {};
+}
+
+std::shared_ptr<PeakFile> PeakFile::loadOrBuild (Engine& engine, const juce::File& audioFile)
+{
+    if (auto peaks = load (engine, audioFile))
+        return peaks;
+
+    auto peaks = std::make_shared<PeakFile>();
+    engine.getBackgroundJobs().addJob (new BuilderJob (engine, audioFile, peaks), true);
+
+    return peaks;
+}
+
+//==============================================================================
+void PeakFile::reset (int newNumChannels, double newSampleRate)
+{
+    const juce::ScopedLock sl (lock);
+
+    mappedLevels.clear();
+    mappedFile.reset();
+
+    levels.clear();
+    levels.reserve (maxNumLevels);
+    levels.emplace_back();
+    levels.back().accumulators.resize ((size_t) newNumChannels);
+
+    numChannels.store (newNumChannels, std::memory_order_release);
+    sampleRate.store (newSampleRate, std::memory_order_release);
+    numSamples.store (0, std::memory_order_release);
+    complete.store (false, std::memory_order_release);
+}
+
+void PeakFile::addBlock (const juce::AudioBuffer<float>& buffer, int startSample, int numSamplesToAdd)
+{
+    const juce::ScopedLock sl (lock);
+
+    const int numChans = getNumChannels();
+    const int numSourceChans = buffer.getNumChannels();
+    jassert (! isComplete() && mappedFile == nullptr);
+
+    if (levels.empty() || numChans == 0 || numSourceChans == 0)
+        return;
+
+    auto& firstLevel = levels.front();
+
+    for (int done = 0; done < numSamplesToAdd;)
+    {
+        const auto isNewPoint = firstLevel.numSamplesInAccumulators == 0;
+        const auto numThisTime = (int) std::min<SampleCount> (numSamplesToAdd - done,
+                                                              samplesPerPointAtFirstLevel - firstLevel.numSamplesInAccumulators);
+
+        for (int chan = 0; chan < numChans; ++chan)
+        {
+            auto data = buffer.getReadPointer (std::min (chan, numSourceChans - 1), startSample + done);
+            auto range = juce::FloatVectorOperations::findMinAndMax (data, numThisTime);
+            auto& acc = firstLevel.accumulators[(size_t) chan];
+
+            float sumOfSquares = 0.0f;
+
+            for (int i = 0; i < numThisTime; ++i)
+                sumOfSquares += data[i] * data[i];
+
+            if (isNewPoint)
+                acc = { range.getStart(), range.getEnd(), sumOfSquares };
+            else
+                acc = { std::min (acc.min, range.getStart()), std::max (acc.max, range.getEnd()), acc.sumOfSquares + sumOfSquares };
+        }
+
+        firstLevel.numSamplesInAccumulators += numThisTime;
+        done += numThisTime;
+
+        if (firstLevel.numSamplesInAccumulators == samplesPerPointAtFirstLevel)
+            completePoint (0, true);
+    }
+
+    numSamples.fetch_add (numSamplesToAdd, std::memory_order_release);
+}
+
+void PeakFile::finish()
+{
+    const juce::ScopedLock sl (lock);
+
+    // Any levels above one that hasn't completed a point won't exist
+    // yet and aren't needed so this only adds to the existing ones
+    for (int level = 0; level < (int) levels.size(); ++level)
+        completePoint (level, false);
+
+    complete.store (true, std::memory_order_release);
+}
+
+void PeakFile::completePoint (int level, bool createNextLevel)
+{
+    auto& l = levels[(size_t) level];
+
+    if (l.numSamplesInAccumulators == 0)
+        return;
+
+    for (auto& acc : l.accumulators)
+        l.points.push_back ({ peak_file::quantise (acc.min),
+                              peak_file::quantise (acc.max),
+                              peak_file::quantise ((float) std::sqrt (acc.sumOfSquares / (double) l.numSamplesInAccumulators)) });
+
+    const auto nextLevel = (size_t) level + 1;
+
+    if (createNextLevel && nextLevel == levels.size() && nextLevel < (size_t) maxNumLevels)
+    {
+        // The levels are reserved up front so this won't invalidate l
+        levels.emplace_back();
+        levels.back().accumulators.resize (l.accumulators.size());
+    }
+
+    if (nextLevel < levels.size())
+        addToLevel ((int) nextLevel, l.accumulators.data(), l.numSamplesInAccumulators, createNextLevel);
+
+    l.numSamplesInAccumulators = 0;
+}
+
+void PeakFile::addToLevel (int level, const Accumulator* source, SampleCount numSamplesAdded, bool createNextLevel)
+{
+    auto& l = levels[(size_t) level];
+    const auto isNewPoint = l.numSamplesInAccumulators == 0;
+
+    for (auto& acc : l.accumulators)
+    {
+        if (isNewPoint)
+            acc = *source;
+        else
+            acc = { std::min (acc.min, source->min), std::max (acc.max, source->max), acc.sumOfSquares + source->sumOfSquares };
+
+        ++source;
+    }
+
+    l.numSamplesInAccumulators += numSamplesAdded;
+
+    if (l.numSamplesInAccumulators == getSamplesPerPoint (level))
+        completePoint (level, createNextLevel);
+}
+
+//==============================================================================
+int PeakFile::getNumLevels() const
+{
+    const juce::ScopedLock sl (lock);
+    return mappedFile != nullptr ? (int) mappedLevels.size() : (int) levels.size();
+}
+
+SampleCount PeakFile::getSamplesPerPoint (int level) noexcept
+{
+    SampleCount num = samplesPerPointAtFirstLevel;
+
+    for (int i = 0; i < level; ++i)
+        num *= levelRatio;
+
+    return num;
+}
+
+std::span<const PeakFile::Point> PeakFile::getPoints (int level) const
+{
+    if (mappedFile != nullptr)
+        return mappedLevels[(size_t) level];
+
+    return levels[(size_t) level].points;
+}
+
+SampleCount PeakFile::getNumSamplesCovered (int level) const
+{
+    const auto numPoints = (SampleCount) (getPoints (level).size() / (size_t) getNumChannels());
+    return std::min (numPoints * getSamplesPerPoint (level), getNumSamples());
+}
+
+void PeakFile::addToPeak (Peak& peak, double& sumOfSquares, SampleCount& numPoints,
+                          SampleRange range, int channel, int level) const
+{
+    const auto samplesPerPoint = getSamplesPerPoint (level);
+    const auto numSamplesCovered = getNumSamplesCovered (level);
+    const auto points = getPoints (level);
+    const auto numChans = (size_t) getNumChannels();
+    const auto end = std::min (range.getEnd(), numSamplesCovered);
+
+    if (range.getStart() < end)
+    {
+        for (auto i = range.getStart() / samplesPerPoint; i <= (end - 1) / samplesPerPoint; ++i)
+        {
+            const auto& p = points[(size_t) i * numChans + (size_t) channel];
+            const auto min = peak_file::unquantise (p.min);
+            const auto max = peak_file::unquantise (p.max);
+            const auto rms = peak_file::unquantise (p.rms);
+
+            if (numPoints++ == 0)
+            {
+                peak.min = min;
+                peak.max = max;
+            }
+            else
+            {
+                peak.min = std::min (peak.min, min);
+                peak.max = std::max (peak.max, max);
+            }
+
+            sumOfSquares += rms * rms;
+        }
+    }
+
+    // Whilst the peaks are being built, the end of the range might only be covered by lower levels
+    if (range.getEnd() > numSamplesCovered && level > 0)
+        addToPeak (peak, sumOfSquares, numPoints,
+                   { std::max (range.getStart(), numSamplesCovered), range.getEnd() },
+                   channel, level - 1);
+}
+
+PeakFile::Peak PeakFile::getPeak (SampleRange range, int channel) const
+{
+    const juce::ScopedLock sl (lock);
+
+    const auto numLevels = getNumLevels();
+
+    if (numLevels == 0 || ! juce::isPositiveAndBelow (channel, getNumChannels()) || range.isEmpty())
+        return {};
+
+    // Use the coarsest level with points no larger than the range
+    int level = 0;
+
+    while (level + 1 < numLevels && getSamplesPerPoint (level + 1) <= range.getLength())
+        ++level;
+
+    Peak peak;
+    double sumOfSquares = 0.0;
+    SampleCount numPoints = 0;
+    addToPeak (peak, sumOfSquares, numPoints, range, channel, level);
+
+    if (numPoints > 0)
+        peak.rms = (float) std::sqrt (sumOfSquares / (double) numPoints);
+
+    return peak;
+}
+
+bool PeakFile::getPeaks (SampleRange range, int channel, std::span<Peak> dest) const
+{
+    const juce::ScopedLock sl (lock);
+
+    if (! juce::isPositiveAndBelow (channel, getNumChannels()))
+        return false;
+
+    const auto numSections = (SampleCount) dest.size();
+    const auto length = range.getLength();
+
+    for (SampleCount i = 0; i < numSections; ++i)
+    {
+        const auto start = range.getStart() + length * i / numSections;
+        const auto end   = range.getStart() + length * (i + 1) / numSections;
+        dest[(size_t) i] = getPeak ({ start, std::max (end, start + 1) }, channel);
+    }
+
+    return true;
+}
+
+//==============================================================================
+bool PeakFile::save (Engine& engine, const juce::File& audioFile) const
+{
+    CRASH_TRACER
+    const juce::ScopedLock sl (lock);
+
+    // The points are written as they're laid out in memory
+   #if JUCE_LITTLE_ENDIAN
+    if (! isComplete() || mappedFile != nullptr || ! audioFile.existsAsFile())
+        return false;
+
+    auto peakFile = getFileFor (engine, audioFile);
+    peakFile.getParentDirectory().createDirectory();
+
+    juce::TemporaryFile tempFile (peakFile, juce::TemporaryFile::useHiddenFile);
+
+    {
+        juce::FileOutputStream out (tempFile.getFile());
+
+        if (! out.openedOk())
+            return false;
+
+        out.writeInt (peak_file::magic);
+        out.writeInt (peak_file::version);
+        out.writeInt (getNumChannels());
+        out.writeInt ((int) levels.size());
+        out.writeDouble (getSampleRate());
+        out.writeInt64 (getNumSamples());
+        out.writeInt64 (audioFile.getSize());
+        out.writeInt64 (audioFile.getLastModificationTime().toMilliseconds());
+
+        for (auto& l : levels)
+            out.writeInt64 ((juce::int64) l.points.size());
+
+        for (auto& l : levels)
+            if (! out.write (l.points.data(), l.points.size() * sizeof (Point)))
+                return false;
+
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+   #else
+    juce::ignoreUnused (engine, audioFile);
+    return false;
+   #endif
+}
+
+bool PeakFile::loadFrom (const juce::File& peakFile, const juce::File& audioFile)
+{
+   #if JUCE_LITTLE_ENDIAN
+    if (! peakFile.existsAsFile())
+        return false;
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile> (peakFile, juce::MemoryMappedFile::readOnly);
+
+    if (mapped->getData() == nullptr || mapped->getSize() < peak_file::fixedHeaderSize)
+        return false;
+
+    juce::MemoryInputStream in (mapped->getData(), mapped->getSize(), false);
+
+    if (in.readInt() != peak_file::magic || in.readInt() != peak_file::version)
+        return false;
+
+    const auto numChans = in.readInt();
+    const auto numLevels = in.readInt();
+    const auto rate = in.readDouble();
+    const auto length = (SampleCount) in.readInt64();
+
+    if (in.readInt64() != audioFile.getSize()
+        || in.readInt64() != audioFile.getLastModificationTime().toMilliseconds())
+        return false;
+
+    if (numChans <= 0 || numLevels <= 0 || numLevels > maxNumLevels)
+        return false;
+
+    std::vector<std::span<const Point>> newLevels;
+    auto offset = peak_file::fixedHeaderSize + (size_t) numLevels * sizeof (juce::int64);
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+        const auto numPoints = (size_t) in.readInt64();
+        const auto numBytes = numPoints * sizeof (Point);
+
+        if (numPoints % (size_t) numChans != 0 || offset + numBytes > mapped->getSize())
+            return false;
+
+        newLevels.emplace_back (reinterpret_cast<const Point*> (static_cast<const char*> (mapped->getData()) + offset),
+                                numPoints);
+        offset += numBytes;
+    }
+
+    const juce::ScopedLock sl (lock);
+    levels.clear();
+    mappedFile = std::move (mapped);
+    mappedLevels = std::move (newLevels);
+
+    numChannels.store (numChans, std::memory_order_release);
+    sampleRate.store (rate, std::memory_order_release);
+    numSamples.store (length, std::memory_order_release);
+    complete.store (true, std::memory_order_release);
+
+    return true;
+   #else
+    juce::ignoreUnused (peakFile, audioFile);
+    return false;
+   #endif
+}
+
+}} // namespace tracktion { inline namespace engine
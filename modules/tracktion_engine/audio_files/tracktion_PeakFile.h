@@ -0,0 +1,158 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Holds the min, max and RMS levels of an audio file at a number of resolutions
+    so waveforms can be drawn at any zoom level without reading the whole range.
+
+    The first level has one point for every 16 samples and each level above that
+    has 16 times fewer points than the one below it. Queries use the coarsest level
+    that still has at least one point per pixel so they take time proportional to
+    the number of pixels rather than the length of the range.
+
+    These are built by streaming blocks in to addBlock, which can be done whilst
+    another thread is querying it, and can be saved to a file next to the audio
+    that's memory mapped when it's loaded again.
+*/
+class PeakFile
+{
+public:
+    /** Creates an empty PeakFile. Call reset before adding any blocks. */
+    PeakFile();
+
+    /** Destructor. */
+    ~PeakFile();
+
+    /** The number of samples each point of the first level represents. */
+    static constexpr int samplesPerPointAtFirstLevel = 16;
+
+    /** The ratio of the number of samples per point between one level and the next. */
+    static constexpr int levelRatio = 16;
+
+    /** The maximum number of levels that will be built. */
+    static constexpr int maxNumLevels = 7;
+
+    /** The levels of a section of audio. */
+    struct Peak
+    {
+        float min = 0.0f, max = 0.0f, rms = 0.0f;
+    };
+
+    //==============================================================================
+    /** Returns the file the peaks for an audio file are saved to.
+        This is next to the audio file unless its folder can't be written to, in
+        which case it's in the Engine's thumbnails folder.
+    */
+    static juce::File getFileFor (Engine&, const juce::File& audioFile);
+
+    /** Loads the peaks for an audio file if they've been saved and are up to date.
+        Returns nullptr if there isn't a valid peak file.
+    */
+    static std::shared_ptr<PeakFile> load (Engine&, const juce::File& audioFile);
+
+    /** Loads the peaks for an audio file or, if they haven't been saved, returns
+        an empty PeakFile and starts building and saving it on a background thread.
+        Use isComplete to find out when it's been built.
+    */
+    static std::shared_ptr<PeakFile> loadOrBuild (Engine&, const juce::File& audioFile);
+
+    //==============================================================================
+    /** Clears the levels, ready to add blocks to. */
+    void reset (int numChannels, double sampleRate);
+
+    /** Adds the next block of samples. */
+    void addBlock (const juce::AudioBuffer<float>&, int startSample, int numSamples);
+
+    /** Adds any samples that don't yet make up a whole point to the end of each
+        level. Call this when all of the audio has been added.
+    */
+    void finish();
+
+    /** Saves the peaks for an audio file.
+        This should only be called once the PeakFile has been finished and
+        all of the audio file's samples have been added.
+    */
+    bool save (Engine&, const juce::File& audioFile) const;
+
+    //==============================================================================
+    /** Returns true if finish has been called or this was loaded from a file. */
+    bool isComplete() const noexcept                    { return complete.load (std::memory_order_acquire); }
+
+    int getNumChannels() const noexcept                 { return numChannels.load (std::memory_order_acquire); }
+    double getSampleRate() const noexcept               { return sampleRate.load (std::memory_order_acquire); }
+
+    /** Returns the number of samples that have been added. */
+    SampleCount getNumSamples() const noexcept          { return numSamples.load (std::memory_order_acquire); }
+
+    /** Returns the number of levels there currently are. */
+    int getNumLevels() const;
+
+    /** Returns the number of samples each point in a level represents. */
+    static SampleCount getSamplesPerPoint (int level) noexcept;
+
+    //==============================================================================
+    /** Returns the levels of a range of samples in a channel.
+        This will be slightly wider than the range as it's made up of whole points.
+    */
+    Peak getPeak (SampleRange, int channel) const;
+
+    /** Fills a span with the levels of a range of samples in a channel, split in
+        to equal sections, e.g. one for each pixel of a waveform.
+        Returns false if the channel doesn't exist.
+    */
+    bool getPeaks (SampleRange, int channel, std::span<Peak> dest) const;
+
+private:
+    //==============================================================================
+    struct Point
+    {
+        int16_t min, max, rms;
+    };
+
+    struct Accumulator
+    {
+        float min = 0.0f, max = 0.0f;
+        double sumOfSquares = 0.0;
+    };
+
+    struct Level
+    {
+        std::vector<Point> points;                 // Interleaved by channel
+        std::vector<Accumulator> accumulators;     // One per channel
+        SampleCount numSamplesInAccumulators = 0;
+    };
+
+    mutable juce::CriticalSection lock;
+    std::vector<Level> levels;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    std::vector<std::span<const Point>> mappedLevels;
+
+    std::atomic<int> numChannels { 0 };
+    std::atomic<double> sampleRate { 0.0 };
+    std::atomic<SampleCount> numSamples { 0 };
+    std::atomic<bool> complete { false };
+
+    class BuilderJob;
+
+    std::span<const Point> getPoints (int level) const;
+    SampleCount getNumSamplesCovered (int level) const;
+    void addToPeak (Peak&, double& sumOfSquares, SampleCount& numPoints, SampleRange, int channel, int level) const;
+    void addToLevel (int level, const Accumulator*, SampleCount numSamplesAdded, bool createNextLevel);
+    void completePoint (int level, bool createNextLevel);
+    bool loadFrom (const juce::File& peakFile, const juce::File& audioFile);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PeakFile)
+};
+
+}} // namespace tracktion { inline namespace engine
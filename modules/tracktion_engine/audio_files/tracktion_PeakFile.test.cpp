@@ -0,0 +1,168 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PEAK_FILE
+
+//==============================================================================
+//==============================================================================
+class PeakFileTests : public juce::UnitTest
+{
+public:
+    PeakFileTests()
+        : juce::UnitTest ("PeakFile", "tracktion_engine")
+    {
+    }
+
+    void runTest() override
+    {
+        runLevelTest();
+        runSaveAndLoadTest();
+    }
+
+private:
+    static PeakFile::Peak getExpectedPeak (const juce::AudioBuffer<float>& buffer, SampleRange range, int channel)
+    {
+        auto data = buffer.getReadPointer (channel, (int) range.getStart());
+        auto minMax = juce::FloatVectorOperations::findMinAndMax (data, (int) range.getLength());
+        double sumOfSquares = 0.0;
+
+        for (int i = 0; i < (int) range.getLength(); ++i)
+            sumOfSquares += data[i] * data[i];
+
+        return { minMax.getStart(), minMax.getEnd(), (float) std::sqrt (sumOfSquares / (double) range.getLength()) };
+    }
+
+    void expectPeak (PeakFile::Peak actual, PeakFile::Peak expected)
+    {
+        expectWithinAbsoluteError (actual.min, expected.min, 0.001f);
+        expectWithinAbsoluteError (actual.max, expected.max, 0.001f);
+        expectWithinAbsoluteError (actual.rms, expected.rms, 0.001f);
+    }
+
+    void runLevelTest()
+    {
+        const int numSamples = 100'000;
+        juce::AudioBuffer<float> buffer (2, numSamples);
+        juce::Random r (42);
+
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (chan, i, (r.nextFloat() * 2.0f - 1.0f) * (0.25f + 0.75f * i / (float) numSamples));
+
+        PeakFile peaks;
+        peaks.reset (2, 44100.0);
+
+        for (int i = 0; i < numSamples;)
+        {
+            const auto numThisTime = std::min (numSamples - i, 997);
+            peaks.addBlock (buffer, i, numThisTime);
+            i += numThisTime;
+        }
+
+        beginTest ("Peaks whilst building");
+        {
+            expect (! peaks.isComplete());
+            expectEquals<SampleCount> (peaks.getNumSamples(), numSamples);
+            expectEquals (peaks.getNumLevels(), 5);
+
+            // Ranges aligned to the points of the level used should match exactly
+            const SampleRange alignedRange (4096 * 3, 4096 * 7);
+            expectPeak (peaks.getPeak (alignedRange, 0), getExpectedPeak (buffer, alignedRange, 0));
+            expectPeak (peaks.getPeak (alignedRange, 1), getExpectedPeak (buffer, alignedRange, 1));
+
+            // The end of the buffer is only covered by the lower levels so far
+            const SampleRange endRange (90'000, numSamples);
+            auto peak = peaks.getPeak (endRange, 1);
+            auto expected = getExpectedPeak (buffer, endRange.withStart (90'000 / 4096 * 4096), 1);
+            expectWithinAbsoluteError (peak.min, expected.min, 0.001f);
+            expectWithinAbsoluteError (peak.max, expected.max, 0.001f);
+        }
+
+        peaks.finish();
+
+        beginTest ("Peaks when finished");
+        {
+            expect (peaks.isComplete());
+            expectEquals<SampleCount> (peaks.getNumSamples(), numSamples);
+
+            const SampleRange wholeRange (0, numSamples);
+            auto peak = peaks.getPeak (wholeRange, 0);
+            auto expected = getExpectedPeak (buffer, wholeRange, 0);
+            expectWithinAbsoluteError (peak.min, expected.min, 0.001f);
+            expectWithinAbsoluteError (peak.max, expected.max, 0.001f);
+
+            std::vector<PeakFile::Peak> pixels (100);
+            expect (peaks.getPeaks (wholeRange, 1, pixels));
+            expect (! peaks.getPeaks (wholeRange, 2, pixels));
+
+            for (size_t i = 0; i < pixels.size(); ++i)
+            {
+                const SampleRange pixelRange ((SampleCount) i * 1000, (SampleCount) (i + 1) * 1000);
+                auto pixelExpected = getExpectedPeak (buffer, pixelRange, 1);
+                expect (pixels[i].min <= pixelExpected.min + 0.001f);
+                expect (pixels[i].max >= pixelExpected.max - 0.001f);
+            }
+        }
+    }
+
+    void runSaveAndLoadTest()
+    {
+        auto& engine = *Engine::getEngines().getFirst();
+
+        using namespace graph::test_utilities;
+        auto tempFile = getSquareFile<juce::WavAudioFormat> (44100.0, 5.0, 2);
+        const auto audioFile = tempFile->getFile();
+
+        auto reader = std::unique_ptr<juce::AudioFormatReader> (AudioFileUtils::createReaderFor (engine, audioFile));
+        juce::AudioBuffer<float> buffer ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+
+        PeakFile built;
+        built.reset (buffer.getNumChannels(), reader->sampleRate);
+        built.addBlock (buffer, 0, buffer.getNumSamples());
+        built.finish();
+
+        beginTest ("Save and load peaks");
+        {
+            expect (built.save (engine, audioFile));
+            auto loaded = PeakFile::load (engine, audioFile);
+            expect (loaded != nullptr);
+
+            if (loaded != nullptr)
+            {
+                expect (loaded->isComplete());
+                expectEquals (loaded->getNumChannels(), built.getNumChannels());
+                expectEquals (loaded->getNumLevels(), built.getNumLevels());
+                expectEquals<SampleCount> (loaded->getNumSamples(), built.getNumSamples());
+
+                for (auto range : { SampleRange (0, 1000), SampleRange (12'345, 67'890), SampleRange (0, buffer.getNumSamples()) })
+                    for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                        expectPeak (loaded->getPeak (range, chan), built.getPeak (range, chan));
+            }
+        }
+
+        beginTest ("Stale peaks aren't loaded");
+        {
+            audioFile.setLastModificationTime (audioFile.getLastModificationTime() + juce::RelativeTime::seconds (10.0));
+            expect (PeakFile::load (engine, audioFile) == nullptr);
+        }
+
+        PeakFile::getFileFor (engine, audioFile).deleteFile();
+    }
+};
+
+static PeakFileTests peakFileTests;
+
+#endif
+
+}} // namespace tracktion { inline namespace engine
@@ -29,6 +29,7 @@ public:
 
         Engine& engine;             /**< The Engine instance this belongs to. */
         const std::unique_ptr<juce::AudioThumbnailBase> thumb;  /**< The thumbnail. */
+        const std::shared_ptr<PeakFile> peaks;  /**< The peaks of the recorded audio, updated as it's recorded. */
         juce::File file;            /**< The file this thumbnail represents. */
         const HashCode hash;        /**< A hash uniquely identifying this thumbnail. */
         TimePosition punchInTime;   /**< The time the start of this thumbnail represents. */
@@ -44,6 +45,7 @@ public:
         void reset (int numChannels, double sampleRate)
         {
             thumb->reset (numChannels, sampleRate, 0);
+            peaks->reset (numChannels, sampleRate);
             nextSampleNum = 0;
         }
 
@@ -53,9 +55,28 @@ public:
         void addBlock (const juce::AudioBuffer<float>& incoming, int startOffsetInBuffer, int numSamples)
         {
             thumb->addBlock (nextSampleNum, incoming, startOffsetInBuffer, numSamples);
+            peaks->addBlock (incoming, startOffsetInBuffer, numSamples);
             nextSampleNum += numSamples;
         }
 
+        /** Saves the peaks built whilst recording so the file doesn't need to be
+            scanned again to draw it. Call this once the file has been closed.
+        */
+        void savePeakFile()
+        {
+            if (! engine.getUIBehaviour().shouldCreatePeakFiles())
+                return;
+
+            std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, file));
+
+            // If the last blocks didn't make it in to the peaks, they'll be built from the file instead
+            if (reader != nullptr && reader->lengthInSamples == peaks->getNumSamples())
+            {
+                peaks->finish();
+                peaks->save (engine, file);
+            }
+        }
+
     private:
         friend class RecordingThumbnailManager;
         std::atomic<int64_t> nextSampleNum { 0 };
@@ -64,6 +85,7 @@ public:
             : engine (e),
               thumb (engine.getUIBehaviour().createAudioThumbnail (1024, engine.getAudioFileFormatManager().readFormatManager,
                                                                    engine.getAudioFileManager().getAudioThumbnailCache())),
+              peaks (std::make_shared<PeakFile>()),
               file (f), hash (f.hashCode64())
         {
             TRACKTION_ASSERT_MESSAGE_THREAD
@@ -70,6 +70,13 @@ public:
     void drawChannels (juce::Graphics&, juce::Rectangle<int>,
                        TimeRange, float verticalZoomFactor);
 
+    /** Fills a span with the min, max and RMS levels of a time range in a channel,
+        split in to equal sections, e.g. one for each pixel of a waveform.
+        This reads from the file's PeakFile so takes the same time at any zoom level.
+        Returns false if the PeakFile hasn't been loaded or built yet.
+    */
+    bool getPeaks (TimeRange, int channelNum, std::span<PeakFile::Peak>) const;
+
     /** Returns the proportion of the thumbnail that has been generated. */
     double getProportionComplete() const noexcept;
 
@@ -119,6 +126,7 @@ public:
 private:
     //==============================================================================
     std::unique_ptr<juce::AudioThumbnailBase> thumbnail;
+    std::shared_ptr<PeakFile> peaks;
     juce::Component& component;
     bool wasGeneratingProxy = false;
     std::atomic<bool> thumbnailIsInvalid { true };
@@ -749,8 +749,10 @@ void ExternalController::userMovedParameterControl (int paramNumber, float newVa
 {
     if (auto p = currentParams[paramNumber])
     {
+        // Relative moves are set straight away so the next one starts from the new value
         if (delta)
-            p->midiControllerMoved (std::clamp (p->getCurrentNormalisedValue() + newValue, 0.0f, 1.0f));
+            p->setParameter (p->snapToState (p->valueRange.convertFrom0to1 (std::clamp (p->getCurrentNormalisedValue() + newValue, 0.0f, 1.0f))),
+                             juce::sendNotification);
         else
             p->midiControllerMoved (newValue);
     }
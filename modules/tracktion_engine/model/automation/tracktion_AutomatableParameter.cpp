@@ -192,11 +192,27 @@ public:
         CRASH_TRACER
         TRACKTION_ASSERT_MESSAGE_THREAD
 
+        auto snapshot = curve.createSnapshot();
+        auto oldSnapshot = snapshot;
+
+        {
+            // Swap so the old snapshot is released outside the lock
+            const std::scoped_lock sl (snapshotLock);
+            std::swap (curveSnapshot, oldSnapshot);
+        }
+
+        // Other threads may still be using old snapshots so keep them until they've finished
+        // with them, otherwise the last reference could be dropped on the audio thread
+        std::erase_if (retiredSnapshots, [] (auto& s) { return s.use_count() == 1; });
+
+        if (oldSnapshot != nullptr)
+            retiredSnapshots.push_back (std::move (oldSnapshot));
+
         std::unique_ptr<AutomationIterator> newStream;
 
-        if (curve.getNumPoints() > 0)
+        if (snapshot->getNumPoints() > 0)
         {
-            auto s = std::make_unique<AutomationIterator> (parameter);
+            auto s = std::make_unique<AutomationIterator> (parameter, snapshot);
 
             if (! s->isEmpty())
                 newStream = std::move (s);
@@ -232,12 +248,16 @@ public:
         return true;
     }
 
+    std::shared_ptr<const AutomationCurve::Snapshot> getSnapshot() const
+    {
+        const std::scoped_lock sl (snapshotLock);
+        return curveSnapshot;
+    }
+
     void setPosition (TimePosition time) override
     {
-        if (! parameter.getEdit().getAutomationRecordManager().isReadingAutomation())
-            if (auto plugin = parameter.getPlugin())
-                if (! plugin->isClipEffectPlugin())
-                    return;
+        if (! shouldFollowCurve())
+            return;
 
         const juce::ScopedLock sl (parameterStreamLock);
 
@@ -245,6 +265,20 @@ public:
             parameterStream->setPosition (time);
     }
 
+    bool getValues (TimeRange range, float* dest, int numSamples)
+    {
+        if (! (isActive() && shouldFollowCurve()))
+            return false;
+
+        const juce::ScopedLock sl (parameterStreamLock);
+
+        if (parameterStream == nullptr)
+            return false;
+
+        parameterStream->getValues (range, dest, numSamples);
+        return true;
+    }
+
     bool isEnabled() override
     {
         return true;
@@ -266,6 +300,20 @@ private:
     std::atomic<bool> automationActive { false };
     std::atomic<TimePosition> lastTime { TimePosition::fromSeconds (-1.0) };
 
+    mutable RealTimeSpinLock snapshotLock;
+    std::shared_ptr<const AutomationCurve::Snapshot> curveSnapshot;
+    std::vector<std::shared_ptr<const AutomationCurve::Snapshot>> retiredSnapshots;
+
+    bool shouldFollowCurve() const
+    {
+        if (! parameter.getEdit().getAutomationRecordManager().isReadingAutomation())
+            if (auto plugin = parameter.getPlugin())
+                if (! plugin->isClipEffectPlugin())
+                    return false;
+
+        return true;
+    }
+
     static juce::ValueTree getState (AutomatableParameter& ap)
     {
         auto v = ap.parentState.getChildWithProperty (IDs::paramID, ap.paramID);
@@ -804,6 +852,19 @@ bool AutomatableParameter::isAutomationActive() const
     return curveSource->isActive() || getAutomationSourceList().isActive();
 }
 
+bool AutomatableParameter::getValues (TimeRange editTime, float* dest, int numSamples) const
+{
+    if (numSamples <= 0 || ! curveSource->getValues (editTime, dest, numSamples))
+        return false;
+
+    // Modifiers are only updated once per block so are applied as an offset
+    if (const float modifierValue = currentModifierValue; modifierValue != 0.0f)
+        juce::FloatVectorOperations::add (dest, modifierValue, numSamples);
+
+    juce::FloatVectorOperations::clip (dest, dest, valueRange.start, valueRange.end, numSamples);
+    return true;
+}
+
 std::optional<float> AutomatableParameter::getDefaultValue() const
 {
     if (attachedValue != nullptr)
@@ -968,6 +1029,11 @@ AutomationCurve& AutomatableParameter::getCurve() const noexcept
     return curveSource->curve;
 }
 
+std::shared_ptr<const AutomationCurve::Snapshot> AutomatableParameter::getCurveSnapshot() const
+{
+    return curveSource->getSnapshot();
+}
+
 Selectable* AutomatableParameter::getOwnerSelectable() const
 {
     if (macroOwner != nullptr)
@@ -1030,7 +1096,6 @@ void AutomatableParameter::resetRecordingStatus()
 //==============================================================================
 void AutomatableParameter::setParameterValue (float value, bool isFollowingCurve)
 {
-    auto& curve = getCurve();
     value = snapToState (getValueRange().clipValue (value));
     currentBaseValue = value;
 
@@ -1057,34 +1122,7 @@ void AutomatableParameter::setParameterValue (float value, bool isFollowingCurve
             if (! getEdit().isLoading())
                 jassert (juce::MessageManager::getInstance()->currentThreadHasLockedMessageManager());
 
-            curveHasChanged();
-
-            if (auto epc = ed.getTransport().getCurrentPlaybackContext())
-            {
-                if (! epc->isDragging())
-                {
-                    auto numPoints = curve.getNumPoints();
-                    auto& arm = ed.getAutomationRecordManager();
-
-                    if (epc->isPlaying() && arm.isWritingAutomation())
-                    {
-                        auto time = epc->getPosition();
-
-                        if (! isRecording)
-                        {
-                            isRecording = true;
-                            arm.postFirstAutomationChange (*this, currentValue);
-                        }
-
-                        arm.postAutomationChange (*this, time, value);
-                    }
-                    else
-                    {
-                        if (numPoints == 1)
-                            curve.movePoint (0, curve.getPointTime (0), value, false);
-                    }
-                }
-            }
+            updateCurveForUserChange (currentValue, value);
 
             currentValue = value;
 
@@ -1102,6 +1140,41 @@ void AutomatableParameter::setParameterValue (float value, bool isFollowingCurve
     }
 }
 
+void AutomatableParameter::updateCurveForUserChange (float previousValue, float newValue)
+{
+    curveHasChanged();
+
+    auto& ed = getEdit();
+
+    if (auto epc = ed.getTransport().getCurrentPlaybackContext())
+    {
+        if (! epc->isDragging())
+        {
+            auto& curve = getCurve();
+            auto numPoints = curve.getNumPoints();
+            auto& arm = ed.getAutomationRecordManager();
+
+            if (epc->isPlaying() && arm.isWritingAutomation())
+            {
+                auto time = epc->getPosition();
+
+                if (! isRecording)
+                {
+                    isRecording = true;
+                    arm.postFirstAutomationChange (*this, previousValue);
+                }
+
+                arm.postAutomationChange (*this, time, newValue);
+            }
+            else
+            {
+                if (numPoints == 1)
+                    curve.movePoint (0, curve.getPointTime (0), newValue, false);
+            }
+        }
+    }
+}
+
 void AutomatableParameter::setParameter (float value, juce::NotificationType nt)
 {
     currentParameterValue = value;
@@ -1126,6 +1199,54 @@ void AutomatableParameter::setNormalisedParameter (float value, juce::Notificati
     setParameter (valueRange.convertFrom0to1 (juce::jlimit (0.0f, 1.0f, value)), nt);
 }
 
+void AutomatableParameter::setParameterFromAudioThread (float value)
+{
+    // Remember the value a run of changes started from so any automation recorded starts there
+    if (! hasQueuedChangesToCommit.load (std::memory_order_acquire))
+        valueBeforeQueuedChanges = currentValue.load();
+
+    currentParameterValue = value;
+    value = snapToState (getValueRange().clipValue (value));
+    currentBaseValue = value;
+
+    if (currentModifierValue != 0.0f)
+        value = snapToState (getValueRange().clipValue (value + currentModifierValue));
+
+    if (currentValue != value)
+    {
+        parameterChanged (value, true);
+        currentValue = value;
+    }
+
+    hasQueuedChangesToCommit.store (true, std::memory_order_release);
+
+    {
+        SCOPED_REALTIME_CHECK
+        queuedChangesCommitter.triggerAsyncUpdate();
+    }
+}
+
+void AutomatableParameter::commitQueuedChanges()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (! hasQueuedChangesToCommit.exchange (false, std::memory_order_acq_rel))
+        return;
+
+    // Apply the changes in the same way as setParameter so they're recorded and can be undone
+    const float value = currentValue;
+    updateCurveForUserChange (valueBeforeQueuedChanges, value);
+
+    if (attachedValue != nullptr)
+    {
+        attachedValue->cancelPendingUpdate();
+        attachedValue->setValue (value);
+    }
+
+    listeners.call (&Listener::parameterChanged, *this, value);
+    listeners.call (&Listener::currentValueChanged, *this);
+}
+
 juce::String AutomatableParameter::getCurrentValueAsStringWithLabel()
 {
     auto text = getCurrentValueAsString();
@@ -1197,7 +1318,7 @@ void AutomatableParameter::parameterChangeGestureEnd()
 //==============================================================================
 void AutomatableParameter::midiControllerMoved (float newPosition)
 {
-    setParameter (snapToState (valueRange.convertFrom0to1 (newPosition)), juce::sendNotification);
+    setParameterFromController (snapToState (valueRange.convertFrom0to1 (newPosition)));
 }
 
 void AutomatableParameter::midiControllerPressed()
@@ -1209,10 +1330,21 @@ void AutomatableParameter::midiControllerPressed()
         if (state >= getNumberOfStates())
             state = 0;
 
-        setParameter (getValueForState (state), juce::sendNotification);
+        setParameterFromController (getValueForState (state));
     }
 }
 
+void AutomatableParameter::setParameterFromController (float value)
+{
+    // Whilst the plugin's being played, its PluginNode applies the change at the point in
+    // the block it was made. Otherwise, or if the queue's full, it's set straight away
+    if (plugin != nullptr && ! plugin->baseClassNeedsInitialising()
+         && plugin->getParameterChangeQueue().post (*this, value))
+        return;
+
+    setParameter (value, juce::sendNotification);
+}
+
 //==============================================================================
 void AutomatableParameter::curveHasChanged()
 {
@@ -1269,25 +1401,28 @@ AutomatableParameter* getParameter (AutomatableParameter::ModifierAssignment& as
 
 //==============================================================================
 AutomationIterator::AutomationIterator (const AutomatableParameter& p)
+    : AutomationIterator (p, p.getCurve().createSnapshot())
+{
+}
+
+AutomationIterator::AutomationIterator (const AutomatableParameter& p, std::shared_ptr<const AutomationCurve::Snapshot> snapshot)
 {
+    jassert (snapshot != nullptr);
     hiRes = ! p.automatableEditElement.edit.engine.getEngineBehaviour().interpolateAutomation();
 
     if (hiRes)
-        copy (p);
+        copy (*snapshot);
     else
-        interpolate (p);
+        interpolate (p, std::move (snapshot));
 }
 
-void AutomationIterator::copy (const AutomatableParameter& param)
+void AutomationIterator::copy (const AutomationCurve::Snapshot& snapshot)
 {
-    const auto& curve = param.getCurve();
-
-    jassert (curve.getNumPoints() > 0);
+    jassert (snapshot.getNumPoints() > 0);
+    points.ensureStorageAllocated (snapshot.getNumPoints());
 
-    for (int i = 0; i < curve.getNumPoints(); i++)
+    for (auto& src : snapshot.getPoints())
     {
-        auto src = curve.getPoint (i);
-
         AutoPoint dst;
         dst.time = src.time;
         dst.value = src.value;
@@ -1297,87 +1432,33 @@ void AutomationIterator::copy (const AutomatableParameter& param)
     }
 }
 
-void AutomationIterator::interpolate (const AutomatableParameter& param)
+void AutomationIterator::interpolate (const AutomatableParameter& param, std::shared_ptr<const AutomationCurve::Snapshot> snapshot)
 {
-    const auto& curve = param.getCurve();
-
-    jassert (curve.getNumPoints() > 0);
+    const auto numPoints = snapshot->getNumPoints();
+    jassert (numPoints > 0);
 
     const auto timeDelta        = TimeDuration::fromSeconds (1.0 / 100.0);
     const double minValueDelta  = (param.getValueRange().getLength()) / 256.0;
+    const auto lastTime         = snapshot->getPoint (numPoints - 1).time + TimeDuration::fromSeconds (1.0);
 
+    // The times only ever increase so the cursor just steps through the points
+    AutomationCurve::Snapshot::Cursor cursor (snapshot);
     int curveIndex = 0;
     int lastCurveIndex = -1;
     TimePosition t;
     float lastValue = 1.0e10;
-    auto lastTime = curve.getPointTime (curve.getNumPoints() - 1) + TimeDuration::fromSeconds (1.0);
-    TimePosition t1;
-    auto t2 = curve.getPointTime (0);
-    float v1 = curve.getValueAt (TimePosition());
-    float v2 = v1;
-    float vp = v2;
-    float c  = 0;
-    CurvePoint bp;
-    double x1end = 0;
-    double x2end = 0;
-    float y1end = 0;
-    float y2end = 0;
+    float vp = snapshot->getPoint (0).value;
 
     while (t < lastTime)
     {
-        while (t >= t2)
-        {
-            if (curveIndex >= curve.getNumPoints() - 1)
-            {
-                t1 = t2;
-                v1 = v2;
-                t2 = lastTime;
-                break;
-            }
-
-            t1 = t2;
-            v1 = v2;
-            c  = curve.getPointCurve (curveIndex);
-
-            if (c != 0.0f)
-            {
-                bp = curve.getBezierPoint (curveIndex);
-
-                if (c < -0.5 || c > 0.5)
-                    curve.getBezierEnds (curveIndex, x1end, y1end, x2end, y2end);
-            }
+        // This is the index of the point that ends the current segment
+        while (curveIndex < numPoints - 1 && snapshot->getPoint (curveIndex).time <= t)
+            ++curveIndex;
 
-            t2 = curve.getPointTime (++curveIndex);
-            v2 = curve.getPointValue (curveIndex);
-        }
-
-        float v = v2;
-
-        if (t2 != t1)
-        {
-            if (c == 0.0f)
-            {
-                v = v1 + (v2 - v1) * (float) ((t - t1) / (t2 - t1));
-            }
-            else if (c >= -0.5 && c <= 0.5)
-            {
-                v = AutomationCurve::getBezierYFromX (t.inSeconds(), t1.inSeconds(), v1, toTime (bp.time, param.getEdit().tempoSequence).inSeconds(), bp.value, t2.inSeconds(), v2);
-            }
-            else
-            {
-                if (t >= t1 && t <= TimePosition::fromSeconds (x1end))
-                    v = v1;
-                else if (t >= TimePosition::fromSeconds (x2end) && t <= t2)
-                    v = v2;
-                else
-                    v = AutomationCurve::getBezierYFromX (t.inSeconds(), x1end, y1end, toTime (bp.time, param.getEdit().tempoSequence).inSeconds(), bp.value, x2end, y2end);
-            }
-        }
+        const auto v = cursor.getValueAt (t);
 
         if (std::abs (v - lastValue) >= minValueDelta || curveIndex != lastCurveIndex)
         {
-            jassert (t >= t1 && t <= t2);
-
             AutoPoint point;
             point.time = t;
             point.value = v;
@@ -1410,24 +1491,20 @@ void AutomationIterator::setPositionHiRes (TimePosition newTime) noexcept
 {
     jassert (points.size() > 0);
 
-    auto newIndex = updateIndex (newTime);
+    currentIndex = updateIndex (newTime);
+    currentValue = getHiResValue (currentIndex, newTime);
+}
 
+float AutomationIterator::getHiResValue (int index, TimePosition newTime) const noexcept
+{
     if (newTime < points[0].time)
-    {
-        currentIndex = newIndex;
-        currentValue = points.getReference (0).value;
-        return;
-    }
+        return points.getReference (0).value;
 
-    if (newIndex == points.size() - 1)
-    {
-        currentIndex = newIndex;
-        currentValue = points.getReference (newIndex).value;
-        return;
-    }
+    if (index == points.size() - 1)
+        return points.getReference (index).value;
 
-    const auto& p1 = points.getReference (newIndex);
-    const auto& p2 = points.getReference (newIndex + 1);
+    const auto& p1 = points.getReference (index);
+    const auto& p2 = points.getReference (index + 1);
 
     const auto t = newTime;
 
@@ -1471,8 +1548,8 @@ void AutomationIterator::setPositionHiRes (TimePosition newTime) noexcept
                 v = float (getBezierYFromX (t.inSeconds(), x1end, y1end, bp.first, bp.second, x2end, y2end));
         }
     }
-    currentIndex = newIndex;
-    currentValue = v;
+
+    return v;
 }
 
 void AutomationIterator::setPositionInterpolated (TimePosition newTime) noexcept
@@ -1505,10 +1582,101 @@ void AutomationIterator::setPositionInterpolated (TimePosition newTime) noexcept
     }
 }
 
+void AutomationIterator::getValues (TimeRange range, float* dest, int numSamples) const noexcept
+{
+    jassert (points.size() > 0);
+
+    if (numSamples <= 0)
+        return;
+
+    // Curved segments are evaluated at this interval and ramped between
+    constexpr int curveStepSize = 16;
+
+    const auto startTime = range.getStart();
+    const auto secondsPerSample = range.getLength().inSeconds() / numSamples;
+    const auto lastIndex = points.size() - 1;
+
+    auto getSampleTime = [&] (int sample)
+    {
+        return startTime + TimeDuration::fromSeconds (secondsPerSample * sample);
+    };
+
+    // Returns the first sample after the given time
+    auto getEndSample = [&] (int sample, TimePosition endTime)
+    {
+        if (secondsPerSample <= 0.0)
+            return numSamples;
+
+        const auto end = (int) std::floor ((endTime - startTime).inSeconds() / secondsPerSample) + 1;
+        return std::clamp (end, sample + 1, numSamples);
+    };
+
+    auto fillRamp = [] (float* d, int num, float start, float delta) noexcept
+    {
+        // This is kept simple so it can be vectorised
+        for (int i = 0; i < num; ++i)
+            d[i] = start + delta * (float) i;
+    };
+
+    for (int i = 0, index = currentIndex; i < numSamples;)
+    {
+        const auto t = getSampleTime (i);
+        index = findIndex (t, index);
+
+        if (t < points.getReference (0).time)
+        {
+            const auto end = getEndSample (i, points.getReference (0).time);
+            juce::FloatVectorOperations::fill (dest + i, points.getReference (0).value, end - i);
+            i = end;
+            continue;
+        }
+
+        if (index == lastIndex)
+        {
+            juce::FloatVectorOperations::fill (dest + i, points.getReference (index).value, numSamples - i);
+            break;
+        }
+
+        const auto& p1 = points.getReference (index);
+        const auto& p2 = points.getReference (index + 1);
+        const auto end = getEndSample (i, p2.time);
+        const auto num = end - i;
+
+        if (p2.time <= p1.time)
+        {
+            juce::FloatVectorOperations::fill (dest + i, p2.value, num);
+        }
+        else if (! hiRes || p1.curve == 0.0f)
+        {
+            const auto slope = (p2.value - p1.value) / (p2.time - p1.time).inSeconds();
+            fillRamp (dest + i, num,
+                      (float) (p1.value + slope * (t - p1.time).inSeconds()),
+                      (float) (slope * secondsPerSample));
+        }
+        else
+        {
+            auto v1 = getHiResValue (index, t);
+
+            for (int j = 0; j < num; j += curveStepSize)
+            {
+                const auto numThisTime = std::min (curveStepSize, num - j);
+                const auto v2 = getHiResValue (index, std::min (getSampleTime (i + j + numThisTime), p2.time));
+                fillRamp (dest + i + j, numThisTime, v1, (v2 - v1) / (float) numThisTime);
+                v1 = v2;
+            }
+        }
+
+        i = end;
+    }
+}
+
 int AutomationIterator::updateIndex (TimePosition newTime)
 {
-    auto newIndex = currentIndex;
+    return findIndex (newTime, currentIndex);
+}
 
+int AutomationIterator::findIndex (TimePosition newTime, int newIndex) const noexcept
+{
     if (! juce::isPositiveAndBelow (newIndex, points.size()))
         newIndex = 0;
 
@@ -1527,6 +1695,26 @@ int AutomationIterator::updateIndex (TimePosition newTime)
     return newIndex;
 }
 
+//==============================================================================
+void AutomationValueBuffer::prepare (int maxBlockSize)
+{
+    values.resize ((size_t) std::max (0, maxBlockSize));
+    followingCurve = false;
+}
+
+bool AutomationValueBuffer::fill (const AutomatableParameter& param, const PluginRenderContext& pc)
+{
+    numSamples = pc.bufferNumSamples;
+    followingCurve = pc.isPlaying && ! pc.isScrubbing
+                      && numSamples <= (int) values.size()
+                      && param.getValues (pc.editTime, values.data(), numSamples);
+
+    if (! followingCurve)
+        constantValue = param.getCurrentValue();
+
+    return followingCurve;
+}
+
 //==============================================================================
 const char* AutomationDragDropTarget::automatableDragString = "automatableParamDrag";
 
@@ -39,6 +39,13 @@ public:
 
     AutomationCurve& getCurve() const noexcept;
 
+    /** Returns the most recent immutable snapshot of the curve.
+        This can be called from any thread. A new snapshot is published shortly
+        after the curve changes, so this may briefly lag behind getCurve().
+        Returns nullptr if the Edit hasn't finished loading yet.
+    */
+    std::shared_ptr<const AutomationCurve::Snapshot> getCurveSnapshot() const;
+
     void attachToCurrentValue (juce::CachedValue<float>&);
     void attachToCurrentValue (juce::CachedValue<int>&);
     void attachToCurrentValue (juce::CachedValue<bool>&);
@@ -81,6 +88,14 @@ public:
     // should be called to change a parameter when a user is actively moving it
     void setParameter (float value, juce::NotificationType);
     void setNormalisedParameter (float value, juce::NotificationType);
+
+    /** Sets the explicit value of the parameter from the audio thread.
+        The new value is used straight away. The curve, automation recording, the
+        ValueTree state (with undo) and the Listener::parameterChanged callback are
+        then updated on the message thread, in the same way as setParameter.
+        @see ParameterChangeQueue
+    */
+    void setParameterFromAudioThread (float value);
     void updateToFollowCurve (TimePosition);
 
     /** Call to indicate this parameter is about to be changed. */
@@ -169,6 +184,16 @@ public:
     /** Updates the parameter and modifier values from its current automation sources. */
     void updateFromAutomationSources (TimePosition);
 
+    /** Fills a buffer with the value of the parameter at each sample in a range of the Edit.
+        This follows the automation curve sample-accurately, rather than giving the single
+        value per block of getCurrentValue. Modifiers are still only evaluated once per block.
+        Returns false, leaving the buffer untouched, if the parameter isn't currently
+        following an automation curve.
+        This should only be called from the audio thread.
+        @see AutomationValueBuffer
+    */
+    bool getValues (TimeRange editTime, float* dest, int numSamples) const;
+
     //==============================================================================
     virtual bool isParameterActive() const                          { return true; }
     virtual bool isDiscrete() const                                 { return false; }
@@ -190,7 +215,8 @@ public:
     void resetRecordingStatus();
 
     //==============================================================================
-    // called by ParameterControlMappings
+    // called by ParameterControlMappings and control surfaces.
+    // If the plugin is being played, these post the change to its ParameterChangeQueue
     void midiControllerMoved (float newPosition);
     void midiControllerPressed();
 
@@ -244,6 +270,10 @@ protected:
     bool updateParametersRecursionCheck = false;
     AsyncCaller parameterChangedCaller { [this] { listeners.call (&Listener::currentValueChanged, *this); } };
 
+    std::atomic<float> valueBeforeQueuedChanges { 0.0f };
+    std::atomic<bool> hasQueuedChangesToCommit { false };
+    AsyncCaller queuedChangesCommitter { [this] { commitQueuedChanges(); } };
+
     juce::ValueTree modifiersState;
     struct AutomationSourceList;
     mutable std::unique_ptr<AutomationSourceList> automationSourceList;
@@ -251,6 +281,9 @@ protected:
     AutomationSourceList& getAutomationSourceList() const;
 
     void setParameterValue (float value, bool isFollowingCurve);
+    void updateCurveForUserChange (float previousValue, float newValue);
+    void setParameterFromController (float value);
+    void commitQueuedChanges();
 
     void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
     void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override;
@@ -397,15 +430,27 @@ struct AutomationIterator
 {
     AutomationIterator (const AutomatableParameter&);
 
+    /** Creates an iterator for a snapshot of the parameter's curve.
+        This doesn't read the curve's ValueTree so is quicker than the other constructor.
+    */
+    AutomationIterator (const AutomatableParameter&, std::shared_ptr<const AutomationCurve::Snapshot>);
+
     bool isEmpty() const noexcept               { return points.size() <= 1; }
 
     void setPosition (TimePosition) noexcept;
     float getCurrentValue() noexcept            { return currentValue; }
 
+    /** Fills a buffer with the value at each sample in a range, without moving the current position.
+        Straight segments are filled as ramps and curved ones are evaluated every few samples.
+    */
+    void getValues (TimeRange, float* dest, int numSamples) const noexcept;
+
 private:
-    void interpolate (const AutomatableParameter&);
-    void copy (const AutomatableParameter&);
+    void interpolate (const AutomatableParameter&, std::shared_ptr<const AutomationCurve::Snapshot>);
+    void copy (const AutomationCurve::Snapshot&);
     int updateIndex (TimePosition newTime);
+    int findIndex (TimePosition newTime, int startIndex) const noexcept;
+    float getHiResValue (int index, TimePosition) const noexcept;
 
     void setPositionHiRes (TimePosition newTime) noexcept;
     void setPositionInterpolated (TimePosition newTime) noexcept;
@@ -425,4 +470,52 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomationIterator)
 };
 
+//==============================================================================
+/**
+    Holds the values of an AutomatableParameter for each sample of a block.
+
+    Internal plugins can use this to follow automation curves within a block,
+    rather than using the single value per block that getCurrentValue gives, so
+    large blocks can be rendered without the parameter's value stepping.
+*/
+class AutomationValueBuffer
+{
+public:
+    AutomationValueBuffer() = default;
+
+    /** The number of samples that plugins should update their coefficients over
+        whilst a parameter is changing.
+    */
+    static constexpr int subBlockSize = 32;
+
+    /** Allocates space for the values. Call this from Plugin::initialise. */
+    void prepare (int maxBlockSize);
+
+    /** Fills the buffer with the parameter's values for the block being rendered.
+        If the parameter isn't following a curve, the transport isn't playing or
+        the block is bigger than the prepared size, the parameter's current value
+        is used for the whole block.
+        Returns true if the values were filled from the curve, so may change over the block.
+    */
+    bool fill (const AutomatableParameter&, const PluginRenderContext&);
+
+    /** Returns true if the last block was filled from an automation curve. */
+    bool isFollowingCurve() const noexcept          { return followingCurve; }
+
+    /** Returns the value at a sample of the last block filled. */
+    float operator[] (int index) const noexcept
+    {
+        jassert (! followingCurve || juce::isPositiveAndBelow (index, numSamples));
+        return followingCurve ? values[(size_t) index] : constantValue;
+    }
+
+private:
+    std::vector<float> values;
+    int numSamples = 0;
+    float constantValue = 0.0f;
+    bool followingCurve = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomationValueBuffer)
+};
+
 }} // namespace tracktion { inline namespace engine
@@ -93,24 +93,39 @@ float AutomationCurve::getPointCurve (int index) const noexcept
     return state.getChild (index).getProperty (IDs::c);
 }
 
+// The points are kept in time order so can be binary searched
 int AutomationCurve::indexBefore (TimePosition t) const
 {
-    for (int i = getNumPoints(); --i >= 0;)
-        if (getPointTime (i) <= t)
-            return i;
+    int start = 0, end = getNumPoints();
+
+    while (start < end)
+    {
+        const auto mid = start + (end - start) / 2;
 
-    return -1;
+        if (getPointTime (mid) <= t)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    return start - 1;
 }
 
 int AutomationCurve::nextIndexAfter (TimePosition t) const
 {
-    auto num = getNumPoints();
+    int start = 0, end = getNumPoints();
 
-    for (int i = 0; i < num; ++i)
-        if (getPointTime (i) >= t)
-            return i;
+    while (start < end)
+    {
+        const auto mid = start + (end - start) / 2;
 
-    return num;
+        if (getPointTime (mid) < t)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    return start;
 }
 
 TimeDuration AutomationCurve::getLength() const
@@ -171,6 +186,117 @@ float AutomationCurve::getValueAt (TimePosition timePos) const
     return getBezierYFromX (time, x1, y1, toTime (bezierPoint.time, getOwnerParameter()->getEdit().tempoSequence).inSeconds(), bezierPoint.value, x2, y2);
 }
 
+//==============================================================================
+AutomationCurve::Snapshot::Snapshot (std::vector<AutomationPoint> newPoints)
+    : points (std::move (newPoints))
+{
+    std::stable_sort (points.begin(), points.end());
+}
+
+int AutomationCurve::Snapshot::indexBefore (TimePosition t) const noexcept
+{
+    auto found = std::upper_bound (points.begin(), points.end(), t,
+                                   [] (TimePosition time, const AutomationPoint& p) { return time < p.time; });
+    return (int) std::distance (points.begin(), found) - 1;
+}
+
+int AutomationCurve::Snapshot::nextIndexAfter (TimePosition t) const noexcept
+{
+    auto found = std::lower_bound (points.begin(), points.end(), t,
+                                   [] (const AutomationPoint& p, TimePosition time) { return p.time < time; });
+    return (int) std::distance (points.begin(), found);
+}
+
+float AutomationCurve::Snapshot::getValueAt (TimePosition t) const noexcept
+{
+    return getValueAt (nextIndexAfter (t), t);
+}
+
+float AutomationCurve::Snapshot::getValueAt (int nextIndex, TimePosition timePos) const noexcept
+{
+    if (points.empty())
+        return 0.0f;
+
+    if (nextIndex <= 0)
+        return points.front().value;
+
+    if (nextIndex >= getNumPoints())
+        return points.back().value;
+
+    // This matches AutomationCurve::getValueAt
+    const auto& p1 = points[(size_t) nextIndex - 1];
+    const auto& p2 = points[(size_t) nextIndex];
+
+    const auto time = timePos.inSeconds();
+    const auto time1 = p1.time.inSeconds();
+    const auto time2 = p2.time.inSeconds();
+
+    if (p1.curve == 0.0f)
+    {
+        auto alpha = (float) ((time - time1) / (time2 - time1));
+        return p1.value + alpha * (p2.value - p1.value);
+    }
+
+    if (p1.curve >= -0.5f && p1.curve <= 0.5f)
+    {
+        auto bp = core::getBezierPoint (time1, p1.value, time2, p2.value, juce::jlimit (-1.0, 1.0, p1.curve * 2.0));
+        return (float) core::getBezierYFromX (time, time1, p1.value, bp.first, bp.second, time2, p2.value);
+    }
+
+    double x1, y1, x2, y2;
+    core::getBezierEnds (time1, p1.value, time2, p2.value, p1.curve, x1, y1, x2, y2);
+
+    if (time >= time1 && time <= x1)
+        return p1.value;
+
+    if (time >= x2 && time <= time2)
+        return p2.value;
+
+    auto bp = core::getBezierPoint (time1, p1.value, time2, p2.value, juce::jlimit (-1.0, 1.0, p1.curve * 2.0));
+    return (float) core::getBezierYFromX (time, x1, y1, bp.first, bp.second, x2, y2);
+}
+
+AutomationCurve::Snapshot::Cursor::Cursor (std::shared_ptr<const Snapshot> s)
+    : snapshot (std::move (s))
+{
+    jassert (snapshot != nullptr);
+}
+
+float AutomationCurve::Snapshot::Cursor::getValueAt (TimePosition t) noexcept
+{
+    const auto& points = snapshot->points;
+    const auto numPoints = (int) points.size();
+
+    // Moves the cursor a few points if it can, otherwise jumps with a binary search
+    constexpr int maxStepsToSearch = 8;
+    int numSteps = 0;
+
+    while (nextIndex < numPoints && points[(size_t) nextIndex].time < t && ++numSteps <= maxStepsToSearch)
+        ++nextIndex;
+
+    while (nextIndex > 0 && points[(size_t) nextIndex - 1].time >= t && ++numSteps <= maxStepsToSearch)
+        --nextIndex;
+
+    if (numSteps > maxStepsToSearch)
+        nextIndex = snapshot->nextIndexAfter (t);
+
+    return snapshot->getValueAt (nextIndex, t);
+}
+
+std::shared_ptr<const AutomationCurve::Snapshot> AutomationCurve::createSnapshot() const
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    std::vector<AutomationPoint> points;
+    points.reserve ((size_t) getNumPoints());
+
+    for (const auto& v : state)
+        points.emplace_back (TimePosition::fromSeconds (static_cast<double> (v.getProperty (IDs::t))),
+                             v.getProperty (IDs::v), v.getProperty (IDs::c));
+
+    return std::make_shared<const Snapshot> (std::move (points));
+}
+
+//==============================================================================
 static double getDistanceFromLine (double& x, double& y,
                                    double x1, double y1,
                                    double x2, double y2)
@@ -278,13 +404,9 @@ juce::ValueTree AutomationCurve::AutomationPoint::toValueTree() const
 
 int AutomationCurve::addPoint (TimePosition time, float value, float curve)
 {
-    int i;
-    for (i = getNumPoints(); --i >= 0;)
-        if (getPointTime (i) <= time)
-            break;
-
-    addPointAtIndex (++i, time, value, curve);
-    return i;
+    const auto index = indexBefore (time) + 1;
+    addPointAtIndex (index, time, value, curve);
+    return index;
 }
 
 void AutomationCurve::addPointAtIndex (int index, TimePosition time, float value, float curve)
@@ -396,15 +518,13 @@ void AutomationCurve::clear()
 juce::Array<AutomationCurve::AutomationPoint> AutomationCurve::getPointsInRegion (TimeRange range) const
 {
     juce::Array<AutomationPoint> results;
-    auto numPoints = getNumPoints();
+    const auto end = nextIndexAfter (range.getEnd());
 
-    for (int i = 0; i < numPoints; ++i)
+    for (int i = nextIndexAfter (range.getStart()); i < end; ++i)
     {
         auto v = state.getChild (i);
-        auto t = TimePosition::fromSeconds (static_cast<double> (v.getProperty (IDs::t)));
-
-        if (range.contains (t))
-            results.add (AutomationPoint (t, v.getProperty (IDs::v), v.getProperty (IDs::c)));
+        results.add (AutomationPoint (TimePosition::fromSeconds (static_cast<double> (v.getProperty (IDs::t))),
+                                      v.getProperty (IDs::v), v.getProperty (IDs::c)));
     }
 
     return results;
@@ -504,20 +624,7 @@ void AutomationCurve::removeRegionAndCloseGap (TimeRange range)
 
 int AutomationCurve::countPointsInRegion (TimeRange range) const
 {
-    int num = 0;
-
-    for (int i = getNumPoints(); --i >= 0;)
-    {
-        auto t = getPointTime(i);
-
-        if (t < range.getStart())
-            break;
-
-        if (t < range.getEnd())
-            ++num;
-    }
-
-    return num;
+    return std::max (0, nextIndexAfter (range.getEnd()) - nextIndexAfter (range.getStart()));
 }
 
 void AutomationCurve::mergeOtherCurve (const AutomationCurve& source,
@@ -590,41 +697,69 @@ void AutomationCurve::simplify (TimeRange range, double minTimeDifference, float
     auto minDist = std::sqrt (minTimeDifference * minTimeDifference
                                 + minValueDifference * minValueDifference);
 
-    for (int i = 1; i < getNumPoints(); ++i)
+    auto isInLine = [minDist] (const AutomationPoint& p1, const AutomationPoint& p2, const AutomationPoint& p3)
     {
-        auto time2 = getPointTime (i);
+        double x = p2.time.inSeconds();
+        double y = p2.value;
+
+        return getDistanceFromLine (x, y, p1.time.inSeconds(), p1.value,
+                                    p3.time.inSeconds(), p3.value) < minDist;
+    };
+
+    // The points to keep are found in one pass over a flat copy of the curve. When a point is
+    // added, the ones kept before it are checked again as they have a new neighbour, so each
+    // point is only added and removed from the kept list once
+    const auto snapshot = createSnapshot();
+    const auto& points = snapshot->getPoints();
+    std::vector<size_t> keptIndexes;
+    keptIndexes.reserve (points.size());
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const auto& p3 = points[i];
 
-        if (range.contains (time2))
+        // see if the last two points kept are in-line with this one
+        while (keptIndexes.size() >= 2)
         {
-            auto time1 = getPointTime (i - 1);
+            const auto& p2 = points[keptIndexes.back()];
 
-            // look for points too close together
-            if (std::abs ((time1 - time2).inSeconds()) < minTimeDifference
-                 && std::abs (getPointValue (i - 1) - getPointValue (i)) < minValueDifference)
-            {
-                removePoint (i);
-                i = std::max (i - 3, 1);
-            }
-            else
-            {
-                // see if three points are in-line
-                if (i < getNumPoints() - 1)
-                {
-                    double x = time2.inSeconds();
-                    double y = getPointValue (i);
+            if (! range.contains (p2.time) || ! isInLine (points[keptIndexes[keptIndexes.size() - 2]], p2, p3))
+                break;
 
-                    auto dist = getDistanceFromLine (x, y, time1.inSeconds(), getPointValue (i - 1),
-                                                     getPointTime (i + 1).inSeconds(), getPointValue (i + 1));
+            keptIndexes.pop_back();
+        }
 
-                    if (dist < minDist)
-                    {
-                        removePoint (i);
-                        i = std::max (i - 3, 1);
-                    }
-                }
-            }
+        // look for points too close together
+        if (! keptIndexes.empty() && range.contains (p3.time))
+        {
+            const auto& p1 = points[keptIndexes.back()];
+
+            if (std::abs ((p1.time - p3.time).inSeconds()) < minTimeDifference
+                 && std::abs (p1.value - p3.value) < minValueDifference)
+                continue;
         }
+
+        keptIndexes.push_back (i);
     }
+
+    if (keptIndexes.size() == points.size())
+        return;
+
+    // Removing children from the middle of the state one at a time is quadratic so
+    // the kept points are removed and re-added in order instead
+    std::vector<juce::ValueTree> keptPoints;
+    keptPoints.reserve (keptIndexes.size());
+
+    for (auto index : keptIndexes)
+        keptPoints.push_back (state.getChild ((int) index));
+
+    auto um = getUndoManager();
+    state.removeAllChildren (um);
+
+    for (auto& v : keptPoints)
+        state.appendChild (v, um);
+
+    checkParenthoodStatus();
 }
 
 void AutomationCurve::addToAllTimes (TimeDuration delta)
@@ -45,6 +45,67 @@ public:
         bool operator< (const AutomationPoint& other) const     { return time < other.time; }
     };
 
+    //==============================================================================
+    /**
+        An immutable, flat copy of a curve's points, sorted by time.
+
+        Points are found with a binary search so values can be evaluated in O(log n),
+        or in amortised constant time with a Cursor when moving through the curve.
+        As it doesn't refer to the curve's ValueTree, it can be used on any thread.
+        @see createSnapshot, AutomatableParameter::getCurveSnapshot
+    */
+    class Snapshot
+    {
+    public:
+        /** Creates a snapshot of some points, which will be sorted by time. */
+        explicit Snapshot (std::vector<AutomationPoint>);
+
+        int getNumPoints() const noexcept                                   { return (int) points.size(); }
+        const AutomationPoint& getPoint (int index) const noexcept          { return points[(size_t) index]; }
+        const std::vector<AutomationPoint>& getPoints() const noexcept      { return points; }
+
+        /** Returns the index of the last point at or before a time, or -1 if there isn't one. */
+        int indexBefore (TimePosition) const noexcept;
+
+        /** Returns the index of the first point at or after a time, or the number of points if there isn't one. */
+        int nextIndexAfter (TimePosition) const noexcept;
+
+        /** Returns the value of the curve at a time, or 0 if there aren't any points. */
+        float getValueAt (TimePosition) const noexcept;
+
+        //==============================================================================
+        /** Evaluates a Snapshot without searching the whole of it each time, for
+            when the times being evaluated are close together, e.g. when playing.
+        */
+        class Cursor
+        {
+        public:
+            /** Creates a Cursor for a snapshot, which it keeps a reference to. */
+            Cursor (std::shared_ptr<const Snapshot>);
+
+            /** Returns the value of the curve at a time, moving the cursor there. */
+            float getValueAt (TimePosition) noexcept;
+
+            /** Returns the snapshot being evaluated. */
+            const Snapshot& getSnapshot() const noexcept                    { return *snapshot; }
+
+        private:
+            std::shared_ptr<const Snapshot> snapshot;
+            int nextIndex = 0;
+        };
+
+    private:
+        std::vector<AutomationPoint> points;
+
+        float getValueAt (int nextIndex, TimePosition) const noexcept;
+    };
+
+    /** Creates a Snapshot of the curve's current points.
+        This reads the ValueTree so must be called from the message thread, but the
+        snapshot returned can then be used on any thread.
+    */
+    std::shared_ptr<const Snapshot> createSnapshot() const;
+
     //==============================================================================
     int getNumPoints() const noexcept;
     TimeDuration getLength() const;
@@ -0,0 +1,83 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+ParameterChangeQueue::ParameterChangeQueue (uint32_t capacity)
+    : mask ((uint32_t) juce::nextPowerOfTwo ((int) std::max (capacity, 2u)) - 1)
+{
+    slots = std::make_unique<Slot[]> (getCapacity());
+
+    for (uint32_t i = 0; i <= mask; ++i)
+        slots[i].sequence.store (i, std::memory_order_relaxed);
+}
+
+double ParameterChangeQueue::getCurrentTime() const
+{
+    if (clock)
+        return clock();
+
+    return juce::Time::getMillisecondCounterHiRes() * 0.001;
+}
+
+void ParameterChangeQueue::setClock (std::function<double()> newClock)
+{
+    clock = std::move (newClock);
+}
+
+//==============================================================================
+bool ParameterChangeQueue::post (AutomatableParameter& parameter, float value, double time) noexcept
+{
+    auto position = writePosition.load (std::memory_order_relaxed);
+
+    for (;;)
+    {
+        auto& slot = slots[position & mask];
+        const auto diff = static_cast<int32_t> (slot.sequence.load (std::memory_order_acquire) - position);
+
+        if (diff == 0)
+        {
+            if (writePosition.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+            {
+                slot.event = { &parameter, value, time };
+                slot.sequence.store (position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The reader hasn't got to this slot yet so the queue is full
+            numDroppedEvents.fetch_add (1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = writePosition.load (std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ParameterChangeQueue::pop (Event& result) noexcept
+{
+    auto& slot = slots[readPosition & mask];
+
+    if (static_cast<int32_t> (slot.sequence.load (std::memory_order_acquire) - (readPosition + 1)) < 0)
+        return false;
+
+    result = std::move (slot.event);
+    slot.event.parameter = nullptr;
+    slot.sequence.store (readPosition + mask + 1, std::memory_order_release);
+    ++readPosition;
+
+    return true;
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,109 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    A lock-free queue of timestamped parameter changes, to be applied on the audio thread.
+
+    Control surfaces, MIDI controllers or the UI can post changes from any thread
+    without waiting for the message thread or taking any locks. Plugins create one
+    of these when it's first needed and their PluginNode empties it every block,
+    setting the parameters at the sample positions within the block that match
+    their timestamps. AutomatableParameter::midiControllerMoved, which is used by
+    MIDI learn mappings and control surfaces, posts here whilst the plugin is being
+    played. The changes are then recorded as automation and added to the undo
+    history on the message thread.
+
+    Timestamps are in seconds, on the same clock as getCurrentTime(). By default
+    this is the juce::Time::getMillisecondCounterHiRes clock used for incoming MIDI.
+
+    The queue is a fixed size and never allocates after construction. If it fills
+    up, e.g. because the plugin isn't being played, post() will return false and
+    the change won't be applied so callers should fall back to
+    AutomatableParameter::setParameter on the message thread.
+*/
+class ParameterChangeQueue
+{
+public:
+    /** Creates a queue able to hold a number of events.
+        This will be rounded up to the next power of two.
+    */
+    explicit ParameterChangeQueue (uint32_t capacity = 1024);
+
+    /** Destructor. */
+    ~ParameterChangeQueue() = default;
+
+    //==============================================================================
+    /** A change to a parameter. */
+    struct Event
+    {
+        AutomatableParameter::Ptr parameter;    /**< The parameter to change. */
+        float value = 0.0f;                     /**< The new value, in the parameter's range. */
+        double time = 0.0;                      /**< The time the change was made, @see getCurrentTime. */
+    };
+
+    /** Returns the current time on the clock that events are timestamped with. */
+    double getCurrentTime() const;
+
+    /** Replaces the clock used to timestamp events, e.g. to use a MIDI driver's timestamps.
+        This must return seconds and be safe to call from the audio thread. It isn't
+        thread safe so should be set before any events are posted.
+    */
+    void setClock (std::function<double()>);
+
+    //==============================================================================
+    /** Adds a change to the queue to be applied on the audio thread.
+        This is lock-free and can be called from any number of threads at once.
+        Returns false if the queue is full, in which case the change will be lost.
+    */
+    bool post (AutomatableParameter&, float value, double time) noexcept;
+
+    /** Adds a change to the queue, timestamped with the current time. */
+    bool post (AutomatableParameter& parameter, float value)    { return post (parameter, value, getCurrentTime()); }
+
+    //==============================================================================
+    /** Removes the oldest event from the queue, returning false if it's empty.
+        This must only be called from one thread at a time, usually the audio thread.
+    */
+    bool pop (Event&) noexcept;
+
+    /** Returns the maximum number of events the queue can hold. */
+    uint32_t getCapacity() const noexcept                       { return mask + 1; }
+
+    /** Returns the number of events that couldn't be posted because the queue was full. */
+    uint32_t getNumDroppedEvents() const noexcept               { return numDroppedEvents.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    // Each slot's sequence number says whether it's free for the writer at that position
+    // or holds an event for the reader, so writers only contend on the write position
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence { 0 };
+        Event event;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    const uint32_t mask;
+    alignas(64) std::atomic<uint32_t> writePosition { 0 };
+    alignas(64) uint32_t readPosition = 0;
+    std::atomic<uint32_t> numDroppedEvents { 0 };
+    std::function<double()> clock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterChangeQueue)
+};
+
+}} // namespace tracktion { inline namespace engine
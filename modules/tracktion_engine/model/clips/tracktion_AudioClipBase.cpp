@@ -119,6 +119,35 @@ private:
     AudioFile original;
     std::unique_ptr<AudioClipBase::ProxyRenderingInfo> proxyInfo;
 
+    std::optional<ChunkedRenderFormat> getChunkedRenderFormat() override
+    {
+        // Only time-stretched renders can start part way through, a plain copy is limited by decoding anyway
+        if (proxyInfo == nullptr || ! original.isValid())
+            return {};
+
+        AudioFileInfo sourceInfo (original.getInfo());
+
+        ChunkedRenderFormat f;
+        f.sampleRate = sourceInfo.sampleRate;
+        f.numChannels = sourceInfo.numChannels;
+        f.bitsPerSample = std::max (16, sourceInfo.bitsPerSample);
+        f.lengthInSamples = proxyInfo->getRenderLength (sourceInfo.sampleRate);
+        f.preRollSamples = (SampleCount) sourceInfo.sampleRate;
+        f.chunkAlignment = AudioClipBase::ProxyRenderingInfo::samplesPerBlock;
+
+        // need to strip AIFF metadata to write to wav files
+        if (sourceInfo.metadata.getValue ("MetaDataSource", "None") != "AIFF")
+            f.metadata = sourceInfo.metadata;
+
+        return f;
+    }
+
+    bool renderChunk (SampleRange range, juce::AudioBuffer<float>& dest) override
+    {
+        juce::ThreadPoolJob* job = this;
+        return proxyInfo->renderSection (engine, original, range, dest, job);
+    }
+
     bool render() override
     {
         CRASH_TRACER
@@ -1909,11 +1938,17 @@ struct StretchSegment
 {
     static constexpr int maxNumChannels = 8;
 
+    /** Creates a segment to render.
+        If startOutputSample is greater than 0, this starts that many output samples
+        in to the segment, as if the earlier part had already been rendered.
+    */
     StretchSegment (Engine& engine, const AudioFile& file,
                     const AudioClipBase::ProxyRenderingInfo& info,
-                    double sampleRate, const AudioSegmentList::Segment& s)
+                    double sampleRate, const AudioSegmentList::Segment& s,
+                    SampleCount startOutputSample = 0)
         : segment (s),
           fileInfo (file.getInfo()),
+          readySampleOutputPos (startOutputSample),
           crossfadeSamples ((int) tracktion::toSamples (info.audioSegmentList->getCrossfadeLength(), sampleRate)),
           numChannelsToUse (juce::jlimit (1, maxNumChannels, fileInfo.numChannels))
     {
@@ -1923,15 +1958,16 @@ struct StretchSegment
         if (reader != nullptr)
         {
             auto sampleRange = segment.getSampleRange();
+            const auto startSourceSample = (SampleCount) (startOutputSample * segment.getStretchRatio());
 
             if (segment.isFollowedBySilence())
             {
-                reader->setReadPosition (sampleRange.getStart());
+                reader->setReadPosition (sampleRange.getStart() + startSourceSample);
             }
             else
             {
                 reader->setLoopRange (sampleRange);
-                reader->setReadPosition (0);
+                reader->setReadPosition (startSourceSample);
             }
 
             timestretcher.initialise (fileInfo.sampleRate, outputBufferSize, numChannelsToUse,
@@ -2097,7 +2133,7 @@ struct StretchSegment
 
     const int outputBufferSize = 1024;
     int readySamplesStart = 0, readySamplesEnd = 0;
-    SampleCount readySampleOutputPos = 0;
+    SampleCount readySampleOutputPos;
     const int crossfadeSamples, numChannelsToUse;
     juce::AudioBuffer<float> fifo { numChannelsToUse, outputBufferSize };
 
@@ -2134,11 +2170,10 @@ bool AudioClipBase::ProxyRenderingInfo::render (Engine& engine, const AudioFile&
     for (auto& segment : audioSegmentList->getSegments())
         segments.add (new StretchSegment (engine, sourceFile, *this, sampleRate, segment));
 
-    const int samplesPerBlock = 1024;
     juce::AudioBuffer<float> buffer (sourceFile.getNumChannels(), samplesPerBlock);
     double time = 0.0;
 
-    auto numBlocks = 1 + (int) (clipTime.getLength().inSeconds() * sampleRate / samplesPerBlock);
+    auto numBlocks = (int) (getRenderLength (sampleRate) / samplesPerBlock);
 
     for (int i = 0; i < numBlocks; ++i)
     {
@@ -2163,6 +2198,67 @@ bool AudioClipBase::ProxyRenderingInfo::render (Engine& engine, const AudioFile&
     return true;
 }
 
+SampleCount AudioClipBase::ProxyRenderingInfo::getRenderLength (double sampleRate) const
+{
+    return (1 + (SampleCount) (clipTime.getLength().inSeconds() * sampleRate / samplesPerBlock)) * samplesPerBlock;
+}
+
+bool AudioClipBase::ProxyRenderingInfo::renderSection (Engine& engine, const AudioFile& sourceFile, SampleRange range,
+                                                       juce::AudioBuffer<float>& dest, juce::ThreadPoolJob* const& job) const
+{
+    CRASH_TRACER
+    jassert (range.getStart() % samplesPerBlock == 0);
+    jassert (dest.getNumSamples() >= range.getLength());
+
+    if (audioSegmentList->getSegments().isEmpty() || ! sourceFile.isValid())
+        return false;
+
+    auto sampleRate = sourceFile.getSampleRate();
+    const auto startTime = TimePosition::fromSamples (range.getStart(), sampleRate);
+
+    // Segments that have already started are begun part way through
+    juce::OwnedArray<StretchSegment> segments;
+
+    for (auto& segment : audioSegmentList->getSegments())
+    {
+        const auto segmentRange = segment.getRange();
+
+        if (segmentRange.getEnd() <= startTime)
+            continue;
+
+        const auto startOutputSample = segmentRange.getStart() < startTime
+                                        ? toSamples (startTime - segmentRange.getStart(), sampleRate)
+                                        : SampleCount();
+
+        segments.add (new StretchSegment (engine, sourceFile, *this, sampleRate, segment, startOutputSample));
+    }
+
+    juce::AudioBuffer<float> buffer (sourceFile.getNumChannels(), samplesPerBlock);
+    dest.clear();
+
+    for (auto pos = range.getStart(); pos < range.getEnd(); pos += samplesPerBlock)
+    {
+        if (job != nullptr && job->shouldExit())
+            return false;
+
+        buffer.clear();
+
+        // Use the same times as a full render so the blocks line up
+        const auto editTime = TimeRange (TimePosition::fromSeconds (pos / sampleRate),
+                                         TimePosition::fromSeconds ((pos + samplesPerBlock) / sampleRate));
+
+        for (auto s : segments)
+            s->renderNextBlock (buffer, editTime, samplesPerBlock);
+
+        const auto numToCopy = (int) std::min ((SampleCount) samplesPerBlock, range.getEnd() - pos);
+
+        for (int i = 0; i < std::min (dest.getNumChannels(), buffer.getNumChannels()); ++i)
+            dest.copyFrom (i, (int) (pos - range.getStart()), buffer, i, 0, numToCopy);
+    }
+
+    return true;
+}
+
 AudioFile AudioClipBase::getPlaybackFile()
 {
     // this needs to return the same file right from the first call, if it's a rendered file then obviously it won't exist but we need to return it anyway
@@ -2305,7 +2401,7 @@ void AudioClipBase::timerCallback()
 
     const bool proxyChanged = lastProxy != newProxy;
 
-    if (proxyChanged || ! newProxy.getFile().exists())
+    if (proxyChanged || ! newProxy.getFile().exists() || AudioProxyGenerator::hasIncompleteRender (newProxy))
     {
         if (proxyChanged
              && lastProxy != originalFile
@@ -449,6 +449,18 @@ public:
         /** Renders this audio segment list to an AudioFile. */
         bool render (Engine&, const AudioFile&, AudioFileWriter&, juce::ThreadPoolJob* const&, std::atomic<float>& progress) const;
 
+        /** Returns the number of samples render() will write. */
+        SampleCount getRenderLength (double sampleRate) const;
+
+        /** Renders a section of the output independently of any other section.
+            The start of the range should be a multiple of samplesPerBlock so the
+            segments are processed in the same blocks as a full render.
+        */
+        bool renderSection (Engine&, const AudioFile&, SampleRange, juce::AudioBuffer<float>&, juce::ThreadPoolJob* const&) const;
+
+        /** The block size segments are rendered in. */
+        static constexpr int samplesPerBlock = 1024;
+
     private:
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProxyRenderingInfo)
     };
@@ -0,0 +1,496 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace binary_edit_file
+{
+    // The file starts with the magic number and version, then the sections, then
+    // the table of contents. It ends with the offset of the table and the magic number again
+    static constexpr int64_t headerSize = 8;
+    static constexpr int64_t footerSize = 12;
+
+    /** Sections that can't contain other sections, so don't need searching. */
+    static bool canContainSections (const juce::Identifier& type)
+    {
+        return ! (type == IDs::SEQUENCE || type == IDs::AUTOMATIONCURVE);
+    }
+
+    static void writePlaceholder (juce::OutputStream& os, const juce::String& key)
+    {
+        os.writeString (IDs::BINARYSECTION.toString());
+        os.writeCompressedInt (1);
+        os.writeString (IDs::key.toString());
+        juce::var (key).writeToStream (os);
+        os.writeCompressedInt (0);
+    }
+
+    struct PendingSection
+    {
+        juce::ValueTree tree;
+        juce::String key;
+    };
+
+    /** Collects the sections found whilst writing, skipping any with duplicate keys. */
+    struct SectionCollector
+    {
+        std::vector<PendingSection>& pending;
+        std::unordered_set<juce::String>& usedKeys;
+        bool hadDuplicateKeys = false;
+
+        bool add (const juce::ValueTree& v, const juce::String& key)
+        {
+            if (usedKeys.insert (key).second)
+            {
+                pending.push_back ({ v, key });
+                return true;
+            }
+
+            hadDuplicateKeys = true;
+            return false;
+        }
+    };
+
+    /** Writes a tree in the same format as juce::ValueTree::writeToStream, but with
+        any sub-sections replaced by placeholders.
+    */
+    static void writeTree (juce::OutputStream& os, const juce::ValueTree& v, bool isSectionRoot, SectionCollector& collector)
+    {
+        if (! isSectionRoot)
+        {
+            if (auto key = BinaryEditFile::getSectionKeyFor (v); key.isNotEmpty() && collector.add (v, key))
+            {
+                writePlaceholder (os, key);
+                return;
+            }
+        }
+
+        os.writeString (v.getType().toString());
+
+        const int numProperties = v.getNumProperties();
+        os.writeCompressedInt (numProperties);
+
+        for (int i = 0; i < numProperties; ++i)
+        {
+            auto name = v.getPropertyName (i);
+            os.writeString (name.toString());
+            v.getProperty (name).writeToStream (os);
+        }
+
+        os.writeCompressedInt (v.getNumChildren());
+
+        for (const auto& child : v)
+            writeTree (os, child, false, collector);
+    }
+
+    /** Finds the sub-sections of a section that's being copied from the last write. */
+    static void findSubSections (const juce::ValueTree& v, std::vector<PendingSection>& found)
+    {
+        if (! canContainSections (v.getType()))
+            return;
+
+        for (const auto& child : v)
+        {
+            if (auto key = BinaryEditFile::getSectionKeyFor (child); key.isNotEmpty())
+                found.push_back ({ child, key });
+            else
+                findSubSections (child, found);
+        }
+    }
+}
+
+//==============================================================================
+BinaryEditFile::~BinaryEditFile() = default;
+
+std::unique_ptr<BinaryEditFile> BinaryEditFile::open (const juce::File& f)
+{
+    CRASH_TRACER
+
+    if (! isBinaryEditFile (f))
+        return {};
+
+    std::unique_ptr<BinaryEditFile> file (new BinaryEditFile());
+    file->mappedFile = std::make_unique<juce::MemoryMappedFile> (f, juce::MemoryMappedFile::readOnly);
+
+    if (file->mappedFile->getData() == nullptr || ! file->readTableOfContents())
+        return {};
+
+    return file;
+}
+
+bool BinaryEditFile::isBinaryEditFile (const juce::File& f)
+{
+    juce::FileInputStream is (f);
+
+    return is.openedOk()
+        && is.getTotalLength() >= binary_edit_file::headerSize + binary_edit_file::footerSize
+        && (uint32_t) is.readInt() == magicNumber;
+}
+
+bool BinaryEditFile::readTableOfContents()
+{
+    using namespace binary_edit_file;
+    auto data = static_cast<const char*> (mappedFile->getData());
+    auto size = (int64_t) mappedFile->getSize();
+
+    if (size < headerSize + footerSize)
+        return false;
+
+    juce::MemoryInputStream header (data, (size_t) headerSize, false);
+
+    if ((uint32_t) header.readInt() != magicNumber
+        || (uint32_t) header.readInt() > currentVersion)
+        return false;
+
+    juce::MemoryInputStream footer (data + size - footerSize, (size_t) footerSize, false);
+    const auto tocOffset = footer.readInt64();
+
+    if ((uint32_t) footer.readInt() != magicNumber
+        || tocOffset < headerSize || tocOffset > size - footerSize)
+        return false;
+
+    juce::MemoryInputStream toc (data + tocOffset, (size_t) (size - footerSize - tocOffset), false);
+    const int numSections = toc.readCompressedInt();
+
+    if (numSections <= 0)
+        return false;
+
+    sections.reserve ((size_t) numSections);
+    sectionIndexes.reserve ((size_t) numSections);
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        Section s;
+        s.key = toc.readString();
+        s.type = juce::Identifier (toc.readString());
+        s.offset = toc.readInt64();
+        s.size = toc.readInt64();
+
+        if (s.offset < headerSize || s.size <= 0 || s.offset + s.size > tocOffset)
+            return false;
+
+        if (i > 0)
+            sectionIndexes.emplace (s.key, i);
+
+        sections.push_back (std::move (s));
+    }
+
+    return true;
+}
+
+//==============================================================================
+juce::String BinaryEditFile::getSectionKey (int index) const
+{
+    jassert (juce::isPositiveAndBelow (index, getNumSections()));
+    return sections[(size_t) index].key;
+}
+
+juce::Identifier BinaryEditFile::getSectionType (int index) const
+{
+    jassert (juce::isPositiveAndBelow (index, getNumSections()));
+    return sections[(size_t) index].type;
+}
+
+int BinaryEditFile::findSection (const juce::String& key) const
+{
+    if (auto found = sectionIndexes.find (key); found != sectionIndexes.end())
+        return found->second;
+
+    return -1;
+}
+
+juce::ValueTree BinaryEditFile::readSection (int index) const
+{
+    if (! juce::isPositiveAndBelow (index, getNumSections()))
+        return {};
+
+    auto& s = sections[(size_t) index];
+    return juce::ValueTree::readFromData (static_cast<const char*> (mappedFile->getData()) + s.offset, (size_t) s.size);
+}
+
+void BinaryEditFile::resolvePlaceholders (juce::ValueTree& v) const
+{
+    // Sections are always written after the section they're in, so only
+    // resolving later sections means a corrupt file can't cause a loop
+    std::function<void (juce::ValueTree&, int)> resolve = [&] (juce::ValueTree& tree, int sectionIndex)
+    {
+        if (! binary_edit_file::canContainSections (tree.getType()))
+            return;
+
+        for (int i = 0; i < tree.getNumChildren(); ++i)
+        {
+            auto child = tree.getChild (i);
+
+            if (isSectionPlaceholder (child))
+            {
+                const auto index = findSection (getPlaceholderKey (child));
+                tree.removeChild (i, nullptr);
+
+                if (index > sectionIndex)
+                {
+                    auto section = readSection (index);
+                    resolve (section, index);
+                    tree.addChild (section, i, nullptr);
+                }
+                else
+                {
+                    jassertfalse;
+                    --i;
+                }
+            }
+            else
+            {
+                resolve (child, sectionIndex);
+            }
+        }
+    };
+
+    resolve (v, 0);
+}
+
+juce::ValueTree BinaryEditFile::readEdit() const
+{
+    CRASH_TRACER
+    auto edit = readSection (0);
+    resolvePlaceholders (edit);
+    return edit;
+}
+
+//==============================================================================
+bool BinaryEditFile::isSectionPlaceholder (const juce::ValueTree& v)
+{
+    return v.hasType (IDs::BINARYSECTION);
+}
+
+juce::String BinaryEditFile::getPlaceholderKey (const juce::ValueTree& v)
+{
+    jassert (isSectionPlaceholder (v));
+    return v[IDs::key].toString();
+}
+
+juce::String BinaryEditFile::getSectionKeyFor (const juce::ValueTree& v)
+{
+    const auto type = v.getType();
+
+    if (TrackList::isTrack (type) || Clip::isClipState (type))
+        return v[IDs::id].toString();
+
+    if (type == IDs::SEQUENCE || type == IDs::AUTOMATIONCURVE)
+        if (auto parentID = v.getParent()[IDs::id].toString(); parentID.isNotEmpty())
+            return parentID + "/" + (type == IDs::SEQUENCE ? type.toString() : v[IDs::paramID].toString());
+
+    return {};
+}
+
+//==============================================================================
+//==============================================================================
+BinaryEditFileWriter::BinaryEditFileWriter (const juce::ValueTree& editState)
+    : state (editState)
+{
+    jassert (state.hasType (IDs::EDIT));
+    state.addListener (this);
+}
+
+BinaryEditFileWriter::~BinaryEditFileWriter()
+{
+    state.removeListener (this);
+}
+
+bool BinaryEditFileWriter::writeToFile (const juce::File& file)
+{
+    CRASH_TRACER
+    juce::TemporaryFile tempFile (file, juce::TemporaryFile::useHiddenFile);
+
+    {
+        juce::FileOutputStream os (tempFile.getFile());
+
+        if (! os.openedOk())
+            return false;
+
+        writeToStream (os);
+        os.flush();
+
+        if (! os.getStatus().wasOk())
+            return false;
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
+
+void BinaryEditFileWriter::writeToStream (juce::OutputStream& destStream)
+{
+    CRASH_TRACER
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    using namespace binary_edit_file;
+
+    struct TocEntry
+    {
+        juce::String key;
+        juce::Identifier type;
+        int64_t offset, size;
+    };
+
+    juce::MemoryBlock newFileData;
+    std::unordered_map<juce::String, CachedSection> newCachedSections;
+    std::vector<TocEntry> toc;
+    Statistics stats;
+
+    {
+        juce::MemoryOutputStream os (newFileData, false);
+        os.writeInt ((int) BinaryEditFile::magicNumber);
+        os.writeInt ((int) BinaryEditFile::currentVersion);
+
+        // Sections are added to this as they're found so are written breadth first
+        std::vector<PendingSection> pending { { state, {} } };
+        std::unordered_set<juce::String> usedKeys;
+        std::vector<PendingSection> subSections;
+
+        for (size_t i = 0; i < pending.size(); ++i)
+        {
+            auto section = pending[i];
+            const auto offset = (int64_t) os.getPosition();
+            bool canBeCopied = false;
+
+            auto cached = cachedSections.end();
+
+            if (section.key.isNotEmpty() && ! changedSections.contains (section.key))
+                cached = cachedSections.find (section.key);
+
+            if (cached != cachedSections.end())
+            {
+                // The placeholders in the copied data need to refer to the same sections
+                subSections.clear();
+                findSubSections (section.tree, subSections);
+                canBeCopied = true;
+
+                for (auto& s : subSections)
+                    if (usedKeys.contains (s.key))
+                        canBeCopied = false;
+            }
+
+            if (canBeCopied)
+            {
+                os.write (static_cast<const char*> (lastFileData.getData()) + cached->second.offset,
+                          (size_t) cached->second.size);
+
+                for (auto& s : subSections)
+                {
+                    usedKeys.insert (s.key);
+                    pending.push_back (s);
+                }
+
+                ++stats.numSectionsCopied;
+            }
+            else
+            {
+                SectionCollector collector { pending, usedKeys };
+                writeTree (os, section.tree, true, collector);
+                ++stats.numSectionsWritten;
+
+                // Sections with inlined duplicates can't be copied as changes to those won't be tracked
+                if (collector.hadDuplicateKeys)
+                    section.key = {};
+            }
+
+            const auto size = (int64_t) os.getPosition() - offset;
+            toc.push_back ({ pending[i].key, section.tree.getType(), offset, size });
+
+            if (section.key.isNotEmpty())
+                newCachedSections[section.key] = { offset, size };
+        }
+
+        const auto tocOffset = (int64_t) os.getPosition();
+        os.writeCompressedInt ((int) toc.size());
+
+        for (auto& entry : toc)
+        {
+            os.writeString (entry.key);
+            os.writeString (entry.type.toString());
+            os.writeInt64 (entry.offset);
+            os.writeInt64 (entry.size);
+        }
+
+        os.writeInt64 (tocOffset);
+        os.writeInt ((int) BinaryEditFile::magicNumber);
+    }
+
+    destStream.write (newFileData.getData(), newFileData.getSize());
+
+    stats.numBytes = (int64_t) newFileData.getSize();
+    lastWriteStatistics = stats;
+
+    lastFileData = std::move (newFileData);
+    cachedSections = std::move (newCachedSections);
+    changedSections.clear();
+}
+
+//==============================================================================
+void BinaryEditFileWriter::markSectionChanged (const juce::ValueTree& v)
+{
+    for (auto t = v; t.isValid(); t = t.getParent())
+    {
+        if (auto key = BinaryEditFile::getSectionKeyFor (t); key.isNotEmpty())
+        {
+            changedSections.insert (key);
+            return;
+        }
+    }
+}
+
+void BinaryEditFileWriter::markAllSectionsChanged (const juce::ValueTree& v)
+{
+    auto key = BinaryEditFile::getSectionKeyFor (v);
+
+    if (key.isNotEmpty())
+    {
+        changedSections.insert (key);
+
+        if (! binary_edit_file::canContainSections (v.getType()))
+            return;
+    }
+
+    for (const auto& child : v)
+        markAllSectionsChanged (child);
+}
+
+void BinaryEditFileWriter::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i)
+{
+    markSectionChanged (v);
+
+    // If a section's key changes, the placeholder in its parent needs updating too
+    if (i == IDs::id || i == IDs::paramID)
+        markSectionChanged (v.getParent());
+}
+
+void BinaryEditFileWriter::valueTreeChildAdded (juce::ValueTree& parent, juce::ValueTree& child)
+{
+    // Anything could have changed whilst the child was detached so it all needs writing
+    markSectionChanged (parent);
+    markAllSectionsChanged (child);
+}
+
+void BinaryEditFileWriter::valueTreeChildRemoved (juce::ValueTree& parent, juce::ValueTree&, int)
+{
+    markSectionChanged (parent);
+}
+
+void BinaryEditFileWriter::valueTreeChildOrderChanged (juce::ValueTree& parent, int, int)
+{
+    markSectionChanged (parent);
+}
+
+void BinaryEditFileWriter::valueTreeRedirected (juce::ValueTree&)
+{
+    cachedSections.clear();
+    lastFileData.reset();
+}
+
+}} // namespace tracktion { inline namespace engine
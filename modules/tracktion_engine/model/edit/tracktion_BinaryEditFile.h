@@ -0,0 +1,171 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Reads an Edit that's been saved in the binary format written by BinaryEditFileWriter.
+
+    The file is split in to sections, one for the Edit itself and one for each
+    track, clip, MIDI sequence and automation curve, with a table of contents at
+    the end. Sections refer to the sections inside them with placeholder children,
+    so each can be parsed on its own.
+
+    The file is memory mapped and only the table of contents is read when it's
+    opened, so sections can be read lazily with readSection, or the whole Edit
+    can be read with readEdit.
+*/
+class BinaryEditFile
+{
+public:
+    /** Opens a binary Edit file.
+        Returns nullptr if the file doesn't exist or isn't a valid binary Edit.
+    */
+    static std::unique_ptr<BinaryEditFile> open (const juce::File&);
+
+    /** Returns true if a file starts with the binary Edit header. */
+    static bool isBinaryEditFile (const juce::File&);
+
+    /** Destructor. */
+    ~BinaryEditFile();
+
+    //==============================================================================
+    /** Returns the number of sections. The first section is always the Edit. */
+    int getNumSections() const noexcept                         { return (int) sections.size(); }
+
+    /** Returns the key of a section, which is the ID of the object it holds. */
+    juce::String getSectionKey (int index) const;
+
+    /** Returns the type of the ValueTree held in a section. */
+    juce::Identifier getSectionType (int index) const;
+
+    /** Returns the index of the section with a given key, or -1 if there isn't one. */
+    int findSection (const juce::String& key) const;
+
+    /** Parses a single section.
+        Any sections inside it are left as placeholders which can be found with
+        isSectionPlaceholder and read with readSection or resolvePlaceholders.
+    */
+    juce::ValueTree readSection (int index) const;
+
+    /** Replaces any placeholders inside a tree with the sections they refer to. */
+    void resolvePlaceholders (juce::ValueTree&) const;
+
+    /** Reads the whole Edit, with all of its sections. */
+    juce::ValueTree readEdit() const;
+
+    //==============================================================================
+    /** Returns true if a tree is a placeholder for a section. */
+    static bool isSectionPlaceholder (const juce::ValueTree&);
+
+    /** Returns the key of the section a placeholder refers to. */
+    static juce::String getPlaceholderKey (const juce::ValueTree&);
+
+    /** Returns the key a tree would be saved in a separate section with, or an
+        empty string if it's saved as part of its parent's section.
+    */
+    static juce::String getSectionKeyFor (const juce::ValueTree&);
+
+    /** @internal */
+    static constexpr uint32_t magicNumber = 0x4245544b; // "TKEB"
+    /** @internal */
+    static constexpr uint32_t currentVersion = 1;
+
+private:
+    struct Section
+    {
+        juce::String key;
+        juce::Identifier type;
+        int64_t offset = 0, size = 0;
+    };
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    std::vector<Section> sections;
+    std::unordered_map<juce::String, int> sectionIndexes;
+
+    BinaryEditFile() = default;
+    bool readTableOfContents();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BinaryEditFile)
+};
+
+//==============================================================================
+/**
+    Writes an Edit's state in the binary Edit format.
+
+    This listens to the Edit's state and keeps track of which sections have
+    changed since it last wrote a file. When it writes the next one, the sections
+    that haven't changed are copied from the previous file rather than being
+    serialised again, so saving an Edit where only a few things have been
+    changed doesn't have to convert the whole state.
+
+    Only the serialisation is incremental. Every save still writes out the whole
+    file, so the time spent on disk I/O grows with the size of the Edit.
+
+    This should only be used on the message thread.
+    @see BinaryEditFile, Edit::getBinaryEditFileWriter
+*/
+class BinaryEditFileWriter  : private juce::ValueTree::Listener
+{
+public:
+    /** Creates a writer for an Edit's state. */
+    BinaryEditFileWriter (const juce::ValueTree& editState);
+
+    /** Destructor. */
+    ~BinaryEditFileWriter() override;
+
+    /** Writes the state to a file, replacing it if it exists.
+        This writes to a temporary file that's then moved over the original so an
+        existing file is left intact if the write fails.
+    */
+    bool writeToFile (const juce::File&);
+
+    /** Writes the state to a stream. */
+    void writeToStream (juce::OutputStream&);
+
+    /** Details of the last write. */
+    struct Statistics
+    {
+        int numSectionsWritten = 0;     /**< The number of sections that were serialised. */
+        int numSectionsCopied = 0;      /**< The number of sections copied from the last write. */
+        int64_t numBytes = 0;           /**< The total size of the file. */
+    };
+
+    /** Returns details of the last write. */
+    Statistics getLastWriteStatistics() const noexcept      { return lastWriteStatistics; }
+
+private:
+    //==============================================================================
+    struct CachedSection
+    {
+        int64_t offset = 0, size = 0;
+    };
+
+    juce::ValueTree state;
+    juce::MemoryBlock lastFileData;
+    std::unordered_map<juce::String, CachedSection> cachedSections;
+    std::unordered_set<juce::String> changedSections;
+    Statistics lastWriteStatistics;
+
+    void markSectionChanged (const juce::ValueTree&);
+    void markAllSectionsChanged (const juce::ValueTree&);
+
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override;
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override;
+    void valueTreeChildOrderChanged (juce::ValueTree&, int, int) override;
+    void valueTreeRedirected (juce::ValueTree&) override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BinaryEditFileWriter)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,124 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_BINARY_EDIT_FILE
+
+#include "../../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+TEST_SUITE("tracktion_engine")
+{
+    TEST_CASE ("BinaryEditFile")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine, 4, Edit::forEditing);
+        juce::TemporaryFile tempEditFile;
+        const auto file = tempEditFile.getFile();
+
+        auto tracks = getAudioTracks (*edit);
+        std::vector<MidiClip*> clips;
+
+        for (auto t : tracks)
+        {
+            auto clip = t->insertMIDIClip ({ 0_tp, 4_tp }, nullptr);
+
+            for (int i = 0; i < 16; ++i)
+                clip->getSequence().addNote (60 + i, BeatPosition::fromBeats (i * 0.5), BeatDuration::fromBeats (0.5), 100, 0, nullptr);
+
+            clips.push_back (clip.get());
+        }
+
+        auto& volCurve = tracks[0]->getVolumePlugin()->volParam->getCurve();
+        volCurve.addPoint (0_tp, 0.5f, 0.0f);
+        volCurve.addPoint (2_tp, 1.0f, 0.0f);
+
+        edit->flushState();
+        BinaryEditFileWriter writer (edit->state);
+
+        SUBCASE ("Round trip")
+        {
+            CHECK (writer.writeToFile (file));
+            CHECK (BinaryEditFile::isBinaryEditFile (file));
+            CHECK_EQ (writer.getLastWriteStatistics().numSectionsCopied, 0);
+
+            auto binaryFile = BinaryEditFile::open (file);
+            REQUIRE (binaryFile != nullptr);
+            CHECK (binaryFile->readEdit().isEquivalentTo (edit->state));
+        }
+
+        SUBCASE ("Sections can be read lazily")
+        {
+            CHECK (writer.writeToFile (file));
+            auto binaryFile = BinaryEditFile::open (file);
+            REQUIRE (binaryFile != nullptr);
+
+            auto clipIndex = binaryFile->findSection (clips[1]->itemID.toString());
+            REQUIRE (clipIndex > 0);
+            CHECK_EQ (binaryFile->getSectionType (clipIndex), IDs::MIDICLIP);
+
+            auto clipState = binaryFile->readSection (clipIndex);
+            auto sequence = clipState.getChildWithName (IDs::BINARYSECTION);
+            REQUIRE (sequence.isValid());
+            CHECK (BinaryEditFile::isSectionPlaceholder (sequence));
+            CHECK_EQ (binaryFile->getSectionType (binaryFile->findSection (BinaryEditFile::getPlaceholderKey (sequence))), IDs::SEQUENCE);
+
+            binaryFile->resolvePlaceholders (clipState);
+            CHECK (clipState.isEquivalentTo (clips[1]->state));
+        }
+
+        SUBCASE ("Unchanged sections are copied")
+        {
+            CHECK (writer.writeToFile (file));
+            const auto firstWrite = writer.getLastWriteStatistics();
+
+            clips[2]->setName ("Changed");
+            clips[3]->getSequence().getNotes()[0]->setVelocity (50, nullptr);
+            tracks[1]->insertMIDIClip ({ 4_tp, 8_tp }, nullptr);
+
+            CHECK (writer.writeToFile (file));
+            const auto secondWrite = writer.getLastWriteStatistics();
+            CHECK (secondWrite.numSectionsCopied > 0);
+            CHECK (secondWrite.numSectionsWritten < firstWrite.numSectionsWritten);
+            CHECK (secondWrite.numSectionsCopied + secondWrite.numSectionsWritten > firstWrite.numSectionsWritten);
+
+            auto binaryFile = BinaryEditFile::open (file);
+            REQUIRE (binaryFile != nullptr);
+            CHECK (binaryFile->readEdit().isEquivalentTo (edit->state));
+        }
+
+        SUBCASE ("Binary Edits can be loaded")
+        {
+            CHECK (writer.writeToFile (file));
+            auto state = loadEditFromFile (engine, file, ProjectItemID());
+            CHECK (state.hasType (IDs::EDIT));
+            CHECK_EQ (state.getNumChildren(), edit->state.getNumChildren());
+
+            auto loadedEdit = Edit::createEditForExamining (engine, state);
+            auto loadedTracks = getAudioTracks (*loadedEdit);
+            REQUIRE_EQ (loadedTracks.size(), tracks.size());
+
+            for (auto t : loadedTracks)
+                CHECK_EQ (getClipsOfType<MidiClip> (*t).size(), 1);
+        }
+
+        SUBCASE ("Invalid files aren't opened")
+        {
+            CHECK (file.replaceWithText ("<EDIT/>"));
+            CHECK (! BinaryEditFile::isBinaryEditFile (file));
+            CHECK (BinaryEditFile::open (file) == nullptr);
+        }
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif
@@ -395,7 +395,7 @@ struct Edit::TreeWatcher   : public juce::ValueTree::Listener
 
     void restart()
     {
-        edit.restartPlayback();
+        edit.restartPlaybackForStateChange();
     }
 
     void updateTrackStatusesAsync()
@@ -1150,6 +1150,16 @@ void Edit::flushPluginStateIfNeeded (Plugin& p)
     changedPluginsList->flushPluginStateIfNeeded (p);
 }
 
+BinaryEditFileWriter& Edit::getBinaryEditFileWriter()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (binaryEditFileWriter == nullptr)
+        binaryEditFileWriter = std::make_unique<BinaryEditFileWriter> (state);
+
+    return *binaryEditFileWriter;
+}
+
 juce::Time Edit::getTimeOfLastChange() const
 {
     return juce::Time (lastSignificantChange.get().getHexValue64());
@@ -1175,6 +1185,16 @@ bool Edit::hasChangedSinceSaved() const
 
 void Edit::restartPlayback()
 {
+    if (transportControl != nullptr)
+        if (auto context = getCurrentPlaybackContext())
+            context->invalidateCachedTrackNodes();
+
+    restartPlaybackForStateChange();
+}
+
+void Edit::restartPlaybackForStateChange()
+{
+    // Any cached track Nodes will have been invalidated by the state change itself
     shouldRestartPlayback = true;
 
     if (! isTimerRunning())
@@ -2387,6 +2407,11 @@ void Edit::pluginChanged (Plugin& p) noexcept
 
     changedPluginsList->pluginChanged (p);
     pluginChangeTimer->pluginChanged();
+
+    // External plugins can change without their state being updated so anything
+    // rendered ahead with the old settings needs to be discarded
+    if (auto epc = getCurrentPlaybackContext())
+        epc->flushLookAheadRendering();
 }
 
 //==============================================================================
@@ -12,6 +12,7 @@ namespace tracktion { inline namespace engine
 {
 
 class ClipEffect;
+class BinaryEditFileWriter;
 
 //==============================================================================
 /**
@@ -196,6 +197,14 @@ public:
     /** Saves the specified plugin state to the state ValueTree. */
     void flushPluginStateIfNeeded (Plugin&);
 
+    /** @internal
+        Returns the writer used to save the Edit in the binary format. This is
+        created when it's first needed and keeps track of what's changed since
+        the last save, so unchanged parts can be copied rather than serialised.
+        The whole file is still written every time.
+    */
+    BinaryEditFileWriter& getBinaryEditFileWriter();
+
     /** Returns the time the last change occurred.
         If no modifications occurred since this object was initialised, this returns the Time the Edit was last saved.
     */
@@ -353,6 +362,8 @@ public:
     /** Use this to tell the play engine to rebuild the audio graph if the toplogy has changed.
         You shouldn't normally need to use this as it's called automatically as
         track/clips/plugins etc. are added/removed/changed.
+        As this can't tell what has changed, any cached track Nodes will be rebuilt.
+        @see EditPlaybackContext::enableIncrementalGraphRebuilds
     */
     void restartPlayback();
 
@@ -908,6 +919,7 @@ private:
 
     struct TreeWatcher;
     std::unique_ptr<TreeWatcher> treeWatcher;
+    std::unique_ptr<BinaryEditFileWriter> binaryEditFileWriter;
 
     std::unique_ptr<TrackList> trackList;
     std::unique_ptr<EditInputDevices> editInputDevices;
@@ -932,6 +944,7 @@ private:
     Track::Ptr loadedTrack (Track::Ptr);
     void updateTrackStatuses();
     void updateTrackStatusesAsync();
+    void restartPlaybackForStateChange();
     void moveTrackInternal (Track::Ptr, TrackInsertPoint);
 
     //==============================================================================
@@ -195,7 +195,9 @@ bool EditFileOperations::writeToFile (const juce::File& file, bool writeQuickBin
             if (editSnapshot != nullptr)
                 editSnapshot->setState (edit.state, edit.getLength());
 
-            if (auto xml = edit.state.createXml())
+            if (edit.engine.getEngineBehaviour().shouldSaveEditsInBinaryFormat())
+                ok = edit.getBinaryEditFileWriter().writeToFile (file);
+            else if (auto xml = edit.state.createXml())
                 ok = xml->writeTo (file);
 
             jassert (ok);
@@ -443,7 +445,14 @@ juce::ValueTree loadEditFromFile (Engine& e, const juce::File& f, ProjectItemID
     CRASH_TRACER
     juce::ValueTree state;
 
-    if (auto xml = juce::parseXML (f))
+    if (auto binaryFile = BinaryEditFile::open (f))
+    {
+        if (state = binaryFile->readEdit(); state.hasType (IDs::EDIT))
+            state = updateLegacyEdit (state);
+        else
+            state = {};
+    }
+    else if (auto xml = juce::parseXML (f))
     {
         updateLegacyEdit (*xml);
         state = juce::ValueTree::fromXml (*xml);
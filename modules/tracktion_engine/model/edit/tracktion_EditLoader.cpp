@@ -81,7 +81,11 @@ std::shared_ptr<EditLoader::Handle> EditLoader::loadEdit (Engine& engine, juce::
                                           const ScopedThreadExitStatusEnabler threadExitEnabler;
 
                                           auto opts = std::move (options);
-                                          opts.editState = loadValueTree (file, IDs::EDIT);
+
+                                          if (auto binaryFile = BinaryEditFile::open (file))
+                                              opts.editState = binaryFile->readEdit();
+                                          else
+                                              opts.editState = loadValueTree (file, IDs::EDIT);
 
                                           if (! opts.editState.isValid())
                                               return completionCallback ({});
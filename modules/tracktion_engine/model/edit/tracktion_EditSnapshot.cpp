@@ -221,7 +221,9 @@ void EditSnapshot::refreshFromProjectItem (ProjectItem::Ptr pi)
         return;
 
     sourceFile = pi->getSourceFile();
-    auto newState = loadValueTree (sourceFile, true);
+    auto binaryFile = BinaryEditFile::open (sourceFile);
+    auto newState = binaryFile != nullptr ? binaryFile->readEdit()
+                                          : loadValueTree (sourceFile, true);
 
     if (! newState.hasType (IDs::EDIT))
         return;
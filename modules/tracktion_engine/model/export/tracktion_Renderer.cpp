@@ -116,6 +116,20 @@ juce::StringPairArray createAcidInfo (Edit& edit, TimeRange time)
     return metadata;
 }
 
+//==============================================================================
+Renderer::Statistics Renderer::Parameters::getStatistics() const
+{
+    Statistics s;
+    s.peak                  = resultMagnitude;
+    s.average               = resultRMS;
+    s.audioDuration         = resultAudioDuration;
+    s.integratedLoudness    = resultIntegratedLoudness;
+    s.maxMomentaryLoudness  = resultMaxMomentaryLoudness;
+    s.maxShortTermLoudness  = resultMaxShortTermLoudness;
+    s.truePeak              = resultTruePeak;
+    return s;
+}
+
 //==============================================================================
 Renderer::RenderTask::RenderTask (const juce::String& taskDescription,
                                   const Renderer::Parameters& r,
@@ -207,7 +221,7 @@ bool Renderer::RenderTask::performNormalisingAndTrimming (const Renderer::Parame
                                                + doneRange.getStart());
     }
 
-    if (target.shouldNormalise || target.shouldNormaliseByRMS)
+    if (target.shouldNormalise || target.shouldNormaliseByRMS || target.shouldNormaliseByLoudness)
         setJobName (TRANS("Normalising") + "...");
 
     std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (params.edit->engine,
@@ -232,7 +246,20 @@ bool Renderer::RenderTask::performNormalisingAndTrimming (const Renderer::Parame
     progress = 0.96f;
     float gain = 1.0f;
 
-    if (target.shouldNormaliseByRMS)
+    if (target.shouldNormaliseByLoudness)
+    {
+        // The loudness was measured as it was rendered so the gain is known without reading the file again
+        if (intermediate.resultIntegratedLoudness > LoudnessMeter::silenceLoudness)
+        {
+            gain = dbToGain (target.normaliseToLevelDb - intermediate.resultIntegratedLoudness);
+
+            if (intermediate.resultTruePeak * gain > dbToGain (target.maxTruePeakDb))
+                gain = dbToGain (target.maxTruePeakDb) / intermediate.resultTruePeak;
+
+            gain = juce::jlimit (0.0f, 100.0f, gain);
+        }
+    }
+    else if (target.shouldNormaliseByRMS)
         gain = juce::jlimit (0.0f, 100.0f, dbToGain (target.normaliseToLevelDb) / (intermediate.resultRMS + 2.0f / 32768.0f));
     else if (target.shouldNormalise)
         gain = juce::jlimit (0.0f, 100.0f, dbToGain (target.normaliseToLevelDb) * (1.0f / (intermediate.resultMagnitude * 1.005f + 2.0f / 32768.0f)));
@@ -413,6 +440,182 @@ bool Renderer::RenderTask::addMidiMetaDataAndWriteToFile (juce::File destFile, j
 }
 
 
+//==============================================================================
+namespace render_utils
+{
+    inline void addTrackAndDependencies (juce::Array<Track*>& tracks, Track& t)
+    {
+        if (tracks.contains (&t))
+            return;
+
+        tracks.add (&t);
+
+        for (auto inputTrack : t.getInputTracks())
+            addTrackAndDependencies (tracks, *inputTrack);
+
+        for (auto subTrack : t.getAllSubTracks (true))
+            addTrackAndDependencies (tracks, *subTrack);
+    }
+}
+
+Renderer::ParallelRenderTask::ParallelRenderTask (const juce::String& taskDescription,
+                                                  std::vector<Renderer::Parameters> p)
+    : ThreadPoolJobWithProgress (taskDescription),
+      params (std::move (p))
+{
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        renders.push_back (std::make_unique<Render>());
+        errorMessages.add ({});
+    }
+
+    if (params.empty())
+        return;
+
+    jassert (params.front().engine != nullptr);
+    const auto numCPUs = (size_t) params.front().engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio();
+
+    if (canRenderInParallel (params))
+        numConcurrentRenders = std::clamp (params.size(), (size_t) 1, std::max ((size_t) 1, numCPUs));
+
+    // Any CPUs not being used for separate renders are shared out between the graphs
+    const auto numThreadsPerRender = (int) std::max ((size_t) 1, numCPUs / numConcurrentRenders);
+
+    for (auto& r : params)
+    {
+        r.offlineRender = true;
+        r.realTimeRender = false;
+        r.blockSizeForAudio = std::max (r.blockSizeForAudio, minBlockSize);
+        r.numThreadsForAudio = numThreadsPerRender;
+    }
+}
+
+Renderer::ParallelRenderTask::~ParallelRenderTask()
+{
+}
+
+juce::ThreadPoolJob::JobStatus Renderer::ParallelRenderTask::runJob()
+{
+    CRASH_TRACER
+
+    // This runs on a thread pool job. The graphs are built first, before any rendering
+    // starts, as createRenderTask blocks this thread whilst it builds each one on the message thread
+    for (size_t i = 0; i < renders.size(); ++i)
+    {
+        auto& render = *renders[i];
+
+        if (! render.task)
+            render.task = render_utils::createRenderTask (params[i], getJobName(), &render.progress, nullptr);
+    }
+
+    std::atomic<size_t> nextRender { 0 };
+
+    auto renderNext = [this, &nextRender]
+    {
+        juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+
+        for (;;)
+        {
+            const auto index = nextRender++;
+
+            if (index >= renders.size())
+                return;
+
+            if (auto& task = renders[index]->task)
+                while (! shouldExit() && task->runJob() == jobNeedsRunningAgain)
+                {}
+        }
+    };
+
+    {
+        std::vector<std::thread> threads;
+
+        for (size_t i = 1; i < numConcurrentRenders; ++i)
+            threads.emplace_back (renderNext);
+
+        renderNext();
+
+        for (auto& t : threads)
+            t.join();
+    }
+
+    // Merge the results back in to the params
+    for (size_t i = 0; i < renders.size(); ++i)
+    {
+        auto& render = *renders[i];
+        auto& r = params[i];
+
+        if (render.task == nullptr)
+        {
+            errorMessages.set ((int) i, TRANS("Couldn't render, as the selected region was empty"));
+            continue;
+        }
+
+        r.resultMagnitude               = render.task->params.resultMagnitude;
+        r.resultRMS                     = render.task->params.resultRMS;
+        r.resultAudioDuration           = render.task->params.resultAudioDuration;
+        r.resultIntegratedLoudness      = render.task->params.resultIntegratedLoudness;
+        r.resultMaxMomentaryLoudness    = render.task->params.resultMaxMomentaryLoudness;
+        r.resultMaxShortTermLoudness    = render.task->params.resultMaxShortTermLoudness;
+        r.resultTruePeak                = render.task->params.resultTruePeak;
+
+        errorMessages.set ((int) i, render.task->errorMessage);
+
+        // Deleting the task closes the file and performs any normalising or trimming
+        render.task.reset();
+
+        if (shouldExit())
+            r.destFile.deleteFile();
+    }
+
+    return jobHasFinished;
+}
+
+float Renderer::ParallelRenderTask::getCurrentTaskProgress()
+{
+    if (renders.empty())
+        return 1.0f;
+
+    float total = 0.0f;
+
+    for (auto& render : renders)
+        total += render->progress;
+
+    return total / (float) renders.size();
+}
+
+bool Renderer::ParallelRenderTask::canRenderInParallel (const std::vector<Renderer::Parameters>& params)
+{
+    std::map<Edit*, juce::Array<Track*>> tracksUsed;
+
+    for (auto& r : params)
+    {
+        // Master plugins would be shared between the renders
+        if (r.edit == nullptr || r.tracksToDo.isZero() || r.useMasterPlugins)
+            return false;
+
+        // Racks can be shared between tracks and modifiers are updated with the
+        // position of the render so these can only be used by one render at a time
+        if (r.edit->getRackList().size() > 0 || ! getAllModifiers (*r.edit).isEmpty())
+            return false;
+
+        juce::Array<Track*> tracks;
+
+        for (auto t : toTrackArray (*r.edit, r.tracksToDo))
+            render_utils::addTrackAndDependencies (tracks, *t);
+
+        auto& used = tracksUsed[r.edit];
+
+        for (auto t : tracks)
+            if (used.contains (t))
+                return false;
+
+        used.addArray (tracks);
+    }
+
+    return true;
+}
+
 //==============================================================================
 bool Renderer::renderToFile (const juce::String& taskDescription,
                              const juce::File& outputFile,
@@ -480,6 +683,48 @@ bool Renderer::renderToFile (Edit& edit, const juce::File& f, bool useThread)
     return renderToFile ({}, f, edit, { 0_tp, edit.getLength() }, toBitSet (getAllTracks (edit)), true, true, {}, useThread);
 }
 
+juce::Array<juce::File> Renderer::renderToFiles (const juce::String& taskDescription, std::vector<Parameters> params)
+{
+    CRASH_TRACER
+    juce::Array<juce::File> renderedFiles;
+
+    if (params.empty())
+        return renderedFiles;
+
+    auto& engine = *params.front().engine;
+    TransportControl::stopAllTransports (engine, false, true);
+
+    for (auto& r : params)
+    {
+        jassert (r.edit != nullptr);
+        turnOffAllPlugins (*r.edit);
+    }
+
+    ParallelRenderTask task (taskDescription, std::move (params));
+    engine.getUIBehaviour().runTaskWithProgressBar (task);
+
+    for (size_t i = 0; i < task.params.size(); ++i)
+    {
+        auto& r = task.params[i];
+        turnOffAllPlugins (*r.edit);
+
+        if (! r.destFile.existsAsFile())
+            continue;
+
+        if (task.errorMessages[(int) i].isNotEmpty())
+            r.destFile.deleteFile();
+        else
+            renderedFiles.add (r.destFile);
+    }
+
+    if (auto firstError = std::find_if (task.errorMessages.begin(), task.errorMessages.end(),
+                                        [] (auto& e) { return e.isNotEmpty(); });
+        firstError != task.errorMessages.end())
+        engine.getUIBehaviour().showWarningMessage (*firstError);
+
+    return renderedFiles;
+}
+
 juce::File Renderer::renderToFile (const juce::String& taskDescription, const Parameters& r)
 {
     CRASH_TRACER
@@ -602,10 +847,7 @@ Renderer::Statistics Renderer::measureStatistics (const juce::String& taskDescri
         if (auto task = render_utils::createRenderTask (r, taskDescription, nullptr, nullptr))
         {
             edit.engine.getUIBehaviour().runTaskWithProgressBar (*task);
-
-            result.peak          = task->params.resultMagnitude;
-            result.average       = task->params.resultRMS;
-            result.audioDuration = task->params.resultAudioDuration;
+            result = task->params.getStatistics();
         }
     }
 
@@ -29,6 +29,21 @@ struct ProcessState;
 class Renderer
 {
 public:
+    //==============================================================================
+    /** The levels of a render.
+        @see measureStatistics(), Parameters::getStatistics()
+    */
+    struct Statistics
+    {
+        float peak = 0;                                                     ///< The sample peak level as a gain
+        float average = 0;                                                  ///< The average RMS level as a gain
+        float audioDuration = 0;                                            ///< The length of the audio in seconds
+        float integratedLoudness = LoudnessMeter::silenceLoudness;          ///< The gated EBU R128 loudness in LUFS
+        float maxMomentaryLoudness = LoudnessMeter::silenceLoudness;        ///< The highest loudness of any 400ms in LUFS
+        float maxShortTermLoudness = LoudnessMeter::silenceLoudness;        ///< The highest loudness of any 3s in LUFS
+        float truePeak = 0;                                                 ///< The 4x oversampled true-peak level as a gain
+    };
+
     //==============================================================================
     /**
         Holds all the properties of a single render operation.
@@ -72,7 +87,11 @@ public:
 
         bool shouldNormalise = false;                           ///< If true, the resulting audio will be normalised by peak level
         bool shouldNormaliseByRMS = false;                      ///< If true, the resulting audio will be normalised by RMS level
+        bool shouldNormaliseByLoudness = false;                 /**< If true, the resulting audio will be normalised by its integrated
+                                                                     loudness, in which case normaliseToLevelDb is in LUFS */
         float normaliseToLevelDb = 0;                           ///< The level to normalise to
+        float maxTruePeakDb = 0;                                /**< When normalising by loudness, the gain will be reduced if needed
+                                                                     to keep the true-peak level below this */
         bool canRenderInMono = true;                            ///< If false, the result audio will be forced to stereo
         bool mustRenderInMono = false;                          ///< If true, the resulting audio will be forced to mono
         bool usePlugins = true;                                 ///< If false, clip/tracks plugins will be ommited from the render
@@ -80,6 +99,10 @@ public:
         bool realTimeRender = false;                            ///< If true, there will be a pause between each rendered block to simulate real-time
         bool ditheringEnabled = false;                          ///< If true, low-level noise will be added to the output for non-float formats
         bool checkNodesForAudio = true;                         ///< If true, attempting to render an Edit that doesn't produce audio will fail
+        bool offlineRender = false;                             /**< If true, blocks will be rendered as fast as possible without pausing to let
+                                                                     plugins warm up or other threads run. @see ParallelRenderTask */
+        int numThreadsForAudio = 0;                             /**< The number of threads to process the graph with, if this is 0,
+                                                                     EngineBehaviour::getNumberOfCPUsToUseForAudio will be used */
 
         int quality = 0;                                        ///< For audio formats that support it, the desired quality index @see juce::AudioFormat::createWriterFor
         juce::StringPairArray metadata;                         ///< A map of meta data to add to the file
@@ -94,6 +117,19 @@ public:
         float resultRMS = 0;
         /// @internal
         float resultAudioDuration = 0;
+        /// @internal
+        float resultIntegratedLoudness = LoudnessMeter::silenceLoudness;
+        /// @internal
+        float resultMaxMomentaryLoudness = LoudnessMeter::silenceLoudness;
+        /// @internal
+        float resultMaxShortTermLoudness = LoudnessMeter::silenceLoudness;
+        /// @internal
+        float resultTruePeak = 0;
+
+        /** Returns the Statistics measured during the last render with these Parameters.
+            These are measured before any normalisation is applied.
+        */
+        Statistics getStatistics() const;
     };
 
     //==============================================================================
@@ -164,6 +200,67 @@ public:
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderTask)
     };
 
+    //==============================================================================
+    /** Task that renders several sets of Parameters at the same time.
+
+        This is intended for bouncing stems or separate tracks. Each render is
+        performed offline with large blocks and no real-time waits, the renders are
+        spread across the CPUs and any CPUs left over are used to process each
+        render's graph.
+
+        If the Parameters can't safely be rendered at the same time they will be
+        rendered one after another. @see canRenderInParallel
+
+        As with RenderTask, call runJob until it returns jobHasFinished.
+    */
+    class ParallelRenderTask    : public ThreadPoolJobWithProgress
+    {
+    public:
+        /// Constructs a ParallelRenderTask for a number of sets of parameters
+        ParallelRenderTask (const juce::String& taskDescription,
+                            std::vector<Renderer::Parameters>);
+
+        /// Destructor
+        ~ParallelRenderTask() override;
+
+        /// Call until this returns jobHasFinished to perform the renders
+        JobStatus runJob() override;
+
+        /// Returns the overall progress of the renders
+        float getCurrentTaskProgress() override;
+
+        /// Returns the number of renders that will be run at the same time
+        size_t getNumConcurrentRenders() const noexcept     { return numConcurrentRenders; }
+
+        /** Returns true if the Parameters use separate sets of tracks and no shared
+            state such as master plugins, racks or modifiers so can be rendered at
+            the same time.
+        */
+        static bool canRenderInParallel (const std::vector<Renderer::Parameters>&);
+
+        /// The Parameters being used, once finished these contain the results of each render
+        std::vector<Renderer::Parameters> params;
+
+        /// An error message for each of the Parameters, empty if that render succeeded
+        juce::StringArray errorMessages;
+
+        /// The smallest block size renders will be performed with
+        static constexpr int minBlockSize = 8192;
+
+    private:
+        //==============================================================================
+        struct Render
+        {
+            std::unique_ptr<RenderTask> task;
+            std::atomic<float> progress { 0.0f };
+        };
+
+        std::vector<std::unique_ptr<Render>> renders;
+        size_t numConcurrentRenders = 1;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelRenderTask)
+    };
+
     //==============================================================================
     /** Cheks a file for write access etc. and presents pop-up options to the user
         if problems occur.
@@ -199,14 +296,12 @@ public:
     /** Renders an entire Edit to a file. */
     static bool renderToFile (Edit&, const juce::File&, bool useThread = true);
 
-    //==============================================================================
-    /** @see measureStatistics() */
-    struct Statistics
-    {
-        float peak = 0;
-        float average = 0;
-        float audioDuration = 0;
-    };
+    /** Renders a number of Parameters, each to its own file, at the same time
+        using a ParallelRenderTask.
+        Returns the files that were successfully rendered.
+    */
+    static juce::Array<juce::File> renderToFiles (const juce::String& taskDescription,
+                                                  std::vector<Parameters>);
 
     /** Renders a section of an edit to measure various details about its audio content */
     static Statistics measureStatistics (const juce::String& taskDescription,
@@ -65,6 +65,123 @@ TEST_SUITE("tracktion_engine")
         CHECK (thumbnail->getNumSamplesFinished() >= toSamples (fileLength, 44100.0));
         CHECK (thumbnail->getTotalLength() >= fileLength.inSeconds());
     }
+
+    TEST_CASE ("Renderer loudness normalisation")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        auto fileLength = 5_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+
+        auto track = getAudioTracks (*edit)[0];
+        insertWaveClip (*track, {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                        DeleteExistingClips::no);
+
+        juce::TemporaryFile destFile (".wav");
+        Renderer::Parameters params (*edit);
+        params.destFile = destFile.getFile();
+        params.time = params.time.withLength (fileLength);
+        params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+        params.bitDepth = 24;
+        params.shouldNormaliseByLoudness = true;
+        params.normaliseToLevelDb = -16.0f;
+        params.maxTruePeakDb = -1.0f;
+
+        auto task = render_utils::createRenderTask (params, {}, nullptr, nullptr);
+        REQUIRE (task != nullptr);
+
+        std::atomic<bool> finished { false };
+        std::thread renderThread ([&task, &finished]
+                                  {
+                                      while (task->runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+                                      {}
+
+                                      finished = true;
+                                  });
+
+        test_utilities::runDispatchLoopUntilTrue (finished);
+        renderThread.join();
+
+        // The statistics are measured before normalising
+        auto stats = task->params.getStatistics();
+        CHECK (stats.integratedLoudness > -16.0f);
+        CHECK (stats.truePeak >= stats.peak * 0.99f);
+
+        // Deleting the task writes the normalised file
+        task.reset();
+
+        auto buffer = test_utilities::loadFileInToBuffer (engine, destFile.getFile());
+        REQUIRE (buffer.has_value());
+
+        LoudnessMeter meter;
+        meter.reset (44100.0, buffer->getNumChannels());
+        meter.addBlock (*buffer, 0, buffer->getNumSamples());
+
+        CHECK (meter.getIntegratedLoudness() == doctest::Approx (-16.0f).epsilon (0.01));
+        CHECK (gainToDb (meter.getTruePeak()) <= -1.0f + 0.1f);
+    }
+
+    TEST_CASE ("Renderer parallel tracks")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine, 2);
+
+        auto fileLength = 5_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+
+        juce::OwnedArray<juce::TemporaryFile> destFiles;
+        std::vector<Renderer::Parameters> params;
+
+        for (auto track : getAudioTracks (*edit))
+        {
+            insertWaveClip (*track, {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                            DeleteExistingClips::no);
+
+            Renderer::Parameters p (*edit);
+            p.destFile = destFiles.add (std::make_unique<juce::TemporaryFile> (".wav"))->getFile();
+            p.time = p.time.withLength (fileLength);
+            p.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+            p.tracksToDo = toBitSet (juce::Array<Track*> { track });
+            params.push_back (std::move (p));
+        }
+
+        CHECK (Renderer::ParallelRenderTask::canRenderInParallel (params));
+
+        // Rendering a track twice shares its state so can't be done in parallel
+        {
+            auto duplicateParams = params;
+            duplicateParams[1].tracksToDo = duplicateParams[0].tracksToDo;
+            CHECK (! Renderer::ParallelRenderTask::canRenderInParallel (duplicateParams));
+        }
+
+        Renderer::ParallelRenderTask task ({}, std::move (params));
+        CHECK_EQ (task.getNumConcurrentRenders(), std::min ((size_t) 2, (size_t) engine.getEngineBehaviour().getNumberOfCPUsToUseForAudio()));
+
+        // The graphs are built on the message thread so this needs to be kept running
+        std::atomic<bool> finished { false };
+        std::thread renderThread ([&task, &finished]
+                                  {
+                                      while (task.runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+                                      {}
+
+                                      finished = true;
+                                  });
+
+        test_utilities::runDispatchLoopUntilTrue (finished);
+        renderThread.join();
+
+        CHECK_EQ (task.getCurrentTaskProgress(), 1.0f);
+
+        for (size_t i = 0; i < task.params.size(); ++i)
+        {
+            CHECK (task.errorMessages[(int) i].isEmpty());
+            CHECK (task.params[i].resultMagnitude > 0.5f);
+
+            auto buffer = test_utilities::loadFileInToBuffer (engine, task.params[i].destFile);
+            CHECK_EQ (buffer->getNumSamples(), toSamples (fileLength, 44100.0));
+        }
+    }
 }
 
 #endif
@@ -405,6 +405,8 @@ public:
                     }
                 }
 
+                rc->recordingStream = edit.engine.getWaveInputRecordingThread().createStream (*rc->fileWriter, rc->thumbnail);
+
                 return rc;
             }
             else
@@ -639,6 +641,12 @@ public:
               editPlaybackContext (epc), file (f)
         {}
 
+        ~WaveRecordingContext() override
+        {
+            if (recordingStream != nullptr)
+                engine.getWaveInputRecordingThread().closeStream (*recordingStream);
+        }
+
         EditPlaybackContext& editPlaybackContext;
         Engine& engine { editPlaybackContext.edit.engine };
         juce::File file;
@@ -655,11 +663,11 @@ public:
         std::atomic<bool> muteTargetNow { false };
         const bool muteTrackContentsWhilstRecording = engine.getEngineBehaviour().muteTrackContentsWhilstRecording();
 
-        std::mutex fileWriterLock;
         std::unique_ptr<AudioFileWriter> fileWriter;
 
         DiskSpaceCheckTask diskSpaceChecker { engine, file };
         RecordingThumbnailManager::Thumbnail::Ptr thumbnail;
+        std::shared_ptr<WaveInputRecordingThread::Stream> recordingStream; /**< Set before the context is used on the audio thread. */
         WaveInputRecordingThread::ScopedInitialiser threadInitialiser { engine.getWaveInputRecordingThread() };
         const detail::ScopedActiveRecordingDevice scopedActiveRecordingDevice { editPlaybackContext };
 
@@ -671,11 +679,8 @@ public:
             if (isWaitingToClose.load (std::memory_order_acquire))
                 return;
 
-            std::scoped_lock sl (fileWriterLock);
-
-            if (fileWriter != nullptr)
-                engine.getWaveInputRecordingThread().addBlockToRecord (*fileWriter, buffer,
-                                                                       start, numSamples, thumbnail);
+            if (recordingStream != nullptr)
+                recordingStream->write (buffer, start, numSamples);
         }
 
         void stopRecording()
@@ -692,14 +697,10 @@ public:
             assert (isWaitingToClose);
 
             CRASH_TRACER
-            auto extractedFileWriter = [this]
-            {
-                std::scoped_lock sl (fileWriterLock);
-                return std::move (fileWriter);
-            }();
+            if (recordingStream != nullptr)
+                engine.getWaveInputRecordingThread().closeStream (*recordingStream);
 
-            if (extractedFileWriter)
-                engine.getWaveInputRecordingThread().waitForWriterToFinish (*extractedFileWriter);
+            fileWriter.reset();
         }
     };
 
@@ -739,6 +740,9 @@ public:
             return {};
         }
 
+        if (rc->thumbnail != nullptr)
+            rc->thumbnail->savePeakFile();
+
         // Never loop or punch record to slots
         const bool isClipSlot = dynamic_cast<ClipSlot*> (clipOwner) != nullptr;
         const bool wasPunchRecording = isClipSlot ? false : edit.recordingPunchInOut;
@@ -1666,145 +1670,48 @@ void WaveInputDevice::updateRetrospectiveBufferLength (double length)
 }
 
 //==============================================================================
-struct WaveInputRecordingThread::BlockQueue
+WaveInputRecordingThread::Stream::Stream (AudioFileWriter& w, const RecordingThumbnailManager::Thumbnail::Ptr& thumb)
+    : writer (w), thumbnail (thumb),
+      fifo (w.getNumChannels(), (int) (w.getSampleRate() * streamBufferLengthSeconds)),
+      writeBuffer (w.getNumChannels(), minSamplesPerWrite * 4),
+      capacity ((int) (w.getSampleRate() * streamBufferLengthSeconds))
 {
-    BlockQueue()
-    {
-        for (int i = 32; --i >= 0;)
-            addToFreeQueue (new QueuedBlock());
-    }
-
-    struct QueuedBlock
-    {
-        QueuedBlock() = default;
-
-        void load (AudioFileWriter& w, const juce::AudioBuffer<float>& newBuffer,
-                   int start, int numSamples, const RecordingThumbnailManager::Thumbnail::Ptr& thumb)
-        {
-            buffer.setSize (newBuffer.getNumChannels(), numSamples);
-
-            for (int i = buffer.getNumChannels(); --i >= 0;)
-                buffer.copyFrom (i, 0, newBuffer, i, start, numSamples);
-
-            writer = &w;
-            thumbnail = thumb;
-        }
-
-        std::atomic<AudioFileWriter*> writer { nullptr };
-        QueuedBlock* next = nullptr;
-        juce::AudioBuffer<float> buffer { 2, 512 };
-        RecordingThumbnailManager::Thumbnail::Ptr thumbnail;
-
-        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (QueuedBlock)
-    };
-
-    juce::CriticalSection freeQueueLock, pendingQueueLock;
-    QueuedBlock* firstPending = nullptr;
-    QueuedBlock* lastPending = nullptr;
-    QueuedBlock* firstFree = nullptr;
-    std::atomic<int> numPending { 0 };
-
-    QueuedBlock* findFreeBlock()
-    {
-        const juce::ScopedLock sl (freeQueueLock);
-
-        if (firstFree == nullptr)
-            return new QueuedBlock();
-
-        auto* b = firstFree;
-        firstFree = b->next;
-        b->next = nullptr;
-        return b;
-    }
-
-    void addToFreeQueue (QueuedBlock* b) noexcept
-    {
-        jassert (b != nullptr);
-        const juce::ScopedLock sl (freeQueueLock);
-        b->writer = nullptr;
-        b->next = firstFree;
-        firstFree = b;
-    }
-
-    void addToPendingQueue (QueuedBlock* b) noexcept
-    {
-        jassert (b != nullptr);
-        b->next = nullptr;
-        const juce::ScopedLock sl (pendingQueueLock);
-
-        if (lastPending != nullptr)
-            lastPending->next = b;
-        else
-            firstPending = b;
-
-        lastPending = b;
-        ++numPending;
-    }
-
-    QueuedBlock* removeFirstPending() noexcept
-    {
-        const juce::ScopedLock sl (pendingQueueLock);
-
-        if (auto b = firstPending)
-        {
-            firstPending = b->next;
-
-            if (firstPending == nullptr)
-                lastPending = nullptr;
-
-            --numPending;
-            return b;
-        }
-
-        return {};
-    }
-
-    void moveAnyPendingBlocksToFree() noexcept
-    {
-        while (auto b = removeFirstPending())
-            addToFreeQueue (b);
-
-        jassert (numPending == 0);
-        numPending = 0;
-    }
-
-    bool isWriterInQueue (AudioFileWriter& writer) const
-    {
-        const juce::ScopedLock sl (pendingQueueLock);
+}
 
-        for (auto b = firstPending; b != nullptr; b = b->next)
-            if (b->writer == &writer)
-                return true;
+WaveInputRecordingThread::Stream::~Stream()
+{
+}
 
+bool WaveInputRecordingThread::Stream::write (const juce::AudioBuffer<float>& buffer, int start, int numSamples) noexcept
+{
+    if (closing.load (std::memory_order_acquire))
         return false;
-    }
 
-    void deleteFreeQueue() noexcept
-    {
-        auto b = firstFree;
-        firstFree = nullptr;
+    // Once a block has been dropped, the following ones are too until the
+    // writer thread has caught up and filled the gap with silence
+    if (numSamplesDropped.load (std::memory_order_acquire) == 0
+         && fifo.write (buffer, start, numSamples))
+        return true;
 
-        while (b != nullptr)
-        {
-            std::unique_ptr<QueuedBlock> toDelete (b);
-            b = b->next;
-        }
-    }
-};
+    numSamplesDropped.fetch_add (numSamples, std::memory_order_acq_rel);
+    return false;
+}
+
+float WaveInputRecordingThread::Stream::getFillProportion() const noexcept
+{
+    return fifo.getNumReady() / (float) std::max (1, capacity);
+}
 
 //==============================================================================
 WaveInputRecordingThread::WaveInputRecordingThread (Engine& e)
     : Thread ("WaveInputRecordingThread"),
-      engine (e),
-      queue (new BlockQueue())
+      engine (e)
 {
 }
 
 WaveInputRecordingThread::~WaveInputRecordingThread()
 {
     flushAndStop();
-    queue->deleteFreeQueue();
-    queue.reset();
 }
 
 void WaveInputRecordingThread::addUser()
@@ -1820,24 +1727,65 @@ void WaveInputRecordingThread::removeUser()
 }
 
 //==============================================================================
-void WaveInputRecordingThread::addBlockToRecord (AudioFileWriter& writer, const juce::AudioBuffer<float>& buffer,
-                                                 int start, int numSamples, const RecordingThumbnailManager::Thumbnail::Ptr& thumbnail)
+std::shared_ptr<WaveInputRecordingThread::Stream> WaveInputRecordingThread::createStream (AudioFileWriter& writer,
+                                                                                        const RecordingThumbnailManager::Thumbnail::Ptr& thumbnail)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    jassert (writer.isOpen());
+
+    std::shared_ptr<Stream> stream (new Stream (writer, thumbnail));
+
+    const juce::ScopedLock sl (streamsLock);
+    streams.push_back (stream);
+
+    return stream;
+}
+
+void WaveInputRecordingThread::closeStream (Stream& stream)
+{
+    CRASH_TRACER
+
+    if (stream.closing.exchange (true, std::memory_order_acq_rel))
+        return;
+
+    notify();
+
+    while (! stream.finishedEvent.wait (100))
+    {
+        // If the thread has stopped, write what's left here instead
+        if (! isThreadRunning())
+        {
+            writeStream (stream, true);
+            removeStream (stream);
+            break;
+        }
+    }
+}
+
+void WaveInputRecordingThread::removeStream (Stream& stream)
 {
-    if (! threadShouldExit())
     {
-        auto block = queue->findFreeBlock();
-        block->load (writer, buffer, start, numSamples, thumbnail);
-        queue->addToPendingQueue (block);
-        notify();
+        const juce::ScopedLock sl (streamsLock);
+        std::erase_if (streams, [&stream] (auto& s) { return s.get() == &stream; });
     }
+
+    stream.finishedEvent.signal();
+}
+
+//==============================================================================
+WaveInputRecordingThread::Statistics WaveInputRecordingThread::getStatistics() const
+{
+    const std::scoped_lock sl (statisticsMutex);
+    return statistics;
 }
 
-void WaveInputRecordingThread::waitForWriterToFinish (AudioFileWriter& writer)
+void WaveInputRecordingThread::resetStatistics()
 {
-    while (queue->isWriterInQueue (writer) && isThreadRunning())
-        Thread::sleep (2);
+    const std::scoped_lock sl (statisticsMutex);
+    statistics = {};
 }
 
+//==============================================================================
 void WaveInputRecordingThread::run()
 {
     CRASH_TRACER
@@ -1845,40 +1793,113 @@ void WaveInputRecordingThread::run()
 
     for (;;)
     {
-        if (queue->numPending > 500 && ! hasWarned)
+        const bool shouldExit = threadShouldExit();
+        writePendingBlocks (shouldExit);
+
+        if (shouldExit)
+            break;
+
+        // The audio thread doesn't wake this up so it can stay lock-free, the
+        // rings are big enough to just check them periodically instead
+        wait (20);
+    }
+}
+
+void WaveInputRecordingThread::writePendingBlocks (bool flushAll)
+{
+    std::vector<std::shared_ptr<Stream>> streamsToWrite;
+
+    {
+        const juce::ScopedLock sl (streamsLock);
+        streamsToWrite = streams;
+    }
+
+    for (auto& stream : streamsToWrite)
+    {
+        const bool isClosing = stream->closing.load (std::memory_order_acquire);
+        writeStream (*stream, flushAll || isClosing);
+
+        if (isClosing)
+            removeStream (*stream);
+    }
+}
+
+void WaveInputRecordingThread::writeStream (Stream& stream, bool flushAll)
+{
+    const std::scoped_lock sl (stream.drainMutex);
+
+    // Once samples have been dropped, nothing more is added to the ring so
+    // everything that's ready now was recorded before the gap
+    auto numDropped = stream.numSamplesDropped.load (std::memory_order_acquire);
+    auto numReady = stream.fifo.getNumReady();
+
+    if (numReady < minSamplesPerWrite && numDropped == 0 && ! flushAll)
+        return;
+
+    {
+        const std::scoped_lock statsLock (statisticsMutex);
+        statistics.maxFillProportion = std::max (statistics.maxFillProportion, stream.getFillProportion());
+    }
+
+    while (numReady > 0)
+    {
+        const auto numThisTime = std::min (numReady, stream.writeBuffer.getNumSamples());
+        stream.fifo.read (stream.writeBuffer, 0, numThisTime);
+        appendToFile (stream, numThisTime);
+        numReady -= numThisTime;
+    }
+
+    if (numDropped == 0)
+        return;
+
+    if (! hasWarned.exchange (true))
+        TRACKTION_LOG_ERROR ("Audio recording can't keep up!");
+
+    // Fill the gap with silence before letting the audio thread add to the ring again.
+    // If more blocks have been dropped in the meantime, they're filled too
+    stream.writeBuffer.clear();
+    SampleCount numFilled = 0;
+
+    for (;;)
+    {
+        for (auto numToFill = numDropped - numFilled; numToFill > 0;)
         {
-            hasWarned = true;
-            TRACKTION_LOG_ERROR ("Audio recording can't keep up!");
+            const auto numThisTime = (int) std::min<SampleCount> (numToFill, stream.writeBuffer.getNumSamples());
+            appendToFile (stream, numThisTime);
+            numToFill -= numThisTime;
         }
 
-        if (auto block = queue->removeFirstPending())
-        {
-            if (! block->writer.load()->appendBuffer (block->buffer, block->buffer.getNumSamples()))
-            {
-                if (! hasSentStop)
-                {
-                    hasSentStop = true;
-                    TRACKTION_LOG_ERROR ("Audio recording failed to write to disk!");
-                    startTimer (1);
-                }
-            }
+        numFilled = numDropped;
 
-            if (block->thumbnail != nullptr)
-            {
-                block->thumbnail->addBlock (block->buffer, 0, block->buffer.getNumSamples());
-                block->thumbnail = nullptr;
-            }
+        if (stream.numSamplesDropped.compare_exchange_strong (numDropped, 0, std::memory_order_acq_rel))
+            break;
+    }
 
-            queue->addToFreeQueue (block);
-        }
-        else
-        {
-            if (threadShouldExit())
-                break;
+    const std::scoped_lock statsLock (statisticsMutex);
+    statistics.numSamplesDropped += numFilled;
+}
 
-            wait (401);
-        }
+bool WaveInputRecordingThread::appendToFile (Stream& stream, int numSamples)
+{
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    const bool ok = stream.writer.appendBuffer (stream.writeBuffer, numSamples);
+    const auto duration = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+    if (! ok && ! hasSentStop.exchange (true))
+    {
+        TRACKTION_LOG_ERROR ("Audio recording failed to write to disk!");
+        startTimer (1);
     }
+
+    if (stream.thumbnail != nullptr)
+        stream.thumbnail->addBlock (stream.writeBuffer, 0, numSamples);
+
+    const std::scoped_lock sl (statisticsMutex);
+    statistics.numSamplesWritten += numSamples;
+    statistics.numWrites++;
+    statistics.maxWriteDurationMs = std::max (statistics.maxWriteDurationMs, duration);
+
+    return ok;
 }
 
 void WaveInputRecordingThread::timerCallback()
@@ -1900,7 +1921,6 @@ void WaveInputRecordingThread::flushAndStop()
     signalThreadShouldExit();
     notify();
     stopThread (30000);
-    queue->moveAnyPendingBlocksToFree();
     hasSentStop = false;
     hasWarned = false;
 }
@@ -107,6 +107,15 @@ private:
 
 
 //==============================================================================
+/**
+    Writes the audio being recorded to disk on a background thread.
+
+    Each file being recorded has a Stream which holds a preallocated lock-free
+    ring of samples. The audio thread adds blocks to this and the writer thread
+    periodically drains them, coalescing the blocks in to large writes.
+    If the disk can't keep up and a ring fills, the samples that don't fit are
+    dropped and replaced with silence so the recording stays in time.
+*/
 class WaveInputRecordingThread  : public juce::Thread,
                                   private juce::Timer
 {
@@ -115,6 +124,81 @@ public:
     WaveInputRecordingThread (Engine&);
     ~WaveInputRecordingThread() override;
 
+    /** The length of audio each Stream can hold before it overflows.
+        This is long enough to ride out slow disks and offline processing that's
+        running much faster than real time.
+    */
+    static constexpr double streamBufferLengthSeconds = 10.0;
+
+    /** The minimum number of samples that are written at once, unless a Stream is closing. */
+    static constexpr int minSamplesPerWrite = 8192;
+
+    //==============================================================================
+    /** The ring of samples waiting to be written for one file.
+        Create one of these with createStream and call closeStream when the
+        recording has finished.
+    */
+    class Stream
+    {
+    public:
+        /** Destructor. */
+        ~Stream();
+
+        /** Adds a block of samples to be written.
+            This is lock-free and can be called from the audio thread.
+            Returns false if there wasn't room for it.
+        */
+        bool write (const juce::AudioBuffer<float>&, int start, int numSamples) noexcept;
+
+        /** Returns the proportion of the ring that's currently filled. */
+        float getFillProportion() const noexcept;
+
+    private:
+        friend class WaveInputRecordingThread;
+
+        Stream (AudioFileWriter&, const RecordingThumbnailManager::Thumbnail::Ptr&);
+
+        AudioFileWriter& writer;
+        RecordingThumbnailManager::Thumbnail::Ptr thumbnail;
+        AudioFifo fifo;
+        juce::AudioBuffer<float> writeBuffer;
+        const int capacity;
+        std::atomic<SampleCount> numSamplesDropped { 0 };
+        std::atomic<bool> closing { false };
+        std::mutex drainMutex;
+        juce::WaitableEvent finishedEvent;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Stream)
+    };
+
+    /** Creates a Stream to write to a file.
+        This should be called on the message thread after the thread has been
+        started with a ScopedInitialiser.
+    */
+    std::shared_ptr<Stream> createStream (AudioFileWriter&, const RecordingThumbnailManager::Thumbnail::Ptr&);
+
+    /** Blocks until all the samples added to a Stream have been written and
+        then stops writing to it. No more blocks will be accepted by the Stream.
+    */
+    void closeStream (Stream&);
+
+    //==============================================================================
+    /** Statistics about how well the disk has been keeping up with the recording. */
+    struct Statistics
+    {
+        SampleCount numSamplesWritten = 0;  /**< The number of samples written across all the files. */
+        SampleCount numSamplesDropped = 0;  /**< The number of samples replaced with silence because a ring was full. */
+        int64_t numWrites = 0;              /**< The number of coalesced writes made. */
+        float maxFillProportion = 0.0f;     /**< The fullest any ring has been when it was drained. */
+        double maxWriteDurationMs = 0.0;    /**< The longest time a single write took. */
+    };
+
+    /** Returns the statistics since they were last reset. */
+    Statistics getStatistics() const;
+
+    /** Resets the statistics. */
+    void resetStatistics();
+
     //==============================================================================
     struct ScopedInitialiser
     {
@@ -128,9 +212,6 @@ public:
     void removeUser();
 
     //==============================================================================
-    void addBlockToRecord (AudioFileWriter&, const juce::AudioBuffer<float>&,
-                           int start, int numSamples, const RecordingThumbnailManager::Thumbnail::Ptr&);
-    void waitForWriterToFinish (AudioFileWriter&);
     void run() override;
     void timerCallback() override;
 
@@ -138,10 +219,18 @@ public:
 
 private:
     int activeUsers = 0;
-    bool hasWarned = false, hasSentStop = false;
+    std::atomic<bool> hasWarned { false }, hasSentStop { false };
+
+    juce::CriticalSection streamsLock;
+    std::vector<std::shared_ptr<Stream>> streams;
+
+    mutable std::mutex statisticsMutex;
+    Statistics statistics;
 
-    struct BlockQueue;
-    std::unique_ptr<BlockQueue> queue;
+    void writePendingBlocks (bool flushAll);
+    void writeStream (Stream&, bool flushAll);
+    bool appendToFile (Stream&, int numSamples);
+    void removeStream (Stream&);
 
     void prepareToStart();
     void flushAndStop();
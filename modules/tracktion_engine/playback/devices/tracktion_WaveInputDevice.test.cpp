@@ -406,6 +406,43 @@ namespace tracktion::inline engine
                                                            toBufferView (squareBuffer).getStart (recordedFileView.getNumFrames()- blockNumFrames),
                                                            juce::Decibels::decibelsToGain (-99.0f)));
         }
+
+        TEST_CASE ("WaveInputRecordingThread: Stream writes every sample")
+        {
+            auto& engine = *Engine::getEngines()[0];
+            auto& recordingThread = engine.getWaveInputRecordingThread();
+            const WaveInputRecordingThread::ScopedInitialiser threadInitialiser (recordingThread);
+
+            auto squareFile = graph::test_utilities::getSquareFile<juce::WavAudioFormat> (44100.0, 5.0, 2);
+            auto squareBuffer = *engine::test_utilities::loadFileInToBuffer (engine, squareFile->getFile());
+
+            juce::TemporaryFile destFile (".wav");
+            juce::WavAudioFormat format;
+
+            {
+                AudioFileWriter writer (AudioFile (engine, destFile.getFile()), &format, 2, 44100.0, 32, {}, 0);
+                REQUIRE (writer.isOpen());
+
+                recordingThread.resetStatistics();
+                auto stream = recordingThread.createStream (writer, {});
+
+                for (int start = 0; start < squareBuffer.getNumSamples(); start += 512)
+                    stream->write (squareBuffer, start, std::min (512, squareBuffer.getNumSamples() - start));
+
+                recordingThread.closeStream (*stream);
+                CHECK (! stream->write (squareBuffer, 0, 512));
+            }
+
+            const auto stats = recordingThread.getStatistics();
+            CHECK_EQ (stats.numSamplesWritten, static_cast<SampleCount> (squareBuffer.getNumSamples()));
+            CHECK_EQ (stats.numSamplesDropped, 0);
+            CHECK (stats.numWrites > 0);
+
+            auto recordedFileBuffer = *engine::test_utilities::loadFileInToBuffer (engine, destFile.getFile());
+            CHECK_EQ (squareBuffer.getNumSamples(), recordedFileBuffer.getNumSamples());
+            CHECK (graph::test_utilities::buffersAreEqual (recordedFileBuffer, squareBuffer,
+                                                           juce::Decibels::decibelsToGain (-99.0f)));
+        }
     }
 #endif
 
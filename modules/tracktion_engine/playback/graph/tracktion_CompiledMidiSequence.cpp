@@ -0,0 +1,155 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+CompiledMidiSequence::CompiledMidiSequence (const juce::MidiMessageSequence& source)
+{
+    sequence.events.reserve ((size_t) source.getNumEvents());
+
+    for (auto meh : source)
+        sequence.events.push_back ({ meh->message.getTimeStamp(),
+                                     { meh->message.getRawData(), (size_t) meh->message.getRawDataSize() } });
+
+    sequence.sortEvents();
+    compile();
+}
+
+void CompiledMidiSequence::reserve (size_t numEvents)
+{
+    sequence.events.reserve (numEvents);
+    times.reserve (numEvents);
+    packedMessages.reserve (numEvents);
+    noteOffIndexes.reserve (numEvents);
+}
+
+void CompiledMidiSequence::replaceEvents (choc::midi::Sequence& newSequence)
+{
+    jassert (std::is_sorted (newSequence.begin(), newSequence.end()));
+    std::swap (sequence.events, newSequence.events);
+    compile();
+}
+
+//==============================================================================
+bool CompiledMidiSequence::isNoteOn (size_t index) const noexcept
+{
+    const auto packed = packedMessages[index];
+    return (packed & 0xf0) == 0x90 && ((packed >> 16) & 0xff) != 0;
+}
+
+bool CompiledMidiSequence::isNoteOff (size_t index) const noexcept
+{
+    const auto packed = packedMessages[index];
+    return (packed & 0xf0) == 0x80 || ((packed & 0xf0) == 0x90 && ((packed >> 16) & 0xff) == 0);
+}
+
+std::optional<size_t> CompiledMidiSequence::getNoteOffIndex (size_t noteOnIndex) const noexcept
+{
+    if (const auto noteOffIndex = noteOffIndexes[noteOnIndex]; noteOffIndex != noNoteOff)
+        return noteOffIndex;
+
+    return {};
+}
+
+juce::MidiMessage CompiledMidiSequence::getMessage (size_t index) const
+{
+    const auto packed = packedMessages[index];
+
+    // Long messages aren't packed so have to be read from the sequence
+    if (packed == 0)
+        return toMidiMessage (sequence.events[index]);
+
+    const uint8_t data[] = { static_cast<uint8_t> (packed),
+                             static_cast<uint8_t> (packed >> 8),
+                             static_cast<uint8_t> (packed >> 16) };
+
+    return { data, static_cast<int> (packed >> 24), times[index] };
+}
+
+size_t CompiledMidiSequence::indexOfTime (double time) const noexcept
+{
+    return static_cast<size_t> (std::distance (times.begin(), std::lower_bound (times.begin(), times.end(), time)));
+}
+
+//==============================================================================
+void CompiledMidiSequence::compile()
+{
+    const auto numEvents = sequence.events.size();
+    times.resize (numEvents);
+    packedMessages.resize (numEvents);
+    noteOffIndexes.assign (numEvents, noNoteOff);
+
+    for (size_t i = 0; i < numEvents; ++i)
+    {
+        const auto& e = sequence.events[i];
+        times[i] = e.timeStamp;
+        packedMessages[i] = 0;
+
+        if (const auto& m = e.message; m.isShortMessage() && m.length() > 0)
+        {
+            const auto data = m.data();
+            const auto length = m.length();
+
+            packedMessages[i] = static_cast<uint32_t> (data[0])
+                                 | (length > 1 ? static_cast<uint32_t> (data[1]) << 8 : 0u)
+                                 | (length > 2 ? static_cast<uint32_t> (data[2]) << 16 : 0u)
+                                 | (length << 24);
+        }
+    }
+
+    // Pair each note-on with the first note-off after it on the same channel and note number.
+    // Going backwards, this is the last note-off seen for that key.
+    std::array<uint32_t, 16 * 128> nextNoteOffs;
+    nextNoteOffs.fill (noNoteOff);
+
+    for (size_t i = numEvents; i-- > 0;)
+    {
+        const auto packed = packedMessages[i];
+
+        if (packed == 0)
+            continue;
+
+        const auto key = ((packed & 0x0f) << 7) | ((packed >> 8) & 0x7f);
+
+        if (isNoteOff (i))
+            nextNoteOffs[key] = static_cast<uint32_t> (i);
+        else if (isNoteOn (i))
+            noteOffIndexes[i] = nextNoteOffs[key];
+    }
+}
+
+//==============================================================================
+//==============================================================================
+CompiledMidiSequence::Cursor::Cursor (const CompiledMidiSequence& s)
+    : sequence (&s)
+{
+}
+
+void CompiledMidiSequence::Cursor::setSequence (const CompiledMidiSequence& s)
+{
+    sequence = &s;
+    index = 0;
+}
+
+void CompiledMidiSequence::Cursor::setTime (double time)
+{
+    const auto numEvents = sequence->size();
+
+    // Playback is usually contiguous so check if we're already in the right place first
+    if (index <= numEvents
+        && (index == numEvents || sequence->getTime (index) >= time)
+        && (index == 0 || sequence->getTime (index - 1) < time))
+       return;
+
+    index = sequence->indexOfTime (time);
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,119 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    A flat form of a MIDI sequence that's quick to play back.
+
+    The events are sorted and held as separate arrays of times and packed short
+    messages, with each note-on already paired with its note-off, so playing
+    through it doesn't need to do any searching or allocating.
+
+    These are built when a Node is prepared, rather than on the audio thread, and
+    are immutable once shared so can be used by several Nodes at once.
+*/
+class CompiledMidiSequence
+{
+public:
+    /** Creates an empty sequence. */
+    CompiledMidiSequence() = default;
+
+    /** Creates a compiled version of a juce::MidiMessageSequence. */
+    explicit CompiledMidiSequence (const juce::MidiMessageSequence&);
+
+    /** Reserves space for a number of events so replaceEvents won't need to allocate. */
+    void reserve (size_t numEvents);
+
+    /** Replaces the events with those in a sorted sequence.
+        This swaps the sequence's events in to avoid copying or allocating so the
+        sequence passed in will be left holding the old events.
+    */
+    void replaceEvents (choc::midi::Sequence&);
+
+    //==============================================================================
+    /** Returns the number of events. */
+    size_t size() const noexcept                            { return times.size(); }
+
+    /** Returns true if there aren't any events. */
+    bool isEmpty() const noexcept                           { return times.empty(); }
+
+    /** Returns the time of an event. */
+    double getTime (size_t index) const noexcept            { return times[index]; }
+
+    /** Returns true if an event is a note-on. */
+    bool isNoteOn (size_t index) const noexcept;
+
+    /** Returns true if an event is a note-off. */
+    bool isNoteOff (size_t index) const noexcept;
+
+    /** Returns the index of the note-off paired with a note-on, if it has one. */
+    std::optional<size_t> getNoteOffIndex (size_t noteOnIndex) const noexcept;
+
+    /** Returns an event as a juce::MidiMessage. */
+    juce::MidiMessage getMessage (size_t index) const;
+
+    /** Returns the index of the first event at or after a time, or size() if there isn't one. */
+    size_t indexOfTime (double) const noexcept;
+
+    /** Returns the events as a choc::midi::Sequence. */
+    const choc::midi::Sequence& getSequence() const noexcept    { return sequence; }
+
+    //==============================================================================
+    /** Keeps track of a position in a CompiledMidiSequence. */
+    class Cursor
+    {
+    public:
+        /** Creates a Cursor at the start of a sequence. */
+        Cursor (const CompiledMidiSequence&);
+
+        /** Changes the sequence being iterated, moving back to the start. */
+        void setSequence (const CompiledMidiSequence&);
+
+        /** Moves to the first event at or after a time.
+            This is constant time if the time is at the current position.
+        */
+        void setTime (double);
+
+        /** Moves to the next event. Returns false if there are no more events. */
+        bool advance() noexcept                             { return ++index < sequence->size(); }
+
+        /** Returns true if there are no more events. */
+        bool exhausted() const noexcept                     { return index >= sequence->size(); }
+
+        /** Returns the index of the current event. */
+        size_t getIndex() const noexcept                    { return index; }
+
+        /** Returns the current event. */
+        juce::MidiMessage getEvent() const                  { return sequence->getMessage (index); }
+
+    private:
+        const CompiledMidiSequence* sequence;
+        size_t index = 0;
+    };
+
+private:
+    //==============================================================================
+    static constexpr uint32_t noNoteOff = std::numeric_limits<uint32_t>::max();
+
+    choc::midi::Sequence sequence;
+    std::vector<double> times;
+    std::vector<uint32_t> packedMessages, noteOffIndexes;
+
+    void compile();
+    uint8_t getStatusByte (size_t index) const noexcept    { return static_cast<uint8_t> (packedMessages[index] & 0xff); }
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -1793,6 +1793,15 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext&
     std::map<OutputDevice*, TrackNodeVector> deviceNodes;
     std::vector<OutputDevice*> devicesWithFrozenNodes;
 
+    auto createTrackNode = [&params] (Track& t)
+    {
+        return params.trackNodeCache != nullptr ? params.trackNodeCache->createNodeForTrack (t, params)
+                                                : createNodeForTrack (t, params);
+    };
+
+    if (params.trackNodeCache != nullptr)
+        params.trackNodeCache->beginBuild (params);
+
     for (auto t : getAllTracks (edit))
     {
         if (params.allowedTracks != nullptr && ! params.allowedTracks->contains (t))
@@ -1817,7 +1826,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext&
                         devicesWithFrozenNodes.push_back (device);
                     }
                 }
-                else if (auto node = createNodeForTrack (*t, params))
+                else if (auto node = createTrackNode (*t))
                 {
                     deviceNodes[device].push_back (std::move (node));
                 }
@@ -1825,6 +1834,9 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext&
         }
     }
 
+    if (params.trackNodeCache != nullptr)
+        params.trackNodeCache->endBuild();
+
     // Add deviceNodes for any devices only being used by InsertPlugins
     for (auto ins : insertPlugins)
     {
@@ -1976,6 +1988,1002 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (Edit& edit, const Cre
     return node;
 }
 
+//==============================================================================
+//==============================================================================
+/**
+    Renders chunks for the registered LookAheads on a few background threads,
+    always picking the one with the fewest chunks ready next.
+*/
+class TrackNodeCache::LookAheadPool
+{
+public:
+    LookAheadPool()
+    {
+        const auto numThreads = juce::jlimit (1, 4, juce::SystemStats::getNumCpus() / 2);
+
+        for (int i = 0; i < numThreads; ++i)
+            threads.emplace_back ([this] { process(); });
+    }
+
+    ~LookAheadPool()
+    {
+        waitingToExitFlag.test_and_set();
+        workAvailable.signal ((int) threads.size());
+
+        for (auto& t : threads)
+            t.join();
+    }
+
+    void addInstance (LookAhead& instance)
+    {
+        const std::unique_lock sl (instancesMutex);
+        instances.push_back (&instance);
+        workAvailable.signal();
+    }
+
+    void removeInstance (LookAhead& instance)
+    {
+        const std::unique_lock sl (instancesMutex);
+        std::erase (instances, &instance);
+    }
+
+    void flushAll()
+    {
+        const std::unique_lock sl (instancesMutex);
+
+        for (auto instance : instances)
+            instance->flush();
+    }
+
+    /** Wakes a thread to look for more chunks to render. [[ real_time ]] */
+    void notify()
+    {
+        workAvailable.signal();
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex instancesMutex;
+    std::vector<LookAhead*> instances;
+    std::atomic_flag waitingToExitFlag;
+    tracktion::graph::LightweightSemaphore workAvailable;
+
+    void process();
+};
+
+//==============================================================================
+/**
+    Renders a track's CachedGraph ahead of the playhead in to a ring of chunks.
+
+    The Nodes in the graph are built with this object's ProcessState so they can
+    be processed independently of the Edit's playhead. Either one of the
+    LookAheadPool's threads or the audio thread can own the graph at a time.
+    Whilst playing, the pool fills the ring and the audio thread just copies out
+    the chunks. If the next chunk isn't ready or doesn't start where the
+    playhead is, the audio thread plays any frames that do match, takes over
+    the graph, discards the rest of the chunks and processes the remainder of
+    the block itself. The pool then carries on from there.
+
+    If the pool is rendering a chunk when the audio thread needs the graph, it
+    abandons it at the end of the block it's processing so the audio thread only
+    ever waits for one block's worth of the track.
+
+    A flush doesn't discard anything straight away. The pool stops rendering and
+    the chunks already rendered are played up to the next chunk boundary, where
+    the audio thread takes over if the graph is free. If it isn't, the next
+    chunk is played and it tries again at the end of that one.
+*/
+class TrackNodeCache::LookAhead
+{
+public:
+    LookAhead (std::shared_ptr<LookAheadPool> poolToUse, const TempoSequence& tempoSequence)
+        : pool (std::move (poolToUse)),
+          processState (playHeadState, tempoSequence)
+    {
+    }
+
+    ~LookAhead()
+    {
+        stop();
+    }
+
+    /** Returns the state to build the track's Nodes with. */
+    ProcessState& getProcessState()     { return processState; }
+
+    /** Starts rendering once the graph has been prepared. */
+    void start (NodeGraph& graphToProcess, int numChannels, double newSampleRate, int newBlockSize)
+    {
+        graph = &graphToProcess;
+        sampleRate = newSampleRate;
+        maxBlockSize = (choc::buffer::FrameCount) newBlockSize;
+
+        for (auto& chunk : chunks)
+            chunk.audio.resize ({ (choc::buffer::ChannelCount) numChannels, (choc::buffer::FrameCount) lookAheadChunkSize });
+
+        pool->addInstance (*this);
+    }
+
+    /** Stops rendering, waiting for any chunk currently being rendered. */
+    void stop()
+    {
+        if (graph == nullptr)
+            return;
+
+        pool->removeInstance (*this);
+
+        while (! claim (Owner::stopped))
+            std::this_thread::yield();
+
+        graph = nullptr;
+    }
+
+    /** Discards any rendered chunks at the next chunk boundary. */
+    void flush()
+    {
+        needsFlush.store (true, std::memory_order_release);
+    }
+
+    //==============================================================================
+    /** Returns true if the pool should render the next chunk. */
+    bool needsRendering (int& numChunksReady) const
+    {
+        if (! isActive.load (std::memory_order_acquire))
+            return false;
+
+        numChunksReady = getNumChunksReady();
+        return numChunksReady < numLookAheadChunks;
+    }
+
+    /** Tries to take ownership of the graph for the pool. */
+    bool claimForRendering()            { return claim (Owner::pool); }
+
+    /** Renders the next chunk, must only be called after claimForRendering
+        succeeded and this releases the graph afterwards.
+    */
+    void renderNextChunkAndRelease()
+    {
+        // The audio thread might have taken over and stopped since this was picked
+        if (isActive.load (std::memory_order_acquire)
+            && ! takeOverRequested.load (std::memory_order_acquire)
+            && getNumChunksReady() < numLookAheadChunks)
+            renderNextChunk();
+
+        release();
+    }
+
+    //==============================================================================
+    /** Fills the block from the rendered chunks or processes the graph directly. [[ real_time ]] */
+    void process (Node::ProcessContext& pc, ProcessState& mainProcessState)
+    {
+        auto& mainPlayHead = mainProcessState.playHeadState.playHead;
+        const auto mainLoopRange = mainPlayHead.getLoopRange();
+        loopStart.store (mainLoopRange.getStart(), std::memory_order_relaxed);
+        loopEnd.store (mainLoopRange.getEnd(), std::memory_order_relaxed);
+        isLooping.store (mainPlayHead.isLooping(), std::memory_order_release);
+
+        const bool canUseChunks = mainPlayHead.isPlaying()
+                                    && ! mainPlayHead.isUserDragging()
+                                    && mainProcessState.playbackSpeedRatio == 1.0
+                                    && mainProcessState.timelineSampleRange.getLength() == (int64_t) pc.numSamples;
+        const auto timelineStart = mainProcessState.timelineSampleRange.getStart();
+        choc::buffer::FrameCount numFramesRead = 0;
+
+        if (needsFlush.load (std::memory_order_acquire))
+        {
+            // Stop the pool rendering with the old state and finish the chunk being played
+            requestTakeOver();
+
+            if (canUseChunks && readOffset > 0)
+            {
+                numFramesRead = readChunks (pc, timelineStart, 0, true);
+
+                if (numFramesRead == pc.numSamples)
+                    return;
+            }
+
+            if (claim (Owner::audioThread))
+            {
+                processRemainingFrames (pc, mainProcessState, canUseChunks, numFramesRead);
+                return;
+            }
+        }
+
+        if (canUseChunks)
+        {
+            numFramesRead += readChunks (pc, timelineStart, numFramesRead, false);
+
+            if (numFramesRead == pc.numSamples)
+                return;
+        }
+
+        takeOver();
+        processRemainingFrames (pc, mainProcessState, canUseChunks, numFramesRead);
+    }
+
+private:
+    //==============================================================================
+    enum class Owner
+    {
+        none,
+        pool,
+        audioThread,
+        stopped
+    };
+
+    struct Chunk
+    {
+        choc::buffer::ChannelArrayBuffer<float> audio;
+        int64_t timelineStart = 0;
+        choc::buffer::FrameCount numFrames = 0;
+    };
+
+    std::shared_ptr<LookAheadPool> pool;
+    tracktion::graph::PlayHead playHead;
+    tracktion::graph::PlayHeadState playHeadState { playHead };
+    ProcessState processState;
+    NodeGraph* graph = nullptr;
+    double sampleRate = 44100.0;
+    choc::buffer::FrameCount maxBlockSize = 0;
+
+    std::atomic<Owner> owner { Owner::none };
+    std::array<Chunk, numLookAheadChunks> chunks;
+    std::atomic<size_t> readIndex { 0 }, writeIndex { 0 };
+    std::atomic<bool> isActive { false }, needsFlush { false }, takeOverRequested { false }, isLooping { false };
+    std::atomic<int64_t> loopStart { 0 }, loopEnd { 0 };
+
+    // Only accessed by the audio thread
+    choc::buffer::FrameCount readOffset = 0;
+
+    // Only accessed by the owner of the graph
+    int64_t nextReferenceSample = 0, nextTimelineSample = 0;
+
+    //==============================================================================
+    bool claim (Owner newOwner) noexcept
+    {
+        auto expected = Owner::none;
+        return owner.compare_exchange_strong (expected, newOwner, std::memory_order_acquire);
+    }
+
+    void release() noexcept
+    {
+        owner.store (Owner::none, std::memory_order_release);
+    }
+
+    int getNumChunksReady() const noexcept
+    {
+        return (int) (writeIndex.load (std::memory_order_acquire) - readIndex.load (std::memory_order_acquire));
+    }
+
+    /** Stops the pool starting any more chunks and makes it abandon the one it's rendering. */
+    void requestTakeOver() noexcept
+    {
+        isActive.store (false, std::memory_order_release);
+        takeOverRequested.store (true, std::memory_order_release);
+    }
+
+    /** Takes ownership of the graph for the audio thread.
+        The pool checks for this between each block of a chunk so this only waits
+        for as long as it takes to process one block of the track.
+    */
+    void takeOver() noexcept
+    {
+        requestTakeOver();
+
+        while (! claim (Owner::audioThread))
+        {
+           #if JUCE_INTEL
+            _mm_pause();
+           #else
+            __asm__ __volatile__ ("yield");
+           #endif
+        }
+    }
+
+    //==============================================================================
+    /** Copies as many frames as possible from the rendered chunks in to the block,
+        starting at startFrame, and returns the number copied.
+        If stopAtEndOfChunk is true, this only reads up to the end of the current chunk.
+    */
+    choc::buffer::FrameCount readChunks (Node::ProcessContext& pc, int64_t timelineStart,
+                                         choc::buffer::FrameCount startFrame, bool stopAtEndOfChunk)
+    {
+        const auto numChannels = std::min (chunks[0].audio.getNumChannels(), pc.buffers.audio.getNumChannels());
+        auto numDone = startFrame;
+
+        while (numDone < pc.numSamples)
+        {
+            const auto index = readIndex.load (std::memory_order_relaxed);
+
+            if (index == writeIndex.load (std::memory_order_acquire))
+                break;
+
+            auto& chunk = chunks[index % chunks.size()];
+
+            if (chunk.timelineStart + readOffset != timelineStart + numDone)
+                break;
+
+            const auto numToCopy = std::min (chunk.numFrames - readOffset, pc.numSamples - numDone);
+
+            if (numChannels > 0)
+                copy (pc.buffers.audio.getFrameRange ({ numDone, numDone + numToCopy }).getFirstChannels (numChannels),
+                      chunk.audio.getFrameRange ({ readOffset, readOffset + numToCopy }).getFirstChannels (numChannels));
+
+            numDone += numToCopy;
+            readOffset += numToCopy;
+
+            if (readOffset == chunk.numFrames)
+            {
+                readOffset = 0;
+                readIndex.store (index + 1, std::memory_order_release);
+                pool->notify();
+
+                if (stopAtEndOfChunk)
+                    break;
+            }
+        }
+
+        return numDone - startFrame;
+    }
+
+    /** Processes the rest of the block from startFrame, must only be called once the audio thread owns the graph. */
+    void processRemainingFrames (Node::ProcessContext& pc, ProcessState& mainProcessState, bool startRenderingAhead,
+                                 choc::buffer::FrameCount startFrame)
+    {
+        needsFlush.store (false, std::memory_order_release);
+        takeOverRequested.store (false, std::memory_order_release);
+        readIndex.store (writeIndex.load (std::memory_order_relaxed), std::memory_order_release);
+        readOffset = 0;
+
+        auto& mainPlayHead = mainProcessState.playHeadState.playHead;
+        processState.setPlaybackSpeedRatio (mainProcessState.playbackSpeedRatio);
+
+        if (startFrame < pc.numSamples)
+        {
+            const auto numFrames = pc.numSamples - startFrame;
+            const auto referenceStart = pc.referenceSampleRange.getStart() + (int64_t) startFrame;
+            const juce::Range<int64_t> referenceRange (referenceStart, referenceStart + (int64_t) numFrames);
+
+            if (mainPlayHead.isPlaying())
+            {
+                processGraph (referenceRange, mainProcessState.timelineSampleRange.getStart() + (int64_t) startFrame, numFrames);
+            }
+            else
+            {
+                if (playHead.isPlaying())
+                    playHead.stop();
+
+                playHead.setReferenceSampleRange (referenceRange);
+                playHead.setPosition (mainPlayHead.getPosition());
+                processGraph (referenceRange, numFrames);
+            }
+
+            auto output = graph->rootNode->getProcessedOutput();
+
+            if (auto numChannels = std::min (output.audio.getNumChannels(), pc.buffers.audio.getNumChannels()))
+                copy (pc.buffers.audio.getFrameRange ({ startFrame, pc.numSamples }).getFirstChannels (numChannels),
+                      output.audio.getFirstChannels (numChannels));
+
+            // Look-ahead graphs don't output MIDI so this is only ever from the whole block
+            pc.buffers.midi.mergeFrom (output.midi);
+        }
+
+        if (mainPlayHead.isPlaying())
+        {
+            nextReferenceSample = pc.referenceSampleRange.getEnd();
+            nextTimelineSample = mainProcessState.timelineSampleRange.getStart() + (int64_t) pc.numSamples;
+        }
+
+        isActive.store (startRenderingAhead, std::memory_order_release);
+        release();
+
+        if (startRenderingAhead)
+            pool->notify();
+    }
+
+    void renderNextChunk()
+    {
+        auto timelineStart = nextTimelineSample;
+        auto numFrames = (int64_t) lookAheadChunkSize;
+
+        // Follow the playhead round the loop, chunks never cross the end of it
+        if (isLooping.load (std::memory_order_acquire))
+        {
+            const juce::Range<int64_t> loopRange (loopStart.load (std::memory_order_relaxed),
+                                                  loopEnd.load (std::memory_order_relaxed));
+
+            if (! loopRange.isEmpty())
+            {
+                if (timelineStart >= loopRange.getEnd())
+                    timelineStart = loopRange.getStart();
+
+                numFrames = std::min (numFrames, loopRange.getEnd() - timelineStart);
+            }
+        }
+
+        if (numFrames <= 0)
+            return;
+
+        // Split at tempo changes in the same way as TracktionNodePlayer
+        syncPlayHead (nextReferenceSample, timelineStart);
+        const auto referenceStart = nextReferenceSample;
+        processState.update (sampleRate, { referenceStart, referenceStart + numFrames }, ProcessState::UpdateContinuityFlags::no);
+
+        if (auto tempoPosition = processState.getTempoSequencePosition())
+        {
+            const auto nextChange = tempoPosition->getTimeOfNextChange();
+
+            if (nextChange > processState.editTimeRange.getStart() && processState.editTimeRange.contains (nextChange))
+                if (const auto numFramesToChange = toSamples (nextChange - processState.editTimeRange.getStart(), sampleRate);
+                    numFramesToChange >= 128)
+                    numFrames = numFramesToChange;
+        }
+
+        const auto index = writeIndex.load (std::memory_order_relaxed);
+        auto& chunk = chunks[index % chunks.size()];
+        chunk.audio.clear();
+
+        // The graph is prepared for the Edit's block size so the chunk is rendered in blocks of that
+        for (choc::buffer::FrameCount offset = 0; offset < (choc::buffer::FrameCount) numFrames;)
+        {
+            // The audio thread needs the graph so the chunk is abandoned
+            if (takeOverRequested.load (std::memory_order_acquire))
+                return;
+
+            const auto numThisBlock = std::min (maxBlockSize, (choc::buffer::FrameCount) numFrames - offset);
+            const auto blockStart = referenceStart + (int64_t) offset;
+            processGraph ({ blockStart, blockStart + (int64_t) numThisBlock }, numThisBlock);
+
+            auto output = graph->rootNode->getProcessedOutput();
+
+            if (auto numChannels = std::min (output.audio.getNumChannels(), chunk.audio.getNumChannels()))
+                copy (chunk.audio.getFrameRange ({ offset, offset + numThisBlock }).getFirstChannels (numChannels),
+                      output.audio.getFirstChannels (numChannels));
+
+            offset += numThisBlock;
+        }
+
+        chunk.timelineStart = timelineStart;
+        chunk.numFrames = (choc::buffer::FrameCount) numFrames;
+        writeIndex.store (index + 1, std::memory_order_release);
+
+        nextReferenceSample = referenceStart + numFrames;
+        nextTimelineSample = timelineStart + numFrames;
+    }
+
+    //==============================================================================
+    void syncPlayHead (int64_t referenceSample, int64_t timelineSample)
+    {
+        if (playHead.isPlaying() && playHead.referenceSamplePositionToTimelinePosition (referenceSample) == timelineSample)
+            return;
+
+        playHead.setReferenceSampleRange ({ referenceSample, referenceSample });
+        playHead.playSyncedToRange ({ timelineSample, std::numeric_limits<int64_t>::max() });
+    }
+
+    void processGraph (juce::Range<int64_t> referenceRange, int64_t timelineStart, choc::buffer::FrameCount numFrames)
+    {
+        syncPlayHead (referenceRange.getStart(), timelineStart);
+        processGraph (referenceRange, numFrames);
+    }
+
+    void processGraph (juce::Range<int64_t> referenceRange, choc::buffer::FrameCount numFrames)
+    {
+        playHead.setReferenceSampleRange (referenceRange);
+        processState.update (sampleRate, referenceRange, ProcessState::UpdateContinuityFlags::yes);
+
+        for (auto n : graph->orderedNodes)
+            n->prepareForNextBlock (referenceRange);
+
+        for (auto n : graph->orderedNodes)
+            n->process (numFrames, referenceRange);
+    }
+};
+
+void TrackNodeCache::LookAheadPool::process()
+{
+    for (;;)
+    {
+        if (waitingToExitFlag.test (std::memory_order_acquire))
+            return;
+
+        LookAhead* instanceToRender = nullptr;
+
+        {
+            // Instances are claimed before the lock is released so they can't be removed whilst rendering
+            const std::unique_lock sl (instancesMutex);
+            int fewestChunksReady = numLookAheadChunks;
+
+            for (auto instance : instances)
+            {
+                if (int numChunksReady = 0;
+                    instance->needsRendering (numChunksReady) && numChunksReady < fewestChunksReady)
+                {
+                    instanceToRender = instance;
+                    fewestChunksReady = numChunksReady;
+                }
+            }
+
+            if (instanceToRender != nullptr && ! instanceToRender->claimForRendering())
+                instanceToRender = nullptr;
+        }
+
+        if (instanceToRender != nullptr)
+            instanceToRender->renderNextChunkAndRelease();
+        else
+            workAvailable.wait();
+    }
+}
+
+//==============================================================================
+//==============================================================================
+struct TrackNodeCache::CachedGraph
+{
+    // This is declared first so it outlives the Nodes that refer to its ProcessState
+    std::unique_ptr<LookAhead> lookAhead;
+
+    std::unique_ptr<Node> nodeToPrepare;
+    std::shared_ptr<CachedGraph> previousGraph;
+    std::unique_ptr<NodeGraph> nodeGraph;
+    std::vector<Node*> leafNodes;
+    double preparedSampleRate = 0.0;
+    int preparedBlockSize = 0;
+
+    ~CachedGraph()
+    {
+        if (lookAhead != nullptr)
+            lookAhead->stop();
+    }
+
+    Node& getRootNode()
+    {
+        return nodeGraph != nullptr ? *nodeGraph->rootNode : *nodeToPrepare;
+    }
+
+    void prepare (double sampleRate, int blockSize, NodeGraph* mainGraphToReplace)
+    {
+        if (nodeGraph != nullptr)
+        {
+            // The cache should have been invalidated if these change
+            jassert (sampleRate == preparedSampleRate && blockSize == preparedBlockSize);
+            return;
+        }
+
+        // The previous graph for this track is passed in so any state can be carried over.
+        // If the track was flattened last time, its Nodes are in the previous main graph
+        nodeGraph = node_player_utils::prepareToPlay (std::move (nodeToPrepare),
+                                                      previousGraph != nullptr ? previousGraph->nodeGraph.get() : mainGraphToReplace,
+                                                      sampleRate, blockSize);
+        previousGraph.reset();
+        preparedSampleRate = sampleRate;
+        preparedBlockSize = blockSize;
+
+        for (auto n : nodeGraph->orderedNodes)
+            if (n->getDirectInputNodes().empty())
+                leafNodes.push_back (n);
+
+        if (lookAhead != nullptr)
+            lookAhead->start (*nodeGraph, nodeGraph->rootNode->getNodeProperties().numberOfChannels, sampleRate, blockSize);
+    }
+};
+
+//==============================================================================
+/** Processes a track's prepared CachedGraph, which can be shared with the same
+    Node in the previous graph.
+    N.B. This is safe as only one graph is ever processed at once and the
+    CachedGraph is only prepared once, by whichever Node is initialised first.
+
+    The cached sub-graph is processed serially by whichever thread processes this
+    Node so its Nodes can't be processed in parallel and their buffers aren't part
+    of the main graph's static allocation. This is why only tracks that have been
+    unchanged for a rebuild are cached, tracks being edited stay in the main graph.
+*/
+class TrackNodeCache::CachedTrackNode final  : public Node
+{
+public:
+    CachedTrackNode (std::shared_ptr<CachedGraph> graphToUse, EditItemID trackItemID, ProcessState& mainProcessStateToUse)
+        : cachedGraph (std::move (graphToUse)), trackID (trackItemID), mainProcessState (mainProcessStateToUse)
+    {
+        assert (cachedGraph != nullptr);
+    }
+
+    NodeProperties getNodeProperties() override
+    {
+        auto props = cachedGraph->getRootNode().getNodeProperties();
+        props.nodeID = 0;
+
+        constexpr size_t cachedTrackNodeMagicNum = 0x63616368656454;
+        hash_combine (props.nodeID, cachedTrackNodeMagicNum);
+        hash_combine (props.nodeID, trackID.getRawID());
+
+        return props;
+    }
+
+    std::vector<Node*> getInternalNodes() override
+    {
+        // Once prepared, these make the Nodes visible to the next graph in case
+        // the track isn't cached next time and its Nodes want to take over any state.
+        // Look-ahead Nodes are processed on other threads so can't be shared like this
+        if (cachedGraph->nodeGraph != nullptr && cachedGraph->lookAhead == nullptr)
+            return cachedGraph->nodeGraph->orderedNodes;
+
+        return {};
+    }
+
+    void prepareToPlay (const PlaybackInitialisationInfo& info) override
+    {
+        cachedGraph->prepare (info.sampleRate, info.blockSize, info.nodeGraphToReplace);
+    }
+
+    bool isReadyToProcess() override
+    {
+        // The look-ahead graph is processed on other threads so can't be checked here
+        if (cachedGraph->lookAhead != nullptr)
+            return true;
+
+        for (auto n : cachedGraph->leafNodes)
+            if (! n->isReadyToProcess())
+                return false;
+
+        return true;
+    }
+
+    void prefetchBlock (juce::Range<int64_t> referenceSampleRange) override
+    {
+        // The LookAhead prepares the Nodes if it needs to process them
+        if (cachedGraph->lookAhead != nullptr)
+            return;
+
+        for (auto n : cachedGraph->nodeGraph->orderedNodes)
+            n->prepareForNextBlock (referenceSampleRange);
+    }
+
+    void process (ProcessContext& pc) override
+    {
+        if (cachedGraph->lookAhead != nullptr)
+        {
+            cachedGraph->lookAhead->process (pc, mainProcessState);
+            return;
+        }
+
+        auto& nodeGraph = *cachedGraph->nodeGraph;
+
+        for (auto n : nodeGraph.orderedNodes)
+            n->process (pc.numSamples, pc.referenceSampleRange);
+
+        auto output = nodeGraph.rootNode->getProcessedOutput();
+
+        if (auto numChannels = std::min (output.audio.getNumChannels(), pc.buffers.audio.getNumChannels()))
+            copy (pc.buffers.audio.getFirstChannels (numChannels),
+                  output.audio.getFirstChannels (numChannels));
+
+        pc.buffers.midi.mergeFrom (output.midi);
+    }
+
+private:
+    const std::shared_ptr<CachedGraph> cachedGraph;
+    const EditItemID trackID;
+    ProcessState& mainProcessState;
+};
+
+//==============================================================================
+TrackNodeCache::TrackNodeCache (Edit& e)
+    : edit (e), state (e.state)
+{
+    state.addListener (this);
+}
+
+TrackNodeCache::~TrackNodeCache()
+{
+    state.removeListener (this);
+}
+
+void TrackNodeCache::invalidateAll()
+{
+    allTracksDirty = true;
+    flushLookAheads();
+}
+
+void TrackNodeCache::invalidateTrack (EditItemID trackID)
+{
+    dirtyTracks.insert (trackID);
+    flushLookAheads();
+}
+
+void TrackNodeCache::setLookAheadRenderingEnabled (bool enable)
+{
+    if (enable == (lookAheadPool != nullptr))
+        return;
+
+    lookAheadPool = enable ? std::make_shared<LookAheadPool>() : nullptr;
+    invalidateAll();
+}
+
+void TrackNodeCache::flushLookAheads()
+{
+    // Any state change could affect a track's output, e.g. soloing another track
+    if (lookAheadPool != nullptr)
+        lookAheadPool->flushAll();
+}
+
+void TrackNodeCache::beginBuild (const CreateNodeParams& params)
+{
+    if (params.sampleRate != sampleRate
+        || params.blockSize != blockSize
+        || params.includeBypassedPlugins != includeBypassedPlugins
+        || params.allowClipSlots != allowClipSlots
+        || params.readAheadTimeStretchNodes != readAheadTimeStretchNodes)
+    {
+        sampleRate = params.sampleRate;
+        blockSize = params.blockSize;
+        includeBypassedPlugins = params.includeBypassedPlugins;
+        allowClipSlots = params.allowClipSlots;
+        readAheadTimeStretchNodes = params.readAheadTimeStretchNodes;
+        allTracksDirty = true;
+    }
+
+    // Keep the old graphs around until the tracks are rebuilt so they can carry over their state
+    if (std::exchange (allTracksDirty, false))
+    {
+        for (auto& trackAndGraph : cachedGraphs)
+            dirtyTracks.insert (trackAndGraph.first);
+
+        dirtyTracks.insert (flattenedTracks.begin(), flattenedTracks.end());
+    }
+
+    builtTracks.clear();
+    numTracksReused = 0;
+    numTracksRebuilt = 0;
+    numTracksCached = 0;
+    numLookAheadTracks = 0;
+}
+
+namespace
+{
+    CreateNodeParams withProcessState (const CreateNodeParams& p, ProcessState& processState)
+    {
+        return { processState, p.sampleRate, p.blockSize, p.allowedClips, p.allowedTracks,
+                 p.forRendering, p.includePlugins, p.includeMasterPlugins, p.includeBypassedPlugins,
+                 p.implicitlyIncludeSubmixChildTracks, p.allowClipSlots, p.readAheadTimeStretchNodes,
+                 p.trackNodeCache };
+    }
+}
+
+std::unique_ptr<Node> TrackNodeCache::createNodeForTrack (Track& track, const CreateNodeParams& params)
+{
+    CRASH_TRACER
+    auto at = dynamic_cast<AudioTrack*> (&track);
+
+    if (at == nullptr)
+        return tracktion::engine::createNodeForTrack (track, params);
+
+    const auto trackID = at->itemID;
+    builtTracks.insert (trackID);
+    const bool isDirty = dirtyTracks.count (trackID) > 0;
+    const bool wasFlattened = flattenedTracks.erase (trackID) > 0;
+    std::shared_ptr<CachedGraph> previousGraph;
+
+    if (auto found = cachedGraphs.find (trackID); found != cachedGraphs.end())
+    {
+        if (! isDirty)
+        {
+            ++numTracksReused;
+            ++numTracksCached;
+
+            if (found->second->lookAhead != nullptr)
+                ++numLookAheadTracks;
+
+            return makeNode<CachedTrackNode> (found->second, trackID, params.processState);
+        }
+
+        previousGraph = std::move (found->second);
+        cachedGraphs.erase (found);
+    }
+
+    dirtyTracks.erase (trackID);
+    ++numTracksRebuilt;
+
+    // Tracks rendered ahead are built with their own ProcessState so they can be
+    // processed independently of the Edit's playhead
+    std::unique_ptr<LookAhead> lookAhead;
+    std::unique_ptr<Node> node;
+
+    if (lookAheadPool != nullptr && canLookAhead (*at))
+    {
+        lookAhead = std::make_unique<LookAhead> (lookAheadPool, edit.tempoSequence);
+        node = tracktion::engine::createNodeForTrack (*at, withProcessState (params, lookAhead->getProcessState()));
+
+        if (node == nullptr || ! canBeCached (*at, *node) || ! canLookAhead (*node))
+        {
+            node = tracktion::engine::createNodeForTrack (*at, params);
+            lookAhead.reset();
+        }
+    }
+    else
+    {
+        node = tracktion::engine::createNodeForTrack (*at, params);
+    }
+
+    if (node == nullptr || ! canBeCached (*at, *node))
+        return node;
+
+    // Tracks that have changed since the last build are left in the main graph so
+    // their Nodes can be processed in parallel. They're cached once they've been
+    // unchanged for a build. Look-ahead tracks are processed on other threads anyway
+    if (lookAhead == nullptr && (isDirty || ! wasFlattened))
+    {
+        flattenedTracks.insert (trackID);
+        return node;
+    }
+
+    ++numTracksCached;
+
+    if (lookAhead != nullptr)
+        ++numLookAheadTracks;
+
+    auto cachedGraph = std::make_shared<CachedGraph>();
+    cachedGraph->lookAhead = std::move (lookAhead);
+    cachedGraph->nodeToPrepare = std::move (node);
+    cachedGraph->previousGraph = std::move (previousGraph);
+    cachedGraphs[trackID] = cachedGraph;
+
+    return makeNode<CachedTrackNode> (std::move (cachedGraph), trackID, params.processState);
+}
+
+void TrackNodeCache::endBuild()
+{
+    // Remove any tracks that have been deleted or no longer create Nodes
+    for (auto iter = cachedGraphs.begin(); iter != cachedGraphs.end();)
+    {
+        if (builtTracks.count (iter->first) == 0)
+            iter = cachedGraphs.erase (iter);
+        else
+            ++iter;
+    }
+
+    for (auto iter = flattenedTracks.begin(); iter != flattenedTracks.end();)
+    {
+        if (builtTracks.count (*iter) == 0)
+            iter = flattenedTracks.erase (iter);
+        else
+            ++iter;
+    }
+
+    dirtyTracks.clear();
+    builtTracks.clear();
+}
+
+bool TrackNodeCache::canBeCached (AudioTrack& at, Node& node)
+{
+    if (! getDirectInputTracks (at).isEmpty())
+        return false;
+
+    for (auto plugin : at.getAllPlugins())
+        if (dynamic_cast<InsertPlugin*> (plugin) != nullptr)
+            return false;
+
+    // Any Nodes that connect to the rest of the graph or to live inputs mean
+    // the track depends on things outside of its own state
+    auto nodesToCheck = getNodes (node, VertexOrdering::postordering);
+
+    for (size_t i = 0; i < nodesToCheck.size(); ++i)
+    {
+        auto n = nodesToCheck[i];
+
+        if (dynamic_cast<SendNode*> (n) != nullptr
+            || dynamic_cast<ReturnNode*> (n) != nullptr
+            || dynamic_cast<WaveInputDeviceNode*> (n) != nullptr
+            || dynamic_cast<MidiInputDeviceNode*> (n) != nullptr
+            || dynamic_cast<HostedMidiInputDeviceNode*> (n) != nullptr)
+           return false;
+
+        for (auto internalNode : n->getInternalNodes())
+            nodesToCheck.push_back (internalNode);
+    }
+
+    return true;
+}
+
+bool TrackNodeCache::canLookAhead (AudioTrack& at)
+{
+    // Modifiers are updated with the Edit's playback position so would be out of sync
+    if (! getAllModifiers (edit).isEmpty())
+        return false;
+
+    for (auto idi : edit.getAllInputDevices())
+        if (idi->isRecordingEnabled (at.itemID))
+            return false;
+
+    return true;
+}
+
+bool TrackNodeCache::canLookAhead (Node& node)
+{
+    // MIDI output and launched clips depend on the Edit's playhead and sync range
+    if (node.getNodeProperties().hasMidi)
+        return false;
+
+    for (auto n : getNodes (node, VertexOrdering::postordering))
+        if (dynamic_cast<SlotControlNode*> (n) != nullptr
+            || dynamic_cast<ArrangerLauncherSwitchingNode*> (n) != nullptr)
+           return false;
+
+    return true;
+}
+
+//==============================================================================
+void TrackNodeCache::invalidateTrackAndSubTracks (const juce::ValueTree& v)
+{
+    // Sub-tracks can depend on their parent's state e.g. if it's muted
+    if (TrackList::isTrack (v))
+        dirtyTracks.insert (EditItemID::fromID (v));
+
+    for (const auto& child : v)
+        invalidateTrackAndSubTracks (child);
+}
+
+void TrackNodeCache::invalidateForChange (const juce::ValueTree& v)
+{
+    for (auto parent = v; parent.isValid(); parent = parent.getParent())
+    {
+        // Routing changes can change what other tracks are connected to
+        if (parent.hasType (IDs::OUTPUTDEVICES))
+            break;
+
+        if (TrackList::isTrack (parent))
+        {
+            invalidateTrackAndSubTracks (parent);
+            flushLookAheads();
+            return;
+        }
+
+        if (parent.getParent() == state)
+        {
+            // These aren't used by any track Nodes
+            if (parent.hasType (IDs::TRANSPORT)
+                || parent.hasType (IDs::MASTERVOLUME)
+                || parent.hasType (IDs::MASTERPLUGINS)
+                || parent.hasType (IDs::CLICKTRACK)
+                || parent.hasType (IDs::VIDEO))
+               return;
+
+            break;
+        }
+    }
+
+    invalidateAll();
+}
+
+void TrackNodeCache::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i)
+{
+    // Sidechains change the source track's Nodes too
+    if (i == IDs::sidechainSourceID)
+        invalidateAll();
+    else
+        invalidateForChange (v);
+}
+
+void TrackNodeCache::valueTreeChildAdded (juce::ValueTree& p, juce::ValueTree& c)
+{
+    // Adding or moving tracks can change submixes and routing
+    if (TrackList::isTrack (c))
+        invalidateAll();
+    else
+        invalidateForChange (p);
+}
+
+void TrackNodeCache::valueTreeChildRemoved (juce::ValueTree& p, juce::ValueTree& c, int)
+{
+    if (TrackList::isTrack (c))
+        invalidateAll();
+    else
+        invalidateForChange (p);
+}
+
+void TrackNodeCache::valueTreeChildOrderChanged (juce::ValueTree& p, int, int)
+{
+    invalidateForChange (p);
+}
+
 std::function<std::unique_ptr<tracktion::graph::Node> (std::unique_ptr<tracktion::graph::Node>)> EditNodeBuilder::insertOptionalLastStageNode
     = [] (std::unique_ptr<tracktion::graph::Node> input) { return input; };
 
@@ -14,6 +14,7 @@ namespace tracktion { inline namespace engine
 {
 
 class TrackMuteState;
+class TrackNodeCache;
 
 //==============================================================================
 /**
@@ -33,6 +34,128 @@ struct CreateNodeParams
     bool implicitlyIncludeSubmixChildTracks = true;     /**< If true, child track in submixes will be included regardless of the allowedTracks param. Only relevent when forRendering is also true. */
     bool allowClipSlots = true;                         /**< If true, track's clip slots will be included, set to false to disable these (which will use a slightly more efficient Node). */
     bool readAheadTimeStretchNodes = false;             /**< TEMPORARY: If true, real-time time-stretch Nodes will use a larger buffer and background thread to reduce audio CPU use. */
+    TrackNodeCache* trackNodeCache = nullptr;           /**< If set, tracks that haven't changed since the last graph was built will reuse their previous Nodes. */
+};
+
+//==============================================================================
+/**
+    Keeps the Nodes built for an Edit's tracks so that tracks that haven't
+    changed don't need to be recreated and prepared each time the graph is rebuilt.
+
+    Each cached track is built in to its own prepared sub-graph which is then
+    shared between successive Edit graphs so moving a clip only rebuilds the
+    track it's on. Only self-contained tracks can be cached, i.e. ones that don't
+    send to or receive from other parts of the graph via aux sends, racks,
+    sidechains, track inputs, live inputs or inserts. These are always rebuilt.
+
+    A cached sub-graph is processed serially on a single thread and its buffers
+    aren't part of the main graph's static allocation. To avoid this for tracks
+    that are being edited, a track is only cached once it's been unchanged for a
+    rebuild. Until then its Nodes are left in the main graph.
+
+    A track is marked as changed when anything in its state changes. Changes to
+    the rest of the Edit's state or to routing, changes to the sample rate, block
+    size or build options and calls to Edit::restartPlayback which can't be
+    attributed to a particular track invalidate the whole cache.
+
+    Look-ahead rendering can also be enabled. Cached tracks that have no live
+    input, aren't armed for recording and don't use clip slots, modifiers or
+    output MIDI produce the same output on every pass so are rendered by
+    background threads in fixed size chunks ahead of the playhead. The audio
+    thread then only copies out the chunk for the current block, falling back
+    to processing the track itself if the chunk isn't ready or the playhead
+    has jumped. The audio thread never waits for the background threads, if
+    one is midway through a chunk the track is silent for that block and
+    resyncs on the next. Any change to the Edit's state or to an external
+    plugin discards the rendered chunks.
+
+    @see EditPlaybackContext::enableIncrementalGraphRebuilds,
+         EditPlaybackContext::enableLookAheadRendering
+*/
+class TrackNodeCache  : private juce::ValueTree::Listener
+{
+public:
+    /** Creates a cache for an Edit. */
+    TrackNodeCache (Edit&);
+
+    /** Destructor. */
+    ~TrackNodeCache() override;
+
+    //==============================================================================
+    /** Marks all the tracks as changed so they'll be rebuilt by the next graph. */
+    void invalidateAll();
+
+    /** Marks a track as changed so it will be rebuilt by the next graph. */
+    void invalidateTrack (EditItemID);
+
+    /** Returns the number of tracks that reused their Nodes in the last graph build. */
+    int getNumTracksReused() const                      { return numTracksReused; }
+
+    /** Returns the number of tracks that were created in the last graph build. */
+    int getNumTracksRebuilt() const                     { return numTracksRebuilt; }
+
+    /** Returns the number of tracks in the last graph build that are processed as cached sub-graphs. */
+    int getNumTracksCached() const                      { return numTracksCached; }
+
+    //==============================================================================
+    /** Enables rendering suitable tracks ahead of the playhead on background threads.
+        Changing this invalidates the whole cache.
+    */
+    void setLookAheadRenderingEnabled (bool);
+
+    /** Discards any chunks that have been rendered ahead of the playhead.
+        This is called for any change to the Edit's state but also needs calling if
+        something else that affects the output changes, e.g. an external plugin.
+    */
+    void flushLookAheads();
+
+    /** Returns the number of tracks in the last graph build that are rendered ahead of the playhead. */
+    int getNumLookAheadTracks() const                   { return numLookAheadTracks; }
+
+    /** The number of frames in each chunk rendered ahead of the playhead. */
+    static constexpr int lookAheadChunkSize = 1024;
+
+    /** The number of chunks each track can be rendered ahead of the playhead. */
+    static constexpr int numLookAheadChunks = 8;
+
+    //==============================================================================
+    /** @internal */
+    void beginBuild (const CreateNodeParams&);
+    /** @internal */
+    std::unique_ptr<graph::Node> createNodeForTrack (Track&, const CreateNodeParams&);
+    /** @internal */
+    void endBuild();
+
+private:
+    //==============================================================================
+    struct CachedGraph;
+    class CachedTrackNode;
+    class LookAhead;
+    class LookAheadPool;
+
+    Edit& edit;
+    juce::ValueTree state;
+    std::unordered_map<EditItemID, std::shared_ptr<CachedGraph>> cachedGraphs;
+    std::unordered_set<EditItemID> dirtyTracks, builtTracks, flattenedTracks;
+    double sampleRate = 0.0;
+    int blockSize = 0;
+    bool includeBypassedPlugins = true, allowClipSlots = true, readAheadTimeStretchNodes = false;
+    bool allTracksDirty = true;
+    int numTracksReused = 0, numTracksRebuilt = 0, numTracksCached = 0, numLookAheadTracks = 0;
+    std::shared_ptr<LookAheadPool> lookAheadPool;
+
+    void invalidateTrackAndSubTracks (const juce::ValueTree&);
+    void invalidateForChange (const juce::ValueTree&);
+    bool canBeCached (AudioTrack&, graph::Node&);
+    bool canLookAhead (AudioTrack&);
+    bool canLookAhead (graph::Node&);
+
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override;
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override;
+    void valueTreeChildOrderChanged (juce::ValueTree&, int, int) override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackNodeCache)
 };
 
 //==============================================================================
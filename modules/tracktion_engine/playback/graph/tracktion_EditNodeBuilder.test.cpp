@@ -50,6 +50,8 @@ public:
 
         runClipFade (ts, 3.0s, 2, false);
         runClipFade (ts, 3.0s, 2, true);
+
+        runTrackNodeCache (ts, 1.0s, 2);
     }
 
 private:
@@ -503,6 +505,155 @@ private:
         }
     }
 
+    /** Has three tracks with a sin clip on each, the last of which has an aux send so can't be cached.
+        Checks only the changed tracks are rebuilt and the reused Nodes sound the same.
+    */
+    void runTrackNodeCache (graph::test_utilities::TestSetup ts,
+                            TimeDuration durationInSeconds,
+                            int numChannels)
+    {
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (ts.sampleRate, durationInSeconds.inSeconds(), numChannels, 220.0f);
+
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+        edit->ensureNumberOfAudioTracks (3);
+        auto tracks = getAudioTracks (*edit);
+        juce::Array<Clip*> clips;
+
+        for (auto t : tracks)
+            clips.add (t->insertWaveClip ({}, sinFile->getFile(), ClipPosition { { {}, durationInSeconds } }, false).get());
+
+        tracks[2]->pluginList.insertPlugin (edit->getPluginCache().createNewPlugin (AuxSendPlugin::xmlTypeName, {}), 0, nullptr);
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState { playHead };
+        ProcessState processState { playHeadState, edit->tempoSequence };
+
+        CreateNodeParams params { processState };
+        params.sampleRate = ts.sampleRate;
+        params.blockSize = ts.blockSize;
+        params.forRendering = true; // Required for audio files to be read
+
+        TrackNodeCache cache (*edit);
+        std::unique_ptr<NodeGraph> nodeGraph;
+
+        auto buildTracks = [&]
+        {
+            std::vector<std::unique_ptr<Node>> nodes;
+            cache.beginBuild (params);
+
+            for (auto t : tracks)
+                if (auto node = cache.createNodeForTrack (*t, params))
+                    nodes.push_back (std::move (node));
+
+            cache.endBuild();
+
+            // Prepare the graph so the cached tracks get prepared
+            nodeGraph = node_player_utils::prepareToPlay (std::make_unique<SummingNode> (std::move (nodes)), nodeGraph.get(),
+                                                          params.sampleRate, params.blockSize);
+        };
+
+        auto expectBuild = [&] (int expectedNumReused, int expectedNumRebuilt, int expectedNumCached)
+        {
+            buildTracks();
+            expectEquals (cache.getNumTracksReused(), expectedNumReused);
+            expectEquals (cache.getNumTracksRebuilt(), expectedNumRebuilt);
+            expectEquals (cache.getNumTracksCached(), expectedNumCached);
+        };
+
+        beginTest ("Track Node cache");
+        {
+            // Tracks are left in the main graph until they've been unchanged for a build
+            expectBuild (0, 3, 0);
+            expectBuild (0, 3, 2);
+            expectBuild (2, 1, 2);
+
+            clips[0]->setStart (TimePosition::fromSeconds (0.5), false, true);
+            expectBuild (1, 2, 1);
+
+            cache.invalidateTrack (tracks[1]->itemID);
+            expectBuild (0, 3, 1);
+            expectBuild (1, 2, 2);
+            expectBuild (2, 1, 2);
+
+            cache.invalidateAll();
+            expectBuild (0, 3, 0);
+
+            // Tempo changes affect all tracks
+            edit->tempoSequence.getTempo (0)->setBpm (140.0);
+            expectBuild (0, 3, 0);
+
+            params.blockSize = ts.blockSize * 2;
+            expectBuild (0, 3, 0);
+            params.blockSize = ts.blockSize;
+            expectBuild (0, 3, 0);
+        }
+
+        auto render = [&] (std::unique_ptr<Node> node)
+        {
+            graph::test_utilities::TestProcess<TracktionNodePlayer> testContext (std::make_unique<TracktionNodePlayer> (std::move (node), processState, ts.sampleRate, ts.blockSize,
+                                                                                                                        getPoolCreatorFunction (ThreadPoolStrategy::realTime)),
+                                                                                 ts, numChannels, durationInSeconds.inSeconds(), true);
+            testContext.getNodePlayer().setNumThreads (0);
+            testContext.setPlayHead (&playHeadState.playHead);
+            playHeadState.playHead.playSyncedToRange ({});
+            return testContext.processAll();
+        };
+
+        auto renderCachedTracks = [&]
+        {
+            std::vector<std::unique_ptr<Node>> cachedNodes;
+            cache.beginBuild (params);
+
+            for (auto t : tracks)
+                if (auto node = cache.createNodeForTrack (*t, params))
+                    cachedNodes.push_back (std::move (node));
+
+            cache.endBuild();
+            expectEquals (cache.getNumTracksReused(), 2);
+            expectEquals (cache.getNumTracksCached(), 2);
+
+            return render (std::make_unique<SummingNode> (std::move (cachedNodes)));
+        };
+
+        std::vector<std::unique_ptr<Node>> nodes;
+
+        for (auto t : tracks)
+            if (auto node = createNodeForTrack (*t, params))
+                nodes.push_back (std::move (node));
+
+        auto expected = render (std::make_unique<SummingNode> (std::move (nodes)));
+
+        beginTest ("Track Node cache output");
+        {
+            // The last build left the tracks in the main graph so build once to prepare
+            // the cached graphs and then again so they're reused
+            buildTracks();
+            expectEquals (cache.getNumTracksCached(), 2);
+            nodeGraph.reset();
+
+            auto result = renderCachedTracks();
+            expect (graph::test_utilities::buffersAreEqual (result->buffer, expected->buffer, 0.0001f), "Cached track output does not match");
+        }
+
+        beginTest ("Track Node cache look-ahead");
+        {
+            // The aux send track can't be cached so is processed as normal
+            cache.setLookAheadRenderingEnabled (true);
+            expectBuild (0, 3, 2);
+            expectEquals (cache.getNumLookAheadTracks(), 2);
+            nodeGraph.reset();
+
+            auto result = renderCachedTracks();
+            expectEquals (cache.getNumLookAheadTracks(), 2);
+            expect (graph::test_utilities::buffersAreEqual (result->buffer, expected->buffer, 0.0001f), "Look-ahead track output does not match");
+
+            cache.setLookAheadRenderingEnabled (false);
+            expectBuild (0, 3, 0);
+            expectEquals (cache.getNumLookAheadTracks(), 0);
+        }
+    }
+
     //==============================================================================
     //==============================================================================
     static std::unique_ptr<tracktion::graph::Node> createNode (Edit& edit, ProcessState& processState,
@@ -34,6 +34,7 @@ public:
     std::vector<Node*> getDirectInputNodes() override;
     bool isReadyToProcess() override;
     void process (ProcessContext&) override;
+    bool canProcessTempoSubRanges() const override      { return true; }
 
 private:
     //==============================================================================
@@ -155,7 +155,8 @@ namespace chocMidiHelpers
 
     inline void createControllerUpdatesForTime (const choc::midi::Sequence& sequence,
                                                 uint8_t channel, double time,
-                                                juce::Array<juce::MidiMessage>& dest)
+                                                juce::Array<juce::MidiMessage>& dest,
+                                                double timeStampOffset = 0.0)
     {
         ProgramChange programChange;
         ControllerValues controllerValues;
@@ -169,7 +170,9 @@ namespace chocMidiHelpers
 
             const auto& mm = event.message;
 
-            if (! (mm.getChannel1to16() == channel && event.timeStamp <= time))
+            const auto eventTime = event.timeStamp + timeStampOffset;
+
+            if (! (mm.getChannel1to16() == channel && eventTime <= time))
                 continue;
 
             if (mm.isController())
@@ -186,8 +189,8 @@ namespace chocMidiHelpers
 
                 if (std::find (std::begin (passthroughs), std::end (passthroughs), num) != std::end (passthroughs))
                 {
-                    parameterNumberState.sendIfNecessary (channel, event.timeStamp, dest);
-                    dest.add (toMidiMessage (event));
+                    parameterNumberState.sendIfNecessary (channel, eventTime, dest);
+                    dest.add (toMidiMessage (event).withTimeStamp (eventTime));
                 }
                 else
                 {
@@ -364,6 +367,14 @@ namespace MidiHelpers
         return dest;
     }
 
+    inline choc::midi::Sequence& addSequence (choc::midi::Sequence& dest, const choc::midi::Sequence& src, double timeStampOffset)
+    {
+        for (const auto& e : src)
+            dest.events.push_back ({ e.timeStamp + timeStampOffset, e.message });
+
+        return dest;
+    }
+
     inline void createNoteOffMap (std::vector<std::pair<size_t, size_t>>& noteOffMap,
                                   const choc::midi::Sequence& seq)
     {
@@ -499,32 +510,27 @@ namespace MidiHelpers
                 e.timeStamp = groove.beatsTimeToGroovyTime (BeatPosition::fromBeats (e.timeStamp), grooveStrength).inBeats();
     }
 
+    /** Adds the messages needed to start playing a sequence from a time.
+        The timeStampOffset is added to the times of all the events in the sequence.
+    */
     inline void createMessagesForTime (MidiMessageArray& destBuffer,
-                                       const choc::midi::Sequence& sourceSequence,
-                                       const std::vector<std::pair<size_t, size_t>>& noteOffMap,
+                                       const CompiledMidiSequence& sourceSequence,
+                                       double timeStampOffset,
                                        double time,
                                        juce::Range<int> channelNumbers,
                                        LiveClipLevel& clipLevel,
                                        bool useMPEChannelMode, MidiMessageArray::MPESourceID midiSourceID,
                                        juce::Array<juce::MidiMessage>& controllerMessagesScratchBuffer)
     {
+        const auto indexOfTime = sourceSequence.indexOfTime (time - timeStampOffset);
+
         if (useMPEChannelMode)
         {
-            const auto indexOfTime = [&]() -> size_t
-                                     {
-                                         const auto numEvents = sourceSequence.events.size();
-
-                                         for (size_t i = 0; i < numEvents; ++i)
-                                             if (sourceSequence.events[i].timeStamp >= time)
-                                                 return i;
-
-                                         return {};
-                                     }();
-
             controllerMessagesScratchBuffer.clearQuick();
 
             for (int i = channelNumbers.getStart(); i < channelNumbers.getEnd(); ++i)
-                MPEStartTrimmer::reconstructExpression (controllerMessagesScratchBuffer, sourceSequence, indexOfTime, i);
+                MPEStartTrimmer::reconstructExpression (controllerMessagesScratchBuffer, sourceSequence.getSequence(),
+                                                        indexOfTime < sourceSequence.size() ? indexOfTime : 0, i);
 
             for (auto& m : controllerMessagesScratchBuffer)
                 destBuffer.addMidiMessage (m, 0.0001, midiSourceID);
@@ -535,7 +541,8 @@ namespace MidiHelpers
                 controllerMessagesScratchBuffer.clearQuick();
 
                 for (int i = channelNumbers.getStart(); i < channelNumbers.getEnd(); ++i)
-                    chocMidiHelpers::createControllerUpdatesForTime (sourceSequence, (uint8_t) i, time, controllerMessagesScratchBuffer);
+                    chocMidiHelpers::createControllerUpdatesForTime (sourceSequence.getSequence(), (uint8_t) i, time,
+                                                                     controllerMessagesScratchBuffer, timeStampOffset);
 
                 for (auto& m : controllerMessagesScratchBuffer)
                     destBuffer.addMidiMessage (m, midiSourceID);
@@ -545,28 +552,21 @@ namespace MidiHelpers
             {
                 auto volScale = clipLevel.getGain();
 
-                for (size_t i = 0; i < sourceSequence.events.size(); ++i)
+                for (size_t i = 0; i < indexOfTime; ++i)
                 {
-                    auto e = sourceSequence.events[i];
-                    const auto& m = e.message;
-
-                    if (! m.isNoteOn())
+                    if (! sourceSequence.isNoteOn (i))
                         continue;
 
-                    if (auto noteOffEvent = getNoteOff (i, sourceSequence, noteOffMap))
+                    if (auto noteOffIndex = sourceSequence.getNoteOffIndex (i))
                     {
-                        if (e.timeStamp >= time)
-                            break;
-
                         // don't play very short notes or ones that have already finished
-                        if (noteOffEvent->timeStamp > time + 0.0001)
+                        if (sourceSequence.getTime (*noteOffIndex) + timeStampOffset > time + 0.0001)
                         {
-                            auto data = m.data();
-                            juce::MidiMessage m2 ((int) data[0], (int) data[1], (int) data[2], e.timeStamp);
-                            m2.multiplyVelocity (volScale);
+                            auto m = sourceSequence.getMessage (i);
+                            m.multiplyVelocity (volScale);
 
                             // give these a tiny offset to make sure they're played after the controller updates
-                            destBuffer.addMidiMessage (m2, 0.0001, midiSourceID);
+                            destBuffer.addMidiMessage (m, 0.0001, midiSourceID);
                         }
                     }
                 }
@@ -574,8 +574,8 @@ namespace MidiHelpers
         }
     }
 
-    inline ActiveNoteList getNotesOnAtTime (const choc::midi::Sequence& sourceSequence,
-                                            const std::vector<std::pair<size_t, size_t>>& noteOffMap,
+    inline ActiveNoteList getNotesOnAtTime (const CompiledMidiSequence& sourceSequence,
+                                            double timeStampOffset,
                                             double time,
                                             juce::Range<int> channelNumbers, LiveClipLevel& clipLevel)
     {
@@ -584,25 +584,23 @@ namespace MidiHelpers
         if (clipLevel.isMute())
             return {};
 
-        for (size_t i = 0; i < sourceSequence.events.size(); ++i)
-        {
-            const auto& e = sourceSequence.events[i];
-            const auto& m = e.message;
+        const auto indexOfTime = sourceSequence.indexOfTime (time - timeStampOffset);
 
-            if (! m.isNoteOn())
+        for (size_t i = 0; i < indexOfTime; ++i)
+        {
+            if (! sourceSequence.isNoteOn (i))
                 continue;
 
-            if (! channelNumbers.contains ((int) m.getChannel1to16()))
+            const auto m = sourceSequence.getMessage (i);
+
+            if (! channelNumbers.contains (m.getChannel()))
                 continue;
 
-            if (auto noteOffEvent = getNoteOff (i, sourceSequence, noteOffMap))
+            if (auto noteOffIndex = sourceSequence.getNoteOffIndex (i))
             {
-                if (e.timeStamp >= time)
-                    break;
-
                 // don't play very short notes or ones that have already finished
-                if (noteOffEvent->timeStamp > time + 0.0001)
-                    noteList.startNote ((int) m.getChannel1to16(), (int) m.getNoteNumber());
+                if (sourceSequence.getTime (*noteOffIndex) + timeStampOffset > time + 0.0001)
+                    noteList.startNote (m.getChannel(), m.getNoteNumber());
             }
         }
 
@@ -697,12 +695,19 @@ public:
 //==============================================================================
 struct EventGenerator   : public MidiGenerator
 {
-    EventGenerator (const choc::midi::Sequence& seq,
-                    const std::vector<std::pair<size_t, size_t>>& noteOffs)
-        : sequence (seq), noteOffMap (noteOffs)
+    EventGenerator (const CompiledMidiSequence& seq)
+        : sequence (&seq), cursor (seq)
     {
     }
 
+    /** Sets the sequence to iterate and an offset to add to its event times. */
+    void setSequence (const CompiledMidiSequence& seq, double timeStampOffsetToUse)
+    {
+        sequence = &seq;
+        timeStampOffset = timeStampOffsetToUse;
+        cursor.setSequence (seq);
+    }
+
     void createMessagesForTime (MidiMessageArray& destBuffer,
                                 SequenceBeatPosition time,
                                 ActiveNoteList& activeNoteList,
@@ -716,7 +721,7 @@ struct EventGenerator   : public MidiGenerator
         cleanedBufferToMerge.clear();
 
         MidiHelpers::createMessagesForTime (scratchBuffer,
-                                            sequence, noteOffMap,
+                                            *sequence, timeStampOffset,
                                             time,
                                             channelNumbers,
                                             clipLevel,
@@ -753,7 +758,7 @@ struct EventGenerator   : public MidiGenerator
 
     ActiveNoteList getNotesOnAtTime (SequenceBeatPosition time, juce::Range<int> channelNumbers, LiveClipLevel& clipLevel) override
     {
-        return MidiHelpers::getNotesOnAtTime (sequence, noteOffMap,
+        return MidiHelpers::getNotesOnAtTime (*sequence, timeStampOffset,
                                               time,
                                               channelNumbers,
                                               clipLevel);
@@ -761,48 +766,31 @@ struct EventGenerator   : public MidiGenerator
 
     void setTime (SequenceBeatPosition pos) override
     {
-        auto numEvents = sequence.events.size();
-
-        // Set the index to the start of the range
-        if (numEvents != 0)
-        {
-            currentIndex = std::clamp<size_t> (currentIndex, 0, numEvents - 1);
-
-            if (sequence.events[currentIndex].timeStamp >= pos)
-            {
-                while (currentIndex > 0 && sequence.events[currentIndex - 1].timeStamp >= pos)
-                    --currentIndex;
-            }
-            else
-            {
-                while (currentIndex < numEvents && sequence.events[currentIndex].timeStamp < pos)
-                    ++currentIndex;
-            }
-        }
+        cursor.setTime (pos - timeStampOffset);
     }
 
     juce::MidiMessage getEvent() override
     {
-        [[ maybe_unused ]] auto numEvents = sequence.events.size();
-        jassert (currentIndex < numEvents);
+        jassert (! cursor.exhausted());
 
-        return toMidiMessage (sequence.events[currentIndex]);
+        auto e = cursor.getEvent();
+        e.addToTimeStamp (timeStampOffset);
+        return e;
     }
 
     bool advance() override
     {
-        ++currentIndex;
-        return ! exhausted();
+        return cursor.advance();
     }
 
     bool exhausted() override
     {
-        return currentIndex >= sequence.events.size();
+        return cursor.exhausted();
     }
 
-    const choc::midi::Sequence& sequence;
-    const std::vector<std::pair<size_t, size_t>>& noteOffMap;
-    size_t currentIndex = 0;
+    const CompiledMidiSequence* sequence;
+    CompiledMidiSequence::Cursor cursor;
+    double timeStampOffset = 0.0;
 };
 
 
@@ -811,7 +799,7 @@ struct EventGenerator   : public MidiGenerator
 class CachingMidiEventGenerator : public MidiGenerator
 {
 public:
-    CachingMidiEventGenerator (std::vector<juce::MidiMessageSequence> seq,
+    CachingMidiEventGenerator (std::vector<std::shared_ptr<const CompiledMidiSequence>> seq,
                                QuantisationType qt,
                                const GrooveTemplate& grooveTemplate, float grooveStrength_)
         : sequences (std::move (seq)),
@@ -819,30 +807,30 @@ public:
           groove (grooveTemplate),
           grooveStrength (grooveStrength_)
     {
-        // Cache the sequence at 0.0 time to reserve the required storage
-        cacheSequence (0.0, {});
-
-        // Reserve the scratch space for the note on/off map
-        size_t maxNumEvents = 0, maxNumNoteOns = 0;
-
-        for (auto& sequence : sequences)
+        if (needsProcessing())
         {
-            size_t squenceNumEvents = 0, squenceNumNoteOns = 0;
+            // Reserve the scratch space for the processed sequence and note on/off map
+            size_t maxNumEvents = 0, maxNumNoteOns = 0;
 
-            for (auto meh : sequence)
+            for (auto& sequence : sequences)
             {
-                ++squenceNumEvents;
+                size_t squenceNumNoteOns = 0;
+
+                for (size_t i = 0; i < sequence->size(); ++i)
+                    if (sequence->isNoteOn (i))
+                        ++squenceNumNoteOns;
 
-                if (meh->message.isNoteOn())
-                    ++squenceNumNoteOns;
+                maxNumEvents = std::max (sequence->size(), maxNumEvents);
+                maxNumNoteOns = std::max (squenceNumNoteOns, maxNumNoteOns);
             }
 
-            maxNumEvents = std::max (squenceNumEvents, maxNumEvents);
-            maxNumNoteOns = std::max (squenceNumNoteOns, maxNumNoteOns);
+            noteOffMap.reserve (maxNumNoteOns);
+            currentSequence.events.reserve (maxNumEvents);
+            processedSequence.reserve (maxNumEvents);
         }
 
-        noteOffMap.reserve (maxNumNoteOns);
-        currentSequence.events.reserve (maxNumEvents);
+        // Cache the sequence at 0.0 time
+        cacheSequence (0.0, {});
     }
 
     void createMessagesForTime (MidiMessageArray& destBuffer,
@@ -864,10 +852,7 @@ public:
 
     ActiveNoteList getNotesOnAtTime (EditBeatPosition time, juce::Range<int> channelNumbers, LiveClipLevel& clipLevel) override
     {
-        return MidiHelpers::getNotesOnAtTime (currentSequence, noteOffMap,
-                                              time,
-                                              channelNumbers,
-                                              clipLevel);
+        return generator.getNotesOnAtTime (time, channelNumbers, clipLevel);
     }
 
     void setTime (EditBeatPosition editBeatPosition) override
@@ -877,24 +862,36 @@ public:
 
     void cacheSequence (double offsetBeats, std::optional<juce::Range<double>> clipRange) override
     {
-        // Create a new sequence by:
+        if (sequences.size() > 0)
+            if (++currentSequenceIndex >= sequences.size())
+                currentSequenceIndex = 0;
+
+        cachedSequenceOffset = offsetBeats;
+
+        const auto& sourceSequence = currentSequenceIndex < sequences.size() ? *sequences[currentSequenceIndex]
+                                                                             : processedSequence;
+
+        // Without any quantisation or groove, the compiled sequence can be played as it is.
+        // It was clipped to the loop range when it was compiled so just needs offsetting.
+        if (! needsProcessing())
+        {
+            generator.setSequence (sourceSequence, offsetBeats);
+            return;
+        }
+
+        // Otherwise create a new sequence by:
         // - Iterating the current sequence
         // - Adding the offset timestamp to get Edit times
         // - Applying the quantisation
         // - Applying the groove
         // - Sorting so events are in order
         // - Setting the sequence to be iterated
-        // - Updating the offset used
-
-        if (sequences.size() > 0)
-            if (++currentSequenceIndex >= sequences.size())
-                currentSequenceIndex = 0;
 
         // Create the cached sequence (without allocating)
         currentSequence.events.clear();
 
         if (currentSequenceIndex < sequences.size())
-            MidiHelpers::addSequence (currentSequence, sequences[currentSequenceIndex], offsetBeats);
+            MidiHelpers::addSequence (currentSequence, sourceSequence.getSequence(), offsetBeats);
 
         jassert (std::is_sorted (currentSequence.begin(), currentSequence.end()));
         MidiHelpers::createNoteOffMap (noteOffMap, currentSequence);
@@ -911,9 +908,8 @@ public:
             MidiHelpers::clipSequenceToRange (currentSequence, *clipRange, noteOffMap);
         }
 
-        MidiHelpers::createNoteOffMap (noteOffMap, currentSequence);
-
-        cachedSequenceOffset = offsetBeats;
+        processedSequence.replaceEvents (currentSequence);
+        generator.setSequence (processedSequence, 0.0);
     }
 
     juce::MidiMessage getEvent() override
@@ -934,11 +930,12 @@ public:
     }
 
 private:
-    std::vector<juce::MidiMessageSequence> sequences;
+    std::vector<std::shared_ptr<const CompiledMidiSequence>> sequences;
 
     choc::midi::Sequence currentSequence;
     std::vector<std::pair<size_t, size_t>> noteOffMap;
-    EventGenerator generator { currentSequence, noteOffMap };
+    CompiledMidiSequence processedSequence;
+    EventGenerator generator { processedSequence };
 
     const QuantisationType quantisation;
     const GrooveTemplate groove;
@@ -946,6 +943,11 @@ private:
 
     size_t currentSequenceIndex = 0;
     double cachedSequenceOffset = 0.0;
+
+    bool needsProcessing() const
+    {
+        return quantisation.isEnabled() || ! groove.isEmpty();
+    }
 };
 
 //==============================================================================
@@ -1163,7 +1165,7 @@ public:
     }
 
     void initialise (std::shared_ptr<ActiveNoteList> noteListToUse,
-                     bool clipPropertiesHaveChanged, size_t lastSequencesHash,
+                     bool clipPropertiesHaveChanged, const GeneratorAndNoteList* lastGenerator,
                      std::shared_ptr<BeatDuration> dynamicOffsetBeatsToUse)
     {
         if (isInitialised())
@@ -1183,10 +1185,25 @@ public:
 
         sequencesHash = std::hash<std::vector<juce::MidiMessageSequence>>{} (sequences);
 
-        if (sequencesHash != lastSequencesHash || clipPropertiesHaveChanged)
+        // This happens when the graph is being prepared so compile the sequences now rather than on
+        // the audio thread. If they haven't changed, the last Node's compiled versions can be shared.
+        if (lastGenerator != nullptr && lastGenerator->getSequencesHash() == sequencesHash
+            && lastGenerator->compiledSequences.size() == sequences.size())
+        {
+            compiledSequences = lastGenerator->compiledSequences;
+        }
+        else
+        {
+            for (auto& sequence : sequences)
+                compiledSequences.push_back (compileSequence (sequence, loopRangeRaw));
+        }
+
+        sequences.clear();
+
+        if (lastGenerator == nullptr || sequencesHash != lastGenerator->getSequencesHash() || clipPropertiesHaveChanged)
             shouldSendNoteOffsForNotesNoLongerPlaying = true;
 
-        auto cachingGenerator = std::make_unique<CachingMidiEventGenerator> (std::move (sequences),
+        auto cachingGenerator = std::make_unique<CachingMidiEventGenerator> (compiledSequences,
                                                                              std::move (quantisation), std::move (groove), grooveStrength);
         auto loopedGenerator = std::make_unique<LoopedMidiEventGenerator> (std::move (cachingGenerator),
                                                                            activeNoteList, clipRangeRaw, loopRangeRaw);
@@ -1373,6 +1390,7 @@ private:
     std::shared_ptr<BeatDuration> dynamicOffsetBeats;
 
     std::vector<juce::MidiMessageSequence> sequences;
+    std::vector<std::shared_ptr<const CompiledMidiSequence>> compiledSequences;
     size_t sequencesHash = 0;
     const BeatRange editRange, loopRange;
     const BeatDuration offset;
@@ -1383,6 +1401,25 @@ private:
 
     bool shouldCreateMessagesForTime = false, shouldSendNoteOffsForNotesNoLongerPlaying = false;
     juce::Array<juce::MidiMessage> controllerMessagesScratchBuffer;
+
+    static std::shared_ptr<const CompiledMidiSequence> compileSequence (const juce::MidiMessageSequence& sequence,
+                                                                        ClipBeatRange loopRangeToClipTo)
+    {
+        auto compiled = std::make_shared<CompiledMidiSequence> (sequence);
+
+        // Clamp any notes to the loop range once here so each pass only needs offsetting
+        if (! loopRangeToClipTo.isEmpty())
+        {
+            auto events = compiled->getSequence();
+            std::vector<std::pair<size_t, size_t>> noteOffMap;
+            MidiHelpers::createNoteOffMap (noteOffMap, events);
+            MidiHelpers::clipSequenceToRange (events, loopRangeToClipTo, noteOffMap);
+            events.sortEvents();
+            compiled->replaceEvents (events);
+        }
+
+        return compiled;
+    }
 };
 
 
@@ -1468,18 +1505,18 @@ void LoopingMidiNode::prepareToPlay (const tracktion::graph::PlaybackInitialisat
 
     std::shared_ptr<ActiveNoteList> activeNoteList;
     bool clipPropertiesHaveChanged = false;
-    size_t lastSequencesHash = 0;
+    const GeneratorAndNoteList* lastGenerator = nullptr;
 
     if (auto oldNode = findNodeWithIDIfNonZero<LoopingMidiNode> (info.nodeGraphToReplace, getNodeProperties().nodeID))
     {
         midiSourceID = oldNode->midiSourceID;
         activeNoteList = oldNode->generatorAndNoteList->getActiveNoteList();
         clipPropertiesHaveChanged = ! generatorAndNoteList->hasSameContentAs (*oldNode->generatorAndNoteList);
-        lastSequencesHash = oldNode->generatorAndNoteList->getSequencesHash();
+        lastGenerator = oldNode->generatorAndNoteList.get();
         dynamicOffsetBeats = oldNode->dynamicOffsetBeats;
     }
 
-    generatorAndNoteList->initialise (activeNoteList, clipPropertiesHaveChanged, lastSequencesHash, dynamicOffsetBeats);
+    generatorAndNoteList->initialise (activeNoteList, clipPropertiesHaveChanged, lastGenerator, dynamicOffsetBeats);
 }
 
 bool LoopingMidiNode::isReadyToProcess()
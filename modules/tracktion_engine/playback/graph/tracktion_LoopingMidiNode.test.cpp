@@ -41,12 +41,14 @@ public:
             runStuckNotesTests (setup, false, 2);
 
             runOffsetTests (setup);
+            runLoopStartTests (setup);
         }
 
         runProgramChangeTests (false);
         runProgramChangeTests (true);
 
         runSequenceClippingTests();
+        runCompiledSequenceTests();
     }
 
 private:
@@ -321,6 +323,75 @@ private:
 
     }
 
+    void runCompiledSequenceTests()
+    {
+        beginTest ("Compiled sequences");
+
+        juce::MidiMessageSequence source;
+        source.addEvent (juce::MidiMessage::noteOn (1, 60, (juce::uint8) 100), 2.0);
+        source.addEvent (juce::MidiMessage::noteOff (1, 60), 3.0);
+        source.addEvent (juce::MidiMessage::controllerEvent (1, 7, 64), 0.0);
+        source.addEvent (juce::MidiMessage::noteOn (1, 60, (juce::uint8) 90), 2.5);
+        source.addEvent (juce::MidiMessage::noteOff (1, 60), 4.0);
+        source.addEvent (juce::MidiMessage::noteOn (2, 60, (juce::uint8) 80), 1.0);
+        source.addEvent (juce::MidiMessage::programChange (1, 5), 0.5);
+
+        const juce::uint8 sysexData[] = { 0x01, 0x02, 0x03, 0x04 };
+        source.addEvent (juce::MidiMessage::createSysExMessage (sysexData, (int) std::size (sysexData)), 1.5);
+        source.sort();
+
+        CompiledMidiSequence compiled (source);
+        expectEquals (compiled.size(), (size_t) source.getNumEvents());
+
+        // Events should be in order and match the source
+        for (size_t i = 0; i < compiled.size(); ++i)
+        {
+            const auto& original = source.getEventPointer ((int) i)->message;
+            const auto message = compiled.getMessage (i);
+
+            expectEquals (compiled.getTime (i), original.getTimeStamp());
+            expectEquals (message.getTimeStamp(), original.getTimeStamp());
+            expect (message.getRawDataSize() == original.getRawDataSize()
+                     && std::memcmp (message.getRawData(), original.getRawData(), (size_t) original.getRawDataSize()) == 0);
+            expect (compiled.isNoteOn (i) == original.isNoteOn());
+            expect (compiled.isNoteOff (i) == original.isNoteOff());
+        }
+
+        // Note-offs should be paired in the same way as a createNoteOffMap
+        {
+            auto seq = compiled.getSequence();
+            std::vector<std::pair<size_t, size_t>> noteOffMap;
+            MidiHelpers::createNoteOffMap (noteOffMap, seq);
+
+            for (size_t i = 0; i < compiled.size(); ++i)
+                expect (compiled.getNoteOffIndex (i) == MidiHelpers::getNoteOffIndex (i, noteOffMap));
+
+            // The note on channel 2 doesn't have a note-off
+            expect (! compiled.getNoteOffIndex (compiled.indexOfTime (1.0)).has_value());
+        }
+
+        // Cursors should find the same positions as searching
+        {
+            CompiledMidiSequence::Cursor cursor (compiled);
+
+            for (double t : { 0.0, 0.25, 1.0, 2.0, 2.75, 1.5, 4.0, 5.0, 0.0 })
+            {
+                cursor.setTime (t);
+                expectEquals (cursor.getIndex(), compiled.indexOfTime (t));
+                expect (cursor.exhausted() == (t > compiled.getTime (compiled.size() - 1)));
+            }
+
+            cursor.setTime (0.0);
+            size_t numEvents = 1;
+
+            while (cursor.advance())
+                ++numEvents;
+
+            expectEquals (numEvents, compiled.size());
+            expect (cursor.exhausted());
+        }
+    }
+
     void runSequenceClippingTest (std::vector<BytesAndTimeStamp> data, juce::Range<double> clipRange, size_t numEventsExpected)
     {
         choc::midi::Sequence seq;
@@ -370,6 +441,55 @@ private:
         testMidiClip (*mc, ts);
     }
 
+    void runLoopStartTests (test_utilities::TestSetup ts)
+    {
+        beginTest ("Notes straddling the loop start");
+
+        // - Create a MIDI clip with a note from beat 0 to 2 and another from beat 2 to 3
+        // - Loop beats 1 to 3 for three passes
+        // - The first note should be clamped to the loop start and re-triggered on every pass
+
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto& tempoSeq = edit->tempoSequence;
+        auto mc = getAudioTracks (*edit)[0]->insertMIDIClip ({ 0_tp, tempoSeq.toTime (3_bp) }, nullptr);
+
+        auto& sequence = mc->getSequence();
+        sequence.addNote (60, 0_bp, 2_bd, 127, 0, nullptr);
+        sequence.addNote (62, 2_bp, 1_bd, 127, 0, nullptr);
+
+        mc->setNumberOfLoops (1);
+        mc->setLoopRangeBeats ({ 1_bp, 3_bp });
+        mc->setEnd (tempoSeq.toTime (6_bp), true);
+        mc->setUsesProxy (true);
+
+        const auto seq = test_utilities::stripNonNoteOnOffMessages (renderMidiClip (*mc, ts, { 0_tp, mc->getPosition().getEnd() }));
+        std::vector<double> straddlingNoteStarts, otherNoteStarts;
+
+        for (auto meh : seq)
+        {
+            if (! meh->message.isNoteOn())
+                continue;
+
+            if (meh->message.getNoteNumber() == 60)
+                straddlingNoteStarts.push_back (meh->message.getTimeStamp());
+            else
+                otherNoteStarts.push_back (meh->message.getTimeStamp());
+        }
+
+        // Each loop pass is 2 beats, 1s at 120bpm
+        expectEquals ((int) straddlingNoteStarts.size(), 3);
+        expectEquals ((int) otherNoteStarts.size(), 3);
+
+        for (size_t i = 0; i < std::min (straddlingNoteStarts.size(), otherNoteStarts.size()); ++i)
+        {
+            expectWithinAbsoluteError (straddlingNoteStarts[i], (double) i, 0.001);
+            expectWithinAbsoluteError (otherNoteStarts[i], i + 0.5, 0.001);
+        }
+
+        testMidiClip (*mc, ts);
+    }
+
     void testMidiClip (MidiClip& mc, test_utilities::TestSetup ts)
     {
         auto renderOpts = RenderOptions::forClipRender ({ &mc }, true);
@@ -84,18 +84,38 @@ void MidiNode::process (ProcessContext& pc)
 
     if (timeBase == MidiList::TimeBase::beats)
     {
-        const auto sectionEditTime = getEditBeatRange();
+        const auto blockEditBeats = getEditBeatRange();
 
-        if (sectionEditTime.isEmpty()
-            || sectionEditTime.getEnd().inBeats() <= editRange.getStart()
-            || sectionEditTime.getStart().inBeats() >= editRange.getEnd())
+        if (blockEditBeats.isEmpty()
+            || blockEditBeats.getEnd().inBeats() <= editRange.getStart()
+            || blockEditBeats.getStart().inBeats() >= editRange.getEnd())
            return;
 
-        const auto secondsPerBeat = getEditTimeRange().getLength().inSeconds() / sectionEditTime.getLength().inBeats();
+        // If the player is batching tempo changes, process each section with its own tempo
+        const auto numSections = getNumTempoSubRanges();
 
-        processSection (pc,
-                        { sectionEditTime.getStart().inBeats(), sectionEditTime.getEnd().inBeats() },
-                        secondsPerBeat, ms[currentSequence]);
+        for (size_t i = 0; i < numSections; ++i)
+        {
+            const auto& subRange = getTempoSubRange (i);
+            const auto sectionEditTime = subRange.editBeatRange;
+            auto subContext = getSubProcessContext (pc, subRange);
+
+            if (sectionEditTime.isEmpty() || subContext.numSamples == 0)
+                continue;
+
+            const auto secondsPerBeat = subRange.editTimeRange.getLength().inSeconds() / sectionEditTime.getLength().inBeats();
+            const auto numEventsBefore = pc.buffers.midi.size();
+
+            processSection (subContext,
+                            { sectionEditTime.getStart().inBeats(), sectionEditTime.getEnd().inBeats() },
+                            secondsPerBeat, ms[currentSequence],
+                            i == 0, i == numSections - 1);
+
+            // Events are relative to the start of the section so offset them to the start of the block
+            if (const auto sectionOffset = (subRange.editTimeRange.getStart() - getEditTimeRange().getStart()).inSeconds(); sectionOffset > 0.0)
+                for (int e = numEventsBefore; e < pc.buffers.midi.size(); ++e)
+                    pc.buffers.midi[e].addToTimeStamp (sectionOffset);
+        }
     }
     else
     {
@@ -108,14 +128,15 @@ void MidiNode::process (ProcessContext& pc)
 
         processSection (pc,
                         { sectionEditTime.getStart().inSeconds(), sectionEditTime.getEnd().inSeconds() },
-                        1.0, ms[currentSequence]);
+                        1.0, ms[currentSequence], true, true);
     }
 }
 
 void MidiNode::processSection (Node::ProcessContext& pc,
                                juce::Range<double> sectionEditRange,
                                double secondsPerTimeBase,
-                               juce::MidiMessageSequence& sequence)
+                               juce::MidiMessageSequence& sequence,
+                               bool isFirstSection, bool isLastSection)
 {
     if (sectionEditRange.isEmpty()
         || sectionEditRange.getEnd() <= editRange.getStart()
@@ -136,7 +157,7 @@ void MidiNode::processSection (Node::ProcessContext& pc,
         return;
     }
 
-    if (! getPlayHeadState().isContiguousWithPreviousBlock() || localTime.getStart() <= 0.00001 || shouldCreateMessagesForTime)
+    if ((isFirstSection && ! getPlayHeadState().isContiguousWithPreviousBlock()) || localTime.getStart() <= 0.00001 || shouldCreateMessagesForTime)
     {
         MidiNodeHelpers::createMessagesForTime (pc.buffers.midi, sequence, localTime.getStart(),
                                                 channelNumbers, clipLevel, useMPEChannelMode, midiSourceID,
@@ -163,7 +184,7 @@ void MidiNode::processSection (Node::ProcessContext& pc,
     }
 
     auto volScale = clipLevel.getGain();
-    const auto lastBlockOfLoop = getPlayHeadState().isLastBlockOfLoop();
+    const auto lastBlockOfLoop = isLastSection && getPlayHeadState().isLastBlockOfLoop();
     const double durationOfOneSample = sectionEditRange.getLength() / pc.numSamples;
 
     for (;;)
@@ -196,7 +217,7 @@ void MidiNode::processSection (Node::ProcessContext& pc,
 
     // N.B. if the note-off is added on the last time it may not be sent to the plugin which can break the active note-state.
     // To avoid this, make sure any added messages are nudged back by 0.00001s
-    if (getPlayHeadState().isLastBlockOfLoop())
+    if (lastBlockOfLoop)
         MidiNodeHelpers::createNoteOffs (pc.buffers.midi, sequence, midiSourceID,
                                          localTime.getEnd(),
                                          localTime.getLength() - 0.00001,
@@ -32,6 +32,7 @@ public:
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
     void process (ProcessContext&) override;
+    bool canProcessTempoSubRanges() const override      { return true; }
 
 private:
     //==============================================================================
@@ -57,7 +58,8 @@ private:
     void processSection (Node::ProcessContext&,
                          juce::Range<double> sectionEditTime,
                          double secondsPerTimeBase,
-                         juce::MidiMessageSequence&);
+                         juce::MidiMessageSequence&,
+                         bool isFirstSection, bool isLastSection);
 };
 
 }} // namespace tracktion { inline namespace engine
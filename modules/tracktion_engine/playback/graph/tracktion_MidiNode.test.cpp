@@ -40,11 +40,14 @@ public:
 private:
     //==============================================================================
     static std::shared_ptr<graph::test_utilities::TestContext> createTracktionTestContext (ProcessState& processState, std::unique_ptr<Node> node,
-                                                                                           graph::test_utilities::TestSetup ts, int numChannels, double durationInSeconds)
+                                                                                           graph::test_utilities::TestSetup ts, int numChannels, double durationInSeconds,
+                                                                                           bool batchTempoChanges = false)
     {
-        graph::test_utilities::TestProcess<TracktionNodePlayer> testProcess (std::make_unique<TracktionNodePlayer> (std::move (node), processState, ts.sampleRate, ts.blockSize,
-                                                                                                                    getPoolCreatorFunction (ThreadPoolStrategy::realTime)),
-                                                                             ts, numChannels, durationInSeconds, true);
+        auto player = std::make_unique<TracktionNodePlayer> (std::move (node), processState, ts.sampleRate, ts.blockSize,
+                                                             getPoolCreatorFunction (ThreadPoolStrategy::realTime));
+        player->enableBatchedTempoChanges (batchTempoChanges);
+
+        graph::test_utilities::TestProcess<TracktionNodePlayer> testProcess (std::move (player), ts, numChannels, durationInSeconds, true);
         testProcess.setPlayHead (&processState.playHeadState.playHead);
 
         return testProcess.processAll();
@@ -114,7 +117,111 @@ private:
             expectEquals (expectedSequence.getNumEvents(), masterSequence.getNumEvents());
             expectMidiBuffer (*this, testContext->midi, sampleRate, expectedSequence);
         }
+
+        {
+            // Step the tempo every 0.3 beats so blocks frequently straddle a change
+            std::vector<tempo::TempoChange> tempoChanges;
+
+            for (int i = 0; i < 20; ++i)
+                tempoChanges.push_back ({ BeatPosition::fromBeats (i * 0.3), i % 2 == 0 ? 120.0 : 200.0, 1.0f });
+
+            tempo::Sequence tempoSequence (std::move (tempoChanges), { { BeatPosition(), 4, 4, false } },
+                                           tempo::LengthOfOneBeat::dependsOnTimeSignature);
+
+            // Use the seconds of the master sequence as beats
+            const auto durationBeats = duration - 0.5;
+            const auto durationSeconds = tempoSequence.toTime (BeatPosition::fromBeats (durationBeats)).inSeconds() + 0.5;
+
+            juce::MidiMessageSequence expectedSequence;
+
+            for (auto meh : masterSequence)
+                expectedSequence.addEvent (meh->message, tempoSequence.toTime (BeatPosition::fromBeats (meh->message.getTimeStamp())).inSeconds());
+
+            // Plays the MIDI through an optional counting Node with tempo changes batched and checks the timing
+            auto testBatchedTempoChanges = [&] (TempoSubRangeCountingNode::Counts* counts, bool canProcessTempoSubRanges)
+            {
+                ProcessState tempoProcessState (playHeadState, tempoSequence);
+                std::unique_ptr<Node> node = std::make_unique<tracktion::engine::MidiNode> (std::vector<juce::MidiMessageSequence> ({ masterSequence }),
+                                                                                           MidiList::TimeBase::beats,
+                                                                                           juce::Range<int>::withStartAndLength (1, 1),
+                                                                                           false,
+                                                                                           juce::Range<double> (0.0, durationBeats),
+                                                                                           LiveClipLevel(),
+                                                                                           tempoProcessState,
+                                                                                           EditItemID());
+
+                if (counts != nullptr)
+                    node = std::make_unique<TempoSubRangeCountingNode> (std::move (node), tempoProcessState, *counts, canProcessTempoSubRanges);
+
+                auto testContext = createTracktionTestContext (tempoProcessState, std::move (node), ts, 0, durationSeconds, true);
+                expectMidiBuffer (*this, testContext->midi, ts.sampleRate, expectedSequence);
+
+                // Each event should be within a sample or so of its time
+                const auto actualSequence = createMidiMessageSequence (testContext->midi, ts.sampleRate);
+
+                for (int i = 0; i < std::min (actualSequence.getNumEvents(), expectedSequence.getNumEvents()); ++i)
+                    expectWithinAbsoluteError (actualSequence.getEventTime (i), expectedSequence.getEventTime (i), 2.0 / ts.sampleRate);
+            };
+
+            beginTest ("Beat-based MIDI with batched tempo changes");
+            {
+                testBatchedTempoChanges (nullptr, false);
+            }
+
+            beginTest ("Batched tempo changes with a Node that can't process them");
+            {
+                // A Node that doesn't handle the sub-ranges should make the player split blocks at the
+                // tempo changes like it does when they're not batched, so it's processed more often
+                TempoSubRangeCountingNode::Counts batchedCounts, splitCounts;
+                testBatchedTempoChanges (&batchedCounts, true);
+                testBatchedTempoChanges (&splitCounts, false);
+
+                expectGreaterThan (batchedCounts.maxNumTempoSubRanges, (size_t) 1);
+                expectGreaterThan (splitCounts.numProcessCalls, batchedCounts.numProcessCalls);
+            }
+        }
     }
+
+    //==============================================================================
+    /** Passes on its input's MIDI and counts how it gets processed. */
+    class TempoSubRangeCountingNode final   : public Node,
+                                              public TracktionEngineNode
+    {
+    public:
+        struct Counts
+        {
+            int numProcessCalls = 0;
+            size_t maxNumTempoSubRanges = 0;
+        };
+
+        TempoSubRangeCountingNode (std::unique_ptr<Node> inputNode, ProcessState& ps, Counts& countsToUpdate, bool canProcessSubRanges)
+            : TracktionEngineNode (ps), input (std::move (inputNode)), counts (countsToUpdate), canProcess (canProcessSubRanges)
+        {
+        }
+
+        std::vector<Node*> getDirectInputNodes() override       { return { input.get() }; }
+        bool isReadyToProcess() override                        { return input->hasProcessed(); }
+        bool canProcessTempoSubRanges() const override          { return canProcess; }
+
+        NodeProperties getNodeProperties() override
+        {
+            auto props = input->getNodeProperties();
+            props.nodeID = 0;
+            return props;
+        }
+
+        void process (ProcessContext& pc) override
+        {
+            pc.buffers.midi.copyFrom (input->getProcessedOutput().midi);
+            ++counts.numProcessCalls;
+            counts.maxNumTempoSubRanges = std::max (counts.maxNumTempoSubRanges, getNumTempoSubRanges());
+        }
+
+    private:
+        std::unique_ptr<Node> input;
+        Counts& counts;
+        const bool canProcess;
+    };
 };
 
 static MidiNodeTests midiNodeTests;
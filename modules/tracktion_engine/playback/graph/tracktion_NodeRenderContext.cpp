@@ -59,7 +59,8 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
 
     nodePlayer = std::make_unique<TracktionNodePlayer> (std::move (n), *processState, r.sampleRateForAudio, r.blockSizeForAudio,
                                                         getPoolCreatorFunction (static_cast<tracktion::graph::ThreadPoolStrategy> (EditPlaybackContext::getThreadPoolStrategy())));
-    nodePlayer->setNumThreads ((size_t) p.engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1);
+    nodePlayer->setNumThreads ((size_t) (p.numThreadsForAudio > 0 ? p.numThreadsForAudio
+                                                                   : p.engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio()) - 1);
 
     numLatencySamplesToDrop = nodePlayer->getNode()->getNodeProperties().latencyNumSamples;
     r.time = r.time.withEnd (r.time.getEnd() + TimeDuration::fromSamples (numLatencySamplesToDrop, r.sampleRateForAudio));
@@ -70,7 +71,7 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
         TRACKTION_LOG_ERROR("Rendering whilst attached to audio device");
     }
 
-    if (r.shouldNormalise || r.trimSilenceAtEnds || r.shouldNormaliseByRMS)
+    if (r.shouldNormalise || r.trimSilenceAtEnds || r.shouldNormaliseByRMS || r.shouldNormaliseByLoudness)
     {
         needsToNormaliseAndTrim = true;
 
@@ -82,6 +83,7 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
         r.shouldNormalise = false;
         r.trimSilenceAtEnds = false;
         r.shouldNormaliseByRMS = false;
+        r.shouldNormaliseByLoudness = false;
     }
 
     numOutputChans = 2;
@@ -126,6 +128,7 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
     peak = 0.0001f;
     rmsTotal = 0.0;
     rmsNumSamps = 0;
+    loudnessMeter.reset (r.sampleRateForAudio, numOutputChans);
     streamTime = r.time.getStart();
 
     precount = numPreRenderBlocks;
@@ -156,6 +159,10 @@ NodeRenderContext::~NodeRenderContext()
     r.resultMagnitude = owner.params.resultMagnitude = peak;
     r.resultRMS = owner.params.resultRMS = rmsNumSamps > 0 ? (float) (rmsTotal / rmsNumSamps) : 0.0f;
     r.resultAudioDuration = owner.params.resultAudioDuration = float (numSamplesWrittenToSource / owner.params.sampleRateForAudio);
+    r.resultIntegratedLoudness = owner.params.resultIntegratedLoudness = loudnessMeter.getIntegratedLoudness();
+    r.resultMaxMomentaryLoudness = owner.params.resultMaxMomentaryLoudness = loudnessMeter.getMaxMomentaryLoudness();
+    r.resultMaxShortTermLoudness = owner.params.resultMaxShortTermLoudness = loudnessMeter.getMaxShortTermLoudness();
+    r.resultTruePeak = owner.params.resultTruePeak = loudnessMeter.getTruePeak();
 
     playHead->stop();
     Renderer::RenderTask::setAllPluginsRealtime (plugins, true);
@@ -174,7 +181,7 @@ bool NodeRenderContext::renderNextBlock (std::atomic<float>& progressToUpdate)
     CRASH_TRACER
     jassert (! r.edit->getTransport().isPlayContextActive());
 
-    if (--sleepCounter <= 0)
+    if (! r.offlineRender && --sleepCounter <= 0)
     {
         sleepCounter = sleepCounterMax;
         juce::Thread::sleep (1);
@@ -286,7 +293,7 @@ bool NodeRenderContext::renderNextBlock (std::atomic<float>& progressToUpdate)
                 return true;
         }
     }
-    else
+    else if (! r.offlineRender)
     {
         // for the pre-count blocks, sleep to give things a chance to get going
         juce::Thread::sleep ((int) (blockLength.inSeconds() * 1000));
@@ -342,6 +349,8 @@ NodeRenderContext::WriteResult NodeRenderContext::writeAudioBlock (choc::buffer:
         ++rmsNumSamps;
     }
 
+    loudnessMeter.addBlock (buffer, 0, blockSizeSamples);
+
     if (! hasStartedSavingToFile)
         samplesTrimmed += blockSizeSamples;
 
@@ -385,7 +394,8 @@ juce::String NodeRenderContext::renderMidi (Renderer::RenderTask& owner,
     // Ensure the node player gets deleted on the message thread
     const juce::ErasedScopeGuard scope ([&nodePlayer] { callBlocking ([&] { nodePlayer.reset(); }); });
 
-    nodePlayer->setNumThreads ((size_t) r.engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1);
+    nodePlayer->setNumThreads ((size_t) (r.numThreadsForAudio > 0 ? r.numThreadsForAudio
+                                                                   : r.engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio()) - 1);
 
     //TODO: Should really purge any non-MIDI nodes here then return if no MIDI has been found
 
@@ -106,6 +106,7 @@ private:
     float peak = 0;
     double rmsTotal = 0;
     int64_t rmsNumSamps = 0;
+    LoudnessMeter loudnessMeter;
     int precount = 0;
     TimePosition streamTime;
 
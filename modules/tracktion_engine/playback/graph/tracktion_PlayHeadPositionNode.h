@@ -42,6 +42,7 @@ public:
 
     std::vector<tracktion::graph::Node*> getDirectInputNodes() override  { return { input.get() }; }
     bool isReadyToProcess() override                                    { return input->hasProcessed(); }
+    bool canProcessTempoSubRanges() const override                      { return true; }
 
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info) override
     {
@@ -111,6 +111,7 @@ void PluginNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationIn
         }
     }
 
+    parameterChanges.reserve (maxNumParameterChangesPerBlock);
     isPrepared = true;
 
     if (info.enableNodeMemorySharing && input->numOutputNodes == 1)
@@ -192,11 +193,44 @@ void PluginNode::process (ProcessContext& pc)
     const auto blockTimeRange = getEditTimeRange();
     auto inputMidiIter = inputBuffers.midi.begin();
 
+    dequeueParameterChanges (blockNumSamples);
+    size_t nextParameterChange = 0;
+
+    // If the player is batching tempo changes, sub-blocks also end at each change
+    // so the plugin is given the right tempo for each section
+    const auto numTempoSubRanges = getNumTempoSubRanges();
+    size_t nextTempoSubRange = 1;
+
     // Process in blocks
     for (int subBlockNum = 0;; ++subBlockNum)
     {
+        // Apply any parameter changes due by now and end this sub-block where the next one is due
+        for (; nextParameterChange < parameterChanges.size(); ++nextParameterChange)
+        {
+            auto& change = parameterChanges[nextParameterChange];
+
+            if (change.sampleOffset > numSamplesDone)
+                break;
+
+            change.parameter->setParameterFromAudioThread (change.value);
+        }
+
         auto numSamplesThisBlock = std::min (subBlockSize, numSamplesLeft);
 
+        if (nextParameterChange < parameterChanges.size())
+            numSamplesThisBlock = std::min (numSamplesThisBlock, parameterChanges[nextParameterChange].sampleOffset - numSamplesDone);
+
+        for (; nextTempoSubRange < numTempoSubRanges; ++nextTempoSubRange)
+        {
+            const auto subRangeStart = (choc::buffer::FrameCount) std::llround (getTempoSubRange (nextTempoSubRange).blockProportion.getStart() * blockNumSamples);
+
+            if (subRangeStart > numSamplesDone)
+            {
+                numSamplesThisBlock = std::min (numSamplesThisBlock, subRangeStart - numSamplesDone);
+                break;
+            }
+        }
+
         auto outputAudioBuffer = toAudioBuffer (outputAudioView.getFrameRange (frameRangeWithStartAndLength (numSamplesDone, numSamplesThisBlock)));
 
         const auto blockPropStart = (numSamplesDone / (double) blockNumSamples);
@@ -242,6 +276,8 @@ void PluginNode::process (ProcessContext& pc)
         isAllNotesOff = false;
     }
 
+    parameterChanges.clear();
+
     // If the plugin was bypassed, use the delayed audio
     if (latencyProcessor)
     {
@@ -289,6 +325,44 @@ PluginRenderContext PluginNode::getPluginRenderContext (TimeRange editTime, juce
              isRendering, canProcessBypassed };
 }
 
+void PluginNode::dequeueParameterChanges (choc::buffer::FrameCount numSamples)
+{
+    parameterChanges.clear();
+
+    auto queue = plugin->getParameterChangeQueueIfCreated();
+
+    if (queue == nullptr)
+        return;
+
+    // Each block covers the time since the previous one so changes keep the spacing they
+    // were made with, just delayed by a block. After a gap, only the last block's worth is used
+    const auto now = queue->getCurrentTime();
+    const auto blockLength = numSamples / sampleRate;
+    auto windowStart = lastParameterChangeTime;
+
+    if (windowStart <= 0.0 || (now - windowStart) > blockLength * 4.0)
+        windowStart = now - blockLength;
+
+    lastParameterChangeTime = now;
+
+    const auto windowLength = now - windowStart;
+    const auto lastSample = numSamples > 0 ? (double) (numSamples - 1) : 0.0;
+    choc::buffer::FrameCount minOffset = 0;
+    ParameterChangeQueue::Event event;
+
+    // Any changes that don't fit are left in the queue for the next block
+    while (parameterChanges.size() < maxNumParameterChangesPerBlock && queue->pop (event))
+    {
+        const auto offset = windowLength > 0.0 ? (choc::buffer::FrameCount) std::clamp ((event.time - windowStart) / windowLength * numSamples,
+                                                                                         0.0, lastSample)
+                                               : 0;
+
+        // Keep the changes in the order they were posted so the most recent always wins
+        minOffset = std::max (minOffset, offset);
+        parameterChanges.push_back ({ std::move (event.parameter), event.value, minOffset });
+    }
+}
+
 void PluginNode::replaceLatencyProcessorIfPossible (NodeGraph* nodeGraphToReplace)
 {
     if (nodeGraphToReplace == nullptr)
@@ -56,6 +56,7 @@ public:
     void prefetchBlock (juce::Range<int64_t>) override;
     void preProcess (choc::buffer::FrameCount, juce::Range<int64_t>) override;
     void process (ProcessContext&) override;
+    bool canProcessTempoSubRanges() const override      { return true; }
 
 private:
     //==============================================================================
@@ -74,6 +75,17 @@ private:
     bool balanceLatency = true, canProcessBypassed = false;
     TimeDuration automationAdjustmentTime;
 
+    struct ParameterChange
+    {
+        AutomatableParameter::Ptr parameter;
+        float value = 0.0f;
+        choc::buffer::FrameCount sampleOffset = 0;
+    };
+
+    static constexpr size_t maxNumParameterChangesPerBlock = 1024;
+    std::vector<ParameterChange> parameterChanges;
+    double lastParameterChangeTime = 0.0;
+
     std::shared_ptr<tracktion::graph::LatencyProcessor> latencyProcessor;
     std::optional<NodeProperties> cachedNodeProperties;
     bool isPrepared = false, canUseSourceBuffers = false;
@@ -81,6 +93,7 @@ private:
     //==============================================================================
     void initialisePlugin (double sampleRateToUse, int blockSizeToUse);
     PluginRenderContext getPluginRenderContext (TimeRange, juce::AudioBuffer<float>&);
+    void dequeueParameterChanges (choc::buffer::FrameCount numSamples);
     void replaceLatencyProcessorIfPossible (NodeGraph*);
 };
 
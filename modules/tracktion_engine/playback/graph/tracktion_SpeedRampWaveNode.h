@@ -60,6 +60,7 @@ public:
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
     void process (ProcessContext&) override;
+    bool canProcessTempoSubRanges() const override      { return true; }
 
 private:
     //==============================================================================
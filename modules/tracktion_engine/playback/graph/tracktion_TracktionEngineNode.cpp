@@ -49,6 +49,8 @@ void ProcessState::update (double newSampleRate, juce::Range<int64_t> newReferen
              || timelineSampleRange.getLength() == newReferenceSampleRange.getLength());
 
     editTimeRange = timeRangeFromSamples (timelineSampleRange, sampleRate);
+    numTempoSubRanges = 1;
+    tempoSubRanges[0] = { { 0.0, 1.0 }, editTimeRange, editBeatRange };
 
     if (! tempoPosition)
         return;
@@ -59,6 +61,8 @@ void ProcessState::update (double newSampleRate, juce::Range<int64_t> newReferen
     const auto beatEnd = tempoPosition->getBeats();
     editBeatRange = { beatStart, beatEnd };
 
+    updateTempoSubRanges();
+
     if (updateContinuityFlags == UpdateContinuityFlags::no)
         return;
 
@@ -87,6 +91,55 @@ void ProcessState::setPlaybackSpeedRatio (double newRatio)
     playbackSpeedRatio = newRatio;
 }
 
+void ProcessState::setTempoSubRangesEnabled (bool shouldBeEnabled)
+{
+    tempoSubRangesEnabled = shouldBeEnabled;
+}
+
+void ProcessState::updateTempoSubRanges()
+{
+    numTempoSubRanges = 1;
+    tempoSubRanges[0] = { { 0.0, 1.0 }, editTimeRange, editBeatRange };
+
+    if (! tempoSubRangesEnabled || ! tempoPosition || editTimeRange.isEmpty() || numSamples <= 1)
+        return;
+
+    // N.B. The position is left at the end of the block as that's where update leaves it
+    tempoPosition->set (editTimeRange.getStart());
+    auto lastChange = editTimeRange.getStart();
+    const auto oneSample = 1.0 / numSamples;
+
+    for (;;)
+    {
+        const auto nextChange = tempoPosition->getTimeOfNextChange();
+        auto& lastSubRange = tempoSubRanges[numTempoSubRanges - 1];
+
+        if (nextChange <= lastChange
+            || nextChange >= editTimeRange.getEnd()
+            || numTempoSubRanges == maxNumTempoSubRanges)
+            break;
+
+        lastChange = nextChange;
+        tempoPosition->set (nextChange);
+        const auto proportion = (nextChange - editTimeRange.getStart()) / editTimeRange.getLength();
+
+        // Skip changes that are less than a sample apart
+        if (proportion - lastSubRange.blockProportion.getStart() < oneSample || 1.0 - proportion < oneSample)
+            continue;
+
+        const auto splitBeat = tempoPosition->getBeats();
+        lastSubRange.blockProportion = lastSubRange.blockProportion.withEnd (proportion);
+        lastSubRange.editTimeRange = lastSubRange.editTimeRange.withEnd (nextChange);
+        lastSubRange.editBeatRange = lastSubRange.editBeatRange.withEnd (splitBeat);
+
+        tempoSubRanges[numTempoSubRanges++] = { { proportion, 1.0 },
+                                                editTimeRange.withStart (nextChange),
+                                                editBeatRange.withStart (splitBeat) };
+    }
+
+    tempoPosition->set (editTimeRange.getEnd());
+}
+
 void ProcessState::setTempoSequence (const tempo::Sequence* ts)
 {
     if (tempoSequence == ts)
@@ -145,6 +198,25 @@ double TracktionEngineNode::getPlaybackSpeedRatio() const
     return processState->playbackSpeedRatio;
 }
 
+tracktion::graph::Node::ProcessContext TracktionEngineNode::getSubProcessContext (const tracktion::graph::Node::ProcessContext& pc,
+                                                                                 const ProcessState::TempoSubRange& subRange)
+{
+    const auto proportion = subRange.blockProportion;
+
+    if (proportion == juce::Range<double> (0.0, 1.0))
+        return pc;
+
+    const auto startSample  = (choc::buffer::FrameCount) std::llround (proportion.getStart() * pc.numSamples);
+    const auto endSample    = (choc::buffer::FrameCount) std::llround (proportion.getEnd() * pc.numSamples);
+    const choc::buffer::FrameRange sampleRange { startSample, endSample };
+
+    const auto referenceLength = (double) pc.referenceSampleRange.getLength();
+    const juce::Range<int64_t> referenceRange (pc.referenceSampleRange.getStart() + (int64_t) std::llround (proportion.getStart() * referenceLength),
+                                               pc.referenceSampleRange.getStart() + (int64_t) std::llround (proportion.getEnd() * referenceLength));
+
+    return { sampleRange.size(), referenceRange, { pc.buffers.audio.getFrameRange (sampleRange), pc.buffers.midi } };
+}
+
 std::optional<TimePosition> TracktionEngineNode::getTimeOfNextChange() const
 {
     if (auto tempoPosition = processState->getTempoSequencePosition())
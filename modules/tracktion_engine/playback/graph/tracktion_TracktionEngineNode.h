@@ -45,6 +45,38 @@ struct ProcessState
     */
     void setPlaybackSpeedRatio (double newRatio);
 
+    //==============================================================================
+    /** A section of the current block between tempo or time sig changes. */
+    struct TempoSubRange
+    {
+        juce::Range<double> blockProportion;    /**< The proportion of the block this section covers. */
+        TimeRange editTimeRange;                /**< The edit time of the section. */
+        BeatRange editBeatRange;                /**< The edit beats of the section. */
+    };
+
+    /** The maximum number of TempoSubRanges a block will be split in to.
+        If there are more changes than this, the remainder will be in the last sub-range.
+    */
+    static constexpr size_t maxNumTempoSubRanges = 16;
+
+    /** Enables splitting the block in to TempoSubRanges when update is called.
+        When disabled, there will only ever be one sub-range covering the whole block.
+        @see TracktionNodePlayer::enableBatchedTempoChanges
+    */
+    void setTempoSubRangesEnabled (bool);
+
+    /** Returns the number of TempoSubRanges the current block has been split in to.
+        This will always be at least 1.
+    */
+    size_t getNumTempoSubRanges() const                     { return numTempoSubRanges; }
+
+    /** Returns one of the TempoSubRanges for the current block. */
+    const TempoSubRange& getTempoSubRange (size_t index) const
+    {
+        jassert (index < numTempoSubRanges);
+        return tempoSubRanges[index];
+    }
+
     /** Sets the TempoSequence this state utilises. */
     void setTempoSequence (const tempo::Sequence*);
 
@@ -88,6 +120,12 @@ private:
     const tempo::Sequence* tempoSequence = nullptr;
     std::unique_ptr<tempo::Sequence::Position> tempoPosition;
     crill::seqlock_object<SyncRange> syncRange { SyncRange() };
+
+    bool tempoSubRangesEnabled = false;
+    std::array<TempoSubRange, maxNumTempoSubRanges> tempoSubRanges;
+    size_t numTempoSubRanges = 1;
+
+    void updateTempoSubRanges();
 };
 
 
@@ -131,6 +169,29 @@ public:
     /** Returns the playback speed ratio of the current process block. */
     double getPlaybackSpeedRatio() const;
 
+    /** Returns the number of sections the current block is split in to by tempo changes.
+        This will be 1 unless the player is batching tempo changes, in which case
+        Nodes that depend on the tempo within the block should process each section.
+        @see ProcessState::getTempoSubRange, TracktionNodePlayer::enableBatchedTempoChanges
+    */
+    size_t getNumTempoSubRanges() const                     { return processState->getNumTempoSubRanges(); }
+
+    /** Returns one of the sections of the current block between tempo changes. */
+    const ProcessState::TempoSubRange& getTempoSubRange (size_t index) const    { return processState->getTempoSubRange (index); }
+
+    /** Returns a ProcessContext for just the frames of one of the sections of a block. */
+    static tracktion::graph::Node::ProcessContext getSubProcessContext (const tracktion::graph::Node::ProcessContext&,
+                                                                        const ProcessState::TempoSubRange&);
+
+    /** Should return true if this Node gives the right results when a block with tempo
+        changes in it is processed in one go. That's either because it only depends on
+        the edit time or because it processes each of the TempoSubRanges itself.
+        If any Node in a graph returns false, the TracktionNodePlayer will split blocks
+        at tempo changes even if it's been asked to batch them.
+        @see TracktionNodePlayer::enableBatchedTempoChanges
+    */
+    virtual bool canProcessTempoSubRanges() const           { return false; }
+
     //==============================================================================
     /** May return the time of the next tempo or time sig change. */
     std::optional<TimePosition> getTimeOfNextChange() const;
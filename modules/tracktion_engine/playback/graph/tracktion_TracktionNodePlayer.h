@@ -46,7 +46,7 @@ public:
                          tracktion::graph::LockFreeMultiThreadedNodePlayer::ThreadPoolCreator poolCreator)
         : TracktionNodePlayer (processStateToUse, std::move (poolCreator))
     {
-        nodePlayer.setNode (std::move (node), sampleRate, blockSize);
+        setNode (std::move (node), sampleRate, blockSize);
     }
 
     /** Sets the number of threads to use for rendering.
@@ -65,11 +65,13 @@ public:
 
     void setNode (std::unique_ptr<tracktion::graph::Node> newNode)
     {
+        updateNodeToBatchTempoChangesFor (newNode.get());
         nodePlayer.setNode (std::move (newNode));
     }
 
     void setNode (std::unique_ptr<tracktion::graph::Node> newNode, double sampleRateToUse, int blockSizeToUse)
     {
+        updateNodeToBatchTempoChangesFor (newNode.get());
         nodePlayer.setNode (std::move (newNode), sampleRateToUse, blockSizeToUse);
     }
 
@@ -128,11 +130,74 @@ public:
         nodePlayer.enableNodeMemorySharing (enableNodeMemorySharing);
     }
 
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableStaticBufferAllocation */
+    void enableStaticBufferAllocation (bool enableStaticBuffers)
+    {
+        nodePlayer.enableStaticBufferAllocation (enableStaticBuffers);
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::setSchedulingStrategy */
+    void setSchedulingStrategy (tracktion::graph::NodeSchedulingStrategy strategy)
+    {
+        nodePlayer.setSchedulingStrategy (strategy);
+    }
+
+    /** Enables handling tempo changes within a block in a single pass of the graph.
+        By default, a block is split at tempo changes and the graph processed once
+        for each section. When enabled, the whole block is processed at once and
+        Nodes that depend on the tempo handle each section themselves using
+        TracktionEngineNode::getTempoSubRange.
+
+        This only applies to graphs where every TracktionEngineNode returns true from
+        canProcessTempoSubRanges. Other graphs are still split at tempo changes.
+        N.B. Blocks are still split at loop boundaries.
+    */
+    void enableBatchedTempoChanges (bool batchTempoChanges)
+    {
+        batchedTempoChanges = batchTempoChanges;
+        processState.setTempoSubRangesEnabled (batchTempoChanges);
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::setNodeProfiler */
+    void setNodeProfiler (tracktion::graph::NodeProfiler* profilerToUse)
+    {
+        nodePlayer.setNodeProfiler (profilerToUse);
+    }
+
 private:
     tracktion::graph::PlayHeadState& playHeadState;
     ProcessState& processState;
     MidiMessageArray scratchMidi;
     tracktion::graph::LockFreeMultiThreadedNodePlayer nodePlayer;
+    bool batchedTempoChanges = false;
+
+    // The root of the last Node set, if it can have its tempo changes batched.
+    // Blocks are only batched when this matches the root processed in the previous
+    // block so an older graph that's still playing isn't batched once a new one is set
+    std::atomic<tracktion::graph::Node*> nodeToBatchTempoChangesFor { nullptr };
+
+    void updateNodeToBatchTempoChangesFor (tracktion::graph::Node* newNode)
+    {
+        bool canBatch = newNode != nullptr;
+
+        if (newNode != nullptr)
+            tracktion::graph::visitNodes (*newNode, [&canBatch] (tracktion::graph::Node& n)
+                                          {
+                                              if (auto ten = dynamic_cast<TracktionEngineNode*> (&n))
+                                                  canBatch = canBatch && ten->canProcessTempoSubRanges();
+                                          }, true);
+
+        nodeToBatchTempoChangesFor.store (canBatch ? newNode : nullptr, std::memory_order_release);
+    }
+
+    bool shouldBatchTempoChanges() const
+    {
+        if (! batchedTempoChanges)
+            return false;
+
+        auto lastNode = nodePlayer.getLastProcessedNode();
+        return lastNode != nullptr && lastNode == nodeToBatchTempoChangesFor.load (std::memory_order_acquire);
+    }
 
     tracktion::graph::Node::ProcessContext getSubProcessContext (const tracktion::graph::Node::ProcessContext& pc, juce::Range<int64_t> subReferenceSampleRange)
     {
@@ -166,7 +231,12 @@ private:
         processState.update (sampleRate, pc.referenceSampleRange, ProcessState::UpdateContinuityFlags::no);
         const auto timeRange = processState.editTimeRange;
 
-        if (auto tempoPosition = processState.getTempoSequencePosition())
+        if (shouldBatchTempoChanges())
+        {
+            // Nodes handle any tempo changes using the ProcessState's TempoSubRanges
+            numMisses += processSubRange (pc, { 0.0, 1.0 });
+        }
+        else if (auto tempoPosition = processState.getTempoSequencePosition())
         {
             double startProportion = 0.0;
             auto lastEventPosition = timeRange.getStart();
@@ -78,7 +78,8 @@ public:
                           const juce::AudioChannelSet& destBufferChannels,
                           const juce::AudioChannelSet& sourceBufferChannels)
         : reader (std::move (ptr)), timeoutMs ((int) std::lround (timeout.inSeconds() * 1000.0)),
-          destChannelSet (destBufferChannels), sourceChannelSet (sourceBufferChannels)
+          destChannelSet (destBufferChannels), sourceChannelSet (sourceBufferChannels),
+          channelMap (reader->createChannelMap (destChannelSet, sourceChannelSet))
     {
     }
 
@@ -117,19 +118,14 @@ public:
 
     bool readSamples (choc::buffer::ChannelArrayView<float>& destBuffer) override
     {
-        auto buffer = toAudioBuffer (destBuffer);
-        return reader->readSamples ((int) destBuffer.getNumFrames(),
-                                    buffer,
-                                    destChannelSet,
-                                    0,
-                                    sourceChannelSet,
-                                    timeoutMs);
+        return reader->readSamples (destBuffer, channelMap, 1.0f, timeoutMs);
     }
 
     AudioFileCache::Reader::Ptr reader;
     int timeoutMs;
     const juce::AudioChannelSet destChannelSet;
     const juce::AudioChannelSet sourceChannelSet;
+    const std::vector<int> channelMap;
     const choc::buffer::ChannelCount numChannels { static_cast<choc::buffer::ChannelCount> (destChannelSet.size()) };
 };
 
@@ -1679,6 +1675,7 @@ void WaveNode::processSection (ProcessContext& pc, juce::Range<int64_t> timeline
     const auto fileEnd         = editTimeToFileSample (sectionEditTime.getEnd());
     const auto numFileSamples  = (int) (fileEnd - fileStart);
 
+    reader->setPlaybackSpeedHint (getPlaybackSpeedRatio());
     reader->setReadPosition (fileStart);
 
     auto destBuffer = pc.buffers.audio;
@@ -1999,7 +1996,16 @@ void WaveNodeRealTime::process (ProcessContext& pc)
     assert (outputSampleRate == getSampleRate());
 
     //TODO: Might get a performance boost by pre-setting the file position in prepareForNextBlock
-    processSection (pc);
+
+    // If the player is batching tempo changes, process each section so the readers see the right tempo
+    for (size_t i = 0; i < getNumTempoSubRanges(); ++i)
+    {
+        const auto& subRange = getTempoSubRange (i);
+        auto subContext = getSubProcessContext (pc, subRange);
+
+        if (subContext.numSamples > 0)
+            processSection (subContext, subRange.editBeatRange, subRange.editTimeRange, i == 0);
+    }
 }
 
 //==============================================================================
@@ -2010,8 +2016,10 @@ bool WaveNodeRealTime::buildAudioReaderGraph()
 
     AudioFileCache::Reader::Ptr fileCacheReader;
 
-    // Try creating a MemoryMappedFileReader first for compressed formats
-    if (audioFile.getInfo().needsCachedProxy)
+    // Try creating a MemoryMappedFileReader first for compressed formats,
+    // unless they've already been decoded to a sidecar the cache can map
+    if (audioFile.getInfo().needsCachedProxy
+        && ! audioFile.engine->getAudioFileManager().cache.hasDecodedSidecar (audioFile))
     {
         if (auto bufferedFileReader = audioFile.engine->getBufferedAudioFileManager().get (audioFile.getFile()))
         {
@@ -2163,10 +2171,8 @@ void WaveNodeRealTime::replaceStateIfPossible (WaveNodeRealTime& other)
     dynamicOffsetBeats = other.dynamicOffsetBeats;
 }
 
-void WaveNodeRealTime::processSection (ProcessContext& pc)
+void WaveNodeRealTime::processSection (ProcessContext& pc, BeatRange sectionEditBeats, TimeRange sectionEditTime, bool isFirstSection)
 {
-    const auto sectionEditBeats = getEditBeatRange();
-    const auto sectionEditTime = getEditTimeRange();
 
     // Check that the number of channels requested matches the destination buffer num channels
     assert (destChannels.size() == (int) pc.buffers.audio.getNumChannels());
@@ -2223,7 +2229,7 @@ void WaveNodeRealTime::processSection (ProcessContext& pc)
         pitchAdjustReader->setKey (getKeyToSyncTo (sectionEditTime.getStart()));
 
     // Read through the audio stack
-    const auto isContiguous = getPlayHeadState().isContiguousWithPreviousBlock();
+    const auto isContiguous = ! isFirstSection || getPlayHeadState().isContiguousWithPreviousBlock();
     uint32_t lastSampleFadeLength = (isFirstBlock && ! sectionContainsStartOfClip) ? std::min (numFrames, 10u) : 0;
     isFirstBlock = false;
 
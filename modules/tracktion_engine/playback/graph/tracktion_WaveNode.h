@@ -61,6 +61,7 @@ public:
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
     void process (ProcessContext&) override;
+    bool canProcessTempoSubRanges() const override      { return true; }
 
 private:
     //==============================================================================
@@ -180,6 +181,7 @@ public:
     void prepareToPlay (const graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
     void process (ProcessContext&) override;
+    bool canProcessTempoSubRanges() const override      { return true; }
 
 private:
     //==============================================================================
@@ -223,7 +225,7 @@ private:
     bool buildAudioReaderGraph();
     void replaceStateIfPossible (NodeGraph*);
     void replaceStateIfPossible (WaveNodeRealTime&);
-    void processSection (ProcessContext&);
+    void processSection (ProcessContext&, BeatRange sectionEditBeats, TimeRange sectionEditTime, bool isFirstSection);
     tempo::Key getKeyToSyncTo (TimePosition) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveNodeRealTime)
@@ -21,6 +21,12 @@ namespace EditPlaybackContextInternal
         return type;
     }
 
+    inline int& getNodeSchedulingStrategyType()
+    {
+        static int type = static_cast<int> (tracktion::graph::NodeSchedulingStrategy::sharedQueue);
+        return type;
+    }
+
     inline bool& getPooledMemoryFlag()
     {
         static bool usePool = false;
@@ -33,6 +39,30 @@ namespace EditPlaybackContextInternal
         return useSharing;
     }
 
+    inline bool& getStaticBufferAllocationFlag()
+    {
+        static bool useStaticBuffers = false;
+        return useStaticBuffers;
+    }
+
+    inline bool& getIncrementalGraphRebuildsFlag()
+    {
+        static bool useIncrementalRebuilds = false;
+        return useIncrementalRebuilds;
+    }
+
+    inline bool& getLookAheadRenderingFlag()
+    {
+        static bool useLookAheadRendering = false;
+        return useLookAheadRendering;
+    }
+
+    inline bool& getBatchedTempoChangesFlag()
+    {
+        static bool batchTempoChanges = false;
+        return batchTempoChanges;
+    }
+
     inline bool& getAudioWorkgroupFlag()
     {
         static bool useAudioWorkgroup = false;
@@ -188,8 +218,11 @@ private:
              };
 
          setNumThreads (numThreads);
+         player.setSchedulingStrategy (static_cast<tracktion::graph::NodeSchedulingStrategy> (getNodeSchedulingStrategy()));
          player.enablePooledMemoryAllocations (EditPlaybackContextInternal::getPooledMemoryFlag());
          player.enableNodeMemorySharing (EditPlaybackContextInternal::getNodeMemorySharingFlag());
+         player.enableStaticBufferAllocation (EditPlaybackContextInternal::getStaticBufferAllocationFlag());
+         player.enableBatchedTempoChanges (EditPlaybackContextInternal::getBatchedTempoChangesFlag());
      }
 
      void setNumThreads (size_t numThreads)
@@ -632,6 +665,7 @@ void EditPlaybackContext::clearNodes()
     }
 
     priorityBooster = nullptr;
+    trackNodeCache = nullptr;
     isAllocated = false;
 
     // Because the nodePlaybackContext is lock-free, it doesn't immediately delete its current node
@@ -667,6 +701,18 @@ void EditPlaybackContext::createNode()
     cnp.includeBypassedPlugins = ! engineBehaviour.shouldBypassedPluginsBeRemovedFromPlaybackGraph();
     cnp.allowClipSlots = engineBehaviour.areClipSlotsEnabled();
     cnp.readAheadTimeStretchNodes = engineBehaviour.enableReadAheadForTimeStretchNodes();
+
+    const bool lookAhead = EditPlaybackContextInternal::getLookAheadRenderingFlag();
+
+    if (! (EditPlaybackContextInternal::getIncrementalGraphRebuildsFlag() || lookAhead))
+        trackNodeCache = nullptr;
+    else if (! trackNodeCache)
+        trackNodeCache = std::make_unique<TrackNodeCache> (edit);
+
+    if (trackNodeCache)
+        trackNodeCache->setLookAheadRenderingEnabled (lookAhead);
+
+    cnp.trackNodeCache = trackNodeCache.get();
     auto editNode = createNodeForEdit (*this, audiblePlaybackTime, cnp);
 
     nodePlaybackContext->setNode (std::move (editNode), cnp.sampleRate, cnp.blockSize);
@@ -687,6 +733,8 @@ void EditPlaybackContext::createPlayAudioNodesIfNeeded (TimePosition startTime)
 
 void EditPlaybackContext::reallocate()
 {
+    // The inputs have changed so any track could have different live inputs
+    invalidateCachedTrackNodes();
     createPlayAudioNodes (getPosition());
 }
 
@@ -1221,6 +1269,22 @@ int EditPlaybackContext::getThreadPoolStrategy()
     return type;
 }
 
+void EditPlaybackContext::setNodeSchedulingStrategy (int type)
+{
+    type = juce::jlimit (static_cast<int> (tracktion::graph::NodeSchedulingStrategy::sharedQueue),
+                         static_cast<int> (tracktion::graph::NodeSchedulingStrategy::workStealing),
+                         type);
+
+    EditPlaybackContextInternal::getNodeSchedulingStrategyType() = type;
+}
+
+int EditPlaybackContext::getNodeSchedulingStrategy()
+{
+    return juce::jlimit (static_cast<int> (tracktion::graph::NodeSchedulingStrategy::sharedQueue),
+                         static_cast<int> (tracktion::graph::NodeSchedulingStrategy::workStealing),
+                         EditPlaybackContextInternal::getNodeSchedulingStrategyType());
+}
+
 void EditPlaybackContext::enablePooledMemory (bool enable)
 {
     EditPlaybackContextInternal::getPooledMemoryFlag() = enable;
@@ -1231,6 +1295,38 @@ void EditPlaybackContext::enableNodeMemorySharing (bool enable)
     EditPlaybackContextInternal::getNodeMemorySharingFlag() = enable;
 }
 
+void EditPlaybackContext::enableStaticBufferAllocation (bool enable)
+{
+    EditPlaybackContextInternal::getStaticBufferAllocationFlag() = enable;
+}
+
+void EditPlaybackContext::enableIncrementalGraphRebuilds (bool enable)
+{
+    EditPlaybackContextInternal::getIncrementalGraphRebuildsFlag() = enable;
+}
+
+void EditPlaybackContext::enableLookAheadRendering (bool enable)
+{
+    EditPlaybackContextInternal::getLookAheadRenderingFlag() = enable;
+}
+
+void EditPlaybackContext::enableBatchedTempoChanges (bool enable)
+{
+    EditPlaybackContextInternal::getBatchedTempoChangesFlag() = enable;
+}
+
+void EditPlaybackContext::invalidateCachedTrackNodes()
+{
+    if (trackNodeCache)
+        trackNodeCache->invalidateAll();
+}
+
+void EditPlaybackContext::flushLookAheadRendering()
+{
+    if (trackNodeCache)
+        trackNodeCache->flushLookAheads();
+}
+
 void EditPlaybackContext::enableAudioWorkgroup (bool enable)
 {
     EditPlaybackContextInternal::getAudioWorkgroupFlag() = enable;
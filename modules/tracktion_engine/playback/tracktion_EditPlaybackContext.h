@@ -141,6 +141,11 @@ public:
     /** @see tracktion::graph::ThreadPoolStrategy */
     static int getThreadPoolStrategy();
 
+    /** @see tracktion::graph::NodeSchedulingStrategy */
+    static void setNodeSchedulingStrategy (int);
+    /** @see tracktion::graph::NodeSchedulingStrategy */
+    static int getNodeSchedulingStrategy();
+
     /** Enables reusing of audio buffers during graph processing
         which may reduce the memory use at the cost of some additional overhead.
     */
@@ -152,6 +157,44 @@ public:
     */
     static void enableNodeMemorySharing (bool);
 
+    /** Enables planning all the audio buffers up front when the graph is built,
+        sharing them between Nodes that can't be live at the same time.
+        This avoids any buffer pool traffic during processing and takes precedence
+        over enablePooledMemory.
+    */
+    static void enableStaticBufferAllocation (bool);
+
+    /** Enables rebuilding only the tracks that have changed when the graph is rebuilt.
+        Tracks that haven't changed reuse their previously prepared Nodes.
+        @see TrackNodeCache
+    */
+    static void enableIncrementalGraphRebuilds (bool);
+
+    /** Enables rendering tracks that don't depend on live input ahead of the
+        playhead on background threads. This implies enableIncrementalGraphRebuilds.
+        N.B. Meters and plugin values on these tracks will lead the audio slightly.
+        @see TrackNodeCache::setLookAheadRenderingEnabled
+    */
+    static void enableLookAheadRendering (bool);
+
+    /** Enables processing tempo changes within a block in a single pass of the graph
+        rather than splitting the block at each change.
+        @see TracktionNodePlayer::enableBatchedTempoChanges
+    */
+    static void enableBatchedTempoChanges (bool);
+
+    /** Marks any cached track Nodes as changed so the next graph rebuilds them all.
+        @see enableIncrementalGraphRebuilds
+    */
+    void invalidateCachedTrackNodes();
+
+    /** Discards any audio that's been rendered ahead of the playhead.
+        This should be called when something that affects a track's output changes
+        without changing the Edit's state, e.g. an external plugin's parameters.
+        @see enableLookAheadRendering
+    */
+    void flushLookAheadRendering();
+
     /** Enables using AudioWorkgroups.
         Currently experimental and only on macOS.
     */
@@ -201,6 +244,7 @@ private:
 
     struct NodePlaybackContext;
     std::unique_ptr<NodePlaybackContext> nodePlaybackContext;
+    std::unique_ptr<TrackNodeCache> trackNodeCache;
 
     juce::WeakReference<EditPlaybackContext> nodeContextToSyncTo;
     std::atomic<double> audiblePlaybackTime { 0.0 };
@@ -12,33 +12,90 @@ namespace tracktion { inline namespace engine
 {
 
 //==============================================================================
-template <typename FloatType>
-static void getSumAndDiff (const juce::AudioBuffer<FloatType>& buffer,
-                           FloatType& sum, FloatType& diff,
-                           int startIndex, int numSamples)
+/** Finds the peak and sum of squares of a channel in a single pass.
+    These are accumulated in several lanes so the loop can be vectorised.
+*/
+static void measureChannel (const float* data, int numSamples, float& peak, float& sumOfSquares) noexcept
 {
-    if (buffer.getNumChannels() == 0)
+    constexpr int numLanes = 8;
+    float peaks[numLanes] = {};
+    float sums[numLanes] = {};
+    int i = 0;
+
+    for (; i + numLanes <= numSamples; i += numLanes)
     {
-        sum = 0;
-        diff = 0;
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            auto s = data[i + lane];
+            peaks[lane] = std::max (peaks[lane], std::abs (s));
+            sums[lane] += s * s;
+        }
     }
-    else
+
+    for (; i < numSamples; ++i)
+    {
+        auto s = data[i];
+        peaks[0] = std::max (peaks[0], std::abs (s));
+        sums[0] += s * s;
+    }
+
+    peak = 0.0f;
+    sumOfSquares = 0.0f;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        peak = std::max (peak, peaks[lane]);
+        sumOfSquares += sums[lane];
+    }
+}
+
+//==============================================================================
+// The four phases of the 48-tap interpolation filter from ITU-R BS.1770-4 Annex 2
+static constexpr float truePeakCoefficients[4][12] =
+{
+    {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+       0.9721679687500f, -0.1022949218750f,  0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+    { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+       0.7797851562500f, -0.2003173828125f,  0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+    { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+       0.4650878906250f, -0.1665039062500f,  0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+    { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+       0.1373291015625f, -0.0594482421875f,  0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+};
+
+void TruePeakDetector::reset() noexcept
+{
+    for (auto& c : channels)
+        c = {};
+}
+
+float TruePeakDetector::process (int channel, const float* samples, int numSamples) noexcept
+{
+    jassert (channel >= 0 && channel < maxNumChannels);
+    auto& c = channels[(size_t) channel];
+    float peak = 0.0f;
+
+    for (int i = 0; i < numSamples; ++i)
     {
-        FloatType s  = 0;
-        FloatType lo = (FloatType) 1;
-        FloatType hi = 0;
+        c.position = (c.position == 0 ? numTaps : c.position) - 1;
+        c.history[(size_t) c.position] = samples[i];
+        c.history[(size_t) (c.position + numTaps)] = samples[i];
+
+        // history[0] is now the newest sample, history[numTaps - 1] the oldest
+        auto history = c.history.data() + c.position;
 
-        for (int i = buffer.getNumChannels(); --i >= 0;)
+        for (auto& coefficients : truePeakCoefficients)
         {
-            auto mag = buffer.getMagnitude (i, startIndex, numSamples);
-            s += mag;
-            lo = juce::jmin (lo, mag);
-            hi = juce::jmax (hi, mag);
-        }
+            float sum = 0.0f;
+
+            for (int tap = 0; tap < numTaps; ++tap)
+                sum += coefficients[tap] * history[tap];
 
-        sum = s / buffer.getNumChannels();
-        diff = juce::jmax (FloatType(), hi - lo);
+            peak = std::max (peak, std::abs (sum));
+        }
     }
+
+    return peak;
 }
 
 //==============================================================================
@@ -136,6 +193,24 @@ void LevelMeasurer::Client::updateAudioLevel (int channel, DbTimePair newAudioLe
         audioLevels[channel] = newAudioLevel;
 }
 
+void LevelMeasurer::Client::updateAudioLevels (const float* dBs, uint32_t overloadedChannels,
+                                               int numChannels, uint32_t time) noexcept
+{
+    juce::SpinLock::ScopedLockType sl (mutex);
+    jassert (numChannels <= maxNumChannels);
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        if (dBs[i] >= audioLevels[i].dB)
+            audioLevels[i] = { time, dBs[i] };
+
+        if ((overloadedChannels & (1u << i)) != 0)
+            overload[i] = true;
+    }
+
+    numChannelsUsed = numChannels;
+}
+
 void LevelMeasurer::Client::updateMidiLevel (DbTimePair newMidiLevel) noexcept
 {
     juce::SpinLock::ScopedLockType sl (mutex);
@@ -154,71 +229,91 @@ void LevelMeasurer::processBuffer (juce::AudioBuffer<float>& buffer, int start,
         return;
 
     auto numChans = std::min ((int) Client::maxNumChannels, buffer.getNumChannels());
-    numActiveChannels = numChans;
     auto now = juce::Time::getApproximateMillisecondCounter();
+    const bool measureTruePeak = truePeakEnabled.load (std::memory_order_relaxed);
 
-    if (mode == LevelMeasurer::peakMode)
+    // Measure every channel in a single pass and publish the results before updating any clients
+    auto& l = lastLevels;
+    l.numChannels = numChans;
+    l.time = now;
+    ++l.numBlocks;
+
+    for (int i = 0; i < Levels::maxNumChannels; ++i)
     {
-        // peak mode
-        for (int i = numChans; --i >= 0;)
+        if (i >= numChans)
         {
-            auto gain = buffer.getMagnitude (i, start, numSamples);
-            bool overloaded = gain > 0.999f;
-            auto newDB = gainToDb (gain);
+            l.peak[(size_t) i] = 0.0f;
+            l.rms[(size_t) i] = 0.0f;
+            l.truePeak[(size_t) i] = 0.0f;
+            continue;
+        }
 
-            for (auto c : clients)
-            {
-                c->updateAudioLevel (i, { now, newDB });
+        auto data = buffer.getReadPointer (i, start);
+        float peak, sumOfSquares;
+        measureChannel (data, numSamples, peak, sumOfSquares);
 
-                if (overloaded)
-                    c->setOverload (i, true);
+        auto truePeak = measureTruePeak ? std::max (peak, truePeakDetector.process (i, data, numSamples)) : 0.0f;
 
-                c->setNumChannelsUsed (numChans);
-            }
-        }
+        l.peak[(size_t) i] = peak;
+        l.rms[(size_t) i] = numSamples > 0 ? std::sqrt (sumOfSquares / (float) numSamples) : 0.0f;
+        l.truePeak[(size_t) i] = truePeak;
+        l.heldPeak[(size_t) i] = std::max ({ l.heldPeak[(size_t) i], peak, truePeak });
+
+        if (std::max (peak, truePeak) > 0.999f)
+            l.overloadedChannels |= (1u << i);
     }
-    else if (mode == LevelMeasurer::RMSMode)
+
+    levels.store (l);
+
+    float dBs[Client::maxNumChannels];
+    uint32_t overloadedChannels = 0;
+
+    if (mode == LevelMeasurer::sumDiffMode)
     {
-        // rms mode
-        for (int i = numChans; --i >= 0;)
+        // sum + diff
+        float sum = 0.0f, diff = 0.0f;
+
+        if (numChans > 0)
         {
-            auto gain = buffer.getRMSLevel (i, start, numSamples);
-            bool overloaded = gain > 0.999f;
-            auto newDB = gainToDb (gain);
+            float lo = 1.0f, hi = 0.0f;
 
-            for (auto c : clients)
+            for (int i = 0; i < numChans; ++i)
             {
-                c->updateAudioLevel (i, { now, newDB });
-
-                if (overloaded)
-                    c->setOverload (i, true);
-
-                c->setNumChannelsUsed (numChans);
+                sum += l.peak[(size_t) i];
+                lo = std::min (lo, l.peak[(size_t) i]);
+                hi = std::max (hi, l.peak[(size_t) i]);
             }
+
+            sum /= (float) numChans;
+            diff = std::max (0.0f, hi - lo);
         }
+
+        dBs[0] = gainToDb (sum);
+        dBs[1] = gainToDb (diff);
+
+        if (sum  > 0.999f) overloadedChannels |= 1u;
+        if (diff > 0.999f) overloadedChannels |= 2u;
+
+        numChans = 2;
     }
     else
     {
-        // sum + diff
-        float sum, diff;
-        getSumAndDiff (buffer, sum, diff, start, numSamples);
-
-        auto sumDB  = gainToDb (sum);
-        auto diffDB = gainToDb (diff);
+        auto& gains = mode == LevelMeasurer::RMSMode ? l.rms : l.peak;
 
-        for (auto c : clients)
+        for (int i = 0; i < numChans; ++i)
         {
-            c->updateAudioLevel (0, { now, sumDB });
-            c->updateAudioLevel (1, { now, diffDB });
+            auto gain = gains[(size_t) i];
+            dBs[i] = gainToDb (gain);
 
-            if (sum  > 0.999f) c->setOverload (0, true);
-            if (diff > 0.999f) c->setOverload (1, true);
-
-            c->setNumChannelsUsed (2);
+            if (gain > 0.999f)
+                overloadedChannels |= (1u << i);
         }
-
-        numActiveChannels = 2;
     }
+
+    numActiveChannels = numChans;
+
+    for (auto c : clients)
+        c->updateAudioLevels (dBs, overloadedChannels, numChans, now);
 }
 
 void LevelMeasurer::processMidi (MidiMessageArray& midiBuffer, const float*)
@@ -256,6 +351,8 @@ void LevelMeasurer::processMidiLevel (float level)
 void LevelMeasurer::clearOverload()
 {
     const std::scoped_lock sl (clientsMutex);
+    lastLevels.overloadedChannels = 0;
+    levels.store (lastLevels);
 
     for (auto c : clients)
         c->setClearOverload (true);
@@ -264,6 +361,8 @@ void LevelMeasurer::clearOverload()
 void LevelMeasurer::clearPeak()
 {
     const std::scoped_lock sl (clientsMutex);
+    lastLevels.heldPeak = {};
+    levels.store (lastLevels);
 
     for (auto c : clients)
         c->setClearPeak (true);
@@ -279,6 +378,18 @@ void LevelMeasurer::clear()
     levelCacheL = -100.0f;
     levelCacheR = -100.0f;
     numActiveChannels = 1;
+
+    lastLevels = {};
+    levels.store (lastLevels);
+    truePeakDetector.reset();
+}
+
+void LevelMeasurer::setTruePeakEnabled (bool shouldBeEnabled) noexcept
+{
+    const std::scoped_lock sl (clientsMutex);
+
+    if (truePeakEnabled.exchange (shouldBeEnabled) != shouldBeEnabled)
+        truePeakDetector.reset();
 }
 
 void LevelMeasurer::setMode (LevelMeasurer::Mode m)
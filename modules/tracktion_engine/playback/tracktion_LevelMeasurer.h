@@ -17,6 +17,37 @@ struct DbTimePair
     float dB = -100.0f;
 };
 
+//==============================================================================
+/**
+    Finds the true-peak level of blocks of audio by 4x oversampling them with
+    the interpolation filter described in ITU-R BS.1770.
+    This keeps the last few samples of each channel between blocks so they need
+    to be passed in contiguously.
+*/
+class TruePeakDetector
+{
+public:
+    static constexpr int maxNumChannels = 8;
+
+    /** Clears the history of each channel. */
+    void reset() noexcept;
+
+    /** Returns the highest magnitude of the oversampled signal in a block of a channel. */
+    float process (int channel, const float* samples, int numSamples) noexcept;
+
+private:
+    static constexpr int numTaps = 12;
+
+    struct Channel
+    {
+        // The history is written twice so the last numTaps samples are always contiguous
+        std::array<float, numTaps * 2> history {};
+        int position = 0;
+    };
+
+    std::array<Channel, maxNumChannels> channels;
+};
+
 //==============================================================================
 /**
     Monitors the levels of buffers that are passed in, and keeps peak values,
@@ -74,6 +105,7 @@ public:
         void setClearPeak (bool) noexcept;
 
         void updateAudioLevel (int channel, DbTimePair) noexcept;
+        void updateAudioLevels (const float* dBs, uint32_t overloadedChannels, int numChannels, uint32_t time) noexcept;
         void updateMidiLevel (DbTimePair) noexcept;
 
     private:
@@ -87,6 +119,37 @@ public:
         juce::SpinLock mutex;
     };
 
+    //==============================================================================
+    /**
+        A snapshot of the levels measured in the most recent block, which can be
+        polled from any thread with getLevels.
+        The levels are all linear gains.
+    */
+    struct Levels
+    {
+        static constexpr int maxNumChannels = Client::maxNumChannels;
+
+        std::array<float, maxNumChannels> peak {};      /**< The peak of each channel in the last block. */
+        std::array<float, maxNumChannels> rms {};       /**< The RMS level of each channel in the last block. */
+        std::array<float, maxNumChannels> truePeak {};  /**< The true-peak of each channel if enabled, otherwise 0. */
+        std::array<float, maxNumChannels> heldPeak {};  /**< The highest peak of each channel since clearPeak was called. */
+        uint32_t overloadedChannels = 0;                /**< A bit for each channel that's overloaded since clearOverload was called. */
+        uint32_t time = 0;                              /**< The millisecond counter when the last block was measured. */
+        uint64_t numBlocks = 0;                         /**< The number of blocks measured, to tell when this has been updated. */
+        int numChannels = 0;                            /**< The number of channels being measured. */
+    };
+
+    /** Returns the levels of the most recent block.
+        This doesn't lock so can be called by the UI or another thread as often as needed.
+        Nothing is measured unless there's at least one Client, so these won't change
+        whilst there aren't any.
+    */
+    Levels getLevels() const noexcept                       { return levels.load(); }
+
+    /** Enables true-peak measurement, which is stored in the Levels. */
+    void setTruePeakEnabled (bool) noexcept;
+    bool isTruePeakEnabled() const noexcept                 { return truePeakEnabled.load (std::memory_order_relaxed); }
+
     //==============================================================================
     void addClient (Client&);
     void removeClient (Client&);
@@ -104,6 +167,12 @@ private:
     juce::Array<Client*> clients;
     RealTimeSpinLock clientsMutex;
 
+    // These are only used whilst the clientsMutex is locked
+    MultipleWriterSeqLock<Levels> levels;
+    Levels lastLevels;
+    TruePeakDetector truePeakDetector;
+    std::atomic<bool> truePeakEnabled { false };
+
     JUCE_DECLARE_WEAK_REFERENCEABLE(LevelMeasurer)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeasurer)
 };
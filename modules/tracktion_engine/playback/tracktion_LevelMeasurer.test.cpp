@@ -0,0 +1,170 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_LEVEL_MEASURER
+
+//==============================================================================
+//==============================================================================
+class LevelMeasurerTests : public juce::UnitTest
+{
+public:
+    LevelMeasurerTests()
+        : juce::UnitTest ("LevelMeasurer", "tracktion_engine")
+    {
+    }
+
+    void runTest() override
+    {
+        runLevelsTest();
+        runTruePeakTest();
+        runNoClientsTest();
+    }
+
+private:
+    void runLevelsTest()
+    {
+        juce::AudioBuffer<float> buffer (3, 1001);
+        juce::Random r (42);
+
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (chan, i, (r.nextFloat() * 2.0f - 1.0f) * 0.4f * (float) (chan + 1));
+
+        LevelMeasurer measurer;
+        LevelMeasurer::Client client;
+        measurer.addClient (client);
+        measurer.processBuffer (buffer, 10, 987);
+
+        beginTest ("Levels match the buffer");
+        {
+            auto levels = measurer.getLevels();
+            expectEquals (levels.numChannels, 3);
+            expectEquals<uint64_t> (levels.numBlocks, 1);
+
+            for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            {
+                expectWithinAbsoluteError (levels.peak[(size_t) chan], buffer.getMagnitude (chan, 10, 987), 0.0001f);
+                expectWithinAbsoluteError (levels.rms[(size_t) chan], buffer.getRMSLevel (chan, 10, 987), 0.0001f);
+                expectEquals (levels.heldPeak[(size_t) chan], levels.peak[(size_t) chan]);
+                expectEquals (levels.truePeak[(size_t) chan], 0.0f);
+            }
+
+            // Only the third channel goes above 1
+            expectEquals (levels.overloadedChannels, 4u);
+        }
+
+        beginTest ("Clients are updated");
+        {
+            expectEquals (client.getNumChannelsUsed(), 3);
+
+            for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                expectWithinAbsoluteError (client.getAndClearAudioLevel (chan).dB,
+                                           gainToDb (buffer.getMagnitude (chan, 10, 987)), 0.001f);
+        }
+
+        beginTest ("Peaks are held until cleared");
+        {
+            buffer.clear();
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+
+            auto levels = measurer.getLevels();
+            expectEquals<uint64_t> (levels.numBlocks, 2);
+            expectEquals (levels.peak[0], 0.0f);
+            expect (levels.heldPeak[0] > 0.0f);
+            expectEquals (levels.overloadedChannels, 4u);
+
+            measurer.clearPeak();
+            measurer.clearOverload();
+            levels = measurer.getLevels();
+            expectEquals (levels.heldPeak[0], 0.0f);
+            expectEquals (levels.overloadedChannels, 0u);
+        }
+
+        measurer.removeClient (client);
+    }
+
+    void runTruePeakTest()
+    {
+        // A sine at a quarter of the sample rate with a 45 degree phase offset
+        // has samples at 0.707 but a true-peak of 1
+        juce::AudioBuffer<float> buffer (1, 1024);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample (0, i, std::sin (juce::MathConstants<float>::halfPi * (float) i
+                                               + juce::MathConstants<float>::pi * 0.25f));
+
+        LevelMeasurer samplePeakMeasurer, truePeakMeasurer;
+        LevelMeasurer::Client samplePeakClient, truePeakClient;
+        samplePeakMeasurer.addClient (samplePeakClient);
+        truePeakMeasurer.addClient (truePeakClient);
+        truePeakMeasurer.setTruePeakEnabled (true);
+
+        // Process it in blocks to check the filter history carries over
+        for (int i = 0; i < buffer.getNumSamples(); i += 128)
+        {
+            samplePeakMeasurer.processBuffer (buffer, i, 128);
+            truePeakMeasurer.processBuffer (buffer, i, 128);
+        }
+
+        beginTest ("True-peak");
+        {
+            auto levels = truePeakMeasurer.getLevels();
+            expectWithinAbsoluteError (levels.peak[0], 0.7071f, 0.001f);
+            expectWithinAbsoluteError (levels.truePeak[0], 1.0f, 0.02f);
+            expectWithinAbsoluteError (levels.heldPeak[0], 1.0f, 0.02f);
+
+            // The interpolated peak goes over the overload threshold even though no sample does
+            expectEquals (levels.overloadedChannels, 1u);
+        }
+
+        beginTest ("Sample-peak only");
+        {
+            auto levels = samplePeakMeasurer.getLevels();
+            expectWithinAbsoluteError (levels.peak[0], 0.7071f, 0.001f);
+            expectWithinAbsoluteError (levels.heldPeak[0], 0.7071f, 0.001f);
+            expectEquals (levels.truePeak[0], 0.0f);
+            expectEquals (levels.overloadedChannels, 0u);
+        }
+
+        samplePeakMeasurer.removeClient (samplePeakClient);
+        truePeakMeasurer.removeClient (truePeakClient);
+    }
+
+    void runNoClientsTest()
+    {
+        beginTest ("Nothing is measured without clients");
+        {
+            juce::AudioBuffer<float> buffer (2, 256);
+            buffer.clear();
+            buffer.setSample (0, 10, 0.5f);
+
+            LevelMeasurer measurer;
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+            expectEquals<uint64_t> (measurer.getLevels().numBlocks, 0);
+            expectEquals (measurer.getLevels().peak[0], 0.0f);
+
+            LevelMeasurer::Client client;
+            measurer.addClient (client);
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+            expectEquals<uint64_t> (measurer.getLevels().numBlocks, 1);
+            expectEquals (measurer.getLevels().peak[0], 0.5f);
+            measurer.removeClient (client);
+        }
+    }
+};
+
+static LevelMeasurerTests levelMeasurerTests;
+
+#endif
+
+}} // namespace tracktion { inline namespace engine
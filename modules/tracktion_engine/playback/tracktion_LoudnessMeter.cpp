@@ -0,0 +1,210 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+void LoudnessMeter::reset (double sampleRate, int numChannelsToUse)
+{
+    jassert (sampleRate > 0.0);
+    jassert (numChannelsToUse <= maxNumChannels);
+    numChannels = std::clamp (numChannelsToUse, 0, maxNumChannels);
+
+    // The K-weighting filter is a high shelf followed by a high pass. These are
+    // the BS.1770 coefficients given for 48kHz, re-derived for the sample rate
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const auto vh = std::pow (10.0, gainDb / 20.0);
+        const auto vb = std::pow (vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        filters[0] = { (vh + vb * k / q + k * k) / a0,
+                       2.0 * (k * k - vh) / a0,
+                       (vh - vb * k / q + k * k) / a0,
+                       2.0 * (k * k - 1.0) / a0,
+                       (1.0 - k / q + k * k) / a0 };
+    }
+
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        filters[1] = { 1.0, -2.0, 1.0,
+                       2.0 * (k * k - 1.0) / a0,
+                       (1.0 - k / q + k * k) / a0 };
+    }
+
+    for (int i = 0; i < maxNumChannels; ++i)
+    {
+        auto& c = channels[(size_t) i];
+        c = {};
+
+        if (numChannels == 6)
+            c.weight = i == 3 ? 0.0 : (i >= 4 ? 1.41 : 1.0);
+    }
+
+    samplesPerStep = std::max (1, juce::roundToInt (sampleRate / 10.0));
+    numSamplesInStep = 0;
+    stepEnergies = {};
+    numSteps = 0;
+
+    momentaryBlockEnergies.clear();
+    momentaryBlockEnergies.reserve (36000); // An hour
+
+    maxMomentaryLoudness = silenceLoudness;
+    maxShortTermLoudness = silenceLoudness;
+    truePeak = 0.0f;
+    truePeakDetector.reset();
+}
+
+void LoudnessMeter::addBlock (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    jassert (samplesPerStep > 0);
+    const auto numChansToUse = std::min (numChannels, buffer.getNumChannels());
+
+    for (int chan = 0; chan < numChansToUse; ++chan)
+        truePeak = std::max (truePeak, truePeakDetector.process (chan, buffer.getReadPointer (chan, startSample), numSamples));
+
+    // Filter the samples in chunks that end on step boundaries
+    while (numSamples > 0)
+    {
+        const auto numThisTime = std::min (numSamples, samplesPerStep - numSamplesInStep);
+
+        for (int chan = 0; chan < numChansToUse; ++chan)
+        {
+            auto& c = channels[(size_t) chan];
+            auto data = buffer.getReadPointer (chan, startSample);
+            auto sumOfSquares = c.sumOfSquares;
+
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                double s = data[i];
+
+                for (int f = 0; f < 2; ++f)
+                {
+                    auto& b = filters[f];
+                    const auto y = b.b0 * s + c.z1[f];
+                    c.z1[f] = b.b1 * s - b.a1 * y + c.z2[f];
+                    c.z2[f] = b.b2 * s - b.a2 * y;
+                    s = y;
+                }
+
+                sumOfSquares += s * s;
+            }
+
+            c.sumOfSquares = sumOfSquares;
+        }
+
+        numSamplesInStep += numThisTime;
+        startSample += numThisTime;
+        numSamples -= numThisTime;
+
+        if (numSamplesInStep == samplesPerStep)
+            endStep();
+    }
+}
+
+void LoudnessMeter::endStep()
+{
+    double energy = 0.0;
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        auto& c = channels[(size_t) chan];
+        energy += c.weight * c.sumOfSquares / samplesPerStep;
+        c.sumOfSquares = 0.0;
+    }
+
+    stepEnergies[(size_t) (numSteps % numStepsPerShortTermBlock)] = energy;
+    ++numSteps;
+    numSamplesInStep = 0;
+
+    // Momentary blocks overlap by 75% so one ends with every step
+    if (numSteps >= numStepsPerMomentaryBlock)
+    {
+        const auto blockEnergy = getMeanStepEnergy (numStepsPerMomentaryBlock);
+        momentaryBlockEnergies.push_back ((float) blockEnergy);
+        maxMomentaryLoudness = std::max (maxMomentaryLoudness, energyToLoudness (blockEnergy));
+    }
+
+    if (numSteps >= numStepsPerShortTermBlock)
+        maxShortTermLoudness = std::max (maxShortTermLoudness, energyToLoudness (getMeanStepEnergy (numStepsPerShortTermBlock)));
+}
+
+double LoudnessMeter::getMeanStepEnergy (int numStepsToUse) const
+{
+    jassert (numSteps >= numStepsToUse);
+    double total = 0.0;
+
+    for (int i = 1; i <= numStepsToUse; ++i)
+        total += stepEnergies[(size_t) ((numSteps - i) % numStepsPerShortTermBlock)];
+
+    return total / numStepsToUse;
+}
+
+float LoudnessMeter::energyToLoudness (double energy) noexcept
+{
+    if (energy <= 0.0)
+        return silenceLoudness;
+
+    return std::max (silenceLoudness, (float) (-0.691 + 10.0 * std::log10 (energy)));
+}
+
+//==============================================================================
+float LoudnessMeter::getMomentaryLoudness() const
+{
+    if (numSteps < numStepsPerMomentaryBlock)
+        return silenceLoudness;
+
+    return energyToLoudness (getMeanStepEnergy (numStepsPerMomentaryBlock));
+}
+
+float LoudnessMeter::getShortTermLoudness() const
+{
+    if (numSteps < numStepsPerShortTermBlock)
+        return silenceLoudness;
+
+    return energyToLoudness (getMeanStepEnergy (numStepsPerShortTermBlock));
+}
+
+float LoudnessMeter::getIntegratedLoudness() const
+{
+    // Blocks below -70 LUFS are ignored, then so are blocks more than 10 LU
+    // below the loudness of what's left
+    auto getGatedMeanEnergy = [this] (float threshold)
+    {
+        const auto thresholdEnergy = std::pow (10.0, (threshold + 0.691) / 10.0);
+        double total = 0.0;
+        size_t numBlocks = 0;
+
+        for (auto energy : momentaryBlockEnergies)
+        {
+            if (energy > thresholdEnergy)
+            {
+                total += energy;
+                ++numBlocks;
+            }
+        }
+
+        return numBlocks > 0 ? total / (double) numBlocks : 0.0;
+    };
+
+    const auto absoluteGatedEnergy = getGatedMeanEnergy (-70.0f);
+
+    if (absoluteGatedEnergy <= 0.0)
+        return silenceLoudness;
+
+    const auto relativeThreshold = std::max (-70.0f, energyToLoudness (absoluteGatedEnergy) - 10.0f);
+    return energyToLoudness (getGatedMeanEnergy (relativeThreshold));
+}
+
+}} // namespace tracktion { inline namespace engine
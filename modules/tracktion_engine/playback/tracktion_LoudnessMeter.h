@@ -0,0 +1,106 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Measures the loudness of a stream of audio as described by EBU R128 and
+    ITU-R BS.1770, i.e. the momentary, short-term and integrated loudness in
+    LUFS, along with the true-peak level.
+
+    Blocks are added with addBlock as they're rendered so the loudness of a whole
+    render is known as soon as it finishes without reading it back. Only the
+    energy of each 100ms step is kept, so this uses very little memory.
+
+    This isn't thread-safe, so should only be used by one thread at a time.
+*/
+class LoudnessMeter
+{
+public:
+    /** Creates a LoudnessMeter. Call reset before adding any blocks. */
+    LoudnessMeter() = default;
+
+    /** The level returned if there hasn't been enough audio to measure. */
+    static constexpr float silenceLoudness = -100.0f;
+
+    /** The maximum number of channels that can be measured. */
+    static constexpr int maxNumChannels = TruePeakDetector::maxNumChannels;
+
+    //==============================================================================
+    /** Clears the measurements, ready to add blocks to.
+        If there are 6 channels they're assumed to be 5.1 in the order L, R, C,
+        LFE, Ls, Rs and weighted accordingly, otherwise all channels are weighted equally.
+    */
+    void reset (double sampleRate, int numChannels);
+
+    /** Adds the next block of samples. */
+    void addBlock (const juce::AudioBuffer<float>&, int startSample, int numSamples);
+
+    //==============================================================================
+    /** Returns the loudness of the last 400ms in LUFS. */
+    float getMomentaryLoudness() const;
+
+    /** Returns the loudness of the last 3s in LUFS. */
+    float getShortTermLoudness() const;
+
+    /** Returns the gated loudness of all the audio that's been added, in LUFS. */
+    float getIntegratedLoudness() const;
+
+    /** Returns the highest momentary loudness so far, in LUFS. */
+    float getMaxMomentaryLoudness() const noexcept          { return maxMomentaryLoudness; }
+
+    /** Returns the highest short-term loudness so far, in LUFS. */
+    float getMaxShortTermLoudness() const noexcept          { return maxShortTermLoudness; }
+
+    /** Returns the highest true-peak level of any channel so far, as a gain. */
+    float getTruePeak() const noexcept                      { return truePeak; }
+
+private:
+    //==============================================================================
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    struct Channel
+    {
+        double z1[2] = {}, z2[2] = {};
+        double sumOfSquares = 0.0;
+        double weight = 1.0;
+    };
+
+    static constexpr int numStepsPerMomentaryBlock = 4;
+    static constexpr int numStepsPerShortTermBlock = 30;
+
+    Biquad filters[2];
+    std::array<Channel, maxNumChannels> channels;
+    int numChannels = 0, samplesPerStep = 0, numSamplesInStep = 0;
+
+    // The energy of the most recent steps, as a circular buffer
+    std::array<double, numStepsPerShortTermBlock> stepEnergies {};
+    int64_t numSteps = 0;
+
+    // The energy of every 400ms block so the integrated loudness can be gated
+    std::vector<float> momentaryBlockEnergies;
+
+    float maxMomentaryLoudness = silenceLoudness, maxShortTermLoudness = silenceLoudness;
+    float truePeak = 0.0f;
+    TruePeakDetector truePeakDetector;
+
+    void endStep();
+    double getMeanStepEnergy (int numStepsToUse) const;
+    static float energyToLoudness (double) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessMeter)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,71 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+#include <tracktion_engine/../3rd_party/doctest/tracktion_doctest.hpp>
+
+namespace tracktion { inline namespace engine
+{
+
+#if ENGINE_UNIT_TESTS_LOUDNESS_METER
+    TEST_SUITE ("tracktion_engine")
+    {
+        static void addSine (LoudnessMeter& meter, double sampleRate, float gain, double seconds)
+        {
+            const int blockSize = 1000;
+            juce::AudioBuffer<float> buffer (2, blockSize);
+            const auto numSamples = (int) (sampleRate * seconds);
+
+            for (int pos = 0; pos < numSamples; pos += blockSize)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    auto s = gain * (float) std::sin (juce::MathConstants<double>::twoPi * 1000.0 * (pos + i) / sampleRate);
+                    buffer.setSample (0, i, s);
+                    buffer.setSample (1, i, s);
+                }
+
+                meter.addBlock (buffer, 0, std::min (blockSize, numSamples - pos));
+            }
+        }
+
+        TEST_CASE ("LoudnessMeter")
+        {
+            // EBU Tech 3341 specifies that a stereo 1kHz sine at -23dBFS should measure -23 LUFS
+            for (auto sampleRate : { 44100.0, 48000.0 })
+            {
+                LoudnessMeter meter;
+                meter.reset (sampleRate, 2);
+
+                CHECK_EQ (meter.getIntegratedLoudness(), LoudnessMeter::silenceLoudness);
+                CHECK_EQ (meter.getMomentaryLoudness(), LoudnessMeter::silenceLoudness);
+
+                addSine (meter, sampleRate, dbToGain (-23.0f), 20.0);
+
+                CHECK (meter.getIntegratedLoudness() == doctest::Approx (-23.0f).epsilon (0.005));
+                CHECK (meter.getMomentaryLoudness() == doctest::Approx (-23.0f).epsilon (0.005));
+                CHECK (meter.getShortTermLoudness() == doctest::Approx (-23.0f).epsilon (0.005));
+                CHECK (meter.getMaxShortTermLoudness() == doctest::Approx (-23.0f).epsilon (0.005));
+                CHECK (meter.getTruePeak() == doctest::Approx (dbToGain (-23.0f)).epsilon (0.02));
+
+                // Silence is gated out of the integrated loudness
+                addSine (meter, sampleRate, 0.0f, 20.0);
+
+                CHECK (meter.getIntegratedLoudness() == doctest::Approx (-23.0f).epsilon (0.005));
+                CHECK_EQ (meter.getMomentaryLoudness(), LoudnessMeter::silenceLoudness);
+                CHECK (meter.getMaxMomentaryLoudness() == doctest::Approx (-23.0f).epsilon (0.005));
+            }
+        }
+    }
+#endif
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
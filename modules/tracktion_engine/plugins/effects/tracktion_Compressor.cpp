@@ -70,10 +70,14 @@ void CompressorPlugin::getChannelNames (juce::StringArray* ins,
         ins->add (TRANS("Sidechain Trigger"));
 }
 
-void CompressorPlugin::initialise (const PluginInitialisationInfo&)
+void CompressorPlugin::initialise (const PluginInitialisationInfo& info)
 {
     currentLevel = 0.0;
     lastSamp = 0.0f;
+
+    for (auto values : { &thresholdValues, &ratioValues, &attackValues,
+                         &releaseValues, &outputValues, &sidechainValues })
+        values->prepare (info.blockSizeSamples);
 }
 
 void CompressorPlugin::deinitialise()
@@ -89,85 +93,101 @@ void CompressorPlugin::applyToBuffer (const PluginRenderContext& fc)
 
     SCOPED_REALTIME_CHECK
 
+    bool isAutomated = thresholdValues.fill (*thresholdGain.parameter, fc);
+    isAutomated = ratioValues.fill (*ratio.parameter, fc) || isAutomated;
+    isAutomated = attackValues.fill (*attackMs.parameter, fc) || isAutomated;
+    isAutomated = releaseValues.fill (*releaseMs.parameter, fc) || isAutomated;
+    isAutomated = outputValues.fill (*outputDb.parameter, fc) || isAutomated;
+    isAutomated = sidechainValues.fill (*sidechainDb.parameter, fc) || isAutomated;
+
+    // Whilst being automated, the settings are updated for each sub-block
+    const int subBlockSize = isAutomated ? AutomationValueBuffer::subBlockSize
+                                         : fc.bufferNumSamples;
+
     const double logThreshold = std::log10 (0.01);
-    const double attackFactor = std::pow (10.0, logThreshold / (attackMs.getCurrentValue() * sampleRate / 1000.0));
-    const double releaseFactor = std::pow (10.0, logThreshold / (releaseMs.getCurrentValue() * sampleRate / 1000.0));
-    const float outputGain = dbToGain (outputDb.getCurrentValue());
-    const float thresh = thresholdGain.getCurrentValue();
-    const float rat = ratio.getCurrentValue();
     const bool useSidechain = useSidechainTrigger.get();
-    const float sidechainGain = dbToGain (sidechainDb.getCurrentValue());
 
     float* b1 = fc.destBuffer->getWritePointer (0, fc.bufferStartSample);
+    float* b2 = fc.destBuffer->getNumChannels() >= 2 ? fc.destBuffer->getWritePointer (1, fc.bufferStartSample) : nullptr;
+    float* b3 = fc.destBuffer->getNumChannels() > 2 ? fc.destBuffer->getWritePointer (2, fc.bufferStartSample) : nullptr;
 
-    if (fc.destBuffer->getNumChannels() >= 2)
+    for (int pos = 0; pos < fc.bufferNumSamples; pos += subBlockSize)
     {
-        float* b2 = fc.destBuffer->getWritePointer (1, fc.bufferStartSample);
-        float* b3 = fc.destBuffer->getNumChannels() > 2 ? fc.destBuffer->getWritePointer (2, fc.bufferStartSample) : nullptr;
-
-        for (int i = fc.bufferNumSamples; --i >= 0;)
-        {
-            float samp1 = *b1 + 1.0f;
-            samp1 -= 1.0f;
-            float samp2 = *b2 + 1.0f;
-            samp2 -= 1.0f;
-
-            float sampAvg = 0.0f;
-
-            if (useSidechain && b3 != nullptr)
-            {
-                sampAvg = lastSamp * preFilterAmount
-                            + std::abs (*b3++ * sidechainGain) * ((1.0f - preFilterAmount));
-            }
-            else
-            {
-                sampAvg = lastSamp * preFilterAmount
-                            + std::abs (samp1 + samp2) * ((1.0f - preFilterAmount) * 0.5f);
-            }
-
-            JUCE_UNDENORMALISE (sampAvg);
-
-            lastSamp = sampAvg;
+        const int numThisTime = std::min (subBlockSize, fc.bufferNumSamples - pos);
 
-            if (sampAvg > thresh)
-                currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
-            else
-                currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
+        const double attackFactor = std::pow (10.0, logThreshold / (attackValues[pos] * sampleRate / 1000.0));
+        const double releaseFactor = std::pow (10.0, logThreshold / (releaseValues[pos] * sampleRate / 1000.0));
+        const float outputGain = dbToGain (outputValues[pos]);
+        const float thresh = thresholdValues[pos];
+        const float rat = ratioValues[pos];
+        const float sidechainGain = dbToGain (sidechainValues[pos]);
 
-            float r = outputGain;
-
-            if (currentLevel > thresh)
+        if (b2 != nullptr)
+        {
+            for (int i = numThisTime; --i >= 0;)
             {
-                r *= (float)((thresh + (currentLevel - thresh) * rat)
-                              / currentLevel);
+                float samp1 = *b1 + 1.0f;
+                samp1 -= 1.0f;
+                float samp2 = *b2 + 1.0f;
+                samp2 -= 1.0f;
+
+                float sampAvg = 0.0f;
+
+                if (useSidechain && b3 != nullptr)
+                {
+                    sampAvg = lastSamp * preFilterAmount
+                                + std::abs (*b3++ * sidechainGain) * ((1.0f - preFilterAmount));
+                }
+                else
+                {
+                    sampAvg = lastSamp * preFilterAmount
+                                + std::abs (samp1 + samp2) * ((1.0f - preFilterAmount) * 0.5f);
+                }
+
+                JUCE_UNDENORMALISE (sampAvg);
+
+                lastSamp = sampAvg;
+
+                if (sampAvg > thresh)
+                    currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
+                else
+                    currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
+
+                float r = outputGain;
+
+                if (currentLevel > thresh)
+                {
+                    r *= (float)((thresh + (currentLevel - thresh) * rat)
+                                  / currentLevel);
+                }
+
+                *b1++ = samp1 * r;
+                *b2++ = samp2 * r;
             }
-
-            *b1++ = samp1 * r;
-            *b2++ = samp2 * r;
         }
-    }
-    else
-    {
-        for (int i = fc.bufferNumSamples; --i >= 0;)
+        else
         {
-            const float samp = *b1;
-            const float sampAvg = lastSamp * preFilterAmount
-                                    + std::abs (samp) * (1.0f - preFilterAmount);
-            lastSamp = sampAvg;
+            for (int i = numThisTime; --i >= 0;)
+            {
+                const float samp = *b1;
+                const float sampAvg = lastSamp * preFilterAmount
+                                        + std::abs (samp) * (1.0f - preFilterAmount);
+                lastSamp = sampAvg;
 
-            JUCE_UNDENORMALISE (lastSamp);
+                JUCE_UNDENORMALISE (lastSamp);
 
-            if (sampAvg > thresh)
-                currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
-            else
-                currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
+                if (sampAvg > thresh)
+                    currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
+                else
+                    currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
 
-            float r = outputGain;
+                float r = outputGain;
 
-            if (currentLevel > thresh)
-                r *= (float)((thresh + (currentLevel - thresh) * rat) / currentLevel);
+                if (currentLevel > thresh)
+                    r *= (float)((thresh + (currentLevel - thresh) * rat) / currentLevel);
 
-            *b1++ = samp * r;
+                *b1++ = samp * r;
+            }
         }
     }
 
@@ -51,6 +51,8 @@ public:
 private:
     double currentLevel = 0.0;
     float lastSamp = 0.0f;
+    AutomationValueBuffer thresholdValues, ratioValues, attackValues,
+                          releaseValues, outputValues, sidechainValues;
 
     void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
 
@@ -189,6 +189,17 @@ static float convertEQLevelToGain (double db)
     return (float) pow (10.0, db / 20.0);
 }
 
+juce::IIRCoefficients EqualiserPlugin::createCoefficients (int band, float freq, float q, float gain) const
+{
+    if (band == 0)
+        return juce::IIRCoefficients::makeLowShelf (lastSampleRate, freq, q, convertEQLevelToGain (gain));
+
+    if (band == 3)
+        return juce::IIRCoefficients::makeHighShelf (lastSampleRate, freq, q, convertEQLevelToGain (gain));
+
+    return juce::IIRCoefficients::makePeakFilter (lastSampleRate, freq, q, convertEQLevelToGain (gain));
+}
+
 void EqualiserPlugin::updateIIRFilters()
 {
     const juce::ScopedLock sl (filterLock);
@@ -197,8 +208,7 @@ void EqualiserPlugin::updateIIRFilters()
     {
         needToUpdateFilters[0] = false;
 
-        auto c = juce::IIRCoefficients::makeLowShelf (lastSampleRate, loFreq->getCurrentValue(), loQ->getCurrentValue(),
-                                                      convertEQLevelToGain (loGain->getCurrentValue()));
+        auto c = createCoefficients (0, loFreq->getCurrentValue(), loQ->getCurrentValue(), loGain->getCurrentValue());
 
         for (int i = EQ_CHANS; --i >= 0;)
             low[i].setCoefficients (c);
@@ -208,8 +218,7 @@ void EqualiserPlugin::updateIIRFilters()
     {
         needToUpdateFilters[1] = false;
 
-        auto c = juce::IIRCoefficients::makePeakFilter (lastSampleRate, midFreq1->getCurrentValue(), midQ1->getCurrentValue(),
-                                                        convertEQLevelToGain (midGain1->getCurrentValue()));
+        auto c = createCoefficients (1, midFreq1->getCurrentValue(), midQ1->getCurrentValue(), midGain1->getCurrentValue());
 
         for (int i = EQ_CHANS; --i >= 0;)
             mid1[i].setCoefficients (c);
@@ -219,8 +228,7 @@ void EqualiserPlugin::updateIIRFilters()
     {
         needToUpdateFilters[2] = false;
 
-        auto c = juce::IIRCoefficients::makePeakFilter (lastSampleRate, midFreq2->getCurrentValue(), midQ2->getCurrentValue(),
-                                                        convertEQLevelToGain (midGain2->getCurrentValue()));
+        auto c = createCoefficients (2, midFreq2->getCurrentValue(), midQ2->getCurrentValue(), midGain2->getCurrentValue());
 
         for (int i = EQ_CHANS; --i >= 0;)
             mid2[i].setCoefficients (c);
@@ -230,16 +238,22 @@ void EqualiserPlugin::updateIIRFilters()
     {
         needToUpdateFilters[3] = false;
 
-        auto c = juce::IIRCoefficients::makeHighShelf (lastSampleRate, hiFreq->getCurrentValue(), hiQ->getCurrentValue(),
-                                                       convertEQLevelToGain (hiGain->getCurrentValue()));
+        auto c = createCoefficients (3, hiFreq->getCurrentValue(), hiQ->getCurrentValue(), hiGain->getCurrentValue());
 
         for (int i = EQ_CHANS; --i >= 0;)
             high[i].setCoefficients (c);
     }
 }
 
-void EqualiserPlugin::initialise (const PluginInitialisationInfo&)
+void EqualiserPlugin::initialise (const PluginInitialisationInfo& info)
 {
+    for (int i = 4; --i >= 0;)
+    {
+        freqValues[i].prepare (info.blockSizeSamples);
+        gainValues[i].prepare (info.blockSizeSamples);
+        qValues[i].prepare (info.blockSizeSamples);
+    }
+
     for (int i = EQ_CHANS; --i >= 0;)
     {
         low[i].reset();
@@ -279,16 +293,58 @@ void EqualiserPlugin::applyToBuffer (const PluginRenderContext& fc)
 
         addAntiDenormalisationNoise (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
 
-        for (int i = std::min ((int) EQ_CHANS, fc.destBuffer->getNumChannels()); --i >= 0;)
+        AutomatableParameter* freqParams[] = { loFreq.get(), midFreq1.get(), midFreq2.get(), hiFreq.get() };
+        AutomatableParameter* gainParams[] = { loGain.get(), midGain1.get(), midGain2.get(), hiGain.get() };
+        AutomatableParameter* qParams[]    = { loQ.get(), midQ1.get(), midQ2.get(), hiQ.get() };
+        juce::IIRFilter* filters[] = { low, mid1, mid2, high };
+
+        bool bandIsAutomated[4] = {};
+        bool anyBandIsAutomated = false;
+
+        for (int band = 0; band < 4; ++band)
         {
-            auto data = fc.destBuffer->getWritePointer (i, fc.bufferStartSample);
+            const bool freqIsAutomated = freqValues[band].fill (*freqParams[band], fc);
+            const bool gainIsAutomated = gainValues[band].fill (*gainParams[band], fc);
+            const bool qIsAutomated    = qValues[band].fill (*qParams[band], fc);
+
+            bandIsAutomated[band] = freqIsAutomated || gainIsAutomated || qIsAutomated;
+            anyBandIsAutomated = anyBandIsAutomated || bandIsAutomated[band];
+        }
+
+        // Automated bands have their coefficients updated for each sub-block
+        const int subBlockSize = anyBandIsAutomated ? AutomationValueBuffer::subBlockSize
+                                                    : fc.bufferNumSamples;
 
-            if (loGain->getCurrentValue() != 0)       low[i] .processSamples (data, fc.bufferNumSamples);
-            if (midGain1->getCurrentValue() != 0)     mid1[i].processSamples (data, fc.bufferNumSamples);
-            if (midGain2->getCurrentValue() != 0)     mid2[i].processSamples (data, fc.bufferNumSamples);
-            if (hiGain->getCurrentValue() != 0)       high[i].processSamples (data, fc.bufferNumSamples);
+        for (int pos = 0; pos < fc.bufferNumSamples; pos += subBlockSize)
+        {
+            const int numThisTime = std::min (subBlockSize, fc.bufferNumSamples - pos);
+
+            for (int band = 0; band < 4; ++band)
+            {
+                if (bandIsAutomated[band])
+                {
+                    auto c = createCoefficients (band, freqValues[band][pos], qValues[band][pos], gainValues[band][pos]);
+
+                    for (int i = EQ_CHANS; --i >= 0;)
+                        filters[band][i].setCoefficients (c);
+                }
+            }
+
+            for (int i = std::min ((int) EQ_CHANS, fc.destBuffer->getNumChannels()); --i >= 0;)
+            {
+                auto data = fc.destBuffer->getWritePointer (i, fc.bufferStartSample + pos);
+
+                for (int band = 0; band < 4; ++band)
+                    if (gainValues[band][pos] != 0)
+                        filters[band][i].processSamples (data, numThisTime);
+            }
         }
 
+        // Makes sure the coefficients match the parameters again when the automation stops
+        for (int band = 0; band < 4; ++band)
+            if (bandIsAutomated[band])
+                needToUpdateFilters[band] = true;
+
         if (phaseInvert)
             fc.destBuffer->applyGain (fc.bufferStartSample, fc.bufferNumSamples, -1.0f);
     }
@@ -86,7 +86,11 @@ private:
     enum { fftOrder = 10 };
     juce::dsp::FFT fft { fftOrder };
 
+    // The values of each band's frequency, gain and Q whilst they're being automated
+    AutomationValueBuffer freqValues[4], gainValues[4], qValues[4];
+
     void updateIIRFilters();
+    juce::IIRCoefficients createCoefficients (int band, float freq, float q, float gain) const;
     std::atomic<bool> needToUpdateFilters[4];
     juce::CriticalSection filterLock;
 
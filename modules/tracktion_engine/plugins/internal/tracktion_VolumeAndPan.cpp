@@ -149,9 +149,11 @@ juce::ValueTree VolumeAndPanPlugin::create()
 const char* VolumeAndPanPlugin::xmlTypeName = "volume";
 
 //==============================================================================
-void VolumeAndPanPlugin::initialise (const PluginInitialisationInfo&)
+void VolumeAndPanPlugin::initialise (const PluginInitialisationInfo& info)
 {
     refreshVCATrack();
+    volValues.prepare (info.blockSizeSamples);
+    panValues.prepare (info.blockSizeSamples);
 
     auto sliderPos = getSliderPos();
     getGainsFromVolumeFaderPositionAndPan (sliderPos, getPan(), getPanLaw(), lastGainL, lastGainR);
@@ -212,28 +214,50 @@ void VolumeAndPanPlugin::applyToBuffer (const PluginRenderContext& fc)
                                 : 0.0f;
             }
 
-            float lgain, rgain;
-            getGainsFromVolumeFaderPositionAndPan (getSliderPos() + vcaPosDelta, getPan(), getPanLaw(), lgain, rgain);
-            lgain *= (polarity ? -1 : 1);
-            rgain *= (polarity ? -1 : 1);
+            // Ramps from the last gains to the ones for the given position and pan
+            auto applyGains = [&] (int startSample, int numSamples, float sliderPos, float panPos)
+            {
+                float lgain, rgain;
+                getGainsFromVolumeFaderPositionAndPan (sliderPos + vcaPosDelta, panPos, getPanLaw(), lgain, rgain);
+                lgain *= (polarity ? -1 : 1);
+                rgain *= (polarity ? -1 : 1);
 
-            fc.destBuffer->applyGainRamp (0, fc.bufferStartSample, fc.bufferNumSamples, lastGainL, lgain);
+                fc.destBuffer->applyGainRamp (0, startSample, numSamples, lastGainL, lgain);
 
-            if (numChansIn > 1)
-                fc.destBuffer->applyGainRamp (1, fc.bufferStartSample, fc.bufferNumSamples, lastGainR, rgain);
+                if (numChansIn > 1)
+                    fc.destBuffer->applyGainRamp (1, startSample, numSamples, lastGainR, rgain);
 
-            lastGainL = lgain;
-            lastGainR = rgain;
+                lastGainL = lgain;
+                lastGainR = rgain;
 
-            // If the number of channels is greater than two, just apply volume
-            if (numChansIn > 2)
-            {
-                const float gain = volumeFaderPositionToGain (getSliderPos() + vcaPosDelta) * (polarity ? -1 : 1);
+                // If the number of channels is greater than two, just apply volume
+                if (numChansIn > 2)
+                {
+                    const float gain = volumeFaderPositionToGain (sliderPos + vcaPosDelta) * (polarity ? -1 : 1);
+
+                    for (int i = 2; i < numChansIn; ++i)
+                        fc.destBuffer->applyGainRamp (i, startSample, numSamples, lastGainS, gain);
+
+                    lastGainS = gain;
+                }
+            };
 
-                for (int i = 2; i < numChansIn; ++i)
-                    fc.destBuffer->applyGainRamp (i, fc.bufferStartSample, fc.bufferNumSamples, lastGainS, gain);
+            const bool volIsAutomated = volValues.fill (*volParam, fc);
+            const bool panIsAutomated = panValues.fill (*panParam, fc);
 
-                lastGainS = gain;
+            if (volIsAutomated || panIsAutomated)
+            {
+                // Follow the automation with a ramp to its value at the end of each sub-block
+                for (int pos = 0; pos < fc.bufferNumSamples; pos += AutomationValueBuffer::subBlockSize)
+                {
+                    const int numThisTime = std::min (AutomationValueBuffer::subBlockSize, fc.bufferNumSamples - pos);
+                    const int lastSample = pos + numThisTime - 1;
+                    applyGains (fc.bufferStartSample + pos, numThisTime, volValues[lastSample], panValues[lastSample]);
+                }
+            }
+            else
+            {
+                applyGains (fc.bufferStartSample, fc.bufferNumSamples, getSliderPos(), getPan());
             }
         }
 
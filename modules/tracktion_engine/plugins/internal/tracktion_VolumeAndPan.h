@@ -75,6 +75,7 @@ public:
 
 private:
     float lastGainL = 0.0f, lastGainR = 0.0f, lastGainS = 0.0f, lastVolumeBeforeMute = 0.0f;
+    AutomationValueBuffer volValues, panValues;
 
     RealTimeSpinLock vcaTrackLock;
     juce::ReferenceCountedObjectPtr<AudioTrack> vcaTrack;
@@ -651,6 +651,24 @@ void Plugin::setQuickControlParameter (AutomatableParameter* param)
         quickParamName = param->paramID;
 }
 
+//==============================================================================
+ParameterChangeQueue& Plugin::getParameterChangeQueue()
+{
+    // Most plugins never have changes posted to them so this is only created when needed
+    std::call_once (parameterChangeQueueCreated, [this]
+                    {
+                        parameterChangeQueue = std::make_unique<ParameterChangeQueue>();
+                        parameterChangeQueueIfCreated.store (parameterChangeQueue.get(), std::memory_order_release);
+                    });
+
+    return *parameterChangeQueue;
+}
+
+ParameterChangeQueue* Plugin::getParameterChangeQueueIfCreated() const noexcept
+{
+    return parameterChangeQueueIfCreated.load (std::memory_order_acquire);
+}
+
 void Plugin::applyToBufferWithAutomation (const PluginRenderContext& pc)
 {
     SCOPED_REALTIME_CHECK
@@ -309,6 +309,20 @@ public:
     AutomatableParameter::Ptr getQuickControlParameter() const;
     void setQuickControlParameter (AutomatableParameter*);
 
+    //==============================================================================
+    /** Returns the queue used to change this plugin's parameters from any thread.
+        Changes posted here are applied by the plugin's PluginNode at the sample
+        positions that match their timestamps.
+        The queue is created the first time this is called so don't call it from
+        the audio thread.
+    */
+    ParameterChangeQueue& getParameterChangeQueue();
+
+    /** Returns the parameter change queue if anything has used it yet, otherwise nullptr.
+        This is safe to call from the audio thread.
+    */
+    ParameterChangeQueue* getParameterChangeQueueIfCreated() const noexcept;
+
     //==============================================================================
     /** Attempts to delete this plugin, whether it's a master plugin, track plugin, etc.
         This will call removeFromParent but also hide any automation parameters etc. being
@@ -431,6 +445,9 @@ protected:
 
 private:
     mutable AutomatableParameter::Ptr quickControlParameter;
+    std::once_flag parameterChangeQueueCreated;
+    std::unique_ptr<ParameterChangeQueue> parameterChangeQueue;
+    std::atomic<ParameterChangeQueue*> parameterChangeQueueIfCreated { nullptr };
 
     std::atomic<int> initialiseCount { 0 };
     double timeToCpuScale = 0;
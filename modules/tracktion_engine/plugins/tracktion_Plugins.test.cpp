@@ -391,6 +391,333 @@ TEST_SUITE ("tracktion_engine")
             CHECK_EQ (setAndGet (15_tp), 0.0f);
         }
     }
+
+    TEST_CASE ("Sample-accurate automation")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine, 1);
+        auto volParam = getAudioTracks(*edit)[0]->getVolumePlugin()->volParam;
+        auto& volCurve = volParam->getCurve();
+
+        // A linear ramp up over the first second
+        volCurve.addPoint (0_tp, 0.0f, 0.0f);
+        volCurve.addPoint (1_tp, 1.0f, 0.0f);
+
+        std::vector<float> values (2000);
+
+        {
+            AutomationIterator iter (*volParam);
+            iter.setPosition (0.5_tp);
+            iter.getValues ({ 0_tp, 2_tp }, values.data(), (int) values.size());
+
+            for (int i = 0; i < 1000; i += 100)
+                CHECK (values[(size_t) i] == doctest::Approx (i / 1000.0f).epsilon (0.001));
+
+            CHECK (values[1500] == doctest::Approx (1.0f));
+            CHECK (values[1999] == doctest::Approx (1.0f));
+
+            // Filling the values doesn't move the iterator
+            CHECK (iter.getCurrentValue() == doctest::Approx (0.5f).epsilon (0.001));
+        }
+
+        {
+            // Iterators built from a snapshot give the same values
+            AutomationIterator iter (*volParam, volCurve.createSnapshot());
+            std::vector<float> snapshotValues (values.size());
+            iter.getValues ({ 0_tp, 2_tp }, snapshotValues.data(), (int) snapshotValues.size());
+
+            for (size_t i = 0; i < values.size(); i += 100)
+                CHECK (snapshotValues[i] == doctest::Approx (values[i]));
+        }
+
+        {
+            volParam->updateStream();
+            CHECK (volParam->getValues ({ 0.25_tp, 0.75_tp }, values.data(), 500));
+            CHECK (values[0] == doctest::Approx (0.25f).epsilon (0.001));
+            CHECK (values[250] == doctest::Approx (0.5f).epsilon (0.001));
+            CHECK (values[499] == doctest::Approx (0.749f).epsilon (0.001));
+
+            CHECK (std::is_sorted (values.begin(), values.begin() + 500));
+        }
+    }
+
+    TEST_CASE ("AutomationCurve snapshots")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine, 1);
+        auto volParam = getAudioTracks(*edit)[0]->getVolumePlugin()->volParam;
+        auto& volCurve = volParam->getCurve();
+
+        // Add the points out of order with a mixture of curve shapes
+        const float curves[] = { 0.0f, 0.25f, -0.4f, 0.8f, -0.9f };
+
+        for (int i = 20; --i >= 0;)
+            volCurve.addPoint (TimePosition::fromSeconds (i * 0.5), (i % 3) / 2.0f, curves[i % 5]);
+
+        REQUIRE_EQ (volCurve.getNumPoints(), 20);
+        CHECK_EQ (volCurve.indexBefore (2.25_tp), 4);
+        CHECK_EQ (volCurve.indexBefore (2.5_tp), 5);
+        CHECK_EQ (volCurve.nextIndexAfter (2.25_tp), 5);
+        CHECK_EQ (volCurve.nextIndexAfter (2.5_tp), 5);
+        CHECK_EQ (volCurve.countPointsInRegion ({ 1_tp, 3_tp }), 4);
+        CHECK_EQ (volCurve.getPointsInRegion ({ 1_tp, 3_tp }).size(), 4);
+
+        auto snapshot = volCurve.createSnapshot();
+        REQUIRE_EQ (snapshot->getNumPoints(), 20);
+        CHECK_EQ (snapshot->indexBefore (TimePosition::fromSeconds (-1.0)), -1);
+        CHECK_EQ (snapshot->indexBefore (2.25_tp), 4);
+        CHECK_EQ (snapshot->nextIndexAfter (2.5_tp), 5);
+        CHECK_EQ (snapshot->nextIndexAfter (20_tp), 20);
+
+        AutomationCurve::Snapshot::Cursor cursor (snapshot);
+
+        for (double t = -1.0; t < 11.0; t += 0.01)
+        {
+            const auto time = TimePosition::fromSeconds (t);
+            CHECK (snapshot->getValueAt (time) == doctest::Approx (volCurve.getValueAt (time)));
+            CHECK (cursor.getValueAt (time) == doctest::Approx (volCurve.getValueAt (time)));
+        }
+
+        // Jumping backwards and forwards should give the same results
+        CHECK (cursor.getValueAt (9.3_tp) == doctest::Approx (volCurve.getValueAt (9.3_tp)));
+        CHECK (cursor.getValueAt (0.3_tp) == doctest::Approx (volCurve.getValueAt (0.3_tp)));
+        CHECK (cursor.getValueAt (0.2_tp) == doctest::Approx (volCurve.getValueAt (0.2_tp)));
+
+        // Snapshots are published when the stream is updated
+        volParam->updateStream();
+        auto published = volParam->getCurveSnapshot();
+        REQUIRE (published != nullptr);
+        CHECK_EQ (published->getNumPoints(), 20);
+
+        volCurve.removePoint (0);
+        CHECK_EQ (snapshot->getNumPoints(), 20);
+        volParam->updateStream();
+        CHECK_EQ (volParam->getCurveSnapshot()->getNumPoints(), 19);
+
+        CHECK_EQ (AutomationCurve::Snapshot ({}).getValueAt (1_tp), 0.0f);
+
+        // Simplifying removes the points in-line with their neighbours
+        volCurve.clear();
+        volCurve.addPoint (0_tp, 0.0f, 0.0f);
+        volCurve.addPoint (1_tp, 0.25f, 0.0f);
+        volCurve.addPoint (2_tp, 0.5f, 0.0f);
+        volCurve.addPoint (3_tp, 0.0f, 0.0f);
+        volCurve.simplify ({ 0_tp, 4_tp }, 0.01, 0.002f);
+
+        REQUIRE_EQ (volCurve.getNumPoints(), 3);
+        CHECK_EQ (volCurve.getPointTime (0), 0_tp);
+        CHECK_EQ (volCurve.getPointTime (1), 2_tp);
+        CHECK_EQ (volCurve.getPointTime (2), 3_tp);
+
+        // Long runs of in-line points are all removed
+        volCurve.clear();
+
+        for (int i = 0; i <= 1000; ++i)
+            volCurve.addPoint (TimePosition::fromSeconds (i * 0.01), (float) i * 0.0005f, 0.0f);
+
+        volCurve.simplify ({ 0_tp, 20_tp }, 0.001, 0.0001f);
+
+        REQUIRE_EQ (volCurve.getNumPoints(), 2);
+        CHECK_EQ (volCurve.getPointTime (0), 0_tp);
+        CHECK (volCurve.getPointTime (1).inSeconds() == doctest::Approx (10.0));
+        CHECK (volCurve.getPointValue (1) == doctest::Approx (0.5f));
+    }
+
+    TEST_CASE ("ParameterChangeQueue")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine, 1);
+        auto volPlugin = getAudioTracks(*edit)[0]->getVolumePlugin();
+        auto volParam = volPlugin->volParam;
+        auto panParam = volPlugin->panParam;
+
+        SUBCASE ("Changes from several threads are all received in order")
+        {
+            constexpr int numThreads = 4, numEventsPerThread = 2000;
+            ParameterChangeQueue queue (numThreads * numEventsPerThread);
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < numThreads; ++t)
+                threads.emplace_back ([&queue, &volParam, t]
+                                      {
+                                          for (int i = 0; i < numEventsPerThread; ++i)
+                                              queue.post (*volParam, (float) i, (double) t);
+                                      });
+
+            for (auto& t : threads)
+                t.join();
+
+            std::vector<int> lastValues (numThreads, -1);
+            ParameterChangeQueue::Event event;
+            int numEvents = 0;
+
+            while (queue.pop (event))
+            {
+                auto& lastValue = lastValues[(size_t) event.time];
+                CHECK_EQ ((int) event.value, lastValue + 1);
+                CHECK (event.parameter == volParam);
+                lastValue = (int) event.value;
+                ++numEvents;
+            }
+
+            CHECK_EQ (numEvents, numThreads * numEventsPerThread);
+            CHECK_EQ (queue.getNumDroppedEvents(), 0u);
+        }
+
+        SUBCASE ("Full queues drop changes")
+        {
+            ParameterChangeQueue queue (100);
+            CHECK_EQ (queue.getCapacity(), 128u);
+
+            for (uint32_t i = 0; i < queue.getCapacity(); ++i)
+                CHECK (queue.post (*panParam, 0.5f));
+
+            CHECK (! queue.post (*panParam, 0.5f));
+            CHECK_EQ (queue.getNumDroppedEvents(), 1u);
+
+            ParameterChangeQueue::Event event;
+            CHECK (queue.pop (event));
+            CHECK (queue.post (*panParam, 0.5f));
+        }
+
+        SUBCASE ("Changes can be applied from the audio thread")
+        {
+            panParam->setParameterFromAudioThread (-0.5f);
+            CHECK_EQ (panParam->getCurrentExplicitValue(), -0.5f);
+            CHECK_EQ (panParam->getCurrentValue(), -0.5f);
+
+            panParam->updateFromAutomationSources (1_tp);
+            CHECK_EQ (panParam->getCurrentValue(), -0.5f);
+        }
+
+        SUBCASE ("Controller changes are queued whilst the plugin is being played")
+        {
+            REQUIRE (volPlugin->baseClassNeedsInitialising());
+
+            // Not being played so this is set straight away
+            panParam->midiControllerMoved (0.25f);
+            CHECK (panParam->getCurrentNormalisedValue() == doctest::Approx (0.25f));
+
+            volPlugin->baseClassInitialise ({ TimePosition(), 44100.0, 512 });
+            panParam->midiControllerMoved (0.75f);
+            CHECK (panParam->getCurrentNormalisedValue() == doctest::Approx (0.25f));
+
+            ParameterChangeQueue::Event event;
+            REQUIRE (volPlugin->getParameterChangeQueue().pop (event));
+            CHECK (event.parameter == panParam);
+            CHECK (event.value == doctest::Approx (panParam->valueRange.convertFrom0to1 (0.75f)));
+            CHECK (! volPlugin->getParameterChangeQueue().pop (event));
+
+            volPlugin->baseClassDeinitialise();
+        }
+
+       #if JUCE_MODAL_LOOPS_PERMITTED
+        SUBCASE ("Changes from the audio thread are committed on the message thread")
+        {
+            struct ChangeListener  : public AutomatableParameter::Listener
+            {
+                void curveHasChanged (AutomatableParameter&) override {}
+                void parameterChanged (AutomatableParameter&, float) override  { changed = true; }
+
+                std::atomic<bool> changed { false };
+            };
+
+            ChangeListener listener;
+            panParam->addListener (&listener);
+            edit->getUndoManager().clearUndoHistory();
+
+            panParam->setParameterFromAudioThread (-0.5f);
+            CHECK_EQ (panParam->getCurrentValue(), -0.5f);
+
+            engine::test_utilities::runDispatchLoopUntilTrue (listener.changed);
+            CHECK (listener.changed);
+            CHECK_EQ (volPlugin->pan.get(), -0.5f);
+
+            // The ValueTree is set with the UndoManager so the change can be undone
+            CHECK (edit->getUndoManager().canUndo());
+            edit->getUndoManager().undo();
+            CHECK_EQ (volPlugin->pan.get(), 0.0f);
+            CHECK_EQ (panParam->getCurrentValue(), 0.0f);
+
+            panParam->removeListener (&listener);
+        }
+       #endif
+
+        SUBCASE ("PluginNode applies changes at their position in the block")
+        {
+            // Outputs a constant level so the volume plugin's gain can be read from the output
+            class ConstantNode final : public graph::Node
+            {
+            public:
+                graph::NodeProperties getNodeProperties() override
+                {
+                    graph::NodeProperties props;
+                    props.hasAudio = true;
+                    props.numberOfChannels = 2;
+                    return props;
+                }
+
+                bool isReadyToProcess() override                { return true; }
+                void process (ProcessContext& pc) override      { setAllFrames (pc.buffers.audio, [] { return 1.0f; }); }
+            };
+
+            graph::test_utilities::TestSetup ts;
+            constexpr int numBlocks = 6, blockWithChange = 3;
+
+            tracktion::graph::PlayHead playHead;
+            tracktion::graph::PlayHeadState playHeadState { playHead };
+            ProcessState processState { playHeadState, edit->tempoSequence };
+
+            auto pluginNode = makeNode<PluginNode> (makeNode<ConstantNode>(), volPlugin, ts.sampleRate, ts.blockSize,
+                                                    nullptr, processState, true, false, -1);
+            graph::test_utilities::TestProcess<TracktionNodePlayer> testProcess (std::make_unique<TracktionNodePlayer> (std::move (pluginNode), processState, ts.sampleRate, ts.blockSize,
+                                                                                                                        getPoolCreatorFunction (ThreadPoolStrategy::realTime)),
+                                                                                 ts, 2, numBlocks * ts.blockSize / ts.sampleRate, true);
+            testProcess.getNodePlayer().setNumThreads (0);
+            testProcess.setPlayHead (&playHead);
+            playHead.playSyncedToRange ({});
+
+            // Step the queue's clock a block at a time and post a change half way through a block's window
+            const auto blockLength = ts.blockSize / ts.sampleRate;
+            const auto newValue = decibelsToVolumeFaderPosition (-12.0f);
+            double now = 100.0;
+
+            auto& queue = volPlugin->getParameterChangeQueue();
+            queue.setClock ([&now] { return now; });
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                if (block == blockWithChange)
+                    CHECK (queue.post (*volParam, newValue, now - blockLength * 0.5));
+
+                testProcess.process (ts.blockSize);
+                now += blockLength;
+            }
+
+            auto result = testProcess.getTestResult();
+            REQUIRE_EQ (result->buffer.getNumSamples(), numBlocks * ts.blockSize);
+
+            const auto samples = result->buffer.getReadPointer (0);
+            const int changeSample = blockWithChange * ts.blockSize + ts.blockSize / 2;
+            const auto levelBefore = samples[changeSample - 2];
+            const auto levelAfter = samples[result->buffer.getNumSamples() - 1];
+
+            // -12dB is roughly a quarter of the level
+            CHECK (levelBefore > 0.0f);
+            CHECK (levelAfter == doctest::Approx (levelBefore * 0.25f).epsilon (0.05));
+
+            // Nothing should change until the change's position in the block, allowing a sample for rounding
+            bool levelIsConstantBeforeChange = true;
+
+            for (int i = ts.blockSize; i < changeSample - 1; ++i)
+                if (samples[i] != doctest::Approx (levelBefore))
+                    levelIsConstantBeforeChange = false;
+
+            CHECK (levelIsConstantBeforeChange);
+            CHECK (samples[changeSample + 2] < levelBefore);
+            CHECK (volParam->getCurrentValue() == doctest::Approx (newValue));
+        }
+    }
 }
 #endif
 
@@ -13,83 +13,131 @@ namespace tracktion::inline engine
 
 //==============================================================================
 //==============================================================================
-ReadAheadTimeStretcher::ProcessThread::ProcessThread()
+ReadAheadTimeStretcher::ProcessPool::ProcessPool()
 {
-    thread = std::thread ([this] { process(); });
+    // Leave plenty of cores free for the real-time threads
+    const int numWorkers = std::clamp ((int) std::thread::hardware_concurrency() / 2, 1, 4);
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.emplace_back ([this] { process(); });
 }
 
-ReadAheadTimeStretcher::ProcessThread::~ProcessThread()
+ReadAheadTimeStretcher::ProcessPool::~ProcessPool()
 {
     waitingToExitFlag.test_and_set();
     event.signal();
-    thread.join();
+
+    for (auto& worker : workers)
+        worker.join();
 }
 
-void ReadAheadTimeStretcher::ProcessThread::addInstance (ReadAheadTimeStretcher* instance)
+void ReadAheadTimeStretcher::ProcessPool::addInstance (ReadAheadTimeStretcher* instance)
 {
-    breakForAddRemoveInstance.test_and_set();
-
-    const std::unique_lock sl (instancesMutex);
+    const std::scoped_lock sl (instancesMutex);
     instances.emplace_back (instance);
+}
 
-    breakForAddRemoveInstance.clear();
+void ReadAheadTimeStretcher::ProcessPool::removeInstance (ReadAheadTimeStretcher* instance)
+{
+    {
+        const std::scoped_lock sl (instancesMutex);
+        std::erase_if (instances, [&] (auto& i) { return i == instance; });
+    }
+
+    // Once removed it can't be claimed again but a worker might still be processing it
+    while (instance->isBeingProcessed.load (std::memory_order_acquire))
+        std::this_thread::yield();
 }
 
-void ReadAheadTimeStretcher::ProcessThread::removeInstance (ReadAheadTimeStretcher* instance)
+void ReadAheadTimeStretcher::ProcessPool::flagForProcessing (ReadAheadTimeStretcher& instance)
 {
-    breakForAddRemoveInstance.test_and_set();
+    instance.needsProcessing.store (true, std::memory_order_release);
+    event.signal();
+}
 
-    const std::unique_lock sl (instancesMutex);
-    std::erase_if (instances, [&] (auto& i) { return i == instance; });
+void ReadAheadTimeStretcher::ProcessPool::setPaused (bool shouldPause)
+{
+    if (shouldPause)
+    {
+        numPauses.fetch_add (1, std::memory_order_acq_rel);
+        return;
+    }
 
-    breakForAddRemoveInstance.clear();
+    // Instances may have been flagged whilst paused so wake a worker to look at them
+    if (numPauses.fetch_sub (1, std::memory_order_acq_rel) == 1)
+        event.signal();
 }
 
-void ReadAheadTimeStretcher::ProcessThread::flagForProcessing (std::atomic<std::uint64_t>& epoch)
+std::vector<ReadAheadTimeStretcher::Statistics> ReadAheadTimeStretcher::ProcessPool::getStatistics()
 {
-    epoch = processEpoch.load (std::memory_order_acquire);
-    event.signal();
+    const std::scoped_lock sl (instancesMutex);
+    std::vector<Statistics> stats;
+    stats.reserve (instances.size());
+
+    for (auto instance : instances)
+        stats.push_back (instance->getStatistics());
+
+    return stats;
 }
 
 //==============================================================================
-void ReadAheadTimeStretcher::ProcessThread::process()
+void ReadAheadTimeStretcher::ProcessPool::process()
 {
     for (;;)
     {
         if (waitingToExitFlag.test (std::memory_order_acquire))
+        {
+            // The event only wakes a single worker so pass it on to the next one
+            event.signal();
             return;
+        }
 
-        bool anyInstancesProcessed = false;
-
+        if (auto instance = claimMostUrgentInstance())
         {
-            const std::unique_lock sl (instancesMutex);
-            const auto currentEpoch = processEpoch.load (std::memory_order_acquire);
-
-            for (auto instance : instances)
-            {
-                if (waitingToExitFlag.test (std::memory_order_acquire))
-                    return;
-
-                if (breakForAddRemoveInstance.test (std::memory_order_acquire))
-                {
-                    anyInstancesProcessed = false; // Run again asap
-                    break;
-                }
-
-                // Skip unflagged instances
-                if (instance->getEpoch() > currentEpoch)
-                    continue;
-
-                if (instance->processNextBlock (false))
-                     anyInstancesProcessed = true;
-            }
+            // Other instances may also be waiting so wake another worker to look at them
+            event.signal();
+
+            instance->processNextBlockInBackground();
+            instance->isBeingProcessed.store (false, std::memory_order_release);
+            continue;
         }
 
-        processEpoch.fetch_add (1, std::memory_order_release);
+        event.wait (-1);
+    }
+}
+
+ReadAheadTimeStretcher* ReadAheadTimeStretcher::ProcessPool::claimMostUrgentInstance()
+{
+    const std::scoped_lock sl (instancesMutex);
+
+    if (numPauses.load (std::memory_order_acquire) > 0)
+        return nullptr;
+
+    ReadAheadTimeStretcher* mostUrgent = nullptr;
+    auto earliestUnderrun = std::numeric_limits<double>::max();
 
-        if (! anyInstancesProcessed)
-            event.wait (-1);
+    for (auto instance : instances)
+    {
+        if (! instance->needsProcessing.load (std::memory_order_acquire)
+            || instance->isBeingProcessed.load (std::memory_order_acquire))
+            continue;
+
+        if (const auto secondsUntilUnderrun = instance->getSecondsUntilUnderrun();
+            secondsUntilUnderrun < earliestUnderrun)
+        {
+            earliestUnderrun = secondsUntilUnderrun;
+            mostUrgent = instance;
+        }
     }
+
+    if (mostUrgent != nullptr)
+    {
+        mostUrgent->needsProcessing.store (false, std::memory_order_release);
+        mostUrgent->isBeingProcessed.store (true, std::memory_order_release);
+        mostUrgent->claimNumber = numClaims++;
+    }
+
+    return mostUrgent;
 }
 
 
@@ -102,7 +150,7 @@ ReadAheadTimeStretcher::ReadAheadTimeStretcher (int numBlocksToReadAhead_)
 
 ReadAheadTimeStretcher::~ReadAheadTimeStretcher()
 {
-    processThread->removeInstance (this);
+    processPool->removeInstance (this);
 }
 
 void ReadAheadTimeStretcher::initialise (double sourceSampleRate, int samplesPerBlock,
@@ -113,6 +161,7 @@ void ReadAheadTimeStretcher::initialise (double sourceSampleRate, int samplesPer
 
     numSamplesPerOutputBlock = samplesPerBlock;
     numChannels = numChannelsToUse;
+    sampleRate = sourceSampleRate;
 
     stretcher.initialise (sourceSampleRate, samplesPerBlock,
                           numChannelsToUse, mode, proOpts,
@@ -121,9 +170,9 @@ void ReadAheadTimeStretcher::initialise (double sourceSampleRate, int samplesPer
     if (! isInitialised())
         return;
 
-    processThread->addInstance (this);
     inputFifo.setSize (numChannels, getMaxFramesNeeded());
     outputFifo.setSize (numChannels, samplesPerBlock * numBlocksToReadAhead);
+    processPool->addInstance (this);
 }
 
 bool ReadAheadTimeStretcher::isInitialised() const
@@ -194,7 +243,7 @@ int ReadAheadTimeStretcher::pushData (const float* const* inChannels, int numSam
 {
     assert (inputFifo.getFreeSpace() >= numSamples);
     inputFifo.write (inChannels, numSamples);
-    processThread->flagForProcessing (epoch);
+    processPool->flagForProcessing (*this);
     hasBeenReset.store (false, std::memory_order_release);
 
     return numSamples;
@@ -211,6 +260,9 @@ int ReadAheadTimeStretcher::popData (float* const* outChannels, int numSamples)
 
     if (outputFifo.getNumReady() <= numSamples)
     {
+        if (outputFifo.getNumReady() < numSamples)
+            numUnderruns.fetch_add (1, std::memory_order_relaxed);
+
         [[ maybe_unused ]] const int numPopped = processNextBlock (true);
         assert (numPopped > 0 && "Not enough input frames pushed");
     }
@@ -218,6 +270,10 @@ int ReadAheadTimeStretcher::popData (float* const* outChannels, int numSamples)
     const int numToRead = std::min (numSamples, outputFifo.getNumReady());
     juce::AudioBuffer<float> destBuffer (outChannels, numChannels, numToRead);
     outputFifo.read (destBuffer, 0);
+
+    // Reading frees up space in the output so the workers might be able to process another block
+    processPool->flagForProcessing (*this);
+
     return numToRead;
 }
 
@@ -245,6 +301,47 @@ int ReadAheadTimeStretcher::flush (float* const* outChannels)
     return 0;
 }
 
+ReadAheadTimeStretcher::Statistics ReadAheadTimeStretcher::getStatistics() const
+{
+    Statistics stats;
+    stats.numBlocksProcessed = numBlocksProcessed.load (std::memory_order_relaxed);
+    stats.numUnderruns = numUnderruns.load (std::memory_order_relaxed);
+
+    const int numReady = outputFifo.getNumReady();
+
+    if (const int capacity = numReady + outputFifo.getFreeSpace(); capacity > 0)
+        stats.fillLevel = numReady / (float) capacity;
+
+    stats.lastServiceNumber = lastServiceNumber.load (std::memory_order_relaxed);
+
+    if (stats.numBlocksProcessed > 0)
+        stats.averageProcessingTimeMs = totalProcessingTimeNs.load (std::memory_order_relaxed) / (stats.numBlocksProcessed * 1.0e6);
+
+    stats.maxProcessingTimeMs = maxProcessingTimeNs.load (std::memory_order_relaxed) / 1.0e6;
+
+    return stats;
+}
+
+std::vector<ReadAheadTimeStretcher::Statistics> ReadAheadTimeStretcher::getAllStatistics()
+{
+    return juce::SharedResourcePointer<ProcessPool>()->getStatistics();
+}
+
+int ReadAheadTimeStretcher::getNumWorkerThreads()
+{
+    return juce::SharedResourcePointer<ProcessPool>()->getNumWorkers();
+}
+
+ReadAheadTimeStretcher::ScopedPauseWorkers::ScopedPauseWorkers()
+{
+    processPool->setPaused (true);
+}
+
+ReadAheadTimeStretcher::ScopedPauseWorkers::~ScopedPauseWorkers()
+{
+    processPool->setPaused (false);
+}
+
 void ReadAheadTimeStretcher::tryToSetNewSpeedAndPitch() const
 {
     if (! newSpeedAndPitchPending.exchange (false, std::memory_order_acq_rel))
@@ -281,4 +378,33 @@ int ReadAheadTimeStretcher::processNextBlock (bool block)
     return stretcher.processData (inputFifo, stretcher.getFramesNeeded(), outputFifo);
 }
 
-}
\ No newline at end of file
+int ReadAheadTimeStretcher::processNextBlockInBackground()
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    const int numProcessed = processNextBlock (false);
+
+    if (numProcessed <= 0)
+        return numProcessed;
+
+    const auto durationNs = std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now() - startTime).count();
+    numBlocksProcessed.fetch_add (1, std::memory_order_relaxed);
+    totalProcessingTimeNs.fetch_add (durationNs, std::memory_order_relaxed);
+
+    // Only the worker that has claimed this instance updates this so a load/store is safe
+    if (durationNs > maxProcessingTimeNs.load (std::memory_order_relaxed))
+        maxProcessingTimeNs.store (durationNs, std::memory_order_relaxed);
+
+    lastServiceNumber.store (claimNumber, std::memory_order_relaxed);
+
+    // There may be enough input left for another block
+    needsProcessing.store (true, std::memory_order_release);
+
+    return numProcessed;
+}
+
+double ReadAheadTimeStretcher::getSecondsUntilUnderrun() const
+{
+    return outputFifo.getNumReady() / sampleRate;
+}
+
+}
@@ -17,9 +17,15 @@ namespace tracktion::inline engine
     Wraps a TimeStretcher but keeps a larger internal input and output buffer
     and uses a background thread to try and process frames, reducing CPU cost on
     real-time threads.
+
+    All instances share a pool of worker threads. Instances that have had data
+    pushed to them are processed in order of how soon their output will run out,
+    so the ones closest to underrunning are always serviced first.
  */
 class ReadAheadTimeStretcher
 {
+    class ProcessPool;
+
 public:
     /** Creates a ReadAheadTimeStretcher that will attempt to process the desired number
         of blocks on a background thread.
@@ -104,50 +110,97 @@ public:
     */
     int flush (float* const* outChannels);
 
+    //==============================================================================
+    /** Some statistics about how well an instance is being kept up to date. */
+    struct Statistics
+    {
+        int numBlocksProcessed = 0;         /**< The number of blocks processed by the worker threads. */
+        int numUnderruns = 0;               /**< The number of times popData had to process on the calling thread. */
+        float fillLevel = 0.0f;             /**< How full the output buffer is, from 0 to 1. */
+        double averageProcessingTimeMs = 0.0;   /**< The average time taken to process a block on the worker threads. */
+        double maxProcessingTimeMs = 0.0;       /**< The longest time taken to process a block on the worker threads. */
+        int64_t lastServiceNumber = -1;         /**< When the worker threads last processed a block for this instance, as a count
+                                                     shared by all the instances so the order they were serviced in can be compared.
+                                                     This is -1 if they haven't processed any. */
+    };
+
+    /** Returns the statistics for this instance. This can be called from any thread. */
+    Statistics getStatistics() const;
+
+    /** Returns the statistics for all the initialised instances. */
+    static std::vector<Statistics> getAllStatistics();
+
+    /** Returns the number of worker threads shared between the instances. */
+    static int getNumWorkerThreads();
+
+    /** @internal Stops the worker threads starting to process any instances whilst it's in scope.
+        N.B. For testing only.
+    */
+    struct ScopedPauseWorkers
+    {
+        ScopedPauseWorkers();
+        ~ScopedPauseWorkers();
+
+    private:
+        juce::SharedResourcePointer<ProcessPool> processPool;
+    };
+
 private:
     //==============================================================================
-    class ProcessThread
+    class ProcessPool
     {
     public:
-        ProcessThread();
-        ~ProcessThread();
+        ProcessPool();
+        ~ProcessPool();
 
         void addInstance (ReadAheadTimeStretcher*);
         void removeInstance (ReadAheadTimeStretcher*);
 
-        void flagForProcessing (std::atomic<std::uint64_t>&);
+        void flagForProcessing (ReadAheadTimeStretcher&);
+        void setPaused (bool);
+
+        int getNumWorkers() const                   { return (int) workers.size(); }
+        std::vector<Statistics> getStatistics();
 
     private:
         //==============================================================================
         std::vector<ReadAheadTimeStretcher*> instances;
         std::mutex instancesMutex;
+        int64_t numClaims = 0;
+        std::atomic<int> numPauses { 0 };
 
-        std::thread thread;
+        std::vector<std::thread> workers;
         juce::WaitableEvent event;
         std::atomic_flag waitingToExitFlag = ATOMIC_FLAG_INIT;
-        std::atomic_flag breakForAddRemoveInstance = ATOMIC_FLAG_INIT;
-        std::atomic<std::uint64_t> processEpoch { 0 };
 
         //==============================================================================
         void process();
+        ReadAheadTimeStretcher* claimMostUrgentInstance();
     };
 
     AudioFifo inputFifo { 1, 32 }, outputFifo { 1, 32 };
     mutable TimeStretcher stretcher;
     const int numBlocksToReadAhead;
     int numChannels = 0, numSamplesPerOutputBlock = 0;
+    double sampleRate = 44100.0;
     mutable std::mutex processMutex;
-    std::atomic<std::uint64_t> epoch { std::numeric_limits<std::uint64_t>::max() };
+
+    // Set when there's new input to process, and while a worker thread is processing this instance
+    std::atomic<bool> needsProcessing { false }, isBeingProcessed { false };
 
     mutable std::atomic<float> pendingSpeedRatio { 1.0f }, pendingSemitonesUp { 0.0f };
     mutable std::atomic<bool> newSpeedAndPitchPending { false }, hasBeenReset { true };
 
-    juce::SharedResourcePointer<ProcessThread> processThread;
+    std::atomic<int> numBlocksProcessed { 0 }, numUnderruns { 0 };
+    std::atomic<std::int64_t> totalProcessingTimeNs { 0 }, maxProcessingTimeNs { 0 }, lastServiceNumber { -1 };
+    std::int64_t claimNumber = -1;
+
+    juce::SharedResourcePointer<ProcessPool> processPool;
 
     void tryToSetNewSpeedAndPitch() const;
     int processNextBlock (bool shouldBlock);
-    bool canProcessNextBlock();
-    std::uint64_t getEpoch() const { return epoch.load (std::memory_order_acquire); }
+    int processNextBlockInBackground();
+    double getSecondsUntilUnderrun() const;
 };
 
 }
@@ -31,6 +31,8 @@ public:
             const auto mode = tracktion::engine::TimeStretcher::soundtouchBetter;
             runPitchShiftTest (mode);
             runTimestretchTest (mode);
+            runReadAheadTest (mode);
+            runReadAheadSchedulingTest (mode);
         }
        #endif
 
@@ -97,6 +99,207 @@ private:
         testStretcher (mode, 2.0f, 0.0f);
     }
 
+    void runReadAheadTest (tracktion::engine::TimeStretcher::Mode mode)
+    {
+        beginTest ("Read-ahead: " + tracktion::engine::TimeStretcher::getNameOfMode (mode));
+
+        const double sampleRate = 44100.0;
+        const int numChannels = 2;
+        const int blockSize = 512;
+        const int numBlocks = 40;
+
+        const auto sourceBuffer = createSinBuffer (sampleRate, numChannels, 440.0f);
+
+        // Several instances share the worker threads
+        std::vector<std::unique_ptr<tracktion::engine::ReadAheadTimeStretcher>> stretchers;
+
+        for (int i = 0; i < 8; ++i)
+        {
+            auto& stretcher = stretchers.emplace_back (std::make_unique<tracktion::engine::ReadAheadTimeStretcher> (3));
+            stretcher->initialise (sampleRate, blockSize, numChannels, mode, {}, true);
+            stretcher->setSpeedAndPitch (1.0f + i * 0.1f, 0.0f);
+            stretcher->reset();
+        }
+
+        expectGreaterThan (tracktion::engine::ReadAheadTimeStretcher::getNumWorkerThreads(), 0);
+        expectGreaterOrEqual ((int) tracktion::engine::ReadAheadTimeStretcher::getAllStatistics().size(), (int) stretchers.size());
+
+        juce::AudioBuffer<float> outputBuffer (numChannels, blockSize);
+        std::vector<int> readPositions (stretchers.size(), 0), numOutputFrames (stretchers.size(), 0);
+
+        auto pushFrames = [&] (size_t index)
+        {
+            auto& stretcher = *stretchers[index];
+            auto& readPosition = readPositions[index];
+            const int numToPush = stretcher.getFramesRecomended();
+
+            if (readPosition + numToPush > sourceBuffer.getNumSamples())
+                readPosition = 0;
+
+            const float* inputs[2] = { sourceBuffer.getReadPointer (0, readPosition),
+                                       sourceBuffer.getReadPointer (1, readPosition) };
+            stretcher.pushData (inputs, numToPush);
+            readPosition += numToPush;
+        };
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (size_t i = 0; i < stretchers.size(); ++i)
+            {
+                pushFrames (i);
+
+                for (int numFramesLeft = blockSize; numFramesLeft > 0;)
+                {
+                    float* outputs[2] = { outputBuffer.getWritePointer (0, blockSize - numFramesLeft),
+                                          outputBuffer.getWritePointer (1, blockSize - numFramesLeft) };
+                    const int numRead = stretchers[i]->popData (outputs, numFramesLeft);
+
+                    if (numRead == 0)
+                        break;
+
+                    numFramesLeft -= numRead;
+                    numOutputFrames[i] += numRead;
+
+                    if (numFramesLeft > 0 && stretchers[i]->requiresMoreFrames())
+                        pushFrames (i);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < stretchers.size(); ++i)
+        {
+            expectEquals (numOutputFrames[i], numBlocks * blockSize);
+
+            const auto stats = stretchers[i]->getStatistics();
+            expect (stats.fillLevel >= 0.0f && stats.fillLevel <= 1.0f);
+        }
+
+        // Removing instances while the workers might be processing them must be safe
+        stretchers.clear();
+    }
+
+    void runReadAheadSchedulingTest (tracktion::engine::TimeStretcher::Mode mode)
+    {
+        using tracktion::engine::ReadAheadTimeStretcher;
+
+        const double sampleRate = 44100.0;
+        const int numChannels = 2;
+        const int blockSize = 512;
+        const size_t numStretchers = 4;
+
+        const auto sourceBuffer = createSinBuffer (sampleRate, numChannels, 440.0f);
+        const float* inputs[2] = { sourceBuffer.getReadPointer (0), sourceBuffer.getReadPointer (1) };
+
+        juce::AudioBuffer<float> outputBuffer (numChannels, blockSize);
+        float* outputs[2] = { outputBuffer.getWritePointer (0), outputBuffer.getWritePointer (1) };
+
+        std::vector<std::unique_ptr<ReadAheadTimeStretcher>> stretchers;
+        std::vector<int> numReady;
+
+        {
+            const ReadAheadTimeStretcher::ScopedPauseWorkers pauseWorkers;
+
+            for (size_t i = 0; i < numStretchers; ++i)
+            {
+                auto& stretcher = *stretchers.emplace_back (std::make_unique<ReadAheadTimeStretcher> (3));
+                stretcher.initialise (sampleRate, blockSize, numChannels, mode, {}, true);
+                stretcher.reset();
+
+                // With the workers paused, the first pop has to process on this thread so is an underrun.
+                // The later ones read what's left of that block so each instance has less output ready.
+                stretcher.pushData (inputs, stretcher.getFramesNeeded());
+
+                for (size_t j = 0; j <= i; ++j)
+                    stretcher.popData (outputs, 1);
+
+                // Then queue up exactly one block for the workers
+                stretcher.pushData (inputs, stretcher.getFramesNeeded());
+                numReady.push_back (stretcher.getNumReady());
+            }
+
+            beginTest ("Read-ahead statistics: " + tracktion::engine::TimeStretcher::getNameOfMode (mode));
+
+            for (auto& stretcher : stretchers)
+            {
+                const auto stats = stretcher->getStatistics();
+                expectEquals (stats.numUnderruns, 1);
+                expectEquals (stats.numBlocksProcessed, 0);
+                expectEquals (stats.averageProcessingTimeMs, 0.0);
+                expectEquals (stats.maxProcessingTimeMs, 0.0);
+                expectEquals<int64_t> (stats.lastServiceNumber, -1);
+            }
+        }
+
+        // Wait for the workers to process the queued blocks
+        const auto allProcessed = [&]
+        {
+            for (auto& stretcher : stretchers)
+                if (stretcher->getStatistics().numBlocksProcessed == 0)
+                    return false;
+
+            return true;
+        };
+
+        for (int i = 0; i < 5000 && ! allProcessed(); ++i)
+            juce::Thread::sleep (1);
+
+        expect (allProcessed());
+
+        std::vector<ReadAheadTimeStretcher::Statistics> stats;
+
+        for (auto& stretcher : stretchers)
+        {
+            auto& s = stats.emplace_back (stretcher->getStatistics());
+
+            // Only one block could be processed, so the average and max are the same
+            expectEquals (s.numBlocksProcessed, 1);
+            expectEquals (s.numUnderruns, 1);
+            expectGreaterThan (s.maxProcessingTimeMs, 0.0);
+            expectWithinAbsoluteError (s.averageProcessingTimeMs, s.maxProcessingTimeMs, 1.0e-9);
+            expect (s.lastServiceNumber >= 0);
+        }
+
+        beginTest ("Read-ahead scheduling: " + tracktion::engine::TimeStretcher::getNameOfMode (mode));
+        {
+            // The instances should have been serviced in order of how much output they had ready,
+            // the one closest to underrunning first
+            std::vector<size_t> serviceOrder (numStretchers);
+
+            for (size_t i = 0; i < numStretchers; ++i)
+                serviceOrder[i] = i;
+
+            std::sort (serviceOrder.begin(), serviceOrder.end(),
+                       [&] (auto a, auto b) { return stats[a].lastServiceNumber < stats[b].lastServiceNumber; });
+
+            for (size_t i = 1; i < numStretchers; ++i)
+                expect (numReady[serviceOrder[i - 1]] <= numReady[serviceOrder[i]]);
+
+            // Each instance popped one more sample than the previous one so the last is the most urgent
+            expectEquals (serviceOrder.front(), numStretchers - 1);
+        }
+
+        beginTest ("Read-ahead underruns: " + tracktion::engine::TimeStretcher::getNameOfMode (mode));
+        {
+            const ReadAheadTimeStretcher::ScopedPauseWorkers pauseWorkers;
+            auto& stretcher = *stretchers.front();
+            const auto underrunsBefore = stretcher.getStatistics().numUnderruns;
+
+            // Reading less than is ready isn't an underrun
+            for (int numToRead = std::min (blockSize, stretcher.getNumReady() - blockSize / 2); numToRead > 0;
+                 numToRead = std::min (blockSize, stretcher.getNumReady() - blockSize / 2))
+                stretcher.popData (outputs, numToRead);
+
+            expectEquals (stretcher.getNumReady(), blockSize / 2);
+            expectEquals (stretcher.getStatistics().numUnderruns, underrunsBefore);
+
+            // But reading more than is ready is
+            stretcher.pushData (inputs, stretcher.getFramesNeeded());
+            stretcher.popData (outputs, stretcher.getNumReady() + 1);
+            expectEquals (stretcher.getStatistics().numUnderruns, underrunsBefore + 1);
+            expectEquals (stretcher.getStatistics().numBlocksProcessed, 1);
+        }
+    }
+
     //==============================================================================
     void testStretcher (tracktion::engine::TimeStretcher::Mode mode, float stretchRatio, float semitonesUp)
     {
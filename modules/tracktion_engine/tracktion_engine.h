@@ -329,6 +329,7 @@ namespace tracktion { inline namespace engine
     class AutomationRecordManager;
     class RenderManager;
     class EditPlaybackContext;
+    class TrackNodeCache;
     class EditInputDevices;
     class InputDeviceInstance;
     class GrooveTemplate;
@@ -377,6 +378,7 @@ namespace tracktion { inline namespace engine
     class LaunchHandle;
     class LaunchQuantisation;
     class BufferedAudioFileManager;
+    class DecodedBlockCache;
 }} // namespace tracktion { inline namespace engine
 
 #ifdef __GNUC__
@@ -431,6 +433,7 @@ namespace tracktion { inline namespace engine
 #include "model/edit/tracktion_EditItem.h"
 #include "model/automation/tracktion_AutomatableParameterTree.h"
 #include "model/automation/tracktion_AutomatableParameter.h"
+#include "model/automation/tracktion_ParameterChangeQueue.h"
 #include "model/automation/tracktion_AutomatableEditItem.h"
 #include "model/automation/tracktion_MacroParameter.h"
 #include "model/automation/tracktion_Modifier.h"
@@ -474,6 +477,7 @@ namespace tracktion { inline namespace engine
 #include "utilities/tracktion_Engine.h"
 
 #include "playback/tracktion_LevelMeasurer.h"
+#include "playback/tracktion_LoudnessMeter.h"
 
 #include "plugins/external/tracktion_VSTXML.h"
 #include "plugins/external/tracktion_ExternalPlugin.h"
@@ -499,6 +503,7 @@ namespace tracktion { inline namespace engine
 #include "model/edit/tracktion_PitchSetting.h"
 #include "model/edit/tracktion_PitchSequence.h"
 #include "model/edit/tracktion_Edit.h"
+#include "model/edit/tracktion_BinaryEditFile.h"
 #include "model/edit/tracktion_EditFileOperations.h"
 #include "model/edit/tracktion_EditLoader.h"
 
@@ -519,6 +524,7 @@ namespace tracktion { inline namespace engine
 #include "utilities/tracktion_Pitch.h"
 
 #include "audio_files/tracktion_AudioFileCache.h"
+#include "audio_files/tracktion_PeakFile.h"
 #include "audio_files/tracktion_SmartThumbnail.h"
 #include "audio_files/tracktion_AudioProxyGenerator.h"
 #include "audio_files/tracktion_AudioFileManager.h"
@@ -531,6 +537,7 @@ namespace tracktion { inline namespace engine
 #include "audio_files/tracktion_AudioFileUtils.h"
 #include "audio_files/tracktion_AudioFifo.h"
 #include "audio_files/tracktion_RecordingThumbnailManager.h"
+#include "audio_files/formats/tracktion_DecodedSidecarAudioFormat.h"
 #include "audio_files/formats/tracktion_FFmpegEncoderAudioFormat.h"
 #include "audio_files/formats/tracktion_FloatAudioFileFormat.h"
 #include "audio_files/formats/tracktion_MemoryMappedFileReader.h"
@@ -40,6 +40,7 @@ extern "C"
  #pragma GCC diagnostic ignored "-Wfloat-equal"
 #endif
 
+#include "audio_files/formats/tracktion_DecodedSidecarAudioFormat.cpp"
 #include "audio_files/formats/tracktion_FFmpegEncoderAudioFormat.cpp"
 #include "audio_files/formats/tracktion_FloatAudioFileFormat.cpp"
 #include "audio_files/formats/tracktion_RexFileFormat.cpp"
@@ -48,8 +49,12 @@ extern "C"
 #include "audio_files/tracktion_BufferedFileReader.h"
 #include "audio_files/tracktion_BufferedFileReader.cpp"
 
+#include "audio_files/tracktion_DecodedBlockCache.h"
+#include "audio_files/tracktion_DecodedBlockCache.cpp"
 #include "audio_files/tracktion_AudioFileCache.cpp"
 #include "audio_files/tracktion_AudioFileCache.test.cpp"
+#include "audio_files/tracktion_PeakFile.cpp"
+#include "audio_files/tracktion_PeakFile.test.cpp"
 #include "audio_files/tracktion_AudioFile.cpp"
 #include "audio_files/tracktion_AudioFile.test.cpp"
 #include "audio_files/tracktion_AudioFileUtils.cpp"
@@ -48,6 +48,7 @@ using namespace std::literals;
 #include "model/automation/tracktion_AutomationRecordManager.cpp"
 #include "model/automation/tracktion_MidiLearn.cpp"
 #include "model/automation/tracktion_ParameterChangeHandler.cpp"
+#include "model/automation/tracktion_ParameterChangeQueue.cpp"
 #include "model/automation/tracktion_ParameterControlMappings.cpp"
 #include "model/automation/tracktion_Modifier.cpp"
 #include "model/automation/modifiers/tracktion_ModifierCommon.cpp"
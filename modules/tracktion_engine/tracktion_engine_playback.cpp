@@ -183,6 +183,7 @@ using namespace std::literals;
 #include "playback/graph/tracktion_AuxSendNode.h"
 #include "playback/graph/tracktion_ClickNode.h"
 #include "playback/graph/tracktion_CombiningNode.h"
+#include "playback/graph/tracktion_CompiledMidiSequence.h"
 #include "playback/graph/tracktion_ContainerClipNode.h"
 #include "playback/graph/tracktion_DynamicOffsetNode.h"
 #include "playback/graph/tracktion_FadeInOutNode.h"
@@ -219,6 +220,7 @@ using namespace std::literals;
 #include "playback/graph/tracktion_AuxSendNode.cpp"
 #include "playback/graph/tracktion_ClickNode.cpp"
 #include "playback/graph/tracktion_CombiningNode.cpp"
+#include "playback/graph/tracktion_CompiledMidiSequence.cpp"
 #include "playback/graph/tracktion_ContainerClipNode.cpp"
 #include "playback/graph/tracktion_DynamicOffsetNode.cpp"
 #include "playback/graph/tracktion_FadeInOutNode.cpp"
@@ -270,6 +272,9 @@ using namespace std::literals;
 #include "playback/tracktion_EditPlaybackContext.cpp"
 #include "playback/tracktion_EditInputDevices.cpp"
 #include "playback/tracktion_LevelMeasurer.cpp"
+#include "playback/tracktion_LevelMeasurer.test.cpp"
+#include "playback/tracktion_LoudnessMeter.cpp"
+#include "playback/tracktion_LoudnessMeter.test.cpp"
 #include "playback/tracktion_MidiNoteDispatcher.cpp"
 #include "playback/tracktion_TransportControl.test.cpp"
 #include "playback/tracktion_TransportControl.cpp"
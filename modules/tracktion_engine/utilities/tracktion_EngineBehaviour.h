@@ -173,6 +173,10 @@ public:
     // Waveform uses yellow, green, blue, purple, red, auto (based on key)
     virtual int getDefaultNoteColour()                                              { return 0; }
 
+    /// If this returns true, Edits are saved in the binary format written by
+    /// BinaryEditFileWriter rather than as XML. Edits in either format can be loaded.
+    virtual bool shouldSaveEditsInBinaryFormat()                                    { return false; }
+
     virtual bool ignoreBWavTimestamps()                                             { return false; }
 
     virtual bool areAudioClipsRemappedWhenTempoChanges()                            { return true; }
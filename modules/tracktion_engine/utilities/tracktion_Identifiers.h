@@ -563,6 +563,7 @@ namespace IDs
     DECLARE_ID (MACROPARAMETERS)
     DECLARE_ID (MACROPARAMETER)
     DECLARE_ID (MAPPEDPARAMETER)
+    DECLARE_ID (BINARYSECTION)
     DECLARE_ID (TRANSPORT)
     DECLARE_ID (position)
     DECLARE_ID (loopPoint1)
@@ -26,6 +26,8 @@ juce::StringRef PropertyStorage::settingToString (SettingID setting)
         case SettingID::automapGuids1:                      return "AutomapGuids1";
         case SettingID::automapGuids2:                      return "AutomapGuids2";
         case SettingID::cacheSizeSamples:                   return "cacheSizeSamples";
+        case SettingID::decodedCacheSizeMb:                 return "decodedCacheSizeMb";
+        case SettingID::decodedSidecars:                    return "decodedSidecars";
         case SettingID::clickTrackMidiNoteBig:              return "clickTrackMidiNoteBig";
         case SettingID::clickTrackMidiNoteLittle:           return "clickTrackMidiNoteLittle";
         case SettingID::clickTrackSampleSmall:              return "clickTrackSampleSmall";
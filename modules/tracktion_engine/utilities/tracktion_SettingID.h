@@ -26,6 +26,8 @@ enum class SettingID
     automapGuids1,
     automapGuids2,
     cacheSizeSamples,
+    decodedCacheSizeMb,
+    decodedSidecars,
     compCrossfadeMs,
     countInMode,
     clickTrackMidiNoteBig,
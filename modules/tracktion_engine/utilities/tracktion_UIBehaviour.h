@@ -107,6 +107,7 @@ public:
     virtual void setBigInputMetersMode (bool) {}
 
     virtual bool shouldGenerateLiveWaveformsWhenRecording()                         { return true;  }
+    virtual bool shouldCreatePeakFiles()                                            { return true;  }
 
     virtual void showSafeRecordDialog (TransportControl&)                           {}
     virtual void hideSafeRecordDialog (TransportControl&)                           {}
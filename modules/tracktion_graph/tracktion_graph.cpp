@@ -43,10 +43,15 @@
 #include "tracktion_graph/tracktion_MultiThreadedNodePlayer.cpp"
 #include "tracktion_graph/tracktion_LockFreeMultiThreadedNodePlayer.cpp"
 #include "tracktion_graph/tracktion_NodePlayerThreadPools.cpp"
+#include "tracktion_graph/tracktion_LockFreeMultiThreadedNodePlayer.test.cpp"
 
 #include "tracktion_graph/nodes/tracktion_ConnectedNode.test.cpp"
 
 #include "utilities/tracktion_AudioBufferPool.tests.cpp"
+#include "utilities/tracktion_AudioBufferArena.tests.cpp"
+#include "utilities/tracktion_SummingKernels.cpp"
+#include "utilities/tracktion_SummingKernels.tests.cpp"
+#include "utilities/tracktion_MidiMessageArray.tests.cpp"
 #include "utilities/tracktion_Semaphore.cpp"
 #include "utilities/tracktion_Semaphore.tests.cpp"
 #include "utilities/tracktion_Threads.cpp"
@@ -98,10 +98,13 @@ namespace tracktion_engine = tracktion::engine;
 #include "tracktion_graph/tracktion_Utility.h"
 
 #include "utilities/tracktion_AudioBufferPool.h"
+#include "utilities/tracktion_AudioBufferArena.h"
+#include "utilities/tracktion_SummingKernels.h"
 #include "utilities/tracktion_AudioBufferStack.h"
 #include "utilities/tracktion_GlueCode.h"
 #include "utilities/tracktion_AudioFifo.h"
 #include "utilities/tracktion_PerformanceMeasurement.h"
+#include "utilities/tracktion_NodeProfiler.h"
 #include "utilities/tracktion_RealTimeSpinLock.h"
 #include "utilities/tracktion_Semaphore.h"
 #include "utilities/tracktion_Threads.h"
@@ -111,13 +111,13 @@ public:
         return TransformResult::none;
     }
 
-    void prepareToPlay (const PlaybackInitialisationInfo& info) override
+    void prepareToPlay (const PlaybackInitialisationInfo&) override
     {
         useDoublePrecision = useDoublePrecision && nodes.size() > 1;
+        sourceChannels.resize (nodes.size());
 
-        if (useDoublePrecision)
-            tempDoubleBuffer.resize ({ (choc::buffer::ChannelCount) getNodeProperties().numberOfChannels,
-                                       (choc::buffer::FrameCount) info.blockSize });
+        if (getNodeProperties().hasMidi)
+            midiSources.reserve (nodes.size() + 1);
 
         isPrepared = true;
     }
@@ -133,10 +133,8 @@ public:
 
     void process (ProcessContext& pc) override
     {
-        if (useDoublePrecision)
-            processDoublePrecision (pc);
-        else
-            processSinglePrecision (pc);
+        sumAudio (pc);
+        mergeMidi (pc);
     }
 
 private:
@@ -148,80 +146,113 @@ private:
     bool isPrepared = false;
 
     bool useDoublePrecision = false;
-    choc::buffer::ChannelArrayBuffer<double> tempDoubleBuffer;
+    std::vector<const float*> sourceChannels;
 
-    static void sortByTimestampUnstable (tracktion_engine::MidiMessageArray& messages) noexcept
+    struct MidiSource
     {
-        std::sort (messages.begin(), messages.end(), [] (const juce::MidiMessage& a, const juce::MidiMessage& b)
-        {
-            auto t1 = a.getTimeStamp();
-            auto t2 = b.getTimeStamp();
+        const tracktion_engine::MidiMessageArray* messages = nullptr;
+        int nextIndex = 0;
+    };
 
-            if (t1 == t2)
-            {
-                if (a.isNoteOff() && b.isNoteOn()) return true;
-                if (a.isNoteOn() && b.isNoteOff()) return false;
-            }
-            return t1 < t2;
-        });
-    }
+    tracktion_engine::MidiMessageArray midiToMerge;
+    std::vector<MidiSource> midiSources;
 
     //==============================================================================
-    void processSinglePrecision (const ProcessContext& pc)
+    void sumAudio (const ProcessContext& pc)
     {
         const auto numChannels = pc.buffers.audio.getNumChannels();
+        const auto numFrames = pc.buffers.audio.getNumFrames();
+        assert (sourceChannels.size() >= nodes.size());
 
-        int nodesWithMidi = pc.buffers.midi.isEmpty() ? 0 : 1;
-
-        // Get each of the inputs and add them to dest
-        for (auto& node : nodes)
+        // Gather the inputs for each channel and sum them in one pass, writing dest once
+        for (choc::buffer::ChannelCount channel = 0; channel < numChannels; ++channel)
         {
-            auto inputFromNode = node->getProcessedOutput();
+            size_t numSources = 0;
 
-            if (auto numChannelsToAdd = std::min (inputFromNode.audio.getNumChannels(), numChannels))
-                add (pc.buffers.audio.getFirstChannels (numChannelsToAdd),
-                     inputFromNode.audio.getFirstChannels (numChannelsToAdd));
+            for (auto& node : nodes)
+            {
+                auto inputAudio = node->getProcessedOutput().audio;
 
-            if (inputFromNode.midi.isNotEmpty())
-                nodesWithMidi++;
+                if (channel < inputAudio.getNumChannels())
+                {
+                    assert (inputAudio.getNumFrames() == numFrames);
+                    sourceChannels[numSources++] = inputAudio.getChannel (channel).data.data;
+                }
+            }
 
-            pc.buffers.midi.mergeFrom (inputFromNode.midi);
-        }
+            auto dest = pc.buffers.audio.getChannel (channel).data.data;
 
-        if (nodesWithMidi > 1)
-            sortByTimestampUnstable (pc.buffers.midi);
+            if (useDoublePrecision)
+                summing_kernels::sumDoublePrecision (dest, sourceChannels.data(), nullptr, numSources, numFrames);
+            else
+                summing_kernels::sum (dest, sourceChannels.data(), nullptr, numSources, numFrames);
+        }
     }
 
-    void processDoublePrecision (const ProcessContext& pc)
+    void mergeMidi (const ProcessContext& pc)
     {
-        const auto numChannels = pc.buffers.audio.getNumChannels();
-        auto doubleView = tempDoubleBuffer.getView().getStart (pc.buffers.audio.getNumFrames());
-        doubleView.clear();
+        auto& destMidi = pc.buffers.midi;
+        int nodesWithMidi = destMidi.isEmpty() ? 0 : 1;
 
-        int nodesWithMidi = pc.buffers.midi.isEmpty() ? 0 : 1;
-
-        // Get each of the inputs and add them to dest
         for (auto& node : nodes)
+            if (node->getProcessedOutput().midi.isNotEmpty())
+                nodesWithMidi++;
+
+        if (nodesWithMidi > 1)
         {
-            auto inputFromNode = node->getProcessedOutput();
+            mergeSortedMidi (destMidi);
+            return;
+        }
 
-            if (auto numChannelsToAdd = std::min (inputFromNode.audio.getNumChannels(), numChannels))
-                add (doubleView.getFirstChannels (numChannelsToAdd),
-                     inputFromNode.audio.getFirstChannels (numChannelsToAdd));
+        for (auto& node : nodes)
+            destMidi.mergeFrom (node->getProcessedOutput().midi);
+    }
 
-            if (inputFromNode.midi.isNotEmpty())
-                nodesWithMidi++;
+    void mergeSortedMidi (tracktion_engine::MidiMessageArray& destMidi)
+    {
+        // Each input is already in order so rather than appending them all and sorting
+        // the result, repeatedly take the earliest of the next message from each one.
+        // Any messages already in the destination are moved out to be merged in first,
+        // so messages at the same time keep the same order as a stable sort would give.
+        midiToMerge.clear();
+        midiToMerge.swapWith (destMidi);
+        midiSources.clear();
+        int numMessages = 0;
+
+        for (int i = -1; i < (int) nodes.size(); ++i)
+        {
+            auto& source = i < 0 ? midiToMerge : nodes[(size_t) i]->getProcessedOutput().midi;
+            destMidi.isAllNotesOff = destMidi.isAllNotesOff || source.isAllNotesOff;
 
-            pc.buffers.midi.mergeFrom (inputFromNode.midi);
+            if (source.isNotEmpty())
+            {
+                midiSources.push_back ({ &source, 0 });
+                numMessages += source.size();
+            }
         }
 
-        assert (doubleView.getNumChannels() == (choc::buffer::ChannelCount) numChannels);
+        destMidi.reserve (numMessages);
 
-        if (numChannels != 0)
-            add (pc.buffers.audio.getFirstChannels (numChannels), doubleView);
+        for (;;)
+        {
+            MidiSource* earliest = nullptr;
 
-        if (nodesWithMidi > 1)
-            sortByTimestampUnstable (pc.buffers.midi);
+            for (auto& source : midiSources)
+                if (source.nextIndex < source.messages->size()
+                     && (earliest == nullptr
+                         || tracktion_engine::MidiMessageArray::isEarlier ((*source.messages)[source.nextIndex],
+                                                                          (*earliest->messages)[earliest->nextIndex])))
+                    earliest = &source;
+
+            if (earliest == nullptr)
+                break;
+
+            destMidi.add ((*earliest->messages)[earliest->nextIndex++]);
+        }
+
+        // If any of the inputs weren't in order, the result will still need sorting
+        if (! std::is_sorted (destMidi.begin(), destMidi.end(), tracktion_engine::MidiMessageArray::isEarlier))
+            destMidi.sortByTimestamp();
     }
 
     //==============================================================================
@@ -81,6 +81,12 @@ namespace node_player_utils
         for (auto n : nodeGraph->orderedNodes)
             n->initialise (info);
 
+        // Cache the IDs so players don't have to get the properties whilst processing
+        nodeGraph->orderedNodeIDs.reserve (nodeGraph->orderedNodes.size());
+
+        for (auto n : nodeGraph->orderedNodes)
+            nodeGraph->orderedNodeIDs.push_back (n->getNodeProperties().nodeID);
+
         return nodeGraph;
     }
 
@@ -115,6 +121,198 @@ namespace node_player_utils
         const size_t numBuffersRequired = std::max ((size_t) 2, std::min (allNodes.size(), 1 + numThreads));
         audioBufferPool.reserve (numBuffersRequired, choc::buffer::Size::create (maxNumChannels, blockSize));
     }
+
+    /** Plans the output buffers of a whole graph up front, assigning each Node a fixed
+        region of a single AudioBufferArena.
+
+        This works a bit like register allocation. The lifetime of each Node's output
+        is worked out from the graph and then regions are shared between Nodes whose
+        outputs can never be live at the same time, regardless of which threads the
+        Nodes get processed on.
+
+        A Node's output is live until all the Nodes that read it have processed.
+        As Nodes with a single input can pass on their input's buffer (e.g. with
+        Node::setAudioOutput), the output is also kept live for as long as any of
+        those Nodes' outputs are. Another Node can then reuse the region once all
+        these readers are guaranteed to have processed before it, i.e. they are
+        all upstream of it. The root Node's output is never reused.
+
+        Nodes that use AllocateAudioBuffer::no don't get a region as they provide
+        their own output. This may be any of their inputs' buffers so these are
+        kept live in the same way as for single input Nodes.
+
+        @param orderedNodes     the Nodes to allocate, in a topological order and initialised
+        @param rootNode         the Node whose output is read after processing
+        @param arena            the arena to allocate the regions in, this will be reset
+        @param blockSize        the maximum number of frames that will be processed
+    */
+    inline void allocateStaticAudioBuffers (const std::vector<Node*>& orderedNodes, Node* rootNode,
+                                            AudioBufferArena& arena, int blockSize)
+    {
+        arena.reset();
+
+        const auto numNodes = orderedNodes.size();
+
+        if (numNodes == 0)
+            return;
+
+        std::unordered_map<Node*, size_t> nodeIndices;
+        nodeIndices.reserve (numNodes);
+
+        for (size_t i = 0; i < numNodes; ++i)
+            nodeIndices[orderedNodes[i]] = i;
+
+        // Find the inputs and outputs of each Node and check the order is topological
+        std::vector<std::vector<size_t>> inputs (numNodes), outputs (numNodes);
+        std::vector<bool> allocatesBuffer (numNodes);
+        bool isTopologicallyOrdered = true;
+
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            allocatesBuffer[i] = orderedNodes[i]->getOptimisations().allocate == AllocateAudioBuffer::yes;
+
+            for (auto inputNode : orderedNodes[i]->getDirectInputNodes())
+            {
+                const auto found = nodeIndices.find (inputNode);
+                jassert (found != nodeIndices.end());
+
+                if (found == nodeIndices.end())
+                    continue;
+
+                if (found->second >= i)
+                    isTopologicallyOrdered = false;
+
+                inputs[i].push_back (found->second);
+                outputs[found->second].push_back (i);
+            }
+        }
+
+        jassert (isTopologicallyOrdered);
+
+        // Build the set of upstream Nodes for each Node as a bitset
+        const size_t numWords = (numNodes + 63) / 64;
+        std::vector<uint64_t> upstreamNodes (isTopologicallyOrdered ? numNodes * numWords : 0, 0);
+
+        auto isUpstream = [&] (size_t nodeIndex, size_t possibleUpstreamIndex)
+        {
+            return (upstreamNodes[nodeIndex * numWords + possibleUpstreamIndex / 64] >> (possibleUpstreamIndex % 64)) & 1;
+        };
+
+        if (isTopologicallyOrdered)
+        {
+            for (size_t i = 0; i < numNodes; ++i)
+            {
+                auto dest = upstreamNodes.data() + i * numWords;
+
+                for (auto input : inputs[i])
+                {
+                    auto source = upstreamNodes.data() + input * numWords;
+
+                    for (size_t w = 0; w < numWords; ++w)
+                        dest[w] |= source[w];
+
+                    dest[input / 64] |= uint64_t (1) << (input % 64);
+                }
+            }
+        }
+
+        // Find the Nodes that must have processed before each output can be reused.
+        // Iterating backwards means all the outputs have been resolved first
+        std::vector<std::vector<size_t>> readers (numNodes);
+        std::vector<bool> isNeverReleased (numNodes, ! isTopologicallyOrdered);
+
+        for (size_t i = numNodes; i-- > 0;)
+        {
+            if (orderedNodes[i] == rootNode || outputs[i].empty())
+                isNeverReleased[i] = true;
+
+            for (auto output : outputs[i])
+            {
+                if (inputs[output].size() == 1 || ! allocatesBuffer[output])
+                {
+                    if (isNeverReleased[output])
+                        isNeverReleased[i] = true;
+                    else
+                        readers[i].insert (readers[i].end(), readers[output].begin(), readers[output].end());
+                }
+                else
+                {
+                    readers[i].push_back (output);
+                }
+            }
+
+            std::sort (readers[i].begin(), readers[i].end());
+            readers[i].erase (std::unique (readers[i].begin(), readers[i].end()), readers[i].end());
+        }
+
+        // Then assign the regions in order, each region remembering the readers of its last Node
+        struct RegionState
+        {
+            std::vector<size_t> readers;
+            bool isNeverReleased = false;
+        };
+
+        std::vector<RegionState> regionStates;
+        std::vector<std::optional<size_t>> nodeRegions (numNodes);
+        std::vector<choc::buffer::Size> nodeSizes (numNodes);
+
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            const auto numChannels = (choc::buffer::ChannelCount) std::max (0, orderedNodes[i]->getNodeProperties().numberOfChannels);
+            nodeSizes[i] = choc::buffer::Size::create (numChannels, (choc::buffer::FrameCount) blockSize);
+
+            if (numChannels == 0 || ! allocatesBuffer[i])
+                continue;
+
+            // Find the smallest free region that fits or the largest one that can be grown
+            std::optional<size_t> bestRegion;
+
+            for (size_t r = 0; r < regionStates.size(); ++r)
+            {
+                auto& state = regionStates[r];
+
+                if (state.isNeverReleased
+                    || ! std::all_of (state.readers.begin(), state.readers.end(),
+                                      [&] (auto reader) { return isUpstream (i, reader); }))
+                    continue;
+
+                if (! bestRegion)
+                {
+                    bestRegion = r;
+                    continue;
+                }
+
+                const auto regionChannels = arena.getRegionSize (r).numChannels;
+                const auto bestChannels = arena.getRegionSize (*bestRegion).numChannels;
+                const bool regionFits = regionChannels >= numChannels;
+                const bool bestFits = bestChannels >= numChannels;
+
+                if (regionFits ? (! bestFits || regionChannels < bestChannels)
+                               : (! bestFits && regionChannels > bestChannels))
+                    bestRegion = r;
+            }
+
+            if (bestRegion)
+            {
+                arena.growRegion (*bestRegion, nodeSizes[i]);
+            }
+            else
+            {
+                bestRegion = arena.addRegion (nodeSizes[i]);
+                regionStates.emplace_back();
+            }
+
+            regionStates[*bestRegion] = { std::move (readers[i]), isNeverReleased[i] };
+            nodeRegions[i] = bestRegion;
+        }
+
+        arena.allocate();
+
+        for (size_t i = 0; i < numNodes; ++i)
+            if (allocatesBuffer[i])
+                orderedNodes[i]->setStaticAudioBufferView (nodeRegions[i] ? arena.getView (*nodeRegions[i], nodeSizes[i])
+                                                                          : choc::buffer::ChannelArrayView<float> { {}, nodeSizes[i] });
+    }
 }
 
 }}
@@ -18,6 +18,15 @@
 namespace tracktion { inline namespace graph
 {
 
+namespace
+{
+    // Node costs are only measured every this many blocks to keep the timing overhead down
+    constexpr uint32_t nodeCostMeasurementInterval = 16;
+
+    // Added to each Node's measured cost so unmeasured graphs are prioritised by depth
+    constexpr double nodeSchedulingOverheadSeconds = 1.0e-7;
+}
+
 LockFreeMultiThreadedNodePlayer::LockFreeMultiThreadedNodePlayer()
 {
     threadPool = getPoolCreatorFunction (ThreadPoolStrategy::realTime) (*this);
@@ -42,6 +51,17 @@ void LockFreeMultiThreadedNodePlayer::setNumThreads (size_t newNumThreads)
 
     clearThreads();
     numThreadsToUse = newNumThreads;
+
+    // The worker queues are sized by the number of threads so need rebuilding
+    // whilst the threads are stopped and the audio thread is locked out
+    {
+        const std::scoped_lock<RealTimeSpinLock> sl (processMutex);
+        const auto scopedAccess = preparedNodeObject.getScopedAccess();
+
+        if (auto pn = scopedAccess.get(); pn != nullptr && pn->graph != nullptr)
+            buildWorkerQueues (*pn);
+    }
+
     createThreads();
 }
 
@@ -63,6 +83,11 @@ void LockFreeMultiThreadedNodePlayer::prepareToPlay (double sampleRateToUse, int
     if (sampleRateToUse == sampleRate && blockSizeToUse == blockSize)
         return;
 
+    rePrepareCurrentNode (sampleRateToUse, blockSizeToUse);
+}
+
+void LockFreeMultiThreadedNodePlayer::rePrepareCurrentNode (double sampleRateToUse, int blockSizeToUse)
+{
     std::unique_ptr<NodeGraph> currentGraph;
 
     // Ensure we've flushed any pending Node to the current prepared Node
@@ -101,10 +126,24 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
     if (! preparedNode->graph->rootNode)
         return -1;
 
+    lastProcessedNode.store (preparedNode->graph->rootNode.get(), std::memory_order_relaxed);
+
     // Reset the stream range
     numSamplesToProcess = pc.numSamples;
     referenceSampleRange = pc.referenceSampleRange;
 
+    auto profiler = nodeProfiler.load (std::memory_order_acquire);
+
+    if (profiler != nullptr && ! profiler->isEnabled())
+        profiler = nullptr;
+
+    const auto blockStartNs = profiler != nullptr ? profiler->now() : 0;
+
+    if (profiler != nullptr)
+        currentBlockNumber = profiler->getNextBlockNumber();
+
+    activeNodeProfiler.store (profiler, std::memory_order_relaxed);
+
     // Prepare all the nodes to be played back
     for (auto node : preparedNode->graph->orderedNodes)
         node->prepareForNextBlock (referenceSampleRange);
@@ -115,7 +154,12 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
     if (numThreadsToUse.load (std::memory_order_acquire) == 0 || preparedNode->graph->orderedNodes.size() == 1)
     {
         for (auto node : preparedNode->graph->orderedNodes)
-            node->process (numSamplesToProcess, referenceSampleRange);
+        {
+            if (profiler != nullptr)
+                static_cast<PlaybackNode*> (node->internal)->readyTimeNs.store (profiler->now(), std::memory_order_relaxed);
+
+            processSingleNode (*node, audioThreadWorkerIndex);
+        }
     }
     else
     {
@@ -129,7 +173,7 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
             if (preparedNode->graph->rootNode->hasProcessed())
                 break;
 
-            if (! processNextFreeNode (*preparedNode))
+            if (! processNextFreeNode (*preparedNode, audioThreadWorkerIndex))
                 threadPool->waitForFinalNode();
         }
     }
@@ -149,6 +193,18 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
     // We need to release the root to match the previous retain
     preparedNode->graph->rootNode->release();
 
+    if (profiler != nullptr)
+    {
+        NodeProfiler::Event blockEvent;
+        blockEvent.nodeTypeName = "Block";
+        blockEvent.blockNumber = currentBlockNumber;
+        blockEvent.threadIndex = audioThreadWorkerIndex;
+        blockEvent.readyNs = blockStartNs;
+        blockEvent.startNs = blockStartNs;
+        blockEvent.endNs = profiler->now();
+        profiler->addEvent (blockEvent);
+    }
+
     return -1;
 }
 
@@ -160,6 +216,7 @@ void LockFreeMultiThreadedNodePlayer::clearNode()
     rootNode = nullptr;
     lastGraphPosted = nullptr;
     lastAudioBufferPoolPosted = nullptr;
+    staticBufferArenaSize.store (0, std::memory_order_release);
     preparedNodeObject.clear();
 
     createThreads();
@@ -178,6 +235,18 @@ void LockFreeMultiThreadedNodePlayer::enableNodeMemorySharing (bool shouldBeEnab
         prepareToPlay (sampleRate, blockSize);
 }
 
+void LockFreeMultiThreadedNodePlayer::enableStaticBufferAllocation (bool shouldBeEnabled)
+{
+    if (std::exchange (staticBufferAllocationEnabled, shouldBeEnabled) != shouldBeEnabled)
+        rePrepareCurrentNode (sampleRate, blockSize);
+}
+
+void LockFreeMultiThreadedNodePlayer::setSchedulingStrategy (NodeSchedulingStrategy newStrategy)
+{
+    if (std::exchange (schedulingStrategy, newStrategy) != newStrategy)
+        rePrepareCurrentNode (sampleRate, blockSize);
+}
+
 
 //==============================================================================
 //==============================================================================
@@ -190,7 +259,8 @@ std::unique_ptr<NodeGraph> LockFreeMultiThreadedNodePlayer::prepareToPlay (std::
     sampleRate.store (sampleRateToUse, std::memory_order_release);
     blockSize.store (blockSizeToUse, std::memory_order_release);;
 
-    if (! useCurrentAudioBufferPool)
+    // Static buffers are assigned to the Nodes once they've been prepared
+    if (! useCurrentAudioBufferPool || staticBufferAllocationEnabled)
         return node_player_utils::prepareToPlay (std::move (node), oldGraph, sampleRateToUse, blockSizeToUse, nullptr, nullptr, nodeMemorySharingEnabled);
 
     return node_player_utils::prepareToPlay (std::move (node), oldGraph, sampleRateToUse, blockSizeToUse,
@@ -239,6 +309,16 @@ void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> n
         return;
     }
 
+    // This needs to happen before the sort below as it needs a topological ordering
+    std::unique_ptr<AudioBufferArena> audioBufferArena;
+
+    if (staticBufferAllocationEnabled)
+    {
+        audioBufferArena = std::make_unique<AudioBufferArena>();
+        node_player_utils::allocateStaticAudioBuffers (newGraph->orderedNodes, newGraph->rootNode.get(),
+                                                       *audioBufferArena, blockSize);
+    }
+
     std::stable_sort (newGraph->orderedNodes.begin(), newGraph->orderedNodes.end(),
                       [] (auto n1, auto n2)
                       {
@@ -251,8 +331,12 @@ void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> n
     newPreparedNode.graph = std::move (newGraph);
     newPreparedNode.nodesReadyToBeProcessed = std::make_unique<LockFreeFifo<Node*>> ((int) newPreparedNode.graph->orderedNodes.size());
     buildNodesOutputLists (newPreparedNode);
+    buildWorkerQueues (newPreparedNode);
 
-    if (useMemoryPool)
+    staticBufferArenaSize.store (audioBufferArena != nullptr ? audioBufferArena->getAllocatedSize() : 0, std::memory_order_release);
+    newPreparedNode.audioBufferArena = std::move (audioBufferArena);
+
+    if (useMemoryPool && ! staticBufferAllocationEnabled)
     {
         const size_t poolCapacity = newPreparedNode.graph->orderedNodes.size();
         newPreparedNode.audioBufferPool = std::make_unique<AudioBufferPool> (poolCapacity);
@@ -272,6 +356,7 @@ void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> n
 void LockFreeMultiThreadedNodePlayer::buildNodesOutputLists (PreparedNode& preparedNode)
 {
     preparedNode.playbackNodes.clear();
+    preparedNode.leafNodes.clear();
     preparedNode.playbackNodes.reserve (preparedNode.graph->orderedNodes.size());
 
     for (auto n : preparedNode.graph->orderedNodes)
@@ -299,6 +384,83 @@ void LockFreeMultiThreadedNodePlayer::buildNodesOutputLists (PreparedNode& prepa
             ++inputNode->numOutputNodes;
         }
     }
+
+    for (auto& playbackNode : preparedNode.playbackNodes)
+    {
+        if (playbackNode->numInputs == 0)
+            preparedNode.leafNodes.push_back (playbackNode.get());
+
+        playbackNode->outputsByPriority[0] = playbackNode->outputs;
+        playbackNode->outputsByPriority[1] = playbackNode->outputs;
+        playbackNode->sortedOutputs.store (&playbackNode->outputsByPriority[0], std::memory_order_release);
+    }
+
+    updateCriticalPathPriorities (preparedNode);
+}
+
+void LockFreeMultiThreadedNodePlayer::updateCriticalPathPriorities (PreparedNode& preparedNode)
+{
+    auto getPriority = [] (Node* n)
+    {
+        return static_cast<PlaybackNode*> (n->internal)->criticalPathPriority.load (std::memory_order_relaxed);
+    };
+
+    // The playbackNodes are in topological order so iterating backwards
+    // means all of a Node's outputs will have been updated before it
+    for (auto iter = preparedNode.playbackNodes.rbegin(); iter != preparedNode.playbackNodes.rend(); ++iter)
+    {
+        auto& playbackNode = **iter;
+        double maxOutputPriority = 0.0;
+
+        for (auto output : playbackNode.outputs)
+            maxOutputPriority = std::max (maxOutputPriority, getPriority (output));
+
+        const auto cost = playbackNode.averageProcessSeconds.load (std::memory_order_relaxed) + nodeSchedulingOverheadSeconds;
+        playbackNode.criticalPathPriority.store (cost + maxOutputPriority, std::memory_order_relaxed);
+    }
+
+    // Then sort the outputs and leaves so the Nodes on the critical path get queued first.
+    // Only the audio thread reads the leaves but the outputs can still be being iterated by
+    // a worker that's finishing the last block. The copy not published is sorted instead and
+    // then swapped in. Every Node has been processed by the end of a block, so any thread
+    // still holding the previous copy has already read all of it by the time it's re-sorted
+    for (auto& playbackNode : preparedNode.playbackNodes)
+    {
+        if (playbackNode->outputs.size() < 2)
+            continue;
+
+        auto current = playbackNode->sortedOutputs.load (std::memory_order_acquire);
+        auto& spare = current == &playbackNode->outputsByPriority[0] ? playbackNode->outputsByPriority[1]
+                                                                     : playbackNode->outputsByPriority[0];
+
+        std::sort (spare.begin(), spare.end(),
+                   [&] (auto n1, auto n2) { return getPriority (n1) > getPriority (n2); });
+        playbackNode->sortedOutputs.store (&spare, std::memory_order_release);
+    }
+
+    std::sort (preparedNode.leafNodes.begin(), preparedNode.leafNodes.end(),
+               [] (auto pn1, auto pn2)
+               {
+                   return pn1->criticalPathPriority.load (std::memory_order_relaxed)
+                        > pn2->criticalPathPriority.load (std::memory_order_relaxed);
+               });
+}
+
+void LockFreeMultiThreadedNodePlayer::buildWorkerQueues (PreparedNode& preparedNode)
+{
+    preparedNode.workerQueues.clear();
+
+    if (schedulingStrategy != NodeSchedulingStrategy::workStealing)
+        return;
+
+    // One queue for the audio thread and one for each worker.
+    // Each Node is only queued once per block so this is the max any queue can hold
+    const auto numQueues = numThreadsToUse.load() + 1;
+    const auto capacity = preparedNode.graph->orderedNodes.size();
+    preparedNode.workerQueues.reserve (numQueues);
+
+    for (size_t i = 0; i < numQueues; ++i)
+        preparedNode.workerQueues.push_back (std::make_unique<WorkStealingDeque> (capacity));
 }
 
 void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedNode)
@@ -312,6 +474,16 @@ void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedN
             break;
     }
 
+    for (auto& queue : preparedNode.workerQueues)
+        queue->clear();
+
+    // Periodically measure the Node costs and then update the priorities from them on the next block
+    const auto blockNum = preparedNode.numBlocksProcessed++;
+    measureNodeCosts.store (blockNum % nodeCostMeasurementInterval == 0, std::memory_order_relaxed);
+
+    if (blockNum % nodeCostMeasurementInterval == 1)
+        updateCriticalPathPriorities (preparedNode);
+
     numNodesQueued.store (0, std::memory_order_release);
 
     // Reset all the counters
@@ -343,18 +515,35 @@ void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedN
    #endif
 
     size_t numNodesJustQueued = 0;
+    auto profiler = activeNodeProfiler.load (std::memory_order_relaxed);
+    const auto queueTimeNs = profiler != nullptr ? profiler->now() : 0;
 
-    // Make sure the counters are reset for all nodes before queueing any
-    for (auto& playbackNode : preparedNode.playbackNodes)
+    auto queueLeaf = [&] (PlaybackNode* playbackNode)
     {
         if (playbackNode->numInputsToBeProcessed.load (std::memory_order_acquire) == 0)
         {
             jassert (! playbackNode->hasBeenQueued);
             playbackNode->hasBeenQueued = true;
-            preparedNode.nodesReadyToBeProcessed->try_enqueue (&playbackNode->node);
+            playbackNode->readyTimeNs.store (queueTimeNs, std::memory_order_relaxed);
+
+            // With work stealing, the leaf Nodes start on the audio thread's queue and
+            // get stolen from the top by the workers
+            if (preparedNode.workerQueues.empty()
+                || ! preparedNode.workerQueues[audioThreadWorkerIndex]->push (&playbackNode->node))
+                preparedNode.nodesReadyToBeProcessed->try_enqueue (&playbackNode->node);
+
             ++numNodesJustQueued;
         }
-    }
+    };
+
+    // Make sure the counters are reset for all nodes before queueing any.
+    // The leaves are sorted by priority so the longest chains get started first.
+    // The shared queue is FIFO but the audio thread pops the most recently pushed
+    // Node from its own queue so they have to be pushed there in reverse
+    if (preparedNode.workerQueues.empty())
+        std::for_each (preparedNode.leafNodes.begin(), preparedNode.leafNodes.end(), queueLeaf);
+    else
+        std::for_each (preparedNode.leafNodes.rbegin(), preparedNode.leafNodes.rend(), queueLeaf);
 
     // Make sure this is only incremented after all the nodes have been queued
     // or the threads will start queueing Nodes at the same time
@@ -366,76 +555,151 @@ void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedN
         threadPool->signal (numThreadsToSignal);
 }
 
-Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode& preparedNode, Node& node)
+Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode& preparedNode, Node& node, size_t workerIndex)
 {
     auto playbackNode = static_cast<PlaybackNode*> (node.internal);
 
-   #if RETURN_MID_NODES_OPTIMISATION
-    Node* nodeToReturn = nullptr;
-   #endif
+    const auto& outputs = *playbackNode->sortedOutputs.load (std::memory_order_acquire);
 
-    for (auto output : playbackNode->outputs)
+    // fetch_sub returns the previous value so if it was 1 the output is now ready
+    auto setInputProcessed = [this] (Node* output)
     {
         auto outputPlaybackNode = static_cast<PlaybackNode*> (output->internal);
 
-        // fetch_sub returns the previous value so it will now be 0
-        if (outputPlaybackNode->numInputsToBeProcessed.fetch_sub (1, std::memory_order_acq_rel) == 1)
+        if (outputPlaybackNode->numInputsToBeProcessed.fetch_sub (1, std::memory_order_acq_rel) != 1)
+            return false;
+
+        jassert (outputPlaybackNode->node.isReadyToProcess());
+        jassert (! outputPlaybackNode->hasBeenQueued);
+        outputPlaybackNode->hasBeenQueued = true;
+
+        if (auto profiler = activeNodeProfiler.load (std::memory_order_relaxed))
+            outputPlaybackNode->readyTimeNs.store (profiler->now(), std::memory_order_relaxed);
+
+        return true;
+    };
+
+   #if RETURN_MID_NODES_OPTIMISATION
+    // We can return one Node to be processed on this thread, otherwise we can
+    // queue it for another thread to possibly process.
+    // The outputs are sorted most critical first so that's the one that gets returned.
+    // This thread's own work-stealing queue pops the most recently pushed Node first
+    // so if we're using that, the others are visited and pushed in reverse
+    Node* nodeToReturn = nullptr;
+
+    if (workerIndex < preparedNode.workerQueues.size())
+    {
+        for (auto iter = outputs.rbegin(); iter != outputs.rend(); ++iter)
         {
-            jassert (outputPlaybackNode->node.isReadyToProcess());
-            jassert (! outputPlaybackNode->hasBeenQueued);
-            outputPlaybackNode->hasBeenQueued = true;
-
-           #if RETURN_MID_NODES_OPTIMISATION
-            // We can return one Node to be processed on this thread, otherwise we can
-            // queue it for another thread to possibly process
-            if (nodeToReturn == nullptr)
+            if (setInputProcessed (*iter))
             {
-                nodeToReturn = &outputPlaybackNode->node;
+                if (nodeToReturn != nullptr)
+                    queueNode (preparedNode, *nodeToReturn, workerIndex);
+
+                nodeToReturn = *iter;
             }
-            else
+        }
+    }
+    else
+    {
+        for (auto output : outputs)
+        {
+            if (setInputProcessed (output))
             {
-                preparedNode.nodesReadyToBeProcessed->try_enqueue (&outputPlaybackNode->node);
-                numNodesQueued.fetch_add (1, std::memory_order_acq_rel);
+                if (nodeToReturn == nullptr)
+                    nodeToReturn = output;
+                else
+                    queueNode (preparedNode, *output, workerIndex);
             }
-           #else
-            // If there is only one Node or we're at the last Node we can return this to be processed by the same thread
-            if (playbackNode->outputs.size() == 1
-                || output == playbackNode->outputs.back())
-                return &outputPlaybackNode->node;
-
-            preparedNode.nodesReadyToBeProcessed->try_enqueue (&outputPlaybackNode->node);
-            numNodesQueued.fetch_add (1, std::memory_order_acq_rel);
-           #endif
         }
     }
 
-   #if RETURN_MID_NODES_OPTIMISATION
     return nodeToReturn;
    #else
+    for (auto output : outputs)
+    {
+        if (setInputProcessed (output))
+        {
+            // If there is only one Node or we're at the last Node we can return this to be processed by the same thread
+            if (outputs.size() == 1 || output == outputs.back())
+                return output;
+
+            queueNode (preparedNode, *output, workerIndex);
+        }
+    }
+
     return nullptr;
    #endif
 }
 
-//==============================================================================
-bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& preparedNode)
+void LockFreeMultiThreadedNodePlayer::queueNode (PreparedNode& preparedNode, Node& node, size_t workerIndex)
+{
+    // Keep the Node on this thread's own queue so its input data is still in cache
+    // when it gets popped. Threads without a queue fall back to the shared one
+    if (workerIndex >= preparedNode.workerQueues.size()
+        || ! preparedNode.workerQueues[workerIndex]->push (&node))
+        preparedNode.nodesReadyToBeProcessed->try_enqueue (&node);
+
+    numNodesQueued.fetch_add (1, std::memory_order_acq_rel);
+}
+
+Node* LockFreeMultiThreadedNodePlayer::dequeueNode (PreparedNode& preparedNode, size_t workerIndex)
 {
     Node* nodeToProcess = nullptr;
+    const auto numQueues = preparedNode.workerQueues.size();
+
+    if (numQueues == 0)
+    {
+        preparedNode.nodesReadyToBeProcessed->try_dequeue (nodeToProcess);
+        return nodeToProcess;
+    }
+
+    // First try our own queue, LIFO to keep the most recently touched Node local
+    if (workerIndex < numQueues)
+        if (auto n = preparedNode.workerQueues[workerIndex]->pop())
+            return n;
+
+    // Then anything that overflowed to the shared queue
+    if (preparedNode.nodesReadyToBeProcessed->try_dequeue (nodeToProcess))
+        return nodeToProcess;
+
+    // Finally try and steal from the other threads, starting with our neighbour
+    // so all the thieves don't contend on the same queue
+    const auto startIndex = workerIndex < numQueues ? workerIndex + 1 : 0;
+
+    for (size_t i = 0; i < numQueues; ++i)
+    {
+        const auto victimIndex = (startIndex + i) % numQueues;
 
+        if (victimIndex == workerIndex)
+            continue;
+
+        if (auto n = preparedNode.workerQueues[victimIndex]->steal())
+            return n;
+    }
+
+    return nullptr;
+}
+
+//==============================================================================
+bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& preparedNode, size_t workerIndex)
+{
     if (numNodesQueued.load (std::memory_order_acquire) == 0)
         return false;
 
-    if (! preparedNode.nodesReadyToBeProcessed->try_dequeue (nodeToProcess))
+    auto nodeToProcess = dequeueNode (preparedNode, workerIndex);
+
+    if (nodeToProcess == nullptr)
         return false;
 
     numNodesQueued.fetch_sub (1, std::memory_order_acq_rel);
 
-    assert (nodeToProcess != nullptr);
-    processNode (preparedNode, *nodeToProcess);
+    processNode (preparedNode, *nodeToProcess, workerIndex);
 
     return true;
 }
 
-void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, Node& node)
+void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, Node& node, size_t workerIndex)
 {
     auto* nodeToProcess = &node;
 
@@ -449,12 +713,52 @@ void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, N
         #endif
 
         // Process Node
-        nodeToProcess->process (numSamplesToProcess, referenceSampleRange);
-        nodeToProcess = updateProcessQueueForNode (preparedNode, *nodeToProcess);
+        processSingleNode (*nodeToProcess, workerIndex);
+        nodeToProcess = updateProcessQueueForNode (preparedNode, *nodeToProcess, workerIndex);
 
         if (! nodeToProcess)
             break;
     }
 }
 
+void LockFreeMultiThreadedNodePlayer::processSingleNode (Node& node, size_t workerIndex)
+{
+    const auto profiler = activeNodeProfiler.load (std::memory_order_relaxed);
+    const bool measureCost = measureNodeCosts.load (std::memory_order_relaxed);
+
+    if (profiler == nullptr && ! measureCost)
+    {
+        node.process (numSamplesToProcess, referenceSampleRange);
+        return;
+    }
+
+    auto playbackNode = static_cast<PlaybackNode*> (node.internal);
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto startNs = profiler != nullptr ? profiler->now() : 0;
+
+    node.process (numSamplesToProcess, referenceSampleRange);
+
+    if (measureCost)
+    {
+        const auto duration = std::chrono::duration<double> (std::chrono::steady_clock::now() - startTime).count();
+        const auto lastAverage = playbackNode->averageProcessSeconds.load (std::memory_order_relaxed);
+        playbackNode->averageProcessSeconds.store (lastAverage > 0.0 ? (lastAverage * 0.8) + (duration * 0.2) : duration,
+                                                   std::memory_order_relaxed);
+    }
+
+    if (profiler != nullptr)
+    {
+        NodeProfiler::Event e;
+        e.node = &node;
+        e.nodeTypeName = typeid (node).name();
+        e.nodeID = playbackNode->nodeID;
+        e.blockNumber = currentBlockNumber;
+        e.threadIndex = (uint32_t) std::min (workerIndex, (size_t) std::numeric_limits<uint32_t>::max());
+        e.readyNs = playbackNode->readyTimeNs.load (std::memory_order_relaxed);
+        e.startNs = startNs;
+        e.endNs = profiler->now();
+        profiler->addEvent (e);
+    }
+}
+
 }}
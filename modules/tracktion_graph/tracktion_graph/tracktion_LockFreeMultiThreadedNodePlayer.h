@@ -22,6 +22,17 @@
 namespace tracktion { inline namespace graph
 {
 
+//==============================================================================
+/**
+    Available strategies for handing out Nodes that are ready to be processed
+    to the threads in a LockFreeMultiThreadedNodePlayer.
+*/
+enum class NodeSchedulingStrategy
+{
+    sharedQueue,    /**< All threads push to and pop from a single MPMC queue. */
+    workStealing    /**< Each thread has its own deque and steals from the others when it runs dry. */
+};
+
 //==============================================================================
 //==============================================================================
 /**
@@ -50,28 +61,137 @@ private:
         std::unique_ptr<rigtorp::MPMCQueue<Type>> fifo;
     };
 
+    //==============================================================================
+    /**
+        A fixed capacity Chase-Lev deque.
+        Only the owning thread may call push and pop, which work LIFO on the bottom
+        of the deque. Any other thread may call steal which takes from the top.
+    */
+    class WorkStealingDeque
+    {
+    public:
+        WorkStealingDeque (size_t capacity)
+            : buffer (std::max (capacity, (size_t) 1))
+        {
+        }
+
+        /** Pushes an item on to the bottom of the deque. Owner thread only. */
+        bool push (Node* item)
+        {
+            const auto b = bottom.load (std::memory_order_relaxed);
+            const auto t = top.load (std::memory_order_acquire);
+
+            if (b - t >= (int64_t) buffer.size())
+                return false;
+
+            buffer[(size_t) b % buffer.size()].store (item, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_release);
+            bottom.store (b + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        /** Pops the most recently pushed item from the bottom of the deque. Owner thread only. */
+        Node* pop()
+        {
+            const auto b = bottom.load (std::memory_order_relaxed) - 1;
+            bottom.store (b, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+            auto t = top.load (std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom.store (b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            auto item = buffer[(size_t) b % buffer.size()].load (std::memory_order_relaxed);
+
+            if (t == b)
+            {
+                // Last item so race any thieves for it
+                if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    item = nullptr;
+
+                bottom.store (b + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        /** Steals the oldest item from the top of the deque. Any thread. */
+        Node* steal()
+        {
+            auto t = top.load (std::memory_order_acquire);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+            const auto b = bottom.load (std::memory_order_acquire);
+
+            if (t >= b)
+                return nullptr;
+
+            auto item = buffer[(size_t) t % buffer.size()].load (std::memory_order_relaxed);
+
+            if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return item;
+        }
+
+        /** Removes all the items. Any thread. */
+        void clear()
+        {
+            while (steal() != nullptr)
+            {}
+        }
+
+    private:
+        std::vector<std::atomic<Node*>> buffer;
+        alignas(64) std::atomic<int64_t> top { 0 };
+        alignas(64) std::atomic<int64_t> bottom { 0 };
+    };
+
     struct PlaybackNode
     {
         PlaybackNode (Node& n)
-            : node (n), numInputs (node.getDirectInputNodes().size())
+            : node (n), numInputs (node.getDirectInputNodes().size()),
+              nodeID (node.getNodeProperties().nodeID)
         {}
 
         Node& node;
         const size_t numInputs;
+        const size_t nodeID;
         std::vector<Node*> outputs;
+
+        // Two copies of the outputs ordered by criticalPathPriority, most critical first.
+        // The audio thread re-sorts the one that isn't in use and then publishes it so an
+        // order is never changed whilst another thread is iterating it
+        std::vector<Node*> outputsByPriority[2];
+        std::atomic<const std::vector<Node*>*> sortedOutputs { nullptr };
         std::atomic<size_t> numInputsToBeProcessed { 0 };
         std::atomic<bool> hasBeenQueued { true };
        #if JUCE_DEBUG
         std::atomic<bool> hasBeenDequeued { false };
        #endif
+
+        // Smoothed cost of processing this Node and the cost of the longest
+        // path from here to the root, used to order ready Nodes
+        std::atomic<double> averageProcessSeconds { 0.0 };
+        std::atomic<double> criticalPathPriority { 0.0 };
+
+        // When the Node became ready to process, only set when profiling
+        std::atomic<int64_t> readyTimeNs { 0 };
     };
 
     struct PreparedNode
     {
         std::unique_ptr<NodeGraph> graph;
         std::vector<std::unique_ptr<PlaybackNode>> playbackNodes;
+        std::vector<PlaybackNode*> leafNodes;
+        uint32_t numBlocksProcessed = 0;
         std::unique_ptr<LockFreeFifo<Node*>> nodesReadyToBeProcessed;
+        std::vector<std::unique_ptr<WorkStealingDeque>> workerQueues;
         std::unique_ptr<AudioBufferPool> audioBufferPool;
+        std::unique_ptr<AudioBufferArena> audioBufferArena;
     };
 
 public:
@@ -167,7 +287,21 @@ public:
         bool process()
         {
             if (auto cpn = currentPreparedNode.load())
-                return player.processNextFreeNode (*cpn);
+                return player.processNextFreeNode (*cpn, noWorkerIndex);
+
+            return false;
+        }
+
+        /** Process the next chain of Nodes from a specific worker thread.
+            The workerIndex should be unique to the calling thread and in the range
+            [0, numThreads) as passed to createThreads. This lets the player keep
+            Nodes local to a thread when the NodeSchedulingStrategy::workStealing is used.
+            @see process
+        */
+        bool process (size_t workerIndex)
+        {
+            if (auto cpn = currentPreparedNode.load())
+                return player.processNextFreeNode (*cpn, workerIndex + 1);
 
             return false;
         }
@@ -224,6 +358,16 @@ public:
         return rootNode;
     }
 
+    /** Returns the root Node that was processed by the last call to process.
+        This can be behind getNode as a newly set Node is only picked up at the
+        start of a block. It should only be called from the audio thread and
+        the returned Node should only be compared, never dereferenced.
+    */
+    Node* getLastProcessedNode() const
+    {
+        return lastProcessedNode.load (std::memory_order_relaxed);
+    }
+
     /** Process a block of the Node. */
     int process (const Node::ProcessContext&);
 
@@ -257,7 +401,58 @@ public:
     /* @internal. */
     void enableNodeMemorySharing (bool shouldBeEnabled);
 
+    /** Enables or disables planning all the Node output buffers up front.
+        When enabled, each Node's output is assigned a fixed region of a single
+        AudioBufferArena when a new Node is set, with regions shared between Nodes
+        that can't be live at the same time. This avoids the pool traffic of
+        enablePooledMemoryAllocations during processing and takes precedence over it.
+        N.B. this will re-prepare the current Node so there may be a gap in the audio.
+        @see node_player_utils::allocateStaticAudioBuffers
+    */
+    void enableStaticBufferAllocation (bool);
+
+    /** Returns the size in bytes of the last static buffer arena allocated, or 0 if
+        static buffer allocation isn't enabled.
+    */
+    size_t getStaticBufferArenaSize() const
+    {
+        return staticBufferArenaSize.load (std::memory_order_acquire);
+    }
+
+    /** Sets the strategy used to distribute ready Nodes between threads.
+        N.B. this will re-prepare the current Node so there may be a gap in the audio.
+    */
+    void setSchedulingStrategy (NodeSchedulingStrategy);
+
+    /** Returns the current scheduling strategy. */
+    NodeSchedulingStrategy getSchedulingStrategy() const
+    {
+        return schedulingStrategy;
+    }
+
+    //==============================================================================
+    /** Sets a NodeProfiler to add per-Node events to whilst it is enabled.
+        The profiler must outlive this player or be removed by passing nullptr.
+        This waits for any current block to finish so the old profiler can be
+        safely deleted after it returns.
+    */
+    void setNodeProfiler (NodeProfiler* profilerToUse)
+    {
+        const std::scoped_lock<RealTimeSpinLock> sl (processMutex);
+        nodeProfiler.store (profilerToUse, std::memory_order_release);
+    }
+
+    /** Returns the NodeProfiler previously set. */
+    NodeProfiler* getNodeProfiler() const
+    {
+        return nodeProfiler.load (std::memory_order_acquire);
+    }
+
 private:
+    //==============================================================================
+    static constexpr size_t noWorkerIndex = std::numeric_limits<size_t>::max();
+    static constexpr size_t audioThreadWorkerIndex = 0;
+
     //==============================================================================
     std::atomic<size_t> numThreadsToUse { std::max ((size_t) 0, (size_t) std::thread::hardware_concurrency() - 1) };
     juce::Range<int64_t> referenceSampleRange;
@@ -270,15 +465,21 @@ private:
 
     LockFreeObject<PreparedNode> preparedNodeObject;
     Node* rootNode = nullptr;
+    std::atomic<Node*> lastProcessedNode { nullptr };
     NodeGraph* lastGraphPosted = nullptr;
     AudioBufferPool* lastAudioBufferPoolPosted = nullptr;
 
     std::atomic<size_t> numNodesQueued { 0 };
+    std::atomic<bool> measureNodeCosts { false };
+    std::atomic<NodeProfiler*> nodeProfiler { nullptr }, activeNodeProfiler { nullptr };
+    uint64_t currentBlockNumber = 0;
 
     //==============================================================================
     std::atomic<double> sampleRate { 44100.0 };
     std::atomic<int> blockSize { 512 };
-    bool nodeMemorySharingEnabled = false;
+    bool nodeMemorySharingEnabled = false, staticBufferAllocationEnabled = false;
+    std::atomic<size_t> staticBufferArenaSize { 0 };
+    NodeSchedulingStrategy schedulingStrategy = NodeSchedulingStrategy::sharedQueue;
 
     //==============================================================================
     /** Prepares a specific Node to be played and returns all the Nodes. */
@@ -286,6 +487,11 @@ private:
                                               double sampleRateToUse, int blockSizeToUse,
                                               bool useCurrentAudioBufferPool);
 
+    /** Re-prepares and posts the current Node, even if the sample rate and block size haven't changed.
+        This is used when an option that the prepared graph depends on is changed.
+    */
+    void rePrepareCurrentNode (double sampleRateToUse, int blockSizeToUse);
+
     //==============================================================================
     void clearThreads();
     void createThreads();
@@ -296,12 +502,17 @@ private:
 
     //==============================================================================
     static void buildNodesOutputLists (PreparedNode&);
+    static void updateCriticalPathPriorities (PreparedNode&);
+    void buildWorkerQueues (PreparedNode&);
     void resetProcessQueue (PreparedNode&);
-    Node* updateProcessQueueForNode (PreparedNode&, Node&);
-    void processNode (PreparedNode&, Node&);
+    Node* updateProcessQueueForNode (PreparedNode&, Node&, size_t workerIndex);
+    void processNode (PreparedNode&, Node&, size_t workerIndex);
+    void processSingleNode (Node&, size_t workerIndex);
+    void queueNode (PreparedNode&, Node&, size_t workerIndex);
+    Node* dequeueNode (PreparedNode&, size_t workerIndex);
 
     //==============================================================================
-    bool processNextFreeNode (PreparedNode&);
+    bool processNextFreeNode (PreparedNode&, size_t workerIndex);
 };
 
 }}
@@ -0,0 +1,518 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SCHEDULING
+ #include "../../tracktion_core/utilities/tracktion_Benchmark.h"
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_SCHEDULING || (TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SCHEDULING)
+
+namespace scheduling_test_utilities
+{
+    /** Creates a graph of numLeaves sin Nodes, each with a gain applied, summed in to a single output. */
+    inline std::unique_ptr<Node> createWideGraph (int numLeaves)
+    {
+        std::vector<std::unique_ptr<Node>> nodes;
+
+        for (int i = 0; i < numLeaves; ++i)
+            nodes.push_back (makeGainNode (std::make_unique<SinNode> (110.0f + (float) i, 2, (size_t) i + 1), 1.0f / (float) numLeaves));
+
+        return std::make_unique<BasicSummingNode> (std::move (nodes));
+    }
+
+    /** Creates a graph of numChains serial chains of Nodes, each chainLength long, summed in to a single output. */
+    inline std::unique_ptr<Node> createDeepGraph (int numChains, int chainLength)
+    {
+        std::vector<std::unique_ptr<Node>> nodes;
+
+        for (int i = 0; i < numChains; ++i)
+        {
+            std::unique_ptr<Node> node = std::make_unique<SinNode> (110.0f + (float) i, 2);
+
+            for (int j = 0; j < chainLength; ++j)
+                node = makeNode<FunctionNode> (std::move (node), [] (float s) { return std::tanh (s * 1.01f); });
+
+            nodes.push_back (makeGainNode (std::move (node), 1.0f / (float) numChains));
+        }
+
+        return std::make_unique<BasicSummingNode> (std::move (nodes));
+    }
+
+    inline std::unique_ptr<LockFreeMultiThreadedNodePlayer> createPlayer (ThreadPoolStrategy poolType,
+                                                                         NodeSchedulingStrategy schedulingStrategy,
+                                                                         size_t numThreads)
+    {
+        auto player = std::make_unique<LockFreeMultiThreadedNodePlayer> (getPoolCreatorFunction (poolType));
+        player->setNumThreads (numThreads);
+
+        player->setSchedulingStrategy (schedulingStrategy);
+
+        return player;
+    }
+}
+
+#endif
+
+#if GRAPH_UNIT_TESTS_SCHEDULING
+
+using namespace test_utilities;
+
+//==============================================================================
+//==============================================================================
+class NodeSchedulingTests : public juce::UnitTest
+{
+public:
+    NodeSchedulingTests()
+        : juce::UnitTest ("NodeScheduling", "tracktion_graph")
+    {
+    }
+
+    void runTest() override
+    {
+        for (auto setup : getTestSetups (*this))
+        {
+            logMessage (juce::String ("Test setup: sample rate SR, block size BS, random blocks RND")
+                        .replace ("SR", juce::String (setup.sampleRate))
+                        .replace ("BS", juce::String (setup.blockSize))
+                        .replace ("RND", setup.randomiseBlockSizes ? "Y" : "N"));
+
+            runSchedulingTests ("Wide graph", setup, [] { return scheduling_test_utilities::createWideGraph (64); });
+            runSchedulingTests ("Deep graph", setup, [] { return scheduling_test_utilities::createDeepGraph (4, 16); });
+        }
+
+        runProfilerTests();
+        runPriorityTests();
+    }
+
+private:
+    //==============================================================================
+    /** Adds its ID to a list when it's processed so the scheduling order can be checked.
+        The inputs aren't owned so a Node can feed more than one output.
+    */
+    class OrderRecordingNode final  : public Node
+    {
+    public:
+        OrderRecordingNode (int idToUse, std::vector<Node*> inputsToUse, std::vector<int>& orderToAddTo,
+                            std::chrono::microseconds processTimeToUse = {})
+            : id (idToUse), inputs (std::move (inputsToUse)), processOrder (orderToAddTo), processTime (processTimeToUse)
+        {
+        }
+
+        std::vector<Node*> getDirectInputNodes() override      { return inputs; }
+        bool isReadyToProcess() override
+        {
+            return std::all_of (inputs.begin(), inputs.end(), [] (auto n) { return n->hasProcessed(); });
+        }
+
+        NodeProperties getNodeProperties() override
+        {
+            NodeProperties props;
+            props.hasAudio = false;
+            props.hasMidi = false;
+            props.numberOfChannels = 0;
+            return props;
+        }
+
+        void process (ProcessContext&) override
+        {
+            if (processTime.count() > 0)
+                std::this_thread::sleep_for (processTime);
+
+            processOrder.push_back (id);
+        }
+
+    private:
+        const int id;
+        const std::vector<Node*> inputs;
+        std::vector<int>& processOrder;
+        const std::chrono::microseconds processTime;
+    };
+
+    /** Passes its input through and counts the number of times it's been prepared. */
+    class PrepareCountingNode final  : public Node
+    {
+    public:
+        PrepareCountingNode (std::unique_ptr<Node> inputToUse, int& numTimesPreparedToUse)
+            : input (std::move (inputToUse)), numTimesPrepared (numTimesPreparedToUse)
+        {
+        }
+
+        std::vector<Node*> getDirectInputNodes() override      { return { input.get() }; }
+        bool isReadyToProcess() override                        { return input->hasProcessed(); }
+        void prepareToPlay (const PlaybackInitialisationInfo&) override { ++numTimesPrepared; }
+
+        NodeProperties getNodeProperties() override
+        {
+            auto props = input->getNodeProperties();
+            constexpr size_t prepareCountingNodeMagicHash = 0x70726570617265;
+            hash_combine (props.nodeID, prepareCountingNodeMagicHash);
+            return props;
+        }
+
+        void process (ProcessContext& pc) override
+        {
+            auto inputBuffers = input->getProcessedOutput();
+            copy (pc.buffers.audio, inputBuffers.audio);
+        }
+
+    private:
+        const std::unique_ptr<Node> input;
+        int& numTimesPrepared;
+    };
+
+    /** Owns a set of OrderRecordingNodes, the last one added being the root. */
+    class OrderRecordingGraph final  : public Node
+    {
+    public:
+        OrderRecordingGraph (std::vector<std::unique_ptr<Node>> nodesToOwn)
+            : nodes (std::move (nodesToOwn))
+        {
+        }
+
+        std::vector<Node*> getDirectInputNodes() override      { return { nodes.back().get() }; }
+        bool isReadyToProcess() override                        { return nodes.back()->hasProcessed(); }
+        NodeProperties getNodeProperties() override             { return nodes.back()->getNodeProperties(); }
+        void process (ProcessContext&) override                 {}
+
+    private:
+        std::vector<std::unique_ptr<Node>> nodes;
+    };
+
+    /** A pool without any threads so the audio thread processes every Node in the
+        order the player hands them out, even though the player thinks it's multi-threaded.
+    */
+    struct NoThreadsPool  : public LockFreeMultiThreadedNodePlayer::ThreadPool
+    {
+        using LockFreeMultiThreadedNodePlayer::ThreadPool::ThreadPool;
+
+        void createThreads (size_t, juce::AudioWorkgroup) override  {}
+        void clearThreads() override                                {}
+        void signalOne() override                                   {}
+        void signal (int) override                                  {}
+        void signalAll() override                                   {}
+        void waitForFinalNode() override                            { std::this_thread::yield(); }
+    };
+
+    /** Processes a graph for a number of blocks, returning the order the Nodes were processed in for each one. */
+    std::vector<std::vector<int>> getProcessOrders (NodeSchedulingStrategy strategy, int numBlocks,
+                                                    std::function<std::unique_ptr<Node> (std::vector<int>&)> createGraph)
+    {
+        std::vector<int> order;
+        std::vector<std::vector<int>> orders;
+        TestSetup testSetup;
+
+        auto player = std::make_unique<LockFreeMultiThreadedNodePlayer> ([] (auto& p) { return std::make_unique<NoThreadsPool> (p); });
+        player->setNumThreads (1);
+        player->setSchedulingStrategy (strategy);
+
+        TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), testSetup, 2, 1.0, false);
+        testProcess.setNode (createGraph (order));
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            order.clear();
+            testProcess.process (testSetup.blockSize);
+            orders.push_back (order);
+        }
+
+        return orders;
+    }
+
+    void runPriorityTests()
+    {
+        for (auto strategy : getNodeSchedulingStrategies())
+        {
+            beginTest ("Leaves are started in priority order: " + getName (strategy));
+            {
+                // Three chains of 1, 3 and 2 Nodes summed in to a root.
+                // The longest chains should be started first whatever order they're added in
+                auto orders = getProcessOrders (strategy, 1, [] (auto& order)
+                {
+                    std::vector<std::unique_ptr<Node>> nodes;
+                    auto add = [&] (int id, std::vector<Node*> inputs)
+                    {
+                        nodes.push_back (std::make_unique<OrderRecordingNode> (id, std::move (inputs), order));
+                        return nodes.back().get();
+                    };
+
+                    auto x1 = add (1, {});
+                    auto y3 = add (4, { add (3, { add (2, {}) }) });
+                    auto z2 = add (6, { add (5, {}) });
+                    add (0, { x1, y3, z2 });
+
+                    return std::make_unique<OrderRecordingGraph> (std::move (nodes));
+                });
+
+                expect (orders[0] == std::vector<int> ({ 2, 3, 4, 5, 6, 1, 0 }),
+                        "Leaves processed in the wrong order: " + toString (orders[0]));
+            }
+
+            beginTest ("Outputs are queued in priority order: " + getName (strategy));
+            {
+                // A single leaf feeding chains of 3, 2 and 1 Nodes. When it's been processed
+                // the thread should continue with the longest chain and queue the other two
+                // so that the next longest is dequeued first
+                auto orders = getProcessOrders (strategy, 1, [] (auto& order)
+                {
+                    std::vector<std::unique_ptr<Node>> nodes;
+                    auto add = [&] (int id, std::vector<Node*> inputs)
+                    {
+                        nodes.push_back (std::make_unique<OrderRecordingNode> (id, std::move (inputs), order));
+                        return nodes.back().get();
+                    };
+
+                    auto leaf = add (1, {});
+                    auto c = add (7, { leaf });
+                    auto b = add (6, { add (5, { leaf }) });
+                    auto a = add (4, { add (3, { add (2, { leaf }) }) });
+                    add (0, { c, b, a });
+
+                    return std::make_unique<OrderRecordingGraph> (std::move (nodes));
+                });
+
+                expect (orders[0] == std::vector<int> ({ 1, 2, 3, 4, 5, 6, 7, 0 }),
+                        "Outputs processed in the wrong order: " + toString (orders[0]));
+            }
+
+            beginTest ("Priorities follow measured costs: " + getName (strategy));
+            {
+                // A slow Node directly in to the root and a longer chain of fast ones.
+                // To start with the chain is prioritised by its depth but once the costs
+                // have been measured, the slow Node should be started first
+                auto orders = getProcessOrders (strategy, 3, [] (auto& order)
+                {
+                    std::vector<std::unique_ptr<Node>> nodes;
+                    auto add = [&] (int id, std::vector<Node*> inputs, std::chrono::microseconds processTime = {})
+                    {
+                        nodes.push_back (std::make_unique<OrderRecordingNode> (id, std::move (inputs), order, processTime));
+                        return nodes.back().get();
+                    };
+
+                    auto slow = add (1, {}, std::chrono::milliseconds (2));
+                    auto fast = add (5, { add (4, { add (3, { add (2, {}) }) }) });
+                    add (0, { slow, fast });
+
+                    return std::make_unique<OrderRecordingGraph> (std::move (nodes));
+                });
+
+                expect (orders[0] == std::vector<int> ({ 2, 3, 4, 5, 1, 0 }),
+                        "Unmeasured Nodes not ordered by depth: " + toString (orders[0]));
+                expect (orders[2] == std::vector<int> ({ 1, 2, 3, 4, 5, 0 }),
+                        "Measured Nodes not ordered by cost: " + toString (orders[2]));
+            }
+        }
+    }
+
+    static juce::String toString (const std::vector<int>& order)
+    {
+        juce::StringArray ids;
+
+        for (auto id : order)
+            ids.add (juce::String (id));
+
+        return ids.joinIntoString (", ");
+    }
+
+    void runSchedulingTests (juce::String name, TestSetup testSetup, std::function<std::unique_ptr<Node>()> createGraph)
+    {
+        const double durationInSeconds = 1.0;
+        const auto expected = createBasicTestContext (createGraph(), testSetup, 2, durationInSeconds);
+
+        for (auto strategy : getNodeSchedulingStrategies())
+        {
+            beginTest (name + ": " + getName (strategy));
+            {
+                TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (scheduling_test_utilities::createPlayer (ThreadPoolStrategy::lightweightSemHybrid, strategy, 3),
+                                                                          testSetup, 2, durationInSeconds, true);
+                testProcess.setNode (createGraph());
+                expect (testProcess.getNodePlayer().getSchedulingStrategy() == strategy);
+
+                auto result = testProcess.processAll();
+                expect (buffersAreEqual (result->buffer, expected->buffer), "Multi-threaded output does not match single threaded");
+            }
+
+            beginTest (name + ": switching to " + getName (strategy) + " when prepared");
+            {
+                const auto previousStrategy = strategy == NodeSchedulingStrategy::sharedQueue ? NodeSchedulingStrategy::workStealing
+                                                                                              : NodeSchedulingStrategy::sharedQueue;
+                TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (scheduling_test_utilities::createPlayer (ThreadPoolStrategy::lightweightSemHybrid, previousStrategy, 3),
+                                                                          testSetup, 2, durationInSeconds, true);
+                int numTimesPrepared = 0;
+                testProcess.setNode (std::make_unique<PrepareCountingNode> (createGraph(), numTimesPrepared));
+                expectEquals (numTimesPrepared, 1);
+
+                // The sample rate and block size are the same but the graph still needs re-preparing
+                testProcess.getNodePlayer().setSchedulingStrategy (strategy);
+                expect (testProcess.getNodePlayer().getSchedulingStrategy() == strategy);
+                expectEquals (numTimesPrepared, 2);
+
+                auto result = testProcess.processAll();
+                expect (buffersAreEqual (result->buffer, expected->buffer), "Output does not match after switching strategy");
+            }
+        }
+    }
+
+    void runProfilerTests()
+    {
+        const int numLeaves = 8;
+        const auto numNodes = (size_t) (numLeaves * 2 + 1);
+        TestSetup testSetup;
+        testSetup.blockSize = 256;
+
+        for (size_t numThreads : { (size_t) 0, (size_t) 3 })
+        {
+            beginTest ("Node profiler: " + juce::String ((int) numThreads) + " threads");
+            {
+                NodeProfiler profiler;
+                TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (scheduling_test_utilities::createPlayer (ThreadPoolStrategy::lightweightSemHybrid,
+                                                                                                                  NodeSchedulingStrategy::workStealing, numThreads),
+                                                                          testSetup, 2, 1.0, false);
+                testProcess.getNodePlayer().setNodeProfiler (&profiler);
+                testProcess.setNode (scheduling_test_utilities::createWideGraph (numLeaves));
+
+                const int numBlocks = 16;
+
+                for (int i = 0; i < numBlocks; ++i)
+                    testProcess.process (testSetup.blockSize);
+
+                expectEquals (profiler.getEvents().size(), (size_t) 0, "Events added whilst disabled");
+
+                profiler.setEnabled (true);
+
+                for (int i = 0; i < numBlocks; ++i)
+                    testProcess.process (testSetup.blockSize);
+
+                profiler.setEnabled (false);
+
+                const auto events = profiler.getEvents();
+                const auto numBlockEvents = (size_t) std::count_if (events.begin(), events.end(), [] (auto& e) { return e.isBlock(); });
+                expectEquals (numBlockEvents, (size_t) numBlocks);
+                expectEquals (profiler.getNumEventsDropped(), (uint64_t) 0);
+                expectEquals (events.size(), numBlockEvents * (numNodes + 1));
+
+                for (auto& e : events)
+                {
+                    expect (e.endNs >= e.startNs);
+
+                    if (! e.isBlock())
+                        expect (e.startNs >= e.readyNs);
+                }
+
+                const auto stats = profiler.getNodeStatistics();
+                expectEquals (stats.size(), numNodes);
+
+                for (auto& s : stats)
+                {
+                    expect (s.nodeTypeName.find ("tracktion") != std::string::npos, "Type name not demangled");
+                    expectEquals (s.processTime.numRuns, (int64_t) numBlocks);
+                }
+
+                // Only the BasicSummingNode doesn't have an ID
+                expectEquals ((size_t) std::count_if (stats.begin(), stats.end(), [] (auto& s) { return s.nodeID != 0; }), numNodes - 1);
+
+                auto json = juce::JSON::parse (juce::String (profiler.toChromeTraceJSON()));
+                expectEquals (json["traceEvents"].size(), (int) events.size());
+
+                testProcess.getNodePlayer().setNodeProfiler (nullptr);
+            }
+        }
+
+        beginTest ("Node profiler: NodePlayer");
+        {
+            NodeProfiler profiler;
+            profiler.setEnabled (true);
+            TestProcess<NodePlayer> testProcess (std::make_unique<NodePlayer> (scheduling_test_utilities::createWideGraph (numLeaves)),
+                                                 testSetup, 2, 1.0, false);
+            testProcess.getNodePlayer().setNodeProfiler (&profiler);
+
+            const int numBlocks = 4;
+
+            for (int i = 0; i < numBlocks; ++i)
+                testProcess.process (testSetup.blockSize);
+
+            const auto stats = profiler.getNodeStatistics();
+            expectEquals (stats.size(), numNodes);
+            expectEquals ((size_t) std::count_if (stats.begin(), stats.end(), [] (auto& s) { return s.nodeID != 0; }), numNodes - 1);
+
+            for (auto& s : stats)
+                expectEquals (s.processTime.numRuns, (int64_t) numBlocks);
+
+            testProcess.getNodePlayer().setNodeProfiler (nullptr);
+        }
+    }
+};
+
+static NodeSchedulingTests nodeSchedulingTests;
+
+#endif
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SCHEDULING
+
+//==============================================================================
+//==============================================================================
+class NodeSchedulingBenchmarks : public juce::UnitTest
+{
+public:
+    NodeSchedulingBenchmarks()
+        : juce::UnitTest ("NodeScheduling", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        const auto numThreads = (size_t) std::max (1, (int) std::thread::hardware_concurrency() - 1);
+
+        for (int blockSize : { 64, 512 })
+        {
+            test_utilities::TestSetup ts;
+            ts.blockSize = blockSize;
+
+            runBenchmark ("Wide graph", "512 leaf Nodes", ts, numThreads,
+                          [] { return scheduling_test_utilities::createWideGraph (512); });
+            runBenchmark ("Deep graph", "16 chains of 64 Nodes", ts, numThreads,
+                          [] { return scheduling_test_utilities::createDeepGraph (16, 64); });
+        }
+    }
+
+private:
+    void runBenchmark (juce::String graphName, juce::String graphDescription,
+                       test_utilities::TestSetup ts, size_t numThreads,
+                       std::function<std::unique_ptr<Node>()> createGraph)
+    {
+        for (auto strategy : test_utilities::getNodeSchedulingStrategies())
+        {
+            const auto description = (graphDescription + ", " + test_utilities::getDescription (ts)
+                                       + ", " + juce::String ((int) numThreads) + " threads, "
+                                       + test_utilities::getName (strategy)).toStdString();
+
+            beginTest (graphName + ": " + description);
+
+            test_utilities::TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (scheduling_test_utilities::createPlayer (ThreadPoolStrategy::lightweightSemHybrid, strategy, numThreads),
+                                                                                      ts, 2, 10.0, false);
+            testProcess.setNode (createGraph());
+            testProcess.processAll();
+
+            BenchmarkList::getInstance().addResult (createBenchmarkResult (createBenchmarkDescription ("Node Scheduling",
+                                                                                                       graphName.toStdString(),
+                                                                                                       description),
+                                                                           testProcess.getStatisticsAndReset()));
+            expect (true);
+        }
+    }
+};
+
+static NodeSchedulingBenchmarks nodeSchedulingBenchmarks;
+
+#endif
+
+}}
@@ -125,6 +125,7 @@ struct NodeGraph
     std::unique_ptr<Node> rootNode;
     std::vector<Node*> orderedNodes;
     std::vector<NodeAndID> sortedNodes;
+    std::vector<size_t> orderedNodeIDs;     // The nodeID of each of the orderedNodes, set once they've been initialised
 };
 
 
@@ -319,6 +320,18 @@ public:
     */
     void release();
 
+    /** Sets a view for this Node to write its output to instead of allocating its own buffer.
+        This is used by players that plan the buffers of the whole graph up front and
+        must be called after initialise. The view must be the size of the Node's output
+        and outlive it.
+        You shouldn't normally need to call this unless your Node player has special
+        requirements.
+    */
+    void setStaticAudioBufferView (const choc::buffer::ChannelArrayView<float>&);
+
+    /** Returns the optimisations this Node has set. */
+    NodeOptimisations getOptimisations() const      { return nodeOptimisations; }
+
     //==============================================================================
     /** @internal */
     void* internal = nullptr;
@@ -380,6 +393,7 @@ private:
     tracktion_engine::MidiMessageArray midiBuffer;
     std::atomic<int> numSamplesProcessed { 0 }, retainCount { 0 };
     NodeOptimisations nodeOptimisations;
+    bool usesStaticAudioBuffer = false;
 
 
     std::vector<Node*> directInputNodes;
@@ -463,6 +477,10 @@ static inline std::vector<Node*> transformNodes (Node& rootNode)
 //==============================================================================
 inline void Node::initialise (const PlaybackInitialisationInfo& info)
 {
+    // Any previous static view will belong to an old graph
+    if (std::exchange (usesStaticAudioBuffer, false))
+        allocatedView = {};
+
     prepareToPlay (info);
 
     auto props = getNodeProperties();
@@ -522,7 +540,11 @@ inline void Node::process (choc::buffer::FrameCount numSamples, juce::Range<int6
 
     if (nodeOptimisations.clear == ClearBuffers::yes)
     {
-        audioBuffer.clear();
+        if (usesStaticAudioBuffer)
+            allocatedView.clear();
+        else
+            audioBuffer.clear();
+
         midiBuffer.clear();
     }
 
@@ -596,6 +618,18 @@ inline size_t Node::getAllocatedBytes() const
         + (size_t (midiBuffer.size()) * sizeof (tracktion_engine::MidiMessageArray::MidiMessageWithSource));
 }
 
+inline void Node::setStaticAudioBufferView (const choc::buffer::ChannelArrayView<float>& view)
+{
+    jassert (! allocateAudioBuffer);
+    jassert (nodeOptimisations.allocate == AllocateAudioBuffer::yes);
+    jassert (view.getSize() == audioBufferSize);
+
+    // The view replaces the internal buffer so free it to keep the working set down
+    audioBuffer = {};
+    allocatedView = view;
+    usesStaticAudioBuffer = true;
+}
+
 inline void Node::setOptimisations (NodeOptimisations newOptimisations)
 {
     nodeOptimisations = newOptimisations;
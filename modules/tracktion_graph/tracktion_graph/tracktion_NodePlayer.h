@@ -117,13 +117,24 @@ public:
 
     int processPostorderedNodes (NodeGraph& graphToProcess, const Node::ProcessContext& pc)
     {
-        return processPostorderedNodesSingleThreaded (graphToProcess, pc);
+        auto profiler = nodeProfiler.load (std::memory_order_acquire);
+        return processPostorderedNodesSingleThreaded (graphToProcess, pc,
+                                                      profiler != nullptr && profiler->isEnabled() ? profiler : nullptr);
+    }
+
+    /** Sets a NodeProfiler to add per-Node events to whilst it is enabled.
+        The profiler must outlive this player or be removed by passing nullptr.
+    */
+    void setNodeProfiler (NodeProfiler* profilerToUse)
+    {
+        nodeProfiler.store (profilerToUse, std::memory_order_release);
     }
 
 protected:
     std::unique_ptr<Node> input;
     std::unique_ptr<NodeGraph> nodeGraph;
     PlayHeadState* playHeadState = nullptr;
+    std::atomic<NodeProfiler*> nodeProfiler { nullptr };
 
     double sampleRate = 0.0;
     int blockSize = 0;
@@ -180,9 +191,14 @@ protected:
 
     /** Processes a group of Nodes assuming a postordering VertexOrdering.
         If these conditions are met the Nodes should be processed in a single loop iteration.
+        If a NodeProfiler is passed, an Event will be added for each Node and the block.
     */
-    static int processPostorderedNodesSingleThreaded (NodeGraph& nodeGraph, const Node::ProcessContext& pc)
+    static int processPostorderedNodesSingleThreaded (NodeGraph& nodeGraph, const Node::ProcessContext& pc,
+                                                      NodeProfiler* profiler = nullptr)
     {
+        const auto blockStartNs = profiler != nullptr ? profiler->now() : 0;
+        const auto blockNumber = profiler != nullptr ? profiler->getNextBlockNumber() : 0;
+
         for (auto node : nodeGraph.orderedNodes)
             node->prepareForNextBlock (pc.referenceSampleRange);
 
@@ -191,11 +207,29 @@ protected:
 
         for (;;)
         {
-            for (auto node : nodeGraph.orderedNodes)
+            for (size_t i = 0; i < nodeGraph.orderedNodes.size(); ++i)
             {
+                auto node = nodeGraph.orderedNodes[i];
+
                 if (! node->hasProcessed() && node->isReadyToProcess())
                 {
-                    node->process (pc.numSamples, pc.referenceSampleRange);
+                    if (profiler != nullptr)
+                    {
+                        NodeProfiler::Event e;
+                        e.node = node;
+                        e.nodeTypeName = typeid (*node).name();
+                        e.nodeID = i < nodeGraph.orderedNodeIDs.size() ? nodeGraph.orderedNodeIDs[i] : 0;
+                        e.blockNumber = blockNumber;
+                        e.startNs = e.readyNs = profiler->now();
+                        node->process (pc.numSamples, pc.referenceSampleRange);
+                        e.endNs = profiler->now();
+                        profiler->addEvent (e);
+                    }
+                    else
+                    {
+                        node->process (pc.numSamples, pc.referenceSampleRange);
+                    }
+
                     ++numNodesProcessed;
                 }
                 else
@@ -216,6 +250,16 @@ protected:
 
                 pc.buffers.midi.mergeFrom (output.midi);
 
+                if (profiler != nullptr)
+                {
+                    NodeProfiler::Event blockEvent;
+                    blockEvent.nodeTypeName = "Block";
+                    blockEvent.blockNumber = blockNumber;
+                    blockEvent.startNs = blockEvent.readyNs = blockStartNs;
+                    blockEvent.endNs = profiler->now();
+                    profiler->addEvent (blockEvent);
+                }
+
                 break;
             }
         }
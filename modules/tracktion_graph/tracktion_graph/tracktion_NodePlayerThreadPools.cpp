@@ -60,7 +60,7 @@ struct ThreadPoolCV : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -155,7 +155,7 @@ private:
         return shouldWait();
     }
 
-    void runThread()
+    void runThread (size_t workerIndex)
     {
         juce::WorkgroupToken token;
         workgroup.join (token);
@@ -165,7 +165,7 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! process (workerIndex))
                 wait();
         }
     }
@@ -195,7 +195,7 @@ struct ThreadPoolRT : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -259,7 +259,7 @@ private:
     std::vector<std::thread> threads;
     juce::AudioWorkgroup workgroup;
 
-    void runThread()
+    void runThread (size_t workerIndex)
     {
         juce::WorkgroupToken token;
         workgroup.join (token);
@@ -269,7 +269,7 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! process (workerIndex))
                 wait();
         }
     }
@@ -310,7 +310,7 @@ struct ThreadPoolHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -424,7 +424,7 @@ private:
         return shouldWait();
     }
 
-    void runThread()
+    void runThread (size_t workerIndex)
     {
         juce::WorkgroupToken token;
         workgroup.join (token);
@@ -434,7 +434,7 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! process (workerIndex))
                 wait();
         }
     }
@@ -466,7 +466,7 @@ struct ThreadPoolSem : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -531,7 +531,7 @@ private:
     std::unique_ptr<SemaphoreType> semaphore;
     juce::AudioWorkgroup workgroup;
 
-    void runThread()
+    void runThread (size_t workerIndex)
     {
         juce::WorkgroupToken token;
         workgroup.join (token);
@@ -541,7 +541,7 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! process (workerIndex))
                 wait();
         }
     }
@@ -573,7 +573,7 @@ struct ThreadPoolSemHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -663,7 +663,7 @@ private:
     std::unique_ptr<SemaphoreType> semaphore;
     juce::AudioWorkgroup workgroup;
 
-    void runThread()
+    void runThread (size_t workerIndex)
     {
         juce::WorkgroupToken token;
         workgroup.join (token);
@@ -675,7 +675,7 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! process (workerIndex))
                 wait();
         }
     }
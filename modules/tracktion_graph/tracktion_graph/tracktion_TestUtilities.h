@@ -235,6 +235,25 @@ namespace test_utilities
                  ThreadPoolStrategy::hybrid };
     }
 
+    /** Returns the name of a NodeSchedulingStrategy. */
+    inline juce::String getName (NodeSchedulingStrategy type)
+    {
+        switch (type)
+        {
+            case NodeSchedulingStrategy::sharedQueue:   return "sharedQueue";
+            case NodeSchedulingStrategy::workStealing:  return "workStealing";
+        }
+
+        jassertfalse;
+        return {};
+    }
+
+    inline std::vector<NodeSchedulingStrategy> getNodeSchedulingStrategies()
+    {
+        return { NodeSchedulingStrategy::sharedQueue,
+                 NodeSchedulingStrategy::workStealing };
+    }
+
     /** Logs the graph structure to the console. */
     inline void logGraph (Node& node)
     {
@@ -0,0 +1,174 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+/**
+    A single contiguous block of memory split in to fixed regions of audio channels.
+
+    Unlike the AudioBufferPool, the regions are all worked out up front so once
+    allocated, handing out a buffer is just returning a view of a region. There's
+    no allocation or pool traffic during processing and as all the buffers live
+    next to each other, the working set is as small as it can be.
+
+    Regions are intended to be shared between several users whose lifetimes
+    don't overlap. It's up to the caller to work out which users can share.
+    @see node_player_utils::allocateStaticAudioBuffers
+*/
+class AudioBufferArena
+{
+public:
+    /** Creates an empty arena. */
+    AudioBufferArena() = default;
+
+    //==============================================================================
+    /** Adds a region of a given size, returning its index.
+        The memory won't be allocated until allocate is called.
+    */
+    size_t addRegion (choc::buffer::Size);
+
+    /** Enlarges a region so it is at least the given size.
+        This must be called before allocate.
+    */
+    void growRegion (size_t regionIndex, choc::buffer::Size);
+
+    /** Returns the size of a region. */
+    choc::buffer::Size getRegionSize (size_t regionIndex) const;
+
+    /** Returns the number of regions that have been added. */
+    size_t getNumRegions() const                    { return regions.size(); }
+
+    //==============================================================================
+    /** Allocates the memory for all the regions.
+        This must be called before getView and will invalidate any previous views.
+    */
+    void allocate();
+
+    /** Returns a view of a region.
+        The size must fit in the region and the contents will be junk, so be sure
+        to clear or initialise it before use.
+        [[ real_time ]]
+    */
+    choc::buffer::ChannelArrayView<float> getView (size_t regionIndex, choc::buffer::Size) const;
+
+    /** Removes all the regions and frees the memory. */
+    void reset();
+
+    //==============================================================================
+    /** Returns the size of all the regions in bytes. */
+    size_t getAllocatedSize() const                 { return numSamplesAllocated * sizeof (float); }
+
+private:
+    //==============================================================================
+    struct Region
+    {
+        choc::buffer::Size size;
+        size_t firstChannel = 0;
+    };
+
+    static constexpr size_t alignmentNumSamples = 16; // 64 bytes
+
+    std::vector<Region> regions;
+    std::vector<float> samples;
+    std::vector<float*> channels;
+    size_t numSamplesAllocated = 0;
+};
+
+
+//==============================================================================
+//        _        _           _  _
+//     __| |  ___ | |_   __ _ (_)| | ___
+//    / _` | / _ \| __| / _` || || |/ __|
+//   | (_| ||  __/| |_ | (_| || || |\__ \ _  _  _
+//    \__,_| \___| \__| \__,_||_||_||___/(_)(_)(_)
+//
+//   Code beyond this point is implementation detail...
+//
+//==============================================================================
+inline size_t AudioBufferArena::addRegion (choc::buffer::Size size)
+{
+    regions.push_back ({ size, 0 });
+    return regions.size() - 1;
+}
+
+inline void AudioBufferArena::growRegion (size_t regionIndex, choc::buffer::Size size)
+{
+    jassert (regionIndex < regions.size());
+    auto& regionSize = regions[regionIndex].size;
+    regionSize = choc::buffer::Size::create (std::max (regionSize.numChannels, size.numChannels),
+                                             std::max (regionSize.numFrames, size.numFrames));
+}
+
+inline choc::buffer::Size AudioBufferArena::getRegionSize (size_t regionIndex) const
+{
+    jassert (regionIndex < regions.size());
+    return regions[regionIndex].size;
+}
+
+inline void AudioBufferArena::allocate()
+{
+    auto getChannelStride = [] (choc::buffer::FrameCount numFrames)
+    {
+        return ((size_t (numFrames) + alignmentNumSamples - 1) / alignmentNumSamples) * alignmentNumSamples;
+    };
+
+    size_t numChannels = 0;
+    numSamplesAllocated = 0;
+
+    for (auto& region : regions)
+    {
+        region.firstChannel = numChannels;
+        numChannels += region.size.numChannels;
+        numSamplesAllocated += region.size.numChannels * getChannelStride (region.size.numFrames);
+    }
+
+    // Over-allocate slightly so the first channel can be aligned
+    samples.assign (numSamplesAllocated + alignmentNumSamples, 0.0f);
+    channels.resize (numChannels);
+
+    auto data = samples.data();
+    data += (alignmentNumSamples - ((reinterpret_cast<uintptr_t> (data) / sizeof (float)) % alignmentNumSamples)) % alignmentNumSamples;
+
+    for (auto& region : regions)
+    {
+        const auto stride = getChannelStride (region.size.numFrames);
+
+        for (choc::buffer::ChannelCount i = 0; i < region.size.numChannels; ++i)
+        {
+            channels[region.firstChannel + i] = data;
+            data += stride;
+        }
+    }
+}
+
+inline choc::buffer::ChannelArrayView<float> AudioBufferArena::getView (size_t regionIndex, choc::buffer::Size size) const
+{
+    jassert (regionIndex < regions.size());
+    auto& region = regions[regionIndex];
+    jassert (size.numChannels <= region.size.numChannels);
+    jassert (size.numFrames <= region.size.numFrames);
+    jassert (region.firstChannel + region.size.numChannels <= channels.size());
+
+    return { { channels.data() + region.firstChannel, 0 }, size };
+}
+
+inline void AudioBufferArena::reset()
+{
+    regions.clear();
+    samples = {};
+    channels = {};
+    numSamplesAllocated = 0;
+}
+
+}}
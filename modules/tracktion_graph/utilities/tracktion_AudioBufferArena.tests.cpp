@@ -0,0 +1,217 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_AUDIOBUFFERARENA
+
+class AudioBufferArenaTests  : public juce::UnitTest
+{
+public:
+    AudioBufferArenaTests()
+        : juce::UnitTest ("AudioBufferArena", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runAllocationTests();
+        runStaticAllocationTests();
+
+        for (auto setup : test_utilities::getTestSetups (*this))
+            runPlayerTests (setup);
+    }
+
+private:
+    /** Creates a chain of stages, each summing two gain Nodes that both read the previous stage.
+        Each stage has a gain of 1 so the output should be the same as the sin.
+    */
+    static std::unique_ptr<Node> createStagedGraph (int numStages, int numChannels)
+    {
+        std::unique_ptr<Node> stage = std::make_unique<SinNode> (220.0f, numChannels);
+
+        for (int i = 0; i < numStages; ++i)
+        {
+            std::shared_ptr<Node> previousStage (std::move (stage));
+
+            std::vector<std::unique_ptr<Node>> nodes;
+            nodes.push_back (makeGainNode (std::make_unique<ForwardingNode> (previousStage), 0.5f));
+            nodes.push_back (makeGainNode (std::make_unique<ForwardingNode> (previousStage), 0.5f));
+            stage = std::make_unique<BasicSummingNode> (std::move (nodes));
+        }
+
+        return stage;
+    }
+
+    /** Creates two tracks, one sending to the other, summed together. */
+    static std::unique_ptr<Node> createSendReturnGraph()
+    {
+        auto track1Node = std::make_unique<SendNode> (makeGainNode (std::make_unique<SinNode> (220.0f), 0.25f), 1);
+        auto track2Node = std::make_unique<ReturnNode> (makeGainNode (std::make_unique<SinNode> (440.0f), 0.5f), 1);
+
+        return makeBaicSummingNode ({ track1Node.release(), track2Node.release() });
+    }
+
+    /** Creates a sin summed with two SilentNodes, which provide their own output buffers. */
+    static std::unique_ptr<Node> createSilentInputsGraph()
+    {
+        return makeBaicSummingNode ({ new SilentNode (2), new SinNode (220.0f, 2), new SilentNode (2) });
+    }
+
+    void runAllocationTests()
+    {
+        using namespace choc::buffer;
+
+        beginTest ("Allocation");
+        {
+            AudioBufferArena arena;
+            const auto mono = arena.addRegion (Size::create (1, 100));
+            const auto stereo = arena.addRegion (Size::create (2, 128));
+            expectEquals<int> ((int) arena.getNumRegions(), 2);
+
+            arena.growRegion (mono, Size::create (2, 128));
+            expect (arena.getRegionSize (mono) == Size::create (2, 128));
+
+            arena.allocate();
+            expectEquals<int> ((int) arena.getAllocatedSize(), (int) (4 * 128 * sizeof (float)));
+
+            auto monoView = arena.getView (mono, Size::create (1, 100));
+            auto stereoView = arena.getView (stereo, Size::create (2, 128));
+            expect (monoView.getSize() == Size::create (1, 100));
+            expect (stereoView.getSize() == Size::create (2, 128));
+
+            // Each channel should be aligned and none should overlap
+            std::vector<float*> channelPointers { monoView.getChannel (0).data.data,
+                                                  stereoView.getChannel (0).data.data,
+                                                  stereoView.getChannel (1).data.data };
+
+            for (auto c : channelPointers)
+                expectEquals<int> ((int) (reinterpret_cast<uintptr_t> (c) % 64), 0);
+
+            std::sort (channelPointers.begin(), channelPointers.end());
+
+            for (size_t i = 1; i < channelPointers.size(); ++i)
+                expect (channelPointers[i] - channelPointers[i - 1] >= 128);
+
+            arena.reset();
+            expectEquals<int> ((int) arena.getNumRegions(), 0);
+            expectEquals<int> ((int) arena.getAllocatedSize(), 0);
+        }
+    }
+
+    void runStaticAllocationTests()
+    {
+        beginTest ("Static allocation");
+        {
+            const int blockSize = 256, numStages = 32;
+            auto nodeGraph = node_player_utils::prepareToPlay (createStagedGraph (numStages, 2), nullptr, 44100.0, blockSize);
+            const auto numNodes = nodeGraph->orderedNodes.size();
+            expectEquals<int> ((int) numNodes, 1 + numStages * 5);
+
+            AudioBufferArena arena;
+            node_player_utils::allocateStaticAudioBuffers (nodeGraph->orderedNodes, nodeGraph->rootNode.get(), arena, blockSize);
+
+            // Only a couple of stages should be live at once so the number of regions
+            // shouldn't depend on the number of stages
+            expectGreaterThan ((int) arena.getNumRegions(), 0);
+            expectLessThan ((int) arena.getNumRegions(), 16);
+            expectLessThan ((int) arena.getAllocatedSize(), (int) (numNodes * 2 * blockSize * sizeof (float)) / 4);
+        }
+
+        beginTest ("Static allocation of a single chain");
+        {
+            // Each Node could pass on its input buffer so nothing can be shared
+            const int blockSize = 256, chainLength = 8;
+            std::unique_ptr<Node> node = std::make_unique<SinNode> (220.0f);
+
+            for (int i = 0; i < chainLength; ++i)
+                node = makeGainNode (std::move (node), 1.0f);
+
+            auto nodeGraph = node_player_utils::prepareToPlay (std::move (node), nullptr, 44100.0, blockSize);
+
+            AudioBufferArena arena;
+            node_player_utils::allocateStaticAudioBuffers (nodeGraph->orderedNodes, nodeGraph->rootNode.get(), arena, blockSize);
+            expectEquals<int> ((int) arena.getNumRegions(), chainLength + 1);
+        }
+
+        beginTest ("Static allocation of Nodes that don't allocate");
+        {
+            // Only the sin and summing Nodes should get a region
+            const int blockSize = 256;
+            auto nodeGraph = node_player_utils::prepareToPlay (createSilentInputsGraph(), nullptr, 44100.0, blockSize);
+            expectEquals<int> ((int) nodeGraph->orderedNodes.size(), 4);
+
+            AudioBufferArena arena;
+            node_player_utils::allocateStaticAudioBuffers (nodeGraph->orderedNodes, nodeGraph->rootNode.get(), arena, blockSize);
+            expectEquals<int> ((int) arena.getNumRegions(), 2);
+        }
+    }
+
+    void runPlayerTests (test_utilities::TestSetup testSetup)
+    {
+        runPlayerTest ("Staged graph", testSetup, [] { return createStagedGraph (16, 2); });
+        runPlayerTest ("Send/return graph", testSetup, [] { return createSendReturnGraph(); });
+        runPlayerTest ("Silent inputs graph", testSetup, [] { return createSilentInputsGraph(); });
+    }
+
+    void runPlayerTest (juce::String name, test_utilities::TestSetup testSetup, std::function<std::unique_ptr<Node>()> createGraph)
+    {
+        const double durationInSeconds = 1.0;
+        const auto expected = test_utilities::createBasicTestContext (createGraph(), testSetup, 2, durationInSeconds);
+
+        for (size_t numThreads : { (size_t) 0, (size_t) 3 })
+        {
+            for (auto strategy : test_utilities::getNodeSchedulingStrategies())
+            {
+                beginTest ("Static allocation: " + name + ", " + juce::String ((int) numThreads) + " threads, "
+                           + test_utilities::getName (strategy) + ", " + test_utilities::getDescription (testSetup));
+                {
+                    auto player = std::make_unique<LockFreeMultiThreadedNodePlayer> (getPoolCreatorFunction (ThreadPoolStrategy::lightweightSemHybrid));
+                    player->setNumThreads (numThreads);
+                    player->setSchedulingStrategy (strategy);
+                    player->enableStaticBufferAllocation (true);
+
+                    test_utilities::TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), testSetup, 2, durationInSeconds, true);
+                    testProcess.setNode (createGraph());
+                    expectGreaterThan ((int) testProcess.getNodePlayer().getStaticBufferArenaSize(), 0);
+
+                    auto result = testProcess.processAll();
+                    expect (test_utilities::buffersAreEqual (result->buffer, expected->buffer), "Static allocation output does not match");
+                }
+            }
+        }
+
+        beginTest ("Static allocation enabled when prepared: " + name + ", " + test_utilities::getDescription (testSetup));
+        {
+            auto player = std::make_unique<LockFreeMultiThreadedNodePlayer> (getPoolCreatorFunction (ThreadPoolStrategy::lightweightSemHybrid));
+            player->setNumThreads (3);
+
+            test_utilities::TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), testSetup, 2, durationInSeconds, true);
+            testProcess.setNode (createGraph());
+            expectEquals ((int) testProcess.getNodePlayer().getStaticBufferArenaSize(), 0);
+
+            // The sample rate and block size are the same but the graph still needs re-preparing
+            testProcess.getNodePlayer().enableStaticBufferAllocation (true);
+            expectGreaterThan ((int) testProcess.getNodePlayer().getStaticBufferArenaSize(), 0);
+
+            auto result = testProcess.processAll();
+            expect (test_utilities::buffersAreEqual (result->buffer, expected->buffer), "Static allocation output does not match");
+
+            testProcess.getNodePlayer().enableStaticBufferAllocation (false);
+            expectEquals ((int) testProcess.getNodePlayer().getStaticBufferArenaSize(), 0);
+        }
+    }
+};
+
+static AudioBufferArenaTests audioBufferArenaTests;
+
+#endif
+
+}} // namespace tracktion_engine
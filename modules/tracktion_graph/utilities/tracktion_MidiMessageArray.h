@@ -245,20 +245,30 @@ struct MidiMessageArray
             m.multiplyVelocity (factor);
     }
 
-    void sortByTimestamp()
+    /** The order messages are sorted in.
+        Messages are ordered by time, with note-offs (including note-ons with a
+        velocity of 0) before anything else at the same time so notes that end and
+        start together don't overlap. Other messages at the same time are equivalent
+        so keep their order in a stable sort.
+        N.B. this means a note-off is also moved before a controller or any other
+        message at the same time, not just before a note-on. Only swapping note-offs
+        and note-ons wouldn't be a strict weak ordering so couldn't be used to sort
+        or merge reliably.
+    */
+    static bool isEarlier (const juce::MidiMessage& a, const juce::MidiMessage& b) noexcept
     {
-        choc::sorting::stable_sort (messages.begin(), messages.end(), [] (const juce::MidiMessage& a, const juce::MidiMessage& b)
-        {
-            auto t1 = a.getTimeStamp();
-            auto t2 = b.getTimeStamp();
+        auto t1 = a.getTimeStamp();
+        auto t2 = b.getTimeStamp();
 
-            if (t1 == t2)
-            {
-                if (a.isNoteOff() && b.isNoteOn()) return true;
-                if (a.isNoteOn() && b.isNoteOff()) return false;
-            }
+        if (t1 != t2)
             return t1 < t2;
-        });
+
+        return a.isNoteOff() && ! b.isNoteOff();
+    }
+
+    void sortByTimestamp()
+    {
+        choc::sorting::stable_sort (messages.begin(), messages.end(), isEarlier);
     }
 
     void reserve (int size)
@@ -0,0 +1,148 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_MIDIMESSAGEARRAY
+
+class MidiMessageArrayTests  : public juce::UnitTest
+{
+public:
+    MidiMessageArrayTests()
+        : juce::UnitTest ("MidiMessageArray", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runSortTests();
+        runSummingNodeTests();
+    }
+
+private:
+    void runSortTests()
+    {
+        beginTest ("Sorting");
+        {
+            tracktion_engine::MidiMessageArray messages;
+            messages.addMidiMessage (juce::MidiMessage::noteOn (1, 62, 0.5f), 2.0, 0);
+            messages.addMidiMessage (juce::MidiMessage::controllerEvent (1, 7, 100), 1.0, 0);
+            messages.addMidiMessage (juce::MidiMessage::noteOn (1, 60, 0.5f), 1.0, 0);
+            messages.addMidiMessage (juce::MidiMessage::noteOff (1, 61), 1.0, 0);
+            messages.addMidiMessage (juce::MidiMessage::noteOn (1, 63, (juce::uint8) 0), 1.0, 0);
+            messages.addMidiMessage (juce::MidiMessage::programChange (1, 5), 0.5, 0);
+            messages.sortByTimestamp();
+
+            // Note-offs (including note-ons with 0 velocity) come before anything else
+            // at the same time and the others keep the order they were added in
+            expectEquals (messages.size(), 6);
+            expect (messages[0].isProgramChange());
+            expect (messages[1].isNoteOff() && messages[1].getNoteNumber() == 61);
+            expect (messages[2].isNoteOff() && messages[2].getNoteNumber() == 63);
+            expect (messages[3].isController());
+            expect (messages[4].isNoteOn() && messages[4].getNoteNumber() == 60);
+            expect (messages[5].getNoteNumber() == 62);
+        }
+
+        beginTest ("Note-offs before controllers");
+        {
+            // A note-off is moved before a controller at the same time, not only before note-ons
+            tracktion_engine::MidiMessageArray messages;
+            messages.addMidiMessage (juce::MidiMessage::controllerEvent (1, 64, 0), 1.0, 0);
+            messages.addMidiMessage (juce::MidiMessage::pitchWheel (1, 0), 1.0, 0);
+            messages.addMidiMessage (juce::MidiMessage::noteOff (1, 60), 1.0, 0);
+            messages.sortByTimestamp();
+
+            expect (messages[0].isNoteOff());
+            expect (messages[1].isController());
+            expect (messages[2].isPitchWheel());
+
+            const auto noteOff = juce::MidiMessage (juce::MidiMessage::noteOff (1, 60), 1.0);
+            const auto controller = juce::MidiMessage (juce::MidiMessage::controllerEvent (1, 64, 0), 1.0);
+            const auto noteOn = juce::MidiMessage (juce::MidiMessage::noteOn (1, 60, 0.5f), 1.0);
+            expect (tracktion_engine::MidiMessageArray::isEarlier (noteOff, controller));
+            expect (! tracktion_engine::MidiMessageArray::isEarlier (controller, noteOff));
+            expect (! tracktion_engine::MidiMessageArray::isEarlier (controller, noteOn));
+            expect (! tracktion_engine::MidiMessageArray::isEarlier (noteOn, controller));
+            expect (! tracktion_engine::MidiMessageArray::isEarlier (noteOff, noteOff));
+        }
+    }
+
+    void runSummingNodeTests()
+    {
+        beginTest ("SummingNode MIDI merging");
+        {
+            test_utilities::TestSetup testSetup;
+            testSetup.blockSize = 64;
+            const double durationInSeconds = 1.0;
+            const int numInputs = 8;
+
+            std::vector<std::unique_ptr<Node>> nodes;
+
+            for (int i = 0; i < numInputs; ++i)
+            {
+                juce::MidiMessageSequence sequence;
+
+                for (int n = 0; n < 20; ++n)
+                {
+                    const auto time = n * 0.05 + i * 0.001;
+                    sequence.addEvent (juce::MidiMessage::noteOn (1 + i, 60 + n, 0.5f), time);
+                    sequence.addEvent (juce::MidiMessage::noteOff (1 + i, 60 + n), time + 0.025);
+                }
+
+                nodes.push_back (std::make_unique<MidiNode> (std::move (sequence)));
+            }
+
+            auto testContext = test_utilities::createBasicTestContext (std::make_unique<SummingNode> (std::move (nodes)),
+                                                                       testSetup, 0, durationInSeconds);
+
+            // All the inputs have events in most blocks so these will be merged
+            expectEquals (testContext->midi.getNumEvents(), numInputs * 20 * 2);
+        }
+
+        beginTest ("SummingNode MIDI merging order");
+        {
+            test_utilities::TestSetup testSetup;
+            testSetup.blockSize = 64;
+
+            // Events at the same time on different inputs: the note-off should come first,
+            // then the others in the order of the inputs
+            juce::MidiMessageSequence first, second;
+            first.addEvent (juce::MidiMessage::noteOn (1, 60, 0.5f), 0.1);
+            first.addEvent (juce::MidiMessage::controllerEvent (1, 7, 100), 0.2);
+            second.addEvent (juce::MidiMessage::noteOff (2, 61), 0.2);
+            second.addEvent (juce::MidiMessage::controllerEvent (2, 7, 50), 0.2);
+
+            std::vector<std::unique_ptr<Node>> nodes;
+            nodes.push_back (std::make_unique<MidiNode> (std::move (first)));
+            nodes.push_back (std::make_unique<MidiNode> (std::move (second)));
+
+            auto testContext = test_utilities::createBasicTestContext (std::make_unique<SummingNode> (std::move (nodes)),
+                                                                       testSetup, 0, 0.5);
+            auto& midi = testContext->midi;
+
+            expectEquals (midi.getNumEvents(), 4);
+
+            if (midi.getNumEvents() == 4)
+            {
+                expect (midi.getEventPointer (0)->message.isNoteOn());
+                expect (midi.getEventPointer (1)->message.isNoteOff());
+                expectEquals (midi.getEventPointer (2)->message.getChannel(), 1);
+                expectEquals (midi.getEventPointer (3)->message.getChannel(), 2);
+            }
+        }
+    }
+};
+
+static MidiMessageArrayTests midiMessageArrayTests;
+
+#endif
+
+}} // namespace tracktion_engine
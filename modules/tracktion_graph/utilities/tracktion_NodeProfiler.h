@@ -0,0 +1,293 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <unordered_map>
+
+#if __has_include (<cxxabi.h>)
+ #include <cxxabi.h>
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+class Node;
+
+//==============================================================================
+//==============================================================================
+/**
+    Collects per-Node timing events from a node player.
+
+    Set one of these on a player (e.g. LockFreeMultiThreadedNodePlayer::setNodeProfiler)
+    and enable it. The player will then add an Event for every Node it processes
+    and one for each block. Adding events is lock-free and doesn't allocate so
+    can happen on the audio and worker threads. If the queue is full, events are
+    dropped and counted.
+
+    On a non-real-time thread, call collectEvents periodically to move the queued
+    events in to the history, which retains a fixed number of the most recent
+    events. These can then be summarised with getNodeStatistics or exported with
+    toChromeTraceJSON and loaded in to chrome://tracing or Perfetto.
+*/
+class NodeProfiler
+{
+public:
+    //==============================================================================
+    /** A single timed event. Times are in nanoseconds since the profiler was created. */
+    struct Event
+    {
+        const Node* node = nullptr;             /**< The Node processed, nullptr for block events. */
+        const char* nodeTypeName = nullptr;     /**< The typeid name of the Node, or "Block". @see demangle */
+        size_t nodeID = 0;                      /**< The Node's nodeID property, if known. */
+        uint64_t blockNumber = 0;               /**< The block this event happened in. */
+        uint32_t threadIndex = 0;               /**< 0 for the calling audio thread, 1+ for worker threads. */
+        int64_t readyNs = 0;                    /**< When the Node became ready to process. */
+        int64_t startNs = 0;                    /**< When processing started. */
+        int64_t endNs = 0;                      /**< When processing finished. */
+
+        /** Returns true if this is a block event rather than a Node event. */
+        bool isBlock() const noexcept           { return node == nullptr; }
+
+        /** Returns the time spent processing. */
+        double getProcessSeconds() const noexcept   { return (double) (endNs - startNs) * 1.0e-9; }
+
+        /** Returns the time between the Node being ready and a thread starting to process it. */
+        double getWaitSeconds() const noexcept      { return (double) std::max ((int64_t) 0, startNs - readyNs) * 1.0e-9; }
+    };
+
+    //==============================================================================
+    /** Creates a NodeProfiler.
+        @param maxNumQueuedEvents       the number of events that can be added between calls to collectEvents
+        @param maxNumRetainedEvents     the number of events kept in the history
+    */
+    NodeProfiler (size_t maxNumQueuedEvents = 65536, size_t maxNumRetainedEvents = 262144)
+        : queue (std::max (maxNumQueuedEvents, (size_t) 1)),
+          maxNumEventsToRetain (maxNumRetainedEvents)
+    {
+    }
+
+    //==============================================================================
+    /** Enables or disables profiling. Players won't add events whilst disabled. */
+    void setEnabled (bool shouldBeEnabled) noexcept
+    {
+        enabled.store (shouldBeEnabled, std::memory_order_release);
+    }
+
+    /** Returns true if profiling is enabled. */
+    bool isEnabled() const noexcept
+    {
+        return enabled.load (std::memory_order_acquire);
+    }
+
+    /** Returns the current time in nanoseconds since the profiler was created. [[ real_time ]] */
+    int64_t now() const noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    /** Returns the next block number to use. [[ real_time ]] */
+    uint64_t getNextBlockNumber() noexcept
+    {
+        return nextBlockNumber.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    /** Adds an event. This is lock-free and doesn't allocate. [[ real_time ]] */
+    void addEvent (const Event& e) noexcept
+    {
+        if (! queue.try_push (e))
+            numEventsDropped.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    /** Returns the number of events that were dropped because the queue was full. */
+    uint64_t getNumEventsDropped() const noexcept
+    {
+        return numEventsDropped.load (std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    /** Moves any queued events in to the history. [[ message_thread ]] */
+    void collectEvents()
+    {
+        const std::scoped_lock sl (historyMutex);
+        Event e;
+
+        while (queue.try_pop (e))
+        {
+            history.push_back (e);
+
+            if (! e.isBlock())
+            {
+                auto& typeName = getDemangledName (e.nodeTypeName);
+                auto& stats = nodeStatistics[{ e.nodeID, typeName }];
+                stats.nodeTypeName = typeName;
+                stats.nodeID = e.nodeID;
+                stats.processTime.addResult (e.getProcessSeconds(), 0);
+                stats.waitTime.addResult (e.getWaitSeconds(), 0);
+            }
+        }
+
+        while (history.size() > maxNumEventsToRetain)
+            history.pop_front();
+    }
+
+    /** Collects and returns all the events in the history. [[ message_thread ]] */
+    std::vector<Event> getEvents()
+    {
+        collectEvents();
+
+        const std::scoped_lock sl (historyMutex);
+        return { history.begin(), history.end() };
+    }
+
+    /** Summarises the time spent in each Node. */
+    struct NodeStatistics
+    {
+        std::string nodeTypeName;
+        size_t nodeID = 0;
+        PerformanceMeasurement::Statistics processTime, waitTime;
+    };
+
+    /** Collects and returns the statistics of every Node seen since the last reset,
+        sorted by total process time.
+        Nodes are identified by their nodeID so their statistics carry over when the
+        graph is rebuilt. Nodes without a nodeID are grouped by their type.
+        [[ message_thread ]]
+    */
+    std::vector<NodeStatistics> getNodeStatistics()
+    {
+        collectEvents();
+
+        const std::scoped_lock sl (historyMutex);
+        std::vector<NodeStatistics> stats;
+        stats.reserve (nodeStatistics.size());
+
+        for (auto& s : nodeStatistics)
+            stats.push_back (s.second);
+
+        std::sort (stats.begin(), stats.end(),
+                   [] (auto& s1, auto& s2) { return s1.processTime.totalSeconds > s2.processTime.totalSeconds; });
+
+        return stats;
+    }
+
+    /** Clears the history and statistics. [[ message_thread ]] */
+    void reset()
+    {
+        collectEvents();
+
+        const std::scoped_lock sl (historyMutex);
+        history.clear();
+        nodeStatistics.clear();
+    }
+
+    //==============================================================================
+    /** Collects the events and returns them in the Chrome trace event JSON format.
+        Each Node is a complete event on the thread that processed it, with its
+        wait time and block number as arguments. [[ message_thread ]]
+    */
+    std::string toChromeTraceJSON()
+    {
+        auto events = getEvents();
+
+        auto toMicroseconds = [] (int64_t ns) { return std::to_string ((double) ns / 1000.0); };
+        auto escape = [] (const std::string& text)
+        {
+            std::string s;
+
+            for (auto c : text)
+            {
+                if (c == '"' || c == '\\')
+                    s += '\\';
+
+                s += c;
+            }
+
+            return s;
+        };
+
+        const std::scoped_lock sl (historyMutex);
+        std::string json = "{\"traceEvents\":[";
+        bool isFirst = true;
+
+        for (auto& e : events)
+        {
+            if (! std::exchange (isFirst, false))
+                json += ",";
+
+            json += "\n{\"name\":\"" + (e.isBlock() ? std::string ("Block ") + std::to_string (e.blockNumber) : escape (getDemangledName (e.nodeTypeName))) + "\""
+                    + ",\"cat\":\"" + (e.isBlock() ? "block" : "node") + "\""
+                    + ",\"ph\":\"X\""
+                    + ",\"ts\":" + toMicroseconds (e.startNs)
+                    + ",\"dur\":" + toMicroseconds (e.endNs - e.startNs)
+                    + ",\"pid\":0"
+                    + ",\"tid\":" + std::to_string (e.threadIndex)
+                    + ",\"args\":{\"block\":" + std::to_string (e.blockNumber);
+
+            if (! e.isBlock())
+                json += ",\"nodeID\":" + std::to_string (e.nodeID)
+                        + ",\"wait_us\":" + toMicroseconds (e.startNs - e.readyNs);
+
+            json += "}}";
+        }
+
+        json += "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+        return json;
+    }
+
+    //==============================================================================
+    /** Returns the readable version of a typeid name, or the name itself if it can't be demangled. */
+    static std::string demangle (const char* typeName)
+    {
+        if (typeName == nullptr)
+            return {};
+
+       #if __has_include (<cxxabi.h>)
+        int status = 0;
+
+        if (char* demangled = abi::__cxa_demangle (typeName, nullptr, nullptr, &status); status == 0)
+        {
+            std::string name (demangled);
+            free (demangled);
+            return name;
+        }
+       #endif
+
+        return typeName;
+    }
+
+private:
+    //==============================================================================
+    const std::chrono::steady_clock::time_point epoch { std::chrono::steady_clock::now() };
+    std::atomic<bool> enabled { false };
+    std::atomic<uint64_t> nextBlockNumber { 0 }, numEventsDropped { 0 };
+    rigtorp::MPMCQueue<Event> queue;
+
+    std::mutex historyMutex;
+    const size_t maxNumEventsToRetain;
+    std::deque<Event> history;
+    std::map<std::pair<size_t, std::string>, NodeStatistics> nodeStatistics;
+    std::unordered_map<const char*, std::string> demangledNames;
+
+    const std::string& getDemangledName (const char* typeName)
+    {
+        auto found = demangledNames.find (typeName);
+
+        if (found == demangledNames.end())
+            found = demangledNames.emplace (typeName, demangle (typeName)).first;
+
+        return found->second;
+    }
+};
+
+}}
@@ -0,0 +1,437 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+
+ #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define TRACKTION_SUMMING_KERNELS_SSE 1
+ #endif
+
+ #if defined (__GNUC__) || defined (__clang__)
+  #define TRACKTION_SUMMING_KERNELS_AVX2 1
+  #define TRACKTION_TARGET_AVX2 __attribute__ ((target ("avx2")))
+ #elif JUCE_MSVC
+  #define TRACKTION_SUMMING_KERNELS_AVX2 1
+  #define TRACKTION_TARGET_AVX2
+ #endif
+#endif
+
+#if JUCE_ARM && (defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64))
+ #include <arm_neon.h>
+ #define TRACKTION_SUMMING_KERNELS_NEON 1
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+namespace summing_kernels
+{
+
+namespace
+{
+    //==============================================================================
+    // Scalar kernels, also used for any remaining frames by the vector kernels
+    //==============================================================================
+    template<typename AccumulatorType, bool applyGain>
+    void sumScalar (float* dest, const float* const* sources, const float* gains,
+                    size_t numSources, size_t startFrame, size_t numFrames) noexcept
+    {
+        for (size_t i = startFrame; i < numFrames; ++i)
+        {
+            AccumulatorType acc = 0;
+
+            for (size_t s = 0; s < numSources; ++s)
+            {
+                if constexpr (applyGain)
+                    acc += static_cast<AccumulatorType> (gains[s]) * static_cast<AccumulatorType> (sources[s][i]);
+                else
+                    acc += static_cast<AccumulatorType> (sources[s][i]);
+            }
+
+            dest[i] = static_cast<float> (acc);
+        }
+    }
+
+   #if TRACKTION_SUMMING_KERNELS_SSE
+    //==============================================================================
+    // SSE2 kernels
+    //==============================================================================
+    template<bool applyGain>
+    void sumSSE (float* dest, const float* const* sources, const float* gains,
+                 size_t numSources, size_t numFrames) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 8 <= numFrames; i += 8)
+        {
+            auto acc0 = _mm_setzero_ps();
+            auto acc1 = _mm_setzero_ps();
+
+            for (size_t s = 0; s < numSources; ++s)
+            {
+                auto x0 = _mm_loadu_ps (sources[s] + i);
+                auto x1 = _mm_loadu_ps (sources[s] + i + 4);
+
+                if constexpr (applyGain)
+                {
+                    const auto g = _mm_set1_ps (gains[s]);
+                    x0 = _mm_mul_ps (x0, g);
+                    x1 = _mm_mul_ps (x1, g);
+                }
+
+                acc0 = _mm_add_ps (acc0, x0);
+                acc1 = _mm_add_ps (acc1, x1);
+            }
+
+            _mm_storeu_ps (dest + i, acc0);
+            _mm_storeu_ps (dest + i + 4, acc1);
+        }
+
+        sumScalar<float, applyGain> (dest, sources, gains, numSources, i, numFrames);
+    }
+
+    template<bool applyGain>
+    void sumDoublePrecisionSSE (float* dest, const float* const* sources, const float* gains,
+                                size_t numSources, size_t numFrames) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            auto accLow = _mm_setzero_pd();
+            auto accHigh = _mm_setzero_pd();
+
+            for (size_t s = 0; s < numSources; ++s)
+            {
+                const auto x = _mm_loadu_ps (sources[s] + i);
+                auto xLow = _mm_cvtps_pd (x);
+                auto xHigh = _mm_cvtps_pd (_mm_movehl_ps (x, x));
+
+                if constexpr (applyGain)
+                {
+                    const auto g = _mm_set1_pd (static_cast<double> (gains[s]));
+                    xLow = _mm_mul_pd (xLow, g);
+                    xHigh = _mm_mul_pd (xHigh, g);
+                }
+
+                accLow = _mm_add_pd (accLow, xLow);
+                accHigh = _mm_add_pd (accHigh, xHigh);
+            }
+
+            _mm_storeu_ps (dest + i, _mm_movelh_ps (_mm_cvtpd_ps (accLow), _mm_cvtpd_ps (accHigh)));
+        }
+
+        sumScalar<double, applyGain> (dest, sources, gains, numSources, i, numFrames);
+    }
+   #endif
+
+   #if TRACKTION_SUMMING_KERNELS_AVX2
+    //==============================================================================
+    // AVX2 kernels
+    // N.B. These are compiled for AVX2 regardless of the build settings so must
+    // only be called if the CPU supports it
+    //==============================================================================
+    template<bool applyGain>
+    TRACKTION_TARGET_AVX2
+    void sumAVX2 (float* dest, const float* const* sources, const float* gains,
+                  size_t numSources, size_t numFrames) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 16 <= numFrames; i += 16)
+        {
+            auto acc0 = _mm256_setzero_ps();
+            auto acc1 = _mm256_setzero_ps();
+
+            for (size_t s = 0; s < numSources; ++s)
+            {
+                auto x0 = _mm256_loadu_ps (sources[s] + i);
+                auto x1 = _mm256_loadu_ps (sources[s] + i + 8);
+
+                if constexpr (applyGain)
+                {
+                    const auto g = _mm256_set1_ps (gains[s]);
+                    x0 = _mm256_mul_ps (x0, g);
+                    x1 = _mm256_mul_ps (x1, g);
+                }
+
+                acc0 = _mm256_add_ps (acc0, x0);
+                acc1 = _mm256_add_ps (acc1, x1);
+            }
+
+            _mm256_storeu_ps (dest + i, acc0);
+            _mm256_storeu_ps (dest + i + 8, acc1);
+        }
+
+        // Avoid the AVX-SSE transition penalty in the scalar code
+        _mm256_zeroupper();
+        sumScalar<float, applyGain> (dest, sources, gains, numSources, i, numFrames);
+    }
+
+    template<bool applyGain>
+    TRACKTION_TARGET_AVX2
+    void sumDoublePrecisionAVX2 (float* dest, const float* const* sources, const float* gains,
+                                 size_t numSources, size_t numFrames) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 8 <= numFrames; i += 8)
+        {
+            auto accLow = _mm256_setzero_pd();
+            auto accHigh = _mm256_setzero_pd();
+
+            for (size_t s = 0; s < numSources; ++s)
+            {
+                const auto x = _mm256_loadu_ps (sources[s] + i);
+                auto xLow = _mm256_cvtps_pd (_mm256_castps256_ps128 (x));
+                auto xHigh = _mm256_cvtps_pd (_mm256_extractf128_ps (x, 1));
+
+                if constexpr (applyGain)
+                {
+                    const auto g = _mm256_set1_pd (static_cast<double> (gains[s]));
+                    xLow = _mm256_mul_pd (xLow, g);
+                    xHigh = _mm256_mul_pd (xHigh, g);
+                }
+
+                accLow = _mm256_add_pd (accLow, xLow);
+                accHigh = _mm256_add_pd (accHigh, xHigh);
+            }
+
+            _mm256_storeu_ps (dest + i, _mm256_insertf128_ps (_mm256_castps128_ps256 (_mm256_cvtpd_ps (accLow)),
+                                                              _mm256_cvtpd_ps (accHigh), 1));
+        }
+
+        _mm256_zeroupper();
+        sumScalar<double, applyGain> (dest, sources, gains, numSources, i, numFrames);
+    }
+   #endif
+
+   #if TRACKTION_SUMMING_KERNELS_NEON
+    //==============================================================================
+    // NEON kernels
+    //==============================================================================
+    template<bool applyGain>
+    void sumNEON (float* dest, const float* const* sources, const float* gains,
+                  size_t numSources, size_t numFrames) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + 8 <= numFrames; i += 8)
+        {
+            auto acc0 = vdupq_n_f32 (0.0f);
+            auto acc1 = vdupq_n_f32 (0.0f);
+
+            for (size_t s = 0; s < numSources; ++s)
+            {
+                auto x0 = vld1q_f32 (sources[s] + i);
+                auto x1 = vld1q_f32 (sources[s] + i + 4);
+
+                if constexpr (applyGain)
+                {
+                    x0 = vmulq_n_f32 (x0, gains[s]);
+                    x1 = vmulq_n_f32 (x1, gains[s]);
+                }
+
+                acc0 = vaddq_f32 (acc0, x0);
+                acc1 = vaddq_f32 (acc1, x1);
+            }
+
+            vst1q_f32 (dest + i, acc0);
+            vst1q_f32 (dest + i + 4, acc1);
+        }
+
+        sumScalar<float, applyGain> (dest, sources, gains, numSources, i, numFrames);
+    }
+
+    template<bool applyGain>
+    void sumDoublePrecisionNEON (float* dest, const float* const* sources, const float* gains,
+                                 size_t numSources, size_t numFrames) noexcept
+    {
+        size_t i = 0;
+
+       #if defined (__aarch64__) || defined (_M_ARM64)
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            auto accLow = vdupq_n_f64 (0.0);
+            auto accHigh = vdupq_n_f64 (0.0);
+
+            for (size_t s = 0; s < numSources; ++s)
+            {
+                const auto x = vld1q_f32 (sources[s] + i);
+                auto xLow = vcvt_f64_f32 (vget_low_f32 (x));
+                auto xHigh = vcvt_high_f64_f32 (x);
+
+                if constexpr (applyGain)
+                {
+                    xLow = vmulq_n_f64 (xLow, static_cast<double> (gains[s]));
+                    xHigh = vmulq_n_f64 (xHigh, static_cast<double> (gains[s]));
+                }
+
+                accLow = vaddq_f64 (accLow, xLow);
+                accHigh = vaddq_f64 (accHigh, xHigh);
+            }
+
+            vst1q_f32 (dest + i, vcvt_high_f32_f64 (vcvt_f32_f64 (accLow), accHigh));
+        }
+       #endif
+
+        // 32-bit ARM doesn't have double precision vectors
+        sumScalar<double, applyGain> (dest, sources, gains, numSources, i, numFrames);
+    }
+   #endif
+
+    //==============================================================================
+    template<bool doublePrecision, bool applyGain>
+    void sumWithInstructionSet (InstructionSet instructionSet, float* dest, const float* const* sources, const float* gains,
+                                size_t numSources, size_t numFrames) noexcept
+    {
+        jassert (isSupported (instructionSet));
+        using Kernel = void (*) (float*, const float* const*, const float*, size_t, size_t) noexcept;
+        Kernel kernel = [] (float* d, const float* const* s, const float* g, size_t numS, size_t numF) noexcept
+        {
+            sumScalar<std::conditional_t<doublePrecision, double, float>, applyGain> (d, s, g, numS, 0, numF);
+        };
+
+        switch (instructionSet)
+        {
+           #if TRACKTION_SUMMING_KERNELS_SSE
+            case InstructionSet::sse:
+                kernel = doublePrecision ? sumDoublePrecisionSSE<applyGain> : sumSSE<applyGain>;
+                break;
+           #endif
+
+           #if TRACKTION_SUMMING_KERNELS_AVX2
+            case InstructionSet::avx2:
+                kernel = doublePrecision ? sumDoublePrecisionAVX2<applyGain> : sumAVX2<applyGain>;
+                break;
+           #endif
+
+           #if TRACKTION_SUMMING_KERNELS_NEON
+            case InstructionSet::neon:
+                kernel = doublePrecision ? sumDoublePrecisionNEON<applyGain> : sumNEON<applyGain>;
+                break;
+           #endif
+
+            case InstructionSet::scalar:
+            default:
+                break;
+        }
+
+        kernel (dest, sources, gains, numSources, numFrames);
+    }
+
+    template<bool doublePrecision>
+    void sumWithInstructionSet (InstructionSet instructionSet, float* dest, const float* const* sources, const float* gains,
+                                size_t numSources, size_t numFrames) noexcept
+    {
+        jassert (numSources == 0 || sources != nullptr);
+
+        if (numSources == 0)
+            std::fill_n (dest, numFrames, 0.0f);
+        else if (numSources == 1 && gains == nullptr)
+            std::copy_n (sources[0], numFrames, dest); // A single input at unity gain is just a copy
+        else if (gains != nullptr)
+            sumWithInstructionSet<doublePrecision, true> (instructionSet, dest, sources, gains, numSources, numFrames);
+        else
+            sumWithInstructionSet<doublePrecision, false> (instructionSet, dest, sources, gains, numSources, numFrames);
+    }
+}
+
+//==============================================================================
+const char* getName (InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::scalar:    return "scalar";
+        case InstructionSet::sse:       return "SSE";
+        case InstructionSet::avx2:      return "AVX2";
+        case InstructionSet::neon:      return "NEON";
+    }
+
+    return "";
+}
+
+bool isSupported (InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::scalar:
+            return true;
+
+        case InstructionSet::sse:
+           #if TRACKTION_SUMMING_KERNELS_SSE
+            return true;
+           #else
+            return false;
+           #endif
+
+        case InstructionSet::avx2:
+           #if TRACKTION_SUMMING_KERNELS_AVX2
+            return juce::SystemStats::hasAVX2();
+           #else
+            return false;
+           #endif
+
+        case InstructionSet::neon:
+           #if TRACKTION_SUMMING_KERNELS_NEON
+            return true;
+           #else
+            return false;
+           #endif
+    }
+
+    return false;
+}
+
+InstructionSet getBestInstructionSet()
+{
+    for (auto instructionSet : { InstructionSet::avx2, InstructionSet::neon, InstructionSet::sse })
+        if (isSupported (instructionSet))
+            return instructionSet;
+
+    return InstructionSet::scalar;
+}
+
+//==============================================================================
+void sum (float* dest, const float* const* sources, const float* gains,
+          size_t numSources, size_t numFrames) noexcept
+{
+    static const auto instructionSet = getBestInstructionSet();
+    sumWithInstructionSet<false> (instructionSet, dest, sources, gains, numSources, numFrames);
+}
+
+void sumDoublePrecision (float* dest, const float* const* sources, const float* gains,
+                         size_t numSources, size_t numFrames) noexcept
+{
+    static const auto instructionSet = getBestInstructionSet();
+    sumWithInstructionSet<true> (instructionSet, dest, sources, gains, numSources, numFrames);
+}
+
+void sum (InstructionSet instructionSet, float* dest, const float* const* sources, const float* gains,
+          size_t numSources, size_t numFrames) noexcept
+{
+    sumWithInstructionSet<false> (instructionSet, dest, sources, gains, numSources, numFrames);
+}
+
+void sumDoublePrecision (InstructionSet instructionSet, float* dest, const float* const* sources, const float* gains,
+                         size_t numSources, size_t numFrames) noexcept
+{
+    sumWithInstructionSet<true> (instructionSet, dest, sources, gains, numSources, numFrames);
+}
+
+}
+
+}}
+
+#undef TRACKTION_SUMMING_KERNELS_SSE
+#undef TRACKTION_SUMMING_KERNELS_AVX2
+#undef TRACKTION_SUMMING_KERNELS_NEON
+#undef TRACKTION_TARGET_AVX2
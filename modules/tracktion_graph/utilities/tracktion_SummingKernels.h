@@ -0,0 +1,80 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Vectorised kernels for mixing a number of inputs together.
+
+    Rather than adding each input to the destination in turn, these load all
+    the inputs for a group of frames, sum them in registers and then write the
+    destination once. The best kernel for the CPU is picked at runtime.
+*/
+namespace summing_kernels
+{
+    /** The instruction sets the kernels can be run with. */
+    enum class InstructionSet
+    {
+        scalar,     /**< Plain C++, available everywhere. */
+        sse,        /**< SSE2, x86 only. */
+        avx2,       /**< AVX2, x86 only and if supported by the CPU. */
+        neon        /**< NEON, ARM only. */
+    };
+
+    /** Returns a human-readable name for an InstructionSet. */
+    const char* getName (InstructionSet);
+
+    /** Returns true if the kernels can be run with the given InstructionSet on this CPU. */
+    bool isSupported (InstructionSet);
+
+    /** Returns the fastest InstructionSet supported on this CPU. */
+    InstructionSet getBestInstructionSet();
+
+    //==============================================================================
+    /** Sums a number of sources in to dest, overwriting its contents.
+
+        @param dest         the destination, this must not be one of the sources
+        @param sources      an array of numSources pointers, each to numFrames samples
+        @param gains        an array of numSources gains to apply to each source,
+                            or nullptr to sum at unity gain
+        @param numSources   the number of sources, if this is 0 dest will be cleared
+        @param numFrames    the number of samples to write
+        [[ real_time ]]
+    */
+    void sum (float* dest, const float* const* sources, const float* gains,
+              size_t numSources, size_t numFrames) noexcept;
+
+    /** Sums a number of sources in to dest using double precision intermediates,
+        overwriting its contents.
+        @see sum
+        [[ real_time ]]
+    */
+    void sumDoublePrecision (float* dest, const float* const* sources, const float* gains,
+                             size_t numSources, size_t numFrames) noexcept;
+
+    /** Sums using a specific InstructionSet which must be supported.
+        This is mainly useful for testing and benchmarking, normally you would call sum.
+    */
+    void sum (InstructionSet, float* dest, const float* const* sources, const float* gains,
+              size_t numSources, size_t numFrames) noexcept;
+
+    /** Sums using double precision and a specific InstructionSet which must be supported.
+        This is mainly useful for testing and benchmarking, normally you would call sumDoublePrecision.
+    */
+    void sumDoublePrecision (InstructionSet, float* dest, const float* const* sources, const float* gains,
+                             size_t numSources, size_t numFrames) noexcept;
+}
+
+}}
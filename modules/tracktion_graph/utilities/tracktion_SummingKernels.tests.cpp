@@ -0,0 +1,223 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SUMMING
+ #include "../../tracktion_core/utilities/tracktion_Benchmark.h"
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_SUMMINGKERNELS || (TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SUMMING)
+
+namespace summing_kernels_test_utilities
+{
+    /** Holds a number of random sources and the pointers and gains to pass to the kernels. */
+    struct Sources
+    {
+        Sources (size_t numSources, size_t numFrames, juce::Random& random)
+        {
+            for (size_t i = 0; i < numSources; ++i)
+            {
+                auto& buffer = buffers.emplace_back (numFrames);
+
+                for (auto& s : buffer)
+                    s = random.nextFloat() * 2.0f - 1.0f;
+
+                pointers.push_back (buffer.data());
+                gains.push_back (random.nextFloat());
+            }
+        }
+
+        std::vector<std::vector<float>> buffers;
+        std::vector<const float*> pointers;
+        std::vector<float> gains;
+    };
+
+    inline std::vector<summing_kernels::InstructionSet> getSupportedInstructionSets()
+    {
+        using summing_kernels::InstructionSet;
+        std::vector<InstructionSet> instructionSets;
+
+        for (auto instructionSet : { InstructionSet::scalar, InstructionSet::sse, InstructionSet::avx2, InstructionSet::neon })
+            if (summing_kernels::isSupported (instructionSet))
+                instructionSets.push_back (instructionSet);
+
+        return instructionSets;
+    }
+}
+
+#endif
+
+#if GRAPH_UNIT_TESTS_SUMMINGKERNELS
+
+//==============================================================================
+//==============================================================================
+class SummingKernelsTests  : public juce::UnitTest
+{
+public:
+    SummingKernelsTests()
+        : juce::UnitTest ("SummingKernels", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        using namespace summing_kernels_test_utilities;
+
+        for (auto instructionSet : getSupportedInstructionSets())
+        {
+            beginTest (juce::String ("Summing: ") + summing_kernels::getName (instructionSet));
+            runSummingTests (instructionSet);
+        }
+
+        beginTest ("Best instruction set");
+        {
+            expect (summing_kernels::isSupported (summing_kernels::getBestInstructionSet()));
+            expect (summing_kernels::isSupported (summing_kernels::InstructionSet::scalar));
+        }
+    }
+
+private:
+    void runSummingTests (summing_kernels::InstructionSet instructionSet)
+    {
+        using namespace summing_kernels_test_utilities;
+        juce::Random random (42);
+
+        // Odd frame counts check the remainder after the vector loops
+        for (size_t numSources : { 0, 1, 2, 3, 7, 32 })
+        {
+            for (size_t numFrames : { 0, 1, 3, 15, 16, 17, 31, 512, 515 })
+            {
+                Sources sources (numSources, numFrames, random);
+
+                for (bool applyGain : { false, true })
+                {
+                    const auto gains = applyGain ? sources.gains.data() : nullptr;
+
+                    // Double precision should match summing in double up to the final rounding
+                    {
+                        std::vector<float> dest (numFrames, 1.0f);
+                        summing_kernels::sumDoublePrecision (instructionSet, dest.data(), sources.pointers.data(), gains, numSources, numFrames);
+
+                        for (size_t i = 0; i < numFrames; ++i)
+                            expectWithinAbsoluteError (dest[i], (float) getExpectedSum (sources, gains, i), 1.0e-5f);
+                    }
+
+                    // Single precision accumulates rounding errors so needs a bit more tolerance
+                    {
+                        std::vector<float> dest (numFrames, 1.0f);
+                        summing_kernels::sum (instructionSet, dest.data(), sources.pointers.data(), gains, numSources, numFrames);
+
+                        for (size_t i = 0; i < numFrames; ++i)
+                            expectWithinAbsoluteError (dest[i], (float) getExpectedSum (sources, gains, i), 1.0e-4f);
+                    }
+                }
+            }
+        }
+    }
+
+    static double getExpectedSum (const summing_kernels_test_utilities::Sources& sources, const float* gains, size_t frame)
+    {
+        double expected = 0.0;
+
+        for (size_t s = 0; s < sources.pointers.size(); ++s)
+            expected += (gains != nullptr ? (double) gains[s] : 1.0) * (double) sources.pointers[s][frame];
+
+        return expected;
+    }
+};
+
+static SummingKernelsTests summingKernelsTests;
+
+#endif
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SUMMING
+
+//==============================================================================
+//==============================================================================
+class SummingKernelsBenchmarks : public juce::UnitTest
+{
+public:
+    SummingKernelsBenchmarks()
+        : juce::UnitTest ("SummingKernels", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        for (size_t numSources : { 2, 8, 64 })
+            for (size_t numFrames : { 64, 512 })
+                runBenchmarks (numSources, numFrames);
+    }
+
+private:
+    void runBenchmarks (size_t numSources, size_t numFrames)
+    {
+        using namespace summing_kernels_test_utilities;
+        juce::Random random (42);
+        Sources sources (numSources, numFrames, random);
+        std::vector<float> dest (numFrames);
+
+        const auto description = std::to_string (numSources) + " sources, " + std::to_string (numFrames) + " frames";
+        const int numIterations = 100'000;
+
+        // The previous approach of clearing and then adding each source to the destination in turn
+        {
+            beginTest ("Per-source add: " + description);
+            Benchmark benchmark (createBenchmarkDescription ("Summing", "Per-source add", description));
+            auto destView = choc::buffer::createMonoView (dest.data(), (choc::buffer::FrameCount) numFrames);
+
+            for (int i = 0; i < numIterations; ++i)
+            {
+                benchmark.start();
+                destView.clear();
+
+                for (auto source : sources.pointers)
+                    add (destView, choc::buffer::createMonoView (source, (choc::buffer::FrameCount) numFrames));
+
+                benchmark.stop();
+            }
+
+            BenchmarkList::getInstance().addResult (benchmark.getResult());
+            expect (true);
+        }
+
+        for (auto instructionSet : getSupportedInstructionSets())
+        {
+            for (bool doublePrecision : { false, true })
+            {
+                const auto name = std::string (summing_kernels::getName (instructionSet)) + (doublePrecision ? " (double)" : "");
+                beginTest (name + ": " + description);
+                Benchmark benchmark (createBenchmarkDescription ("Summing", name, description));
+
+                for (int i = 0; i < numIterations; ++i)
+                {
+                    benchmark.start();
+
+                    if (doublePrecision)
+                        summing_kernels::sumDoublePrecision (instructionSet, dest.data(), sources.pointers.data(), nullptr, numSources, numFrames);
+                    else
+                        summing_kernels::sum (instructionSet, dest.data(), sources.pointers.data(), nullptr, numSources, numFrames);
+
+                    benchmark.stop();
+                }
+
+                BenchmarkList::getInstance().addResult (benchmark.getResult());
+                expect (true);
+            }
+        }
+    }
+};
+
+static SummingKernelsBenchmarks summingKernelsBenchmarks;
+
+#endif
+
+}}